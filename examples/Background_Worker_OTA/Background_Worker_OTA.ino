@@ -0,0 +1,140 @@
+/*━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Background Worker OTA Example — GitHub Updates Without Blocking loop()
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ *
+ * WHAT THIS DOES:
+ * 1. Runs all OTA work (WiFi, ArduinoOTA, GitHub checks, downloads) on a
+ *    worker: core 1 on Pico W / Pico 2 W, a FreeRTOS task on ESP32
+ * 2. loop() only sends requests ("check GitHub", "update") and reads
+ *    events (started, progress, done, error) - it never waits for the network
+ * 3. Requests and events travel through lock-free queues, no shared flags
+ *
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * RULES FOR WORKER MODE:
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ *
+ * • Configure the library and call otaSetup...() first, then otaWorkerBegin()
+ * • After that, do NOT call otaLoop() or other OTA functions from loop()
+ * • Pico W / Pico 2 W: loop1() must call otaWorkerLoop() (see below)
+ * • OTA callbacks (otaOnProgress, ...) run on the worker, not in loop()
+ *
+ * Board setup, .bin generation and GitHub releases: see the GitHub_OTA example.
+ *
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * CONFIGURATION:
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ *
+ * • Edit secret.h with WiFi credentials (WIFI_SSID, WIFI_PASSWORD)
+ * • Update GITHUB_OWNER, GITHUB_REPO and CURRENT_VERSION below
+ *
+ * Compatible with: Pico W, Pico 2 W, ESP32
+ * For more details, see README.md
+ *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━*/
+
+#include <pico_ota.h>
+#include "secret.h"  // Contains WIFI_SSID and WIFI_PASSWORD
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Configuration
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+const char* GITHUB_OWNER = "username";
+const char* GITHUB_REPO = "my-project";
+const char* CURRENT_VERSION = "1.0.0";
+
+// Check for updates every 1 hour
+const unsigned long CHECK_INTERVAL_MS = 60 * 60 * 1000;
+
+#if defined(LED_BUILTIN)
+  const int LED_PIN = LED_BUILTIN;
+#else
+  const int LED_PIN = 25;
+#endif
+
+unsigned long lastCheckMs = 0;
+bool checkPending = false;
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  pinMode(LED_PIN, OUTPUT);
+
+  Serial.println();
+  Serial.println("╔═══════════════════════════════════════════╗");
+  Serial.println("║      Background Worker OTA Example        ║");
+  Serial.println("╚═══════════════════════════════════════════╝");
+  Serial.println();
+
+  otaSetGitHubRepo(GITHUB_OWNER, GITHUB_REPO);
+  otaSetCurrentVersion(CURRENT_VERSION);
+  otaSetAutoReconnect(true);
+
+  // Returns at once; the worker finishes connecting in the background
+  otaSetupAsync(WIFI_SSID, WIFI_PASSWORD, "worker-ota-device");
+
+  if (!otaWorkerBegin()) {
+    Serial.println("[Setup] Could not start the OTA worker");
+  }
+  Serial.println("[Setup] Device ready!");
+}
+
+void loop() {
+  // Ask the worker to check GitHub periodically (the first check after 10s)
+  if (!checkPending && millis() - lastCheckMs >= (lastCheckMs ? CHECK_INTERVAL_MS : 10000)) {
+    lastCheckMs = millis();
+    checkPending = otaRequestGitHubCheck();
+  }
+
+  // Handle everything the worker reports
+  OtaEvent event;
+  while (otaPollEvent(&event)) {
+    handleOtaEvent(event);
+  }
+
+  // Your application code here - never blocked by OTA
+  digitalWrite(LED_PIN, (millis() / 500) % 2);
+  delay(10);
+}
+
+void handleOtaEvent(const OtaEvent& event) {
+  switch (event.type) {
+    case OTA_EVENT_STARTED:
+      Serial.println(event.command == OTA_COMMAND_CHECK_GITHUB ? "[Worker] Checking GitHub..."
+                                                               : "[Worker] Update started");
+      break;
+
+    case OTA_EVENT_PROGRESS:
+      if (event.phase == OTA_PROGRESS_VERIFY) {
+        Serial.println("[Worker] Verifying...");
+      } else if (event.total > 0) {
+        Serial.printf("[Worker] Progress: %u%% at %lu kB/s, %lu s left\n",
+                      (unsigned)((uint64_t)event.bytes * 100 / event.total),
+                      (unsigned long)(event.bytesPerSecond / 1024), (unsigned long)event.etaSeconds);
+      }
+      break;
+
+    case OTA_EVENT_DONE:
+      if (event.command == OTA_COMMAND_CHECK_GITHUB) {
+        checkPending = false;
+        if (event.result == OTA_UPDATE_OK) {
+          Serial.printf("[Worker] New version %s, updating...\n", event.version);
+          otaRequestGitHubUpdate();
+        } else {
+          Serial.println("[Worker] Firmware is up to date");
+        }
+      }
+      break;
+
+    case OTA_EVENT_ERROR:
+      checkPending = false;
+      Serial.printf("[Worker] Failed with code %d\n", event.result);
+      break;
+  }
+}
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+// Core 1: the OTA worker (ESP32 runs it as a task started by otaWorkerBegin)
+void loop1() {
+  otaWorkerLoop();
+  delay(1);
+}
+#endif
@@ -0,0 +1,3 @@
+// WiFi credentials
+#define WIFI_SSID     "YourWiFiSSID"
+#define WIFI_PASSWORD "YourWiFiPassword"
@@ -120,6 +120,8 @@ const char* CURRENT_VERSION = "1.0.0";
 const char* ASSET_PATTERN = "*.bin";
 
 // Check for updates every 1 hour
+// (with many devices, otaSetUpdatePolicy() spreads the checks and lets the
+// library run them - see the HTTP_Pull_OTA example)
 const unsigned long CHECK_INTERVAL_MS = 60 * 60 * 1000;
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -280,6 +282,10 @@ void checkForUpdate() {
       Serial.println("[GitHub] Check asset pattern or release attachments");
       break;
       
+    case OTA_UPDATE_RATE_LIMITED:
+      Serial.printf("[GitHub] API rate limit, next check in %lu s\n", otaGetGitHubRetryDelay());
+      break;
+      
     default:
       Serial.printf("[GitHub] Check failed with code: %d\n", result);
       break;
@@ -297,6 +303,9 @@ void doGitHubUpdate() {
     case OTA_UPDATE_FAILED:
       Serial.println("[GitHub] Firmware download/install failed");
       break;
+    case OTA_UPDATE_WRONG_IMAGE:
+      Serial.println("[GitHub] Release asset is not firmware for this board");
+      break;
     default:
       Serial.printf("[GitHub] Update failed with code: %d\n", result);
       break;
@@ -58,9 +58,12 @@
  * 1. Upload this sketch via USB (device connects to WiFi)
  * 2. Generate .bin file of updated code (Sketch → Export Compiled Binary)
  * 3. Upload .bin to your web server
- * 4. Device checks server every 5 minutes (configurable)
+ * 4. Device checks server about every 5 minutes (configurable); the library
+ *    spreads the checks of many devices so they do not hit the server at once
  * 5. When new firmware found, device downloads, installs, and reboots
  * 6. Check Serial Monitor to verify update success
+ * 7. The new firmware confirms itself once WiFi works; if it cannot, the
+ *    device goes back to the previous firmware after 3 boots
  * 
  *━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * CONFIGURATION:
@@ -68,7 +71,8 @@
  * 
  * • Edit secret.h with WiFi credentials (WIFI_SSID, WIFI_PASSWORD)
  * • Update FIRMWARE_URL below to your server address
- * • Optional: Adjust CHECK_INTERVAL_MS for update frequency
+ * • Optional: Adjust CHECK_INTERVAL_S for update frequency
+ * • Optional: Send 'u' over Serial to check right away
  * • Optional: Change CURRENT_VERSION with each release for tracking
  * 
  * Compatible with: Pico W, Pico 2 W, ESP32, ESP32-S2, ESP32-C3
@@ -89,19 +93,22 @@ const char* FIRMWARE_URL = "http://your-server.com/firmware.bin";
 // Current firmware version (for version checking)
 const char* CURRENT_VERSION = "1.0.0";
 
-// Check for updates every 5 minutes
-const unsigned long CHECK_INTERVAL_MS = 5 * 60 * 1000;
+// Check for updates about every 5 minutes (+/- 10%, see OtaUpdatePolicy)
+const uint32_t CHECK_INTERVAL_S = 5 * 60;
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Global State
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
-unsigned long lastCheckMs = 0;
 bool updatePending = false;
 
 void setup() {
   Serial.begin(115200);
   delay(2000);
+
+  // Roll back to the previous firmware if this one fails 3 boots in a row
+  // or does not call otaMarkAppValid() within 2 minutes of booting
+  otaSetBootGuard(3, 120000);
   
   Serial.println();
   Serial.println("╔═══════════════════════════════════════════╗");
@@ -130,12 +137,23 @@ void setup() {
   otaSetAutoReconnect(true);
   otaSetReconnectInterval(30000);  // 30 seconds
   
+  // Let the library schedule the checks: first one within a minute of
+  // connecting, then every CHECK_INTERVAL_S, longer if the server asks
+  // (Cache-Control: max-age, Retry-After)
+  otaSetCurrentVersion(CURRENT_VERSION);
+  OtaUpdatePolicy policy;
+  policy.intervalSeconds = CHECK_INTERVAL_S;
+  policy.startupWindowSeconds = 60;
+  policy.url = FIRMWARE_URL;
+  otaSetUpdatePolicy(policy);
+  
   // Connect to WiFi and initialize OTA
   Serial.print("[Setup] Firmware version: ");
   Serial.println(CURRENT_VERSION);
   
   if (otaSetupWithTimeout(WIFI_SSID, WIFI_PASSWORD, 30000)) {
     Serial.println("[Setup] WiFi connected and OTA ready");
+    otaMarkAppValid();  // Reaches the network: keep this firmware
     Serial.print("[Setup] IP Address: ");
     Serial.println(WiFi.localIP());
   } else {
@@ -148,12 +166,11 @@ void setup() {
 }
 
 void loop() {
-  // Handle OTA events (ArduinoOTA, auto-reconnect)
+  // Handle OTA events (ArduinoOTA, auto-reconnect, scheduled update checks)
   otaLoop();
   
-  // Check for firmware updates periodically
-  if (millis() - lastCheckMs >= CHECK_INTERVAL_MS || lastCheckMs == 0) {
-    lastCheckMs = millis();
+  // Manual check on request
+  if (Serial.available() && Serial.read() == 'u') {
     checkForUpdate();
   }
   
@@ -198,6 +215,10 @@ void checkForUpdate() {
       Serial.println("[Update] HTTP error - check server URL");
       break;
       
+    case OTA_UPDATE_VERIFY_FAILED:
+      Serial.println("[Update] SHA-256 mismatch - image discarded");
+      break;
+      
     case OTA_UPDATE_FAILED:
     default:
       Serial.println("[Update] Update failed");
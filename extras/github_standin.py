@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Local stand-in for the GitHub releases API, for trying out Pico_OTA's
+release cache and rate-limit handling without touching api.github.com.
+
+    github_standin.py --tag v1.2.0 --asset firmware.bin [--script 200,304,403] [--port 8080]
+
+Point the device at it with otaSetGitHubApiUrl("http://<pc-ip>:8080").
+Each request to /repos/<owner>/<repo>/releases/latest takes the next entry
+of --script (the last one repeats):
+
+    200   release JSON with an ETag
+    304   Not Modified if If-None-Match carries the current ETag, else 200
+    403   rate limit exhausted (X-RateLimit-Remaining: 0, reset --reset s ahead)
+    429   secondary rate limit with Retry-After: --reset
+
+Files given with --asset (and matching .sha256 / .manifest files next to
+them) are listed as release assets and served from /download/<name>.
+Every request is logged with the headers the device sent.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class StandIn(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.0"
+    script = []
+    step = 0
+    files = {}
+    tag = ""
+    reset_s = 60
+
+    def log_request(self, code="-", size="-"):
+        sent = {k: self.headers[k] for k in ("If-None-Match", "Range", "x-ota-version") if self.headers[k]}
+        print(f"{self.command} {self.path} -> {code} {sent}", flush=True)
+
+    def etag(self):
+        names = ",".join(sorted(self.files))
+        return '"' + hashlib.sha1(f"{self.tag}|{names}".encode()).hexdigest() + '"'
+
+    def common_headers(self, remaining):
+        # send_response() already added Date, which the device uses as its clock
+        self.send_header("X-RateLimit-Limit", "60")
+        self.send_header("X-RateLimit-Remaining", str(remaining))
+        self.send_header("X-RateLimit-Reset", str(int(time.time()) + self.reset_s))
+
+    def release(self):
+        host = self.headers["Host"]
+        assets = [{"name": name, "size": len(data),
+                   "browser_download_url": f"http://{host}/download/{name}"}
+                  for name, data in sorted(self.files.items())]
+        return json.dumps({"tag_name": self.tag, "name": self.tag, "assets": assets,
+                           "body": "Release notes " * 200}).encode()
+
+    def do_GET(self):
+        if self.path.startswith("/download/"):
+            data = self.files.get(self.path[len("/download/"):])
+            if data is None:
+                self.send_error(404)
+                return
+            self.send_response(200)
+            self.send_header("Content-Length", str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+            return
+
+        if not self.path.endswith("/releases/latest"):
+            self.send_error(404)
+            return
+
+        cls = type(self)
+        action = cls.script[min(cls.step, len(cls.script) - 1)]
+        cls.step += 1
+
+        if action == "403":
+            body = b'{"message": "API rate limit exceeded"}'
+            self.send_response(403)
+            self.common_headers(0)
+        elif action == "429":
+            body = b'{"message": "You have exceeded a secondary rate limit"}'
+            self.send_response(429)
+            self.common_headers(59)
+            self.send_header("Retry-After", str(self.reset_s))
+        elif action == "304" and self.headers["If-None-Match"] == self.etag():
+            self.send_response(304)
+            self.common_headers(59)
+            self.send_header("ETag", self.etag())
+            self.end_headers()
+            return
+        else:
+            body = self.release()
+            self.send_response(200)
+            self.common_headers(59)
+            self.send_header("ETag", self.etag())
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--tag", required=True, help="tag_name of the release, e.g. v1.2.0")
+    parser.add_argument("--asset", action="append", default=[], help="file to attach (repeatable)")
+    parser.add_argument("--script", default="200,304", help="comma-separated 200/304/403/429 sequence")
+    parser.add_argument("--reset", type=int, default=60, help="seconds until the rate limit resets")
+    parser.add_argument("--port", type=int, default=8080)
+    args = parser.parse_args()
+
+    script = args.script.split(",")
+    if any(s not in ("200", "304", "403", "429") for s in script):
+        parser.error("--script entries must be 200, 304, 403 or 429")
+
+    files = {}
+    for path in args.asset:
+        for extra in ("", ".sha256", ".manifest"):
+            if os.path.exists(path + extra):
+                files[os.path.basename(path) + extra] = open(path + extra, "rb").read()
+
+    StandIn.script = script
+    StandIn.files = files
+    StandIn.tag = args.tag
+    StandIn.reset_s = args.reset
+    print(f"Serving release {args.tag} with {sorted(files)} on port {args.port}")
+    ThreadingHTTPServer(("", args.port), StandIn).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Compress firmware images for Pico_OTA ("OTAZ" format, see src/ota_lzss.h).
+
+    ota_compress.py compress   firmware.bin firmware.otaz [-w 12] [-l 4]
+    ota_compress.py decompress firmware.otaz firmware.bin
+
+The output is heatshrink's LZSS bit stream behind a 12-byte header, so the
+device decodes it with a 2^w byte window and no other buffer. `compress`
+checks the result by decoding it and prints the ratio and the RAM the
+decoder needs. Serve the .otaz file (or an .otad patch compressed with this
+tool) in place of the .bin.
+
+The device decoder's window is limited to OTA_LZSS_MAX_WINDOW_BITS (12 by
+default), so -w above that is rejected on the device.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = b"OTAZ"
+VERSION = 1
+HEADER = struct.Struct("<4sBBBxI")
+MAX_CHAIN = 48  # Candidates tried per position
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.count = 0
+
+    def put(self, value, bits):
+        self.acc = (self.acc << bits) | value
+        self.count += bits
+        while self.count >= 8:
+            self.count -= 8
+            self.out.append((self.acc >> self.count) & 0xFF)
+        self.acc &= (1 << self.count) - 1
+
+    def flush(self):
+        if self.count:
+            self.out.append((self.acc << (8 - self.count)) & 0xFF)
+            self.acc = self.count = 0
+        return bytes(self.out)
+
+
+def compress(data, window_bits, lookahead_bits):
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    # A back-reference only pays off if it is shorter than the literals
+    min_len = (1 + window_bits + lookahead_bits) // 9 + 1
+
+    bits = BitWriter()
+    heads = {}     # 3-byte key -> most recent position
+    prev = {}      # position -> previous position with the same key
+    n = len(data)
+    i = 0
+
+    def insert(pos):
+        if pos + 3 <= n:
+            key = data[pos:pos + 3]
+            old = heads.get(key)
+            if old is not None:
+                prev[pos] = old
+            heads[key] = pos
+
+    while i < n:
+        best_len = 0
+        best_dist = 0
+        limit = min(max_len, n - i)
+        if limit >= min_len:
+            cand = heads.get(data[i:i + 3])
+            tries = 0
+            while cand is not None and i - cand <= window and tries < MAX_CHAIN:
+                # Cheap reject before measuring the full match
+                if data[cand + best_len:cand + best_len + 1] == data[i + best_len:i + best_len + 1]:
+                    length = 0
+                    while length < limit and data[cand + length] == data[i + length]:
+                        length += 1
+                    if length > best_len:
+                        best_len, best_dist = length, i - cand
+                        if length == limit:
+                            break
+                cand = prev.get(cand)
+                tries += 1
+
+        if best_len >= min_len:
+            bits.put(0, 1)
+            bits.put(best_dist - 1, window_bits)
+            bits.put(best_len - 1, lookahead_bits)
+            step = best_len
+        else:
+            bits.put(0x100 | data[i], 9)
+            step = 1
+        for pos in range(i, i + step):
+            insert(pos)
+        i += step
+        if i & 0xFFFF < step:
+            # Drop chain links that fell out of the window
+            cutoff = i - window
+            prev = {k: v for k, v in prev.items() if k >= cutoff}
+
+    return HEADER.pack(MAGIC, VERSION, window_bits, lookahead_bits, n) + bits.flush()
+
+
+def decompress(blob):
+    magic, version, window_bits, lookahead_bits, size = HEADER.unpack_from(blob)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an OTAZ v1 file")
+    out = bytearray()
+    acc = count = 0
+    pos = HEADER.size
+
+    def take(bits):
+        nonlocal acc, count, pos
+        while count < bits:
+            if pos >= len(blob):
+                raise ValueError("truncated input")
+            acc = (acc << 8) | blob[pos]
+            pos += 1
+            count += 8
+        count -= bits
+        value = (acc >> count) & ((1 << bits) - 1)
+        acc &= (1 << count) - 1
+        return value
+
+    while len(out) < size:
+        if take(1):
+            out.append(take(8))
+        else:
+            dist = take(window_bits) + 1
+            length = take(lookahead_bits) + 1
+            for _ in range(length):
+                out.append(out[-dist] if dist <= len(out) else 0)
+    if len(out) != size or pos != len(blob):
+        raise ValueError("corrupt input")
+    return bytes(out)
+
+
+def cmd_compress(args):
+    data = open(args.input, "rb").read()
+    start = time.perf_counter()
+    blob = compress(data, args.window_bits, args.lookahead_bits)
+    took = time.perf_counter() - start
+    if decompress(blob) != data:
+        sys.exit("internal error: output does not decompress to the input")
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    saved = 100.0 * (1 - len(blob) / max(len(data), 1))
+    print(f"{args.output}: {len(blob)} bytes from {len(data)} ({saved:.1f}% smaller, "
+          f"{took:.1f} s); device decoder window: {1 << args.window_bits} bytes")
+
+
+def cmd_decompress(args):
+    try:
+        data = decompress(open(args.input, "rb").read())
+    except ValueError as e:
+        sys.exit(str(e))
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("compress", help="compress a .bin (or .otad) file")
+    p.add_argument("input")
+    p.add_argument("output")
+    p.add_argument("-w", "--window-bits", type=int, default=12, choices=range(4, 16))
+    p.add_argument("-l", "--lookahead-bits", type=int, default=4, choices=range(3, 15))
+    p.set_defaults(func=cmd_compress)
+    p = sub.add_parser("decompress", help="restore the original file")
+    p.add_argument("input")
+    p.add_argument("output")
+    p.set_defaults(func=cmd_decompress)
+    args = parser.parse_args()
+    if args.cmd == "compress" and args.lookahead_bits >= args.window_bits:
+        parser.error("lookahead bits must be smaller than window bits")
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
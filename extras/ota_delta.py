@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Make and apply Pico_OTA delta patches ("OTAD" format, see src/ota_delta.h).
+
+    ota_delta.py diff  old.bin new.bin patch.otad
+    ota_delta.py apply old.bin patch.otad out.bin
+
+`diff` verifies every patch by applying it before writing it and prints the
+patch size, the ratio to the full image and the apply throughput. Serve the
+patch file instead of the .bin (or attach it to a GitHub release, see the
+README) and the device rebuilds the new image from the running one.
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"OTAD"
+VERSION = 1
+HEADER = struct.Struct("<4sB3xIIII")
+
+KEY_LEN = 8          # Bytes hashed to find match candidates
+MIN_MATCH = 16       # Shorter matches are cheaper as extra bytes
+MAX_CANDIDATES = 8   # Source offsets remembered per key
+MISMATCH_GIVEUP = 32 # Stop extending after this many bytes without gain
+
+
+def write_varint(out, value):
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def zigzag(value):
+    return value << 1 if value >= 0 else (-value << 1) - 1
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def build_index(old):
+    index = {}
+    for pos in range(len(old) - KEY_LEN + 1):
+        slot = index.setdefault(old[pos:pos + KEY_LEN], [])
+        if len(slot) < MAX_CANDIDATES:
+            slot.append(pos)
+    return index
+
+
+def extend(old, new, o, n):
+    """bsdiff-style approximate forward extension: keep going while at
+    least half of the bytes so far match, return the best-scoring length."""
+    best_score = best_len = score = length = 0
+    limit = min(len(old) - o, len(new) - n)
+    while length < limit and length - best_len < MISMATCH_GIVEUP:
+        score += 1 if old[o + length] == new[n + length] else -1
+        length += 1
+        if score > best_score:
+            best_score, best_len = score, length
+    return best_len
+
+
+def find_matches(old, new):
+    index = build_index(old)
+    matches = []
+    n = 0
+    last_offset = 0
+    while n <= len(new) - KEY_LEN:
+        # Continuing the previous alignment is the common case after an edit
+        candidates = [n + last_offset] if 0 <= n + last_offset < len(old) else []
+        candidates += index.get(new[n:n + KEY_LEN], [])
+        best_len, best_o = 0, 0
+        for o in candidates:
+            length = extend(old, new, o, n)
+            if length > best_len:
+                best_len, best_o = length, o
+        if best_len >= MIN_MATCH:
+            matches.append((n, best_o, best_len))
+            last_offset = best_o - n
+            n += best_len
+        else:
+            n += 1
+    return matches
+
+
+def encode_diff(out, old, new, o, n, length):
+    """Store new[n:n+length] - old[o:o+length] as copy/add pairs."""
+    i = 0
+    while i < length:
+        start = i
+        while i < length and old[o + i] == new[n + i]:
+            i += 1
+        copy = i - start
+        start = i
+        # Bridge short runs of equal bytes inside an add span; a new pair
+        # costs at least two bytes.
+        while i < length:
+            if old[o + i] != new[n + i]:
+                i += 1
+            elif i + 2 < length and (old[o + i + 1] != new[n + i + 1] or
+                                     old[o + i + 2] != new[n + i + 2]):
+                i += 1
+            else:
+                break
+        write_varint(out, copy)
+        write_varint(out, i - start)
+        out += bytes((new[n + k] - old[o + k]) & 0xFF for k in range(start, i))
+
+
+def make_patch(old, new):
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(old), zlib.crc32(old),
+                                len(new), zlib.crc32(new)))
+    matches = find_matches(old, new)
+    # A leading record with an empty diff run covers bytes before the first match
+    if new and (not matches or matches[0][0] > 0):
+        matches.insert(0, (0, 0, 0))
+    for k, (n, o, length) in enumerate(matches):
+        if k + 1 < len(matches):
+            next_n, next_o, _ = matches[k + 1]
+        else:
+            next_n, next_o = len(new), o + length
+        extra = new[n + length:next_n]
+        write_varint(out, length)
+        write_varint(out, len(extra))
+        write_varint(out, zigzag(next_o - (o + length)))
+        encode_diff(out, old, new, o, n, length)
+        out += extra
+    return bytes(out)
+
+
+def apply_patch(old, patch):
+    magic, version, src_size, src_crc, dst_size, dst_crc = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an OTAD v1 patch")
+    if src_size != len(old) or src_crc != zlib.crc32(old):
+        raise ValueError("patch was made for a different source image")
+    out = bytearray()
+    pos = HEADER.size
+    src = 0
+    while len(out) < dst_size:
+        diff_len, pos = read_varint(patch, pos)
+        extra_len, pos = read_varint(patch, pos)
+        seek, pos = read_varint(patch, pos)
+        left = diff_len
+        while left:
+            copy, pos = read_varint(patch, pos)
+            add, pos = read_varint(patch, pos)
+            out += old[src:src + copy]
+            src += copy
+            out += bytes((old[src + k] + patch[pos + k]) & 0xFF for k in range(add))
+            src += add
+            pos += add
+            left -= copy + add
+        src += unzigzag(seek)
+        out += patch[pos:pos + extra_len]
+        pos += extra_len
+    if len(out) != dst_size or zlib.crc32(out) != dst_crc or pos != len(patch):
+        raise ValueError("patch is corrupt")
+    return bytes(out)
+
+
+def cmd_diff(args):
+    old = open(args.old, "rb").read()
+    new = open(args.new, "rb").read()
+    start = time.perf_counter()
+    patch = make_patch(old, new)
+    made = time.perf_counter() - start
+
+    start = time.perf_counter()
+    if apply_patch(old, patch) != new:
+        sys.exit("internal error: patch does not reproduce the new image")
+    applied = time.perf_counter() - start
+
+    with open(args.patch, "wb") as f:
+        f.write(patch)
+    print(f"{args.patch}: {len(patch)} bytes, {100.0 * len(patch) / max(len(new), 1):.1f}% "
+          f"of {len(new)} (diff {made:.2f} s, apply {len(new) / 1024 / max(applied, 1e-9):.0f} KiB/s)")
+
+
+def cmd_apply(args):
+    old = open(args.old, "rb").read()
+    patch = open(args.patch, "rb").read()
+    try:
+        out = apply_patch(old, patch)
+    except ValueError as e:
+        sys.exit(str(e))
+    with open(args.out, "wb") as f:
+        f.write(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("diff", help="make a patch from old.bin to new.bin")
+    p.add_argument("old")
+    p.add_argument("new")
+    p.add_argument("patch")
+    p.set_defaults(func=cmd_diff)
+    p = sub.add_parser("apply", help="rebuild new.bin from old.bin and a patch")
+    p.add_argument("old")
+    p.add_argument("patch")
+    p.add_argument("out")
+    p.set_defaults(func=cmd_apply)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
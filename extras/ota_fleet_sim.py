@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Simulate the update-check load a fleet puts on the server.
+
+    ota_fleet_sim.py [--devices 2000] [--hours 3] [--interval 3600]
+                     [--jitter 10] [--startup-window 300] [--max-age 0]
+                     [--capacity 0] [--retry-after 0] [--rollout 100]
+                     [--bucket 60] [--csv load.csv]
+
+All devices come back at the same moment, e.g. after a power cut, and
+connect to WiFi within a few seconds. Two schedules are compared:
+
+  fixed    the examples' CHECK_INTERVAL_MS timer: check once connected,
+           then every --interval seconds
+  policy   otaSetUpdatePolicy(): first check at a per-device point of the
+           startup window, intervals +/- --jitter percent, server hints
+           (Cache-Control: max-age, Retry-After) and retries with backoff
+
+The policy schedule uses the same hash of the MAC address and the same
+formulas as handleUpdateSchedule() in src/pico_ota_http.cpp, so each simulated
+device makes exactly the checks a real one would. --capacity makes the
+server answer 503 when more requests than that arrive in one second (with
+Retry-After: --retry-after when given). --rollout prints how many devices
+a staged rollout at that percentage would reach.
+
+Prints requests per --bucket seconds as a bar chart for each schedule and
+the peak rate; --csv writes the same series for plotting elsewhere.
+"""
+
+import argparse
+import heapq
+import random
+
+M32 = 0xFFFFFFFF
+RETRY_S = 60  # kScheduleRetryS
+MAX_INTERVAL_S = 30 * 24 * 3600
+
+
+def fnv1a(text, h=2166136261):
+    for b in text.encode():
+        h = ((h ^ b) * 16777619) & M32
+    return h
+
+
+def mix32(x):
+    x ^= x >> 16
+    x = (x * 0x7FEB352D) & M32
+    x ^= x >> 15
+    x = (x * 0x846CA68B) & M32
+    x ^= x >> 16
+    return x
+
+
+class Device:
+    def __init__(self, mac):
+        self.mac = mac
+        self.hash = fnv1a(mac)
+        self.checks = 0
+        self.failures = 0
+
+    def offset(self, seconds, jitter):
+        spread = seconds * jitter // 100
+        return mix32((self.hash + self.checks * 0x9E3779B9) & M32) % (2 * spread + 1)
+
+    def next_wait(self, args, ok, hint):
+        """scheduleAfter(): seconds until the next check"""
+        base = args.interval
+        if ok:
+            self.failures = 0
+        else:
+            retry = RETRY_S << min(self.failures, 16)
+            base = min(retry, args.interval)
+            self.failures = min(self.failures + 1, 255)
+        spread = base * args.jitter // 100
+        wait = base - spread + self.offset(base, args.jitter)
+        if hint > wait:
+            wait = hint + self.offset(hint, args.jitter) // 2
+        self.checks += 1
+        return min(wait, MAX_INTERVAL_S)
+
+
+def make_fleet(count, seed):
+    rng = random.Random(seed)
+    macs = set()
+    while len(macs) < count:
+        macs.add("28:CD:C1:%02X:%02X:%02X" % (rng.randrange(256), rng.randrange(256), rng.randrange(256)))
+    return [Device(mac) for mac in sorted(macs)]
+
+
+def simulate(args, policy):
+    """Return the request count per bucket"""
+    rng = random.Random(args.seed)
+    devices = make_fleet(args.devices, args.seed)
+    end = args.hours * 3600
+    buckets = [0] * (int(end // args.bucket) + 1)
+    per_second = {}
+    events = []
+    for i, dev in enumerate(devices):
+        connected = rng.uniform(2, 8)  # WiFi association + DHCP
+        first = connected + (dev.hash % args.startup_window if policy and args.startup_window else 0)
+        heapq.heappush(events, (first, i))
+
+    while events:
+        t, i = heapq.heappop(events)
+        if t >= end:
+            break
+        dev = devices[i]
+        buckets[int(t // args.bucket)] += 1
+        second = int(t)
+        per_second[second] = per_second.get(second, 0) + 1
+        overloaded = args.capacity and per_second[second] > args.capacity
+        if not policy:
+            heapq.heappush(events, (t + args.interval, i))
+            continue
+        hint = args.retry_after if overloaded else args.max_age
+        heapq.heappush(events, (t + dev.next_wait(args, not overloaded, hint), i))
+    return buckets, max(per_second.values()) if per_second else 0
+
+
+def chart(title, buckets, peak_second, args, width=50):
+    print(f"{title}: {sum(buckets)} requests, peak {max(buckets)} per {args.bucket} s, "
+          f"peak {peak_second} in one second")
+    top = max(buckets) or 1
+    for n, count in enumerate(buckets):
+        if count == 0 and n > 0 and buckets[n - 1] == 0:
+            continue
+        minutes = n * args.bucket / 60
+        bar = "#" * max(1 if count else 0, round(count * width / top))
+        print(f"  {minutes:7.1f} min {count:6d} {bar}")
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--devices", type=int, default=2000)
+    parser.add_argument("--hours", type=float, default=3)
+    parser.add_argument("--interval", type=int, default=3600, help="seconds between checks")
+    parser.add_argument("--jitter", type=int, default=10, help="percent (OtaUpdatePolicy.jitterPercent)")
+    parser.add_argument("--startup-window", type=int, default=300, help="seconds (OtaUpdatePolicy.startupWindowSeconds)")
+    parser.add_argument("--max-age", type=int, default=0, help="Cache-Control: max-age sent by the server")
+    parser.add_argument("--capacity", type=int, default=0, help="requests per second before the server answers 503")
+    parser.add_argument("--retry-after", type=int, default=0, help="Retry-After sent with a 503")
+    parser.add_argument("--rollout", type=int, default=100, help="rollout percentage of the release")
+    parser.add_argument("--version", default="1.1.0", help="release version (picks the rollout devices)")
+    parser.add_argument("--bucket", type=int, default=60, help="seconds per chart row")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--csv", help="write bucket,fixed,policy rows to this file")
+    args = parser.parse_args()
+
+    fixed, fixed_peak = simulate(args, False)
+    policy, policy_peak = simulate(args, True)
+    chart("fixed timer", fixed, fixed_peak, args)
+    chart("update policy", policy, policy_peak, args)
+
+    if args.rollout < 100:
+        fleet = make_fleet(args.devices, args.seed)
+        reached = sum(1 for dev in fleet if fnv1a(args.version, dev.hash) % 100 < args.rollout)
+        print(f"rollout {args.rollout}% of {args.version}: {reached} of {args.devices} devices")
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write("seconds,fixed,policy\n")
+            for n, (a, b) in enumerate(zip(fixed, policy)):
+                f.write(f"{n * args.bucket},{a},{b}\n")
+        print(f"{args.csv}: {len(fixed)} rows")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,343 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Pre-flight firmware image check of Pico_OTA on the host (see src/ota_image_check.h).
+
+    ota_image_check.py check    firmware.bin --board picow|pico2w|esp32|esp32s3|esp32c3
+                                [--space BYTES] [--flash BYTES] [--revision 1.0] [--window 512]
+    ota_image_check.py corpus   DIR
+    ota_image_check.py selftest
+
+`check` runs the check a device makes on the first --window bytes
+(OTA_IMAGE_CHECK_BYTES) of an image before it erases or stages anything,
+prints what the header says and whether the board would take the image.
+Use it on a build before publishing it. --space is the sketch area
+(Pico: flash before LittleFS) or the OTA partition (ESP32); --flash and
+--revision describe an ESP32 (major.minor).
+
+The corpus holds headers laid out as Arduino-Pico (RP2040 boot2 and
+vector table, RP2350 IMAGE_DEF block) and ESP-IDF (esp_image_header_t)
+emit them, and malformed ones: corrupt boot2, stack or reset vector out of
+range, broken or late picobin blocks, other chips, chip revisions and
+flash sizes, truncated images, UF2 files and HTML error pages. `selftest`
+runs every header against each board and compares with the expected
+result; `corpus` writes them as .bin files with expected.txt, to serve to
+a device (e.g. python3 -m http.server) and watch it reject them.
+
+Pure Python, no dependencies.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+WINDOW = 512  # OTA_IMAGE_CHECK_BYTES
+
+XIP_BASE = 0x10000000
+SRAM_BASE = 0x20000000
+RP2040_SRAM_END = 0x20042000
+RP2350_SRAM_END = 0x20082000
+RP2040_XIP_SIZE = 0x01000000
+RP2350_XIP_SIZE = 0x02000000
+BOOT2_SIZE = 256
+
+BLOCK_START = 0xFFFFDED3
+BLOCK_END = 0xAB123579
+ITEM_IMAGE_TYPE = 0x42
+ITEM_LAST = 0xFF
+IMAGE_TYPE_EXE = 0x0001
+
+ESP_MAGIC = 0xE9
+ESP_HEADER_SIZE = 24
+ESP_MAX_SEGMENTS = 16
+
+OK, ERR_FORMAT, ERR_CHIP, ERR_REVISION, ERR_FLASH, ERR_SIZE = "ok", "format", "chip", "revision", "flash", "size"
+
+ESP_CHIPS = {0x0000: "ESP32", 0x0002: "ESP32-S2", 0x0005: "ESP32-C3", 0x0009: "ESP32-S3", 0x000C: "ESP32-C2",
+             0x000D: "ESP32-C6", 0x0010: "ESP32-H2", 0x0012: "ESP32-P4", 0x0014: "ESP32-C61", 0x0017: "ESP32-C5"}
+
+MB = 1024 * 1024
+
+# OtaImageTarget of each board; space and flash as in the default partition schemes
+BOARDS = {
+    "picow": dict(kind="RP2040", space=1 * MB),                       # 2 MB: sketch 1 MB, FS 1 MB
+    "pico2w": dict(kind="RP2350", space=2 * MB),                      # 4 MB: sketch 2 MB, FS 2 MB
+    "esp32": dict(kind="ESP", chip=0x0000, revision=301, flash=4 * MB, space=0x140000),
+    "esp32s3": dict(kind="ESP", chip=0x0009, revision=2, flash=8 * MB, space=0x300000),
+    "esp32c3": dict(kind="ESP", chip=0x0005, revision=4, flash=4 * MB, space=0x140000),
+}
+
+
+def crc32_mpeg2(data):
+    """CRC-32/MPEG-2, as the RP2040 boot ROM checks boot2"""
+    crc = 0xFFFFFFFF
+    for byte in data:
+        crc ^= byte << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else crc << 1
+            crc &= 0xFFFFFFFF
+    return crc
+
+
+def le32(data, at):
+    return struct.unpack_from("<I", data, at)[0]
+
+
+def le16(data, at):
+    return struct.unpack_from("<H", data, at)[0]
+
+
+def parse_esp(data, info):
+    if len(data) < ESP_HEADER_SIZE or data[0] != ESP_MAGIC:
+        return False
+    segments, spi_mode, flash = data[1], data[2], data[3] >> 4
+    if segments == 0 or segments > ESP_MAX_SEGMENTS or spi_mode > 5 or flash > 7:
+        return False
+    info.update(kind="ESP", flash=1 << (20 + flash), entry=le32(data, 4), chip=le16(data, 12))
+    min_rev = le16(data, 15) or data[14] * 100  # IDF 5: major * 100 + minor, older: major only
+    max_rev = le16(data, 17)
+    info.update(min_rev=min_rev, max_rev=0 if max_rev == 0xFFFF else max_rev)
+    return True
+
+
+def find_image_type(data):
+    """IMAGE_TYPE flags of the first complete picobin block, None if there is none"""
+    for at in range(0, len(data) - 3, 4):
+        if le32(data, at) != BLOCK_START:
+            continue
+        flags = None
+        pos = at + 4
+        while pos + 4 <= len(data):
+            item = data[pos]
+            words = le16(data, pos + 1) if item & 0x80 else data[pos + 1]
+            if item == ITEM_LAST:
+                if words * 4 == pos - at - 4 and pos + 12 <= len(data) and le32(data, pos + 8) == BLOCK_END:
+                    return flags
+                break
+            if words == 0:
+                break
+            if item == ITEM_IMAGE_TYPE:
+                flags = le16(data, pos + 2)
+            pos += words * 4
+    return None
+
+
+def check(data, image_size, target):
+    """(result, info) of otaImageCheck() for the header bytes data"""
+    info = dict(kind=None, chip=0, min_rev=0, max_rev=0, flash=0, sp=0, entry=0)
+    vectors, arm = 0, False
+    if not parse_esp(data, info):
+        flags = find_image_type(data)
+        if flags is not None and (flags >> 12) & 0x7 == 1:
+            if flags & 0xF != IMAGE_TYPE_EXE:
+                return ERR_FORMAT, info
+            info["kind"] = "RP2350"
+            info["cpu"] = "Arm" if (flags >> 8) & 0x7 == 0 else "RISC-V"
+            arm = info["cpu"] == "Arm"
+        elif len(data) >= BOOT2_SIZE and crc32_mpeg2(data[:BOOT2_SIZE - 4]) == le32(data, BOOT2_SIZE - 4):
+            info["kind"] = "RP2040"
+            vectors, arm = BOOT2_SIZE, True
+        else:
+            return ERR_FORMAT, info
+
+    if arm:
+        if len(data) < vectors + 8:
+            return ERR_FORMAT, info
+        info["sp"], info["entry"] = le32(data, vectors), le32(data, vectors + 4)
+        rp2040 = info["kind"] == "RP2040"
+        sram_end = RP2040_SRAM_END if rp2040 else RP2350_SRAM_END
+        xip_size = RP2040_XIP_SIZE if rp2040 else RP2350_XIP_SIZE
+        if (not SRAM_BASE < info["sp"] <= sram_end or info["entry"] & 1 == 0
+                or not XIP_BASE <= info["entry"] < XIP_BASE + xip_size):
+            return ERR_FORMAT, info
+
+    if info["kind"] != target["kind"] or (info["kind"] == "ESP" and info["chip"] != target["chip"]):
+        return ERR_CHIP, info
+    if info["kind"] == "ESP" and (target["revision"] < info["min_rev"]
+                                  or (info["max_rev"] and target["revision"] > info["max_rev"])):
+        return ERR_REVISION, info
+    if target.get("flash") and info["flash"] > target["flash"]:
+        return ERR_FLASH, info
+    if arm and target.get("space") and info["entry"] - XIP_BASE >= target["space"]:
+        return ERR_FLASH, info
+    if image_size and target.get("space") and image_size > target["space"]:
+        return ERR_SIZE, info
+    return OK, info
+
+
+def chip_name(info):
+    if info["kind"] == "ESP":
+        return ESP_CHIPS.get(info["chip"], "ESP (unknown chip)")
+    return info["kind"] or "unknown"
+
+
+# ━━━ Corpus ━━━
+
+def rp2040_image(sp=RP2040_SRAM_END, reset=0x100001F7, crc_ok=True, size=WINDOW):
+    """Arduino-Pico RP2040 build: boot2 (code + CRC), then the vector table"""
+    code = bytes((i * 37 + 11) & 0xFF for i in range(BOOT2_SIZE - 4))
+    crc = crc32_mpeg2(code) ^ (0 if crc_ok else 0x1)
+    image = code + struct.pack("<I", crc) + struct.pack("<II", sp, reset)
+    return image + bytes((i * 13) & 0xFF for i in range(size - len(image)))
+
+
+def picobin_block(flags, items_extra=b"", end=BLOCK_END):
+    """IMAGE_DEF with an IMAGE_TYPE item, as pico-sdk's crt0 embeds it"""
+    items = struct.pack("<BBH", ITEM_IMAGE_TYPE, 1, flags) + items_extra
+    last = struct.pack("<BHB", ITEM_LAST, len(items) // 4, 0)
+    return struct.pack("<I", BLOCK_START) + items + last + struct.pack("<II", 0, end)
+
+
+def rp2350_image(flags=0x1021, block_at=0x124, sp=RP2350_SRAM_END, reset=0x1000015D, block=None, size=WINDOW):
+    """Arduino-Pico RP2350 build: vector table, binary info header, IMAGE_DEF"""
+    if flags & 0x0700:  # RISC-V: code from the first byte
+        head = bytes.fromhex("9700000093808000") * 4
+    else:
+        head = struct.pack("<II", sp, reset) + struct.pack("<66I", *[0x10000161] * 66)  # 16 + 52 IRQs
+        head += struct.pack("<5I", 0x7188EBF2, 0x10000114, 0x10000150, 0x10000160, 0xE71AA390)
+    head = head + bytes(max(0, block_at - len(head)))
+    image = head[:block_at] + (block if block is not None else picobin_block(flags))
+    return image + bytes((i * 7) & 0xFF for i in range(max(0, size - len(image))))
+
+
+def esp_image(chip=0x0000, flash=2, segments=5, spi_mode=2, min_rev=0, min_rev_full=0, max_rev_full=399,
+              magic=ESP_MAGIC, size=WINDOW):
+    """ESP-IDF app image: esp_image_header_t, first segment, esp_app_desc_t"""
+    header = struct.pack("<BBBBIB3BHBHH4BB", magic, segments, spi_mode, (flash << 4) | 0xF, 0x40081234,
+                         0xEE, 0, 0, 0, chip, min_rev, min_rev_full, max_rev_full, 0, 0, 0, 0, 1)
+    segment = struct.pack("<II", 0x3F400020, 0x1234)
+    app_desc = struct.pack("<I", 0xABCD5432) + bytes(28) + b"1.2.0".ljust(32, b"\0") + b"size_report".ljust(32, b"\0")
+    image = header + segment + app_desc
+    return image + bytes((i * 5) & 0xFF for i in range(size - len(image)))
+
+
+def corpus():
+    """(name, header bytes, image size, {board: expected}); boards left out expect "chip" """
+    rp2040 = rp2040_image()
+    return [
+        # Real layouts
+        ("rp2040_arduino_pico", rp2040, 412160, {"picow": OK}),
+        ("rp2350_arm", rp2350_image(), 398336, {"pico2w": OK}),
+        ("rp2350_riscv", rp2350_image(flags=0x1101, block_at=0x40), 401408, {"pico2w": OK}),
+        ("esp32_idf5", esp_image(), 1048576, {"esp32": OK}),
+        ("esp32_idf4_legacy", esp_image(max_rev_full=0), 1048576, {"esp32": OK}),
+        ("esp32s3_idf5", esp_image(chip=0x0009, flash=3, max_rev_full=99), 1048576, {"esp32s3": OK}),
+        ("esp32c3_idf5", esp_image(chip=0x0005, min_rev_full=3, max_rev_full=199), 1048576, {"esp32c3": OK}),
+        ("rp2040_short_image", rp2040[:300], 300, {"picow": OK}),
+        ("size_unknown", rp2040, 0, {"picow": OK}),
+        # Malformed or not for these boards
+        ("rp2040_boot2_crc", rp2040_image(crc_ok=False), 412160, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2040_stack_out_of_sram", rp2040_image(sp=RP2350_SRAM_END), 412160, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2040_reset_not_thumb", rp2040_image(reset=0x100001F6), 412160, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2040_reset_past_sketch", rp2040_image(reset=0x10180001), 412160, {"picow": ERR_FLASH}),
+        ("rp2040_too_large", rp2040, 1536 * 1024, {"picow": ERR_SIZE}),
+        ("rp2040_truncated", rp2040[:100], 100, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2350_data_image", rp2350_image(flags=0x1002), 65536, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2350_no_end_marker", rp2350_image(block=picobin_block(0x1021, end=0)), 398336,
+         {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2350_block_late", rp2350_image(block_at=600, size=700), 398336, {b: ERR_FORMAT for b in BOARDS}),
+        ("rp2350_reset_in_sram", rp2350_image(reset=0x20000101), 398336, {b: ERR_FORMAT for b in BOARDS}),
+        ("esp32_no_segments", esp_image(segments=0), 1048576, {b: ERR_FORMAT for b in BOARDS}),
+        ("esp32_bad_magic", esp_image(magic=0xE8), 1048576, {b: ERR_FORMAT for b in BOARDS}),
+        ("esp32_16mb_flash", esp_image(flash=4), 1048576, {"esp32": ERR_FLASH}),
+        ("esp32_needs_rev3", esp_image(min_rev_full=300, max_rev_full=399), 1048576, {"esp32": OK}),
+        ("esp32_needs_rev4", esp_image(min_rev_full=400, max_rev_full=499), 1048576, {"esp32": ERR_REVISION}),
+        ("esp32_up_to_rev1", esp_image(max_rev_full=199), 1048576, {"esp32": ERR_REVISION}),
+        ("esp32_legacy_rev3", esp_image(min_rev=3, max_rev_full=0), 1048576, {"esp32": OK}),
+        ("esp32_too_large", esp_image(), 0x180000, {"esp32": ERR_SIZE}),
+        ("uf2_file", struct.pack("<II", 0x0A324655, 0x9E5D5157) + bytes(WINDOW - 8), 824832,
+         {b: ERR_FORMAT for b in BOARDS}),
+        ("html_error_page", b"<!DOCTYPE html><html><head><title>404 Not Found</title></head>".ljust(WINDOW, b" "),
+         WINDOW, {b: ERR_FORMAT for b in BOARDS}),
+        ("empty_erased_flash", b"\xff" * WINDOW, 1048576, {b: ERR_FORMAT for b in BOARDS}),
+    ]
+
+
+def expected_for(expect, board):
+    return expect.get(board, ERR_CHIP)
+
+
+# ━━━ Commands ━━━
+
+def parse_revision(text):
+    major, _, minor = text.partition(".")
+    return int(major) * 100 + int(minor or 0)
+
+
+def cmd_check(args):
+    target = dict(BOARDS[args.board])
+    if args.space is not None:
+        target["space"] = args.space
+    if args.flash is not None:
+        target["flash"] = args.flash
+    if args.revision is not None:
+        target["revision"] = parse_revision(args.revision)
+    with open(args.image, "rb") as f:
+        data = f.read()
+    result, info = check(data[:args.window], len(data), target)
+    print(f"{args.image}: {len(data)} bytes, {chip_name(info)} image")
+    if info["kind"] == "ESP":
+        rev = f"v{info['min_rev'] // 100}.{info['min_rev'] % 100}"
+        if info["max_rev"]:
+            rev += f" to v{info['max_rev'] // 100}.{info['max_rev'] % 100}"
+        print(f"  chip revision {rev}, flash {info['flash'] // MB} MB, entry 0x{info['entry']:08x}")
+    elif info["kind"]:
+        print(f"  {info.get('cpu', 'Arm')}, stack 0x{info['sp']:08x}, reset 0x{info['entry']:08x}")
+    if result == OK:
+        print(f"{args.board}: accepted")
+        return 0
+    print(f"{args.board}: rejected ({result})")
+    return 1
+
+
+def cmd_corpus(args):
+    os.makedirs(args.dir, exist_ok=True)
+    with open(os.path.join(args.dir, "expected.txt"), "w") as out:
+        out.write("# name image_size " + " ".join(BOARDS) + "\n")
+        for name, data, size, expect in corpus():
+            with open(os.path.join(args.dir, name + ".bin"), "wb") as f:
+                f.write(data)
+            out.write(f"{name} {size} " + " ".join(expected_for(expect, b) for b in BOARDS) + "\n")
+    print(f"wrote {len(corpus())} headers to {args.dir}")
+    return 0
+
+
+def cmd_selftest(args):
+    failures = 0
+    cases = corpus()
+    for name, data, size, expect in cases:
+        for board, target in BOARDS.items():
+            want = expected_for(expect, board)
+            got, _ = check(data[:WINDOW], size, target)
+            if got != want:
+                print(f"FAIL {name} on {board}: {got}, expected {want}")
+                failures += 1
+    if failures:
+        return 1
+    print(f"selftest OK ({len(cases)} headers x {len(BOARDS)} boards)")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("check", help="check a .bin as a board would")
+    p.add_argument("image")
+    p.add_argument("--board", required=True, choices=sorted(BOARDS))
+    p.add_argument("--space", type=lambda s: int(s, 0), help="sketch area / OTA partition in bytes")
+    p.add_argument("--flash", type=lambda s: int(s, 0), help="ESP32: flash size in bytes")
+    p.add_argument("--revision", help="ESP32: chip revision, e.g. 3.1")
+    p.add_argument("--window", type=int, default=WINDOW, help="OTA_IMAGE_CHECK_BYTES")
+    p.set_defaults(func=cmd_check)
+    p = sub.add_parser("corpus", help="write the header corpus as .bin files")
+    p.add_argument("dir")
+    p.set_defaults(func=cmd_corpus)
+    p = sub.add_parser("selftest", help="run the corpus against every board")
+    p.set_defaults(func=cmd_selftest)
+    args = parser.parse_args()
+    sys.exit(args.func(args))
+
+
+if __name__ == "__main__":
+    main()
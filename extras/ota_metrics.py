@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Read a device's OTA telemetry (/metrics, see otaGetStats()) and print it.
+
+    ota_metrics.py http://<device-ip>/metrics [--binary] [--user U --password P]
+    ota_metrics.py dump.bin | dump.json
+    ota_metrics.py http://<device-ip>/metrics --save dump.bin --binary
+
+Prints one row per phase: how often it ran, mean and maximum time, and
+percentiles estimated from the histogram buckets (the upper bound of the
+bucket the percentile falls in), then the counters. --binary fetches the
+packed form (?format=binary, about 800 bytes) instead of JSON; a saved
+dump is recognised by its first bytes. --json prints the decoded numbers as
+JSON, e.g. to collect them from many devices.
+"""
+
+import argparse
+import base64
+import json
+import struct
+import sys
+import urllib.request
+
+PHASES = ["dns", "connect", "firstByte", "download", "flashWrite", "verify", "install", "boot", "reconnect"]
+COUNTERS = ["updatesStarted", "updatesInstalled", "updatesFailed", "bytesDownloaded",
+            "bytesUploaded", "bytesServed", "wifiDisconnects", "reconnectAttempts"]
+
+
+def decode_binary(data):
+    """Packed /metrics body -> the same dict the JSON form gives"""
+    if len(data) < 8 or data[:4] != b"OTAM" or data[4] != 1:
+        raise ValueError("not an OTAM v1 metrics dump")
+    phases, buckets, counters = data[5], data[6], data[7]
+    words = struct.unpack_from(f"<{phases * (3 + buckets) + counters}I", data, 8)
+    result = {"phases": {}}
+    for p in range(phases):
+        row = words[p * (3 + buckets):(p + 1) * (3 + buckets)]
+        name = PHASES[p] if p < len(PHASES) else f"phase{p}"
+        result["phases"][name] = {"count": row[0], "totalMs": row[1], "maxMs": row[2], "buckets": list(row[3:])}
+    for c, value in enumerate(words[phases * (3 + buckets):]):
+        result[COUNTERS[c] if c < len(COUNTERS) else f"counter{c}"] = value
+    return result
+
+
+def decode(data):
+    return decode_binary(data) if data[:4] == b"OTAM" else json.loads(data)
+
+
+def bucket_bound(index, last):
+    """Upper bound in ms of histogram bucket index (None for the open last one)"""
+    return None if index == last else (1 << index) - 1
+
+
+def percentile(buckets, fraction):
+    total = sum(buckets)
+    if total == 0:
+        return "-"
+    seen = 0
+    for i, count in enumerate(buckets):
+        seen += count
+        if seen >= fraction * total:
+            bound = bucket_bound(i, len(buckets) - 1)
+            return f">={1 << (i - 1)}" if bound is None else str(bound)
+    return "-"
+
+
+def fetch(url, binary, user, password):
+    if binary:
+        url += ("&" if "?" in url else "?") + "format=binary"
+    request = urllib.request.Request(url, headers={"User-Agent": "Pico-OTA"})
+    if user:
+        token = base64.b64encode(f"{user}:{password or ''}".encode()).decode()
+        request.add_header("Authorization", f"Basic {token}")
+    with urllib.request.urlopen(request, timeout=10) as response:
+        return response.read()
+
+
+def report(stats):
+    print(f"{'phase':<11} {'count':>7} {'mean ms':>9} {'p50':>7} {'p90':>7} {'p99':>7} {'max ms':>9}")
+    for name, phase in stats["phases"].items():
+        count = phase["count"]
+        mean = f"{phase['totalMs'] / count:.1f}" if count else "-"
+        b = phase["buckets"]
+        print(f"{name:<11} {count:>7} {mean:>9} {percentile(b, 0.5):>7} {percentile(b, 0.9):>7} "
+              f"{percentile(b, 0.99):>7} {phase['maxMs']:>9}")
+    print()
+    for name, value in stats.items():
+        if name not in ("phases", "uptimeMs"):
+            print(f"{name:<18} {value}")
+    if "uptimeMs" in stats:
+        print(f"{'uptimeMs':<18} {stats['uptimeMs']}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="http://<device>/metrics, or a saved dump")
+    parser.add_argument("--binary", action="store_true", help="fetch the packed form")
+    parser.add_argument("--user", help="web user name (otaSetWebCredentials)")
+    parser.add_argument("--password")
+    parser.add_argument("--save", help="also write the raw body to this file")
+    parser.add_argument("--json", action="store_true", help="print the decoded numbers as JSON")
+    args = parser.parse_args()
+
+    if args.source.startswith(("http://", "https://")):
+        data = fetch(args.source, args.binary, args.user, args.password)
+    else:
+        data = open(args.source, "rb").read()
+    if args.save:
+        open(args.save, "wb").write(data)
+    try:
+        stats = decode(data)
+    except ValueError as error:
+        sys.exit(f"{args.source}: {error}")
+
+    if args.json:
+        print(json.dumps(stats, indent=2))
+    else:
+        report(stats)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Host-side model of LAN peer sharing (otaSetPeerSharing), over loopback.
+
+    ota_peer_sim.py serve firmware.bin --token TOKEN [--port 8081]
+    ota_peer_sim.py fetch --origin URL --sha256 HEX --size N [--peer URL ...] [--token TOKEN] [-o out.bin]
+    ota_peer_sim.py site [--devices 8] [--size 262144] [--stagger 0.2]
+
+serve   answers GET /ota/image?sha256=<hex>&size=<bytes> like a device does:
+        the image with Range support if it has that digest and size, else
+        404, and 401 without the X-OTA-Peer-Token header of --token (the
+        device's otaSetPeerToken()). Point a device at it by hand to test
+        the receiving side.
+fetch   receives an image like a device does: each --peer in turn (range
+        requests with --token, image checked against --sha256 / --size),
+        then --origin. Use it against a real device to test its serving
+        side, e.g. --peer http://<device-ip>/ota/image.
+site    starts an origin server and --devices device processes on
+        127.0.0.1. Each device fetches the image (peers first), then serves
+        it itself; a shared directory of ports stands in for mDNS. Devices
+        start --stagger seconds apart, as otaSetUpdatePolicy() spreads
+        them. Prints where every device got the image and the bytes the
+        origin (the site's uplink) served.
+
+Peers are tried from a per-device starting point (FNV-1a of the name modulo
+the peer count), as fetchFromPeers() in src/pico_ota_http.cpp does.
+"""
+
+import argparse
+import hashlib
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.error
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+CHUNK = 32768   # otaSetDownloadChunkSize() default
+MAX_PEERS = 3   # kPeerMaxTries
+
+
+def fnv1a(text, h=2166136261):
+    for b in text.encode():
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def make_handler(image, counter=None, token=None):
+    """Request handler serving image as a peer (/ota/image, for token) and as an origin (/firmware.bin)"""
+    digest = hashlib.sha256(image).hexdigest()
+
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.0"
+
+        def log_message(self, *args):
+            pass
+
+        def do_GET(self):
+            url = urlparse(self.path)
+            if url.path == "/ota/image":
+                if self.headers["X-OTA-Peer-Token"] != token:
+                    self.send_error(401, "Peer token required")
+                    return
+                query = parse_qs(url.query)
+                if (query.get("sha256", [""])[0].lower() != digest
+                        or query.get("size", [""])[0] != str(len(image))):
+                    self.send_error(404, "Image not available")
+                    return
+            elif url.path != "/firmware.bin" or counter is None:
+                self.send_error(404)
+                return
+
+            first, last = 0, len(image) - 1
+            value = self.headers["Range"] or ""
+            partial = value.startswith("bytes=") and "-" in value
+            if partial:
+                start, _, end = value[6:].partition("-")
+                first = int(start or 0)
+                last = min(int(end), last) if end else last
+                if first > last:
+                    self.send_response(416)
+                    self.send_header("Content-Range", f"bytes */{len(image)}")
+                    self.end_headers()
+                    return
+            body = image[first:last + 1]
+            self.send_response(206 if partial else 200)
+            if partial:
+                self.send_header("Content-Range", f"bytes {first}-{last}/{len(image)}")
+            self.send_header("Accept-Ranges", "bytes")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+            if counter is not None:
+                with counter["lock"]:
+                    counter["bytes"] += len(body)
+    return Handler
+
+
+def start_server(handler, port=0):
+    server = ThreadingHTTPServer(("127.0.0.1", port), handler)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+def transfer(url, size, token=None):
+    """Fetch size bytes of url range by range; None on any HTTP error"""
+    data = bytearray()
+    while len(data) < size:
+        last = min(len(data) + CHUNK, size) - 1
+        headers = {"Range": f"bytes={len(data)}-{last}", "User-Agent": "Pico-OTA"}
+        if token:
+            headers["X-OTA-Peer-Token"] = token
+        request = urllib.request.Request(url, headers=headers)
+        try:
+            with urllib.request.urlopen(request, timeout=10) as response:
+                chunk = response.read()
+        except (urllib.error.URLError, OSError):
+            return None
+        if not chunk:
+            return None
+        data += chunk
+    return bytes(data)
+
+
+def receive(origin, peers, sha256, size, name, token):
+    """Peers first, then the origin. Returns (image, source)"""
+    if peers:
+        first = fnv1a(name) % len(peers)
+        for peer in (peers[(first + i) % len(peers)] for i in range(min(len(peers), MAX_PEERS))):
+            url = f"{peer}?sha256={sha256}&size={size}"
+            image = transfer(url, size, token)
+            if image is not None and hashlib.sha256(image).hexdigest() == sha256:
+                return image, peer
+    image = transfer(origin, size)
+    if image is None or len(image) != size or hashlib.sha256(image).hexdigest() != sha256:
+        return None, origin
+    return image, origin
+
+
+def cmd_serve(args):
+    image = open(args.image, "rb").read()
+    print(f"Serving {args.image} ({len(image)} bytes, sha256 {hashlib.sha256(image).hexdigest()}) "
+          f"on http://127.0.0.1:{args.port}/ota/image", flush=True)
+    ThreadingHTTPServer(("", args.port), make_handler(image, token=args.token)).serve_forever()
+
+
+def cmd_fetch(args):
+    image, source = receive(args.origin, args.peer, args.sha256.lower(), args.size, args.name, args.token)
+    if image is None:
+        print("fetch failed (no peer had the image, origin did not match)")
+        return 1
+    print(f"{len(image)} bytes from {source}, SHA-256 verified")
+    if args.output:
+        open(args.output, "wb").write(image)
+    return 0
+
+
+def cmd_device(args):
+    """One simulated device of a site: fetch, then serve until killed"""
+    peers = []
+    for entry in sorted(os.listdir(args.registry)):
+        peers.append(f"http://127.0.0.1:{int(entry)}/ota/image")
+    image, source = receive(args.origin, peers, args.sha256, args.size, args.name, args.token)
+    if image is None:
+        print(f"{args.name} FAILED", flush=True)
+        return 1
+    server = start_server(make_handler(image, token=args.token))
+    port = server.server_address[1]
+    open(os.path.join(args.registry, str(port)), "w").close()  # "mDNS announcement"
+    print(f"{args.name} {'origin' if source == args.origin else 'peer  '} {source}", flush=True)
+    sys.stdin.read()  # Serve until the site closes our stdin
+    return 0
+
+
+def cmd_site(args):
+    image = os.urandom(args.size)
+    sha256 = hashlib.sha256(image).hexdigest()
+    token = os.urandom(8).hex()  # The site's otaSetPeerToken()
+    counter = {"bytes": 0, "lock": threading.Lock()}
+    origin = start_server(make_handler(image, counter))
+    origin_url = f"http://127.0.0.1:{origin.server_address[1]}/firmware.bin"
+
+    devices = []
+    with tempfile.TemporaryDirectory() as registry:
+        for n in range(args.devices):
+            name = "28:CD:C1:00:00:%02X" % n
+            devices.append(subprocess.Popen(
+                [sys.executable, os.path.abspath(__file__), "device", "--registry", registry,
+                 "--origin", origin_url, "--sha256", sha256, "--size", str(args.size), "--name", name,
+                 "--token", token],
+                stdin=subprocess.PIPE))
+            time.sleep(args.stagger)
+        deadline = time.time() + 60
+        while len(os.listdir(registry)) < args.devices and time.time() < deadline:
+            if any(d.poll() is not None for d in devices):
+                break
+            time.sleep(0.05)
+        served = len(os.listdir(registry))
+        for device in devices:
+            device.stdin.close()
+        for device in devices:
+            device.wait()
+    origin.shutdown()
+
+    print()
+    print(f"{served} of {args.devices} devices updated")
+    print(f"origin served {counter['bytes']} bytes "
+          f"({counter['bytes'] / args.size:.1f} images, {args.devices} without peers)")
+    return 0 if served == args.devices else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("serve", help="serve an image as a device does")
+    p.add_argument("image")
+    p.add_argument("--port", type=int, default=8081)
+    p.add_argument("--token", required=True, help="peer token peers must send (otaSetPeerToken())")
+
+    for name in ("fetch", "device"):
+        p = sub.add_parser(name, help="receive an image as a device does" if name == "fetch" else argparse.SUPPRESS)
+        p.add_argument("--origin", required=True, help="image URL on the server")
+        p.add_argument("--sha256", required=True, help="expected digest (from the signed manifest)")
+        p.add_argument("--size", type=int, required=True, help="expected size (from the signed manifest)")
+        p.add_argument("--name", default="28:CD:C1:00:00:00", help="MAC address, picks the first peer")
+        p.add_argument("--token", help="X-OTA-Peer-Token sent to peers (otaSetPeerToken())")
+        if name == "fetch":
+            p.add_argument("--peer", action="append", default=[], help="peer /ota/image URL (repeatable)")
+            p.add_argument("-o", "--output", help="write the image here")
+        else:
+            p.add_argument("--registry", required=True)
+
+    p = sub.add_parser("site", help="run a site of device processes on loopback")
+    p.add_argument("--devices", type=int, default=8)
+    p.add_argument("--size", type=int, default=256 * 1024, help="image size in bytes")
+    p.add_argument("--stagger", type=float, default=0.2, help="seconds between device starts")
+
+    args = parser.parse_args()
+    handlers = {"serve": cmd_serve, "fetch": cmd_fetch, "device": cmd_device, "site": cmd_site}
+    sys.exit(handlers[args.command](args))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Simulate an HTTP download into flash, serial vs. buffered writes.
+
+    ota_pipeline_sim.py [--size 1048576] [--rate 600] [--rtt 20] [--window 11680]
+                        [--erase 45] [--program 12] [--cpu 1500] [--buffers 2]
+
+Models the device side of a download (see imageBufferWrite() in
+src/pico_ota_image.cpp): a TCP sender limited by the receive window, a socket
+buffer the sketch reads from, and flash programming that stalls the CPU
+for erase + program time per OTA_IMAGE_WRITE_BLOCK.
+
+  serial     programs each block as soon as it is complete
+             (the download path before write buffering)
+  buffered   keeps up to --buffers complete blocks and programs one when
+             the socket has nothing to read, or when all buffers are full
+
+Programming with the socket drained leaves the whole receive window open,
+so the sender keeps transmitting through the stall instead of hitting a
+zero window. Prints the end-to-end MB/s of both and the speedup; use it to
+pick OTA_IMAGE_WRITE_BUFFERS for a given network and flash chip.
+"""
+
+import argparse
+
+STEP = 0.0001  # Simulation step in seconds
+IDLE_SLEEP = 0.001  # delay(1) in the read loop when no data is available
+
+
+def simulate(args, buffers):
+    """Return seconds to receive and program args.size bytes.
+
+    buffers=0 is the serial path."""
+    size = args.size
+    rate = args.rate * 1000.0
+    cpu = args.cpu * 1000.0
+    block = args.block
+    stall = (args.erase + args.program) / 1000.0
+    rtt_steps = max(1, int(args.rtt / 1000.0 / STEP))
+
+    t = 0.0
+    arrived = 0.0         # Bytes that reached the socket buffer
+    consumed = 0.0        # Bytes the sketch has read
+    consumed_seen = [0.0] * rtt_steps  # Window updates still travelling to the sender
+    fill = 0              # Bytes in the block being filled
+    ready = 0             # Complete blocks waiting to be programmed
+    programmed = 0
+    busy_until = 0.0      # CPU stalled (flash) or sleeping until then
+    step = 0
+
+    while programmed < size:
+        # Sender: limited by the link rate and the window it last heard about
+        limit = consumed_seen[step % rtt_steps] + args.window
+        arrived = min(arrived + rate * STEP, limit, float(size))
+        consumed_seen[step % rtt_steps] = consumed
+        step += 1
+        t += STEP
+        if t < busy_until:
+            continue
+
+        buffered = arrived - consumed
+        if buffers and ready and (buffered < 1 or ready >= buffers):
+            ready -= 1
+            programmed += block
+            busy_until = t + stall
+            continue
+        if buffered < 1:
+            if consumed >= size:
+                # Last partial block (and anything still queued)
+                programmed = size
+                busy_until = t + stall * (ready + (1 if fill else 0))
+                t = busy_until
+                break
+            busy_until = t + IDLE_SLEEP
+            continue
+
+        take = min(buffered, cpu * STEP, block - fill)
+        consumed += take
+        fill += take
+        if fill >= block:
+            fill = 0
+            if buffers:
+                ready += 1
+            else:
+                programmed += block
+                busy_until = t + stall
+    return t
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--size", type=int, default=1024 * 1024, help="image size in bytes")
+    parser.add_argument("--rate", type=float, default=600, help="network rate in kB/s")
+    parser.add_argument("--rtt", type=float, default=20, help="round trip time in ms")
+    parser.add_argument("--window", type=int, default=11680, help="TCP receive window in bytes (lwIP TCP_WND)")
+    parser.add_argument("--block", type=int, default=4096, help="OTA_IMAGE_WRITE_BLOCK in bytes")
+    parser.add_argument("--erase", type=float, default=45, help="sector erase time in ms")
+    parser.add_argument("--program", type=float, default=12, help="time to program one block in ms")
+    parser.add_argument("--cpu", type=float, default=1500, help="read + hash rate of the sketch in kB/s")
+    parser.add_argument("--buffers", type=int, default=2, help="OTA_IMAGE_WRITE_BUFFERS")
+    args = parser.parse_args()
+    if args.buffers < 1:
+        parser.error("--buffers must be at least 1")
+
+    serial = simulate(args, 0)
+    buffered = simulate(args, args.buffers)
+    mb = args.size / 1e6
+    print(f"serial:    {serial:7.2f} s  {mb / serial:6.3f} MB/s")
+    print(f"buffered:  {buffered:7.2f} s  {mb / buffered:6.3f} MB/s  ({args.buffers} x {args.block} bytes)")
+    print(f"speedup:   {serial / buffered:.2f}x")
+
+
+if __name__ == "__main__":
+    main()
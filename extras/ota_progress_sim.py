@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Download rate with a progress callback on every read and with the dispatcher.
+
+    ota_progress_sim.py [--size 1048576] [--rate 600] [--rtt 20] [--window 11680]
+                        [--chunk 32768] [--cpu 1500] [--chars 50] [--baud 115200]
+                        [--callback MS] [--min-bytes 4096] [--min-ms 100]
+
+Models the receive loop of receiveBody() in src/pico_ota_http.cpp:
+
+  - a range request of --chunk bytes blocks for one round trip, then the
+    body arrives at --rate, limited to --window unread bytes in the socket
+  - the loop reads 1 KB at a time at --cpu kB/s; with the socket empty it
+    sleeps 1 ms (delay(1))
+  - the progress callback prints --chars characters to a --baud serial
+    port and blocks until they are sent (or takes --callback ms)
+
+and runs it three ways:
+
+  per read    the callback after every read, as otaOnProgress() was called
+              before the dispatcher
+  inline      the dispatcher's deltas (--min-bytes and --min-ms), delivered
+              from the read that meets them
+  dispatcher  the same deltas, delivered where the loop would wait anyway
+              (socket empty, between chunks), or from the read once a
+              report has waited twice --min-ms (transferProgress())
+
+While the callback runs the socket keeps filling, so a callback that fits
+in the gaps costs nothing until the TCP window is full. Prints the download
+rate, the number of callbacks and the longest time between two of them.
+"""
+
+import argparse
+
+READ = 1024  # g_dlBuffer
+
+
+class Device:
+    """Socket buffer filled by the network as the CPU spends time"""
+
+    def __init__(self, args):
+        self.args = args
+        self.t = 0.0
+        self.rate = args.rate * 1000.0
+        self.arrived = 0.0
+        self.body = 0
+        self.body_read = 0
+        self.sending_from = None
+
+    def spend(self, seconds):
+        """CPU busy (or sleeping) for seconds while the network goes on"""
+        if self.sending_from is not None and self.body > 0:
+            start = max(self.t, self.sending_from)
+            end = self.t + seconds
+            if end > start:
+                room = self.args.window - (self.arrived - self.body_read)
+                self.arrived += min(self.rate * (end - start), room, self.body - self.arrived)
+        self.t += seconds
+
+    def available(self):
+        return int(self.arrived) - self.body_read
+
+
+class Dispatcher:
+    """Callback delivery of one mode, counting calls and the longest gap"""
+
+    def __init__(self, args, mode, device):
+        self.args = args
+        self.mode = mode
+        self.device = device
+        self.cost = args.callback / 1000.0 if args.callback is not None else args.chars * 10.0 / args.baud
+        self.min_ms = args.min_ms / 1000.0
+        self.calls = 0
+        self.gap = 0.0
+        self.last_t = 0.0
+        self.last_bytes = 0
+        self.due = False
+
+    def deliver(self, offset):
+        self.gap = max(self.gap, self.device.t - self.last_t)
+        self.due = False
+        self.last_t = self.device.t
+        self.last_bytes = offset
+        self.calls += 1
+        self.device.spend(self.cost)
+
+    def progress(self, offset, total):
+        """transferProgress() after a read"""
+        if self.mode == "none":
+            return
+        if self.mode == "per read":
+            self.deliver(offset)
+            return
+        since = self.device.t - self.last_t
+        if offset == total or (offset - self.last_bytes >= self.args.min_bytes and since >= self.min_ms):
+            self.due = True
+        if self.due and (self.mode == "inline" or since >= 2 * self.min_ms):
+            self.deliver(offset)
+
+    def idle(self, offset):
+        """progressDispatch() where the loop has nothing to read"""
+        if self.mode == "dispatcher" and self.due:
+            self.deliver(offset)
+
+
+def run(args, mode):
+    """Download time (s), callbacks and longest gap between them (s)"""
+    device = Device(args)
+    dispatcher = Dispatcher(args, mode, device)
+    offset = 0
+    while offset < args.size:
+        device.body = min(args.chunk, args.size - offset)
+        device.body_read = 0
+        device.arrived = 0.0
+        device.sending_from = device.t + args.rtt / 2000.0
+        device.spend(args.rtt / 1000.0)  # HTTPClient::GET() waits for the headers
+        while device.body_read < device.body:
+            available = device.available()
+            if available <= 0:
+                dispatcher.idle(offset)
+                if device.available() <= 0:
+                    device.spend(0.001)  # delay(1)
+                continue
+            n = min(available, READ)
+            device.spend(n / (args.cpu * 1000.0))
+            device.body_read += n
+            offset += n
+            dispatcher.progress(offset, args.size)
+        dispatcher.idle(offset)  # transferChunkDone()
+    dispatcher.idle(offset)  # transferEnd()
+    return device.t, dispatcher.calls, dispatcher.gap
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--size", type=int, default=1024 * 1024, help="image size in bytes")
+    parser.add_argument("--rate", type=float, default=600, help="network rate in kB/s")
+    parser.add_argument("--rtt", type=float, default=20, help="round trip time in ms")
+    parser.add_argument("--window", type=int, default=11680, help="TCP receive window in bytes (lwIP TCP_WND)")
+    parser.add_argument("--chunk", type=int, default=32768, help="otaSetDownloadChunkSize() in bytes")
+    parser.add_argument("--cpu", type=float, default=1500, help="read + hash + buffer rate in kB/s")
+    parser.add_argument("--chars", type=int, default=50, help="characters the callback prints")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate")
+    parser.add_argument("--callback", type=float, help="callback cost in ms (instead of --chars / --baud)")
+    parser.add_argument("--min-bytes", type=int, default=4096, help="otaSetProgressThrottle() minBytes")
+    parser.add_argument("--min-ms", type=float, default=100, help="otaSetProgressThrottle() minIntervalMs")
+    args = parser.parse_args()
+
+    base, _, _ = run(args, "none")
+    cost = args.callback if args.callback is not None else args.chars * 10000.0 / args.baud
+    print(f"{args.size} bytes at {args.rate:.0f} kB/s, {args.rtt:.0f} ms RTT, callback {cost:.2f} ms")
+    print(f"{'mode':>12} {'MB/s':>8} {'vs none':>8} {'callbacks':>10} {'max gap':>10}")
+    print(f"{'none':>12} {args.size / base / 1e6:>8.3f} {'100%':>8} {0:>10} {'-':>10}")
+    for mode in ("per read", "inline", "dispatcher"):
+        total, calls, gap = run(args, mode)
+        print(f"{mode:>12} {args.size / total / 1e6:>8.3f} {base / total:>8.0%} {calls:>10} {gap * 1000:>7.0f} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Sign firmware images for Pico_OTA (Ed25519 manifests, see src/ota_manifest.h).
+
+    ota_sign.py keygen   signing.key
+    ota_sign.py pubkey   signing.key
+    ota_sign.py sign     signing.key firmware.bin --version 1.2.0 [--rollout 25] [-o firmware.bin.manifest]
+    ota_sign.py verify   firmware.bin.manifest firmware.bin --pubkey <64 hex digits>
+    ota_sign.py selftest
+
+`keygen` writes a new private key (keep it out of the repository) and
+prints the public key as a C array for otaSetSigningKey(). `sign` writes
+the manifest to publish next to the image: the version, size and SHA-256
+of the image the device will run, signed with the key. For compressed or
+delta downloads, sign the .bin they expand to. --rollout limits the release
+to that percentage of devices (chosen by a hash of each device's MAC
+address); sign again with a higher value to widen it. `selftest` checks this
+implementation against the RFC 8032 test vectors.
+
+Pure Python, no dependencies; signing takes well under a second.
+"""
+
+import argparse
+import hashlib
+import os
+import sys
+
+MANIFEST_MAGIC = "pico-ota-manifest v1"
+
+# Ed25519 (RFC 8032, section 5.1)
+P = 2**255 - 19
+L = 2**252 + 27742317777372353535851937790883648493
+D = -121665 * pow(121666, P - 2, P) % P
+SQRT_M1 = pow(2, (P - 1) // 4, P)
+
+
+def _recover_x(y, sign):
+    if y >= P:
+        return None
+    x2 = (y * y - 1) * pow(D * y * y + 1, P - 2, P)
+    if x2 == 0:
+        return None if sign else 0
+    x = pow(x2, (P + 3) // 8, P)
+    if (x * x - x2) % P != 0:
+        x = x * SQRT_M1 % P
+    if (x * x - x2) % P != 0:
+        return None
+    if (x & 1) != sign:
+        x = P - x
+    return x
+
+
+_BY = 4 * pow(5, P - 2, P) % P
+BASE = (_recover_x(_BY, 0), _BY, 1, _recover_x(_BY, 0) * _BY % P)
+
+
+def _add(p, q):
+    a = (p[1] - p[0]) * (q[1] - q[0]) % P
+    b = (p[1] + p[0]) * (q[1] + q[0]) % P
+    c = 2 * p[3] * q[3] * D % P
+    d = 2 * p[2] * q[2] % P
+    e, f, g, h = b - a, d - c, d + c, b + a
+    return (e * f % P, g * h % P, f * g % P, e * h % P)
+
+
+def _mul(s, p):
+    q = (0, 1, 1, 0)
+    while s:
+        if s & 1:
+            q = _add(q, p)
+        p = _add(p, p)
+        s >>= 1
+    return q
+
+
+def _encode(p):
+    zinv = pow(p[2], P - 2, P)
+    x, y = p[0] * zinv % P, p[1] * zinv % P
+    return (y | ((x & 1) << 255)).to_bytes(32, "little")
+
+
+def _decode(s):
+    y = int.from_bytes(s, "little")
+    sign = y >> 255
+    y &= (1 << 255) - 1
+    x = _recover_x(y, sign)
+    if x is None:
+        return None
+    return (x, y, 1, x * y % P)
+
+
+def _sha512_int(*parts):
+    return int.from_bytes(hashlib.sha512(b"".join(parts)).digest(), "little")
+
+
+def _expand(secret):
+    h = hashlib.sha512(secret).digest()
+    a = int.from_bytes(h[:32], "little")
+    a &= (1 << 254) - 8
+    a |= 1 << 254
+    return a, h[32:]
+
+
+def public_key(secret):
+    return _encode(_mul(_expand(secret)[0], BASE))
+
+
+def sign(secret, msg):
+    a, prefix = _expand(secret)
+    pub = _encode(_mul(a, BASE))
+    r = _sha512_int(prefix, msg) % L
+    big_r = _encode(_mul(r, BASE))
+    h = _sha512_int(big_r, pub, msg) % L
+    s = (r + h * a) % L
+    return big_r + s.to_bytes(32, "little")
+
+
+def verify(pub, msg, sig):
+    if len(pub) != 32 or len(sig) != 64:
+        return False
+    a = _decode(pub)
+    r = _decode(sig[:32])
+    if a is None or r is None:
+        return False
+    s = int.from_bytes(sig[32:], "little")
+    if s >= L:
+        return False
+    h = _sha512_int(sig[:32], pub, msg) % L
+    return _encode(_mul(s, BASE)) == _encode(_add(r, _mul(h, a)))
+
+
+# Manifest
+
+def make_manifest(secret, version, image, rollout=None):
+    body = (f"{MANIFEST_MAGIC}\n"
+            f"version={version}\n"
+            f"size={len(image)}\n"
+            f"sha256={hashlib.sha256(image).hexdigest()}\n")
+    if rollout is not None:
+        body += f"rollout={rollout}\n"
+    return body + f"signature={sign(secret, body.encode()).hex()}\n"
+
+
+def check_manifest(text, pub, image):
+    marker = text.rfind("signature=")
+    if not text.startswith(MANIFEST_MAGIC + "\n") or marker < 0:
+        return "not a manifest"
+    body = text[:marker]
+    try:
+        sig = bytes.fromhex(text[marker + len("signature="):].strip())
+    except ValueError:
+        return "bad signature encoding"
+    if not verify(pub, body.encode(), sig):
+        return "signature does not match the public key"
+    try:
+        fields = dict(line.split("=", 1) for line in body.splitlines()[1:])
+        size = int(fields["size"])
+        fields["sha256"]
+        if not 0 <= int(fields.get("rollout", "100")) <= 100:
+            return "rollout must be 0-100"
+    except (KeyError, ValueError):
+        return "malformed manifest"
+    if size != len(image):
+        return "image size differs from the manifest"
+    if fields["sha256"] != hashlib.sha256(image).hexdigest():
+        return "image SHA-256 differs from the manifest"
+    return None
+
+
+def read_key(path):
+    key = bytes.fromhex(open(path).read().strip())
+    if len(key) != 32:
+        sys.exit(f"{path}: expected 64 hex digits")
+    return key
+
+
+def c_array(pub):
+    rows = [", ".join(f"0x{b:02x}" for b in pub[i:i + 8]) for i in range(0, 32, 8)]
+    return "static const uint8_t OTA_SIGNING_KEY[32] = {\n  " + ",\n  ".join(rows) + "\n};"
+
+
+def cmd_keygen(args):
+    if os.path.exists(args.key):
+        sys.exit(f"{args.key} exists, not overwriting")
+    secret = os.urandom(32)
+    fd = os.open(args.key, os.O_WRONLY | os.O_CREAT | os.O_EXCL, 0o600)
+    with os.fdopen(fd, "w") as f:
+        f.write(secret.hex() + "\n")
+    print(c_array(public_key(secret)))
+
+
+def cmd_pubkey(args):
+    pub = public_key(read_key(args.key))
+    print(pub.hex())
+    print(c_array(pub))
+
+
+def cmd_sign(args):
+    image = open(args.image, "rb").read()
+    if image[:4] in (b"OTAZ", b"OTAD"):
+        sys.exit(f"{args.image}: sign the .bin the device will run, not the compressed/delta file")
+    if args.rollout is not None and not 0 <= args.rollout <= 100:
+        sys.exit("--rollout must be 0-100")
+    manifest = make_manifest(read_key(args.key), args.version, image, args.rollout)
+    output = args.output or args.image + ".manifest"
+    with open(output, "w") as f:
+        f.write(manifest)
+    rollout = f", rollout {args.rollout}%" if args.rollout is not None else ""
+    print(f"{output}: version {args.version}, {len(image)} bytes{rollout}")
+
+
+def cmd_verify(args):
+    pub = bytes.fromhex(args.pubkey)
+    problem = check_manifest(open(args.manifest).read(), pub, open(args.image, "rb").read())
+    if problem:
+        sys.exit(f"{args.manifest}: {problem}")
+    print(f"{args.manifest}: OK")
+
+
+# RFC 8032 section 7.1, tests 1-3: (secret, public, message, signature)
+RFC8032_VECTORS = [
+    ("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+     "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+     "",
+     "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555"
+     "fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"),
+    ("4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+     "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+     "72",
+     "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+     "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"),
+    ("c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+     "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+     "af82",
+     "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+     "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"),
+]
+
+
+def cmd_selftest(args):
+    for secret, pub, msg, sig in RFC8032_VECTORS:
+        secret, pub, msg, sig = (bytes.fromhex(x) for x in (secret, pub, msg, sig))
+        if public_key(secret) != pub or sign(secret, msg) != sig or not verify(pub, msg, sig):
+            sys.exit("RFC 8032 vector failed")
+        if verify(pub, msg + b"x", sig):
+            sys.exit("modified message accepted")
+    secret = bytes(range(32))
+    image = bytes(range(256)) * 64
+    manifest = make_manifest(secret, "1.2.3", image)
+    if check_manifest(manifest, public_key(secret), image) is not None:
+        sys.exit("manifest round trip failed")
+    if check_manifest(manifest.replace("1.2.3", "1.2.4"), public_key(secret), image) is None:
+        sys.exit("tampered manifest accepted")
+    staged = make_manifest(secret, "1.2.3", image, 25)
+    if check_manifest(staged, public_key(secret), image) is not None:
+        sys.exit("manifest with rollout failed")
+    if check_manifest(staged.replace("rollout=25", "rollout=99"), public_key(secret), image) is None:
+        sys.exit("tampered rollout accepted")
+    print("selftest OK")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("keygen", help="create a private key, print the public key")
+    p.add_argument("key")
+    p.set_defaults(func=cmd_keygen)
+    p = sub.add_parser("pubkey", help="print the public key of a private key")
+    p.add_argument("key")
+    p.set_defaults(func=cmd_pubkey)
+    p = sub.add_parser("sign", help="write a signed manifest for an image")
+    p.add_argument("key")
+    p.add_argument("image")
+    p.add_argument("--version", required=True)
+    p.add_argument("--rollout", type=int, help="percentage of devices to offer this release to (default 100)")
+    p.add_argument("-o", "--output")
+    p.set_defaults(func=cmd_sign)
+    p = sub.add_parser("verify", help="check a manifest against an image and public key")
+    p.add_argument("manifest")
+    p.add_argument("image")
+    p.add_argument("--pubkey", required=True)
+    p.set_defaults(func=cmd_verify)
+    p = sub.add_parser("selftest", help="check against the RFC 8032 test vectors")
+    p.set_defaults(func=cmd_selftest)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Flash and RAM cost of the library and of each feature module.
+
+    ota_size_report.py [--fqbn rp2040:rp2040:rpipicow] [--library .]
+                       [--arduino-cli arduino-cli] [--markdown] [--keep DIR]
+
+Builds a small sketch with arduino-cli once per configuration:
+
+  baseline    the sketch's own WiFi connection, without the library
+  core        ArduinoOTA, WiFi management, boot guard, progress reports
+              (every OTA_FEATURE_* set to 0)
+  http-pull   core + OTA_FEATURE_HTTP_PULL
+  github      core + OTA_FEATURE_HTTP_PULL + OTA_FEATURE_GITHUB
+  web         core + OTA_FEATURE_WEB
+  telemetry   core + OTA_FEATURE_TELEMETRY
+  all         the default build, every module on
+
+The sketch calls one entry point of each module that is on, so the linker
+keeps what an application using it would pay for. The flags go to both the
+sketch and the library through compiler.cpp.extra_flags, as -D flags in
+build_opt.h or platformio.ini build_flags would.
+
+Prints the "Sketch uses" / "Global variables use" figures of each build and
+the cost of each module over what it builds on. --markdown prints a table
+for $GITHUB_STEP_SUMMARY instead.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+SKETCH = """\
+// Generated by extras/ota_size_report.py
+#if OTA_SIZE_BASELINE
+#include <WiFi.h>
+#else
+#include <pico_ota.h>
+#endif
+
+// Never true at run time, but the compiler cannot tell: keeps each module's
+// entry point (and what it pulls in) in the image
+volatile bool g_sizeReportCall = false;
+
+void setup() {
+  Serial.begin(115200);
+#if OTA_SIZE_BASELINE
+  WiFi.begin("ssid", "password");
+#else
+  otaSetup("ssid", "password", "size-report");
+  if (g_sizeReportCall) {
+#if OTA_FEATURE_HTTP_PULL
+    otaUpdateFromUrl("http://192.168.1.10/firmware.bin");
+#endif
+#if OTA_FEATURE_GITHUB
+    otaSetGitHubRepo("owner", "repo");
+    otaUpdateFromGitHub();
+#endif
+#if OTA_FEATURE_WEB
+    otaStartWebServer();
+#endif
+#if OTA_FEATURE_TELEMETRY
+    OtaStats stats;
+    otaGetStats(&stats);
+#endif
+  }
+#endif
+}
+
+void loop() {
+#if !OTA_SIZE_BASELINE
+  otaLoop();
+#endif
+}
+"""
+
+OFF = {"HTTP_PULL": 0, "GITHUB": 0, "WEB": 0, "TELEMETRY": 0}
+
+# name, defines, the configuration the module's cost is measured against
+CONFIGS = [
+    ("baseline", {"OTA_SIZE_BASELINE": 1}, None),
+    ("core", {**OFF}, "baseline"),
+    ("http-pull", {**OFF, "HTTP_PULL": 1}, "core"),
+    ("github", {**OFF, "HTTP_PULL": 1, "GITHUB": 1}, "http-pull"),
+    ("web", {**OFF, "WEB": 1}, "core"),
+    ("telemetry", {**OFF, "TELEMETRY": 1}, "core"),
+    ("all", {}, "core"),
+]
+
+FLASH_RE = re.compile(r"Sketch uses (\d+) bytes")
+RAM_RE = re.compile(r"Global variables use (\d+) bytes")
+
+
+def flags(defines):
+    out = []
+    for name, value in defines.items():
+        macro = name if name.startswith("OTA_SIZE") else "OTA_FEATURE_" + name
+        out.append(f"-D{macro}={value}")
+    return " ".join(out)
+
+
+def build(args, sketch_dir, name, defines):
+    """(flash, ram) in bytes of one configuration"""
+    cmd = [args.arduino_cli, "compile", "--fqbn", args.fqbn, "--library", os.path.abspath(args.library),
+           "--build-path", os.path.join(sketch_dir, "build-" + name),
+           "--build-property", "compiler.cpp.extra_flags=" + flags(defines), sketch_dir]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    output = result.stdout + result.stderr
+    flash = FLASH_RE.search(output)
+    ram = RAM_RE.search(output)
+    if result.returncode != 0 or not flash:
+        sys.stderr.write(output)
+        sys.exit(f"{name}: build failed ({' '.join(cmd)})")
+    return int(flash.group(1)), int(ram.group(1)) if ram else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--fqbn", default="rp2040:rp2040:rpipicow", help="board to build for")
+    parser.add_argument("--library", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."),
+                        help="library directory (default: this repository)")
+    parser.add_argument("--arduino-cli", default="arduino-cli", help="arduino-cli executable")
+    parser.add_argument("--markdown", action="store_true", help="print a Markdown table")
+    parser.add_argument("--keep", help="build in DIR and keep it (default: a temporary directory)")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        root = args.keep or tmp
+        sketch_dir = os.path.join(root, "size_report")
+        os.makedirs(sketch_dir, exist_ok=True)
+        with open(os.path.join(sketch_dir, "size_report.ino"), "w") as f:
+            f.write(SKETCH)
+
+        sizes = {}
+        for name, defines, _ in CONFIGS:
+            sizes[name] = build(args, sketch_dir, name, defines)
+            if not args.markdown:
+                print(f"  built {name}: {sizes[name][0]} / {sizes[name][1]} bytes", file=sys.stderr)
+
+    if args.markdown:
+        print(f"### Size report: `{args.fqbn}`\n")
+        print("| Configuration | Flash | RAM | Flash cost | RAM cost | Over |")
+        print("|---|--:|--:|--:|--:|---|")
+    else:
+        print(f"{args.fqbn}")
+        print(f"{'configuration':<12} {'flash':>9} {'ram':>8} {'flash cost':>11} {'ram cost':>9}  over")
+    for name, _, over in CONFIGS:
+        flash, ram = sizes[name]
+        if over:
+            dflash = f"{flash - sizes[over][0]:+d}"
+            dram = f"{ram - sizes[over][1]:+d}"
+        else:
+            dflash = dram = over = "-"
+        if args.markdown:
+            print(f"| {name} | {flash} | {ram} | {dflash} | {dram} | {over} |")
+        else:
+            print(f"{name:<12} {flash:>9} {ram:>8} {dflash:>11} {dram:>9}  {over}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Local update-source stand-ins with scripted latency, for otaUpdateFromSources().
+
+    ota_source_sim.py serve firmware.bin --source SPEC [--source SPEC ...]
+    ota_source_sim.py run [--size 1048576] [--source SPEC ...] [--stall-timeout 2]
+
+SPEC is name[:option,option...], for example
+
+    mirror:latency=5,rate=2000,stall=300000
+    cdn:latency=60,rate=800
+    github:latency=250,rate=400,redirect
+
+  latency=MS       delay before every response
+  rate=KBPS        body rate in kB/s (default: unlimited)
+  stall=BYTES      after serving this many bytes in total, hang: the body
+                   stops mid-transfer and later requests never get an answer
+  status=CODE      answer every request with this status (e.g. 404, 503)
+  uptodate=VER     answer 304 when x-ota-version is VER
+  redirect         answer with 302 to a second path first (like GitHub -> CDN)
+  nosha            do not send X-Firmware-SHA256
+
+Each stand-in serves the image at any path, with Range support, on its own
+127.0.0.1 port.
+
+serve   starts the stand-ins for a real device and prints their URLs, to pass
+        to otaAddUpdateSource() in that order.
+run     starts them with a random image and runs a model of the device
+        against them. The model uses the same steps as otaUpdateFromSources()
+        in src/pico_ota_http.cpp: a probe of the first 8 KB of each source,
+        ranking by latency + size / rate, 32 KB Range requests, and moving
+        to the next source when one stalls or refuses. It keeps the bytes
+        so far when the SHA-256 is known. It prints the probes, the
+        hand-overs and the bytes each source served, then checks the
+        result. With no --source, a default scenario runs: a fast mirror
+        that stalls at 30%, a CDN, and a slow redirecting "GitHub".
+"""
+
+import argparse
+import hashlib
+import os
+import sys
+import threading
+import time
+import urllib.error
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+PROBE_BYTES = 8192       # kProbeBytes
+PROBE_TIMEOUT = 3.0      # kProbeTimeoutMs
+CHUNK = 32768            # otaSetDownloadChunkSize() default
+SOURCE_RETRIES = 1       # kSourceRetries
+DOWNLOAD_RETRIES = 5     # otaSetDownloadRetries() default
+
+DEFAULT_SOURCES = ["mirror:latency=5,rate=2000,stall=30%",
+                   "cdn:latency=60,rate=800",
+                   "github:latency=250,rate=400,redirect"]
+
+
+class Source:
+    def __init__(self, spec, size):
+        name, _, options = spec.partition(":")
+        self.name = name
+        self.latency = 0.0
+        self.rate = 0
+        self.stall = None
+        self.status = None
+        self.uptodate = None
+        self.redirect = False
+        self.sha = True
+        for option in filter(None, options.split(",")):
+            key, _, value = option.partition("=")
+            if key == "latency":
+                self.latency = float(value) / 1000
+            elif key == "rate":
+                self.rate = float(value) * 1000
+            elif key == "stall":
+                self.stall = int(float(value[:-1]) * size / 100) if value.endswith("%") else int(value)
+            elif key == "status":
+                self.status = int(value)
+            elif key == "uptodate":
+                self.uptodate = value
+            elif key == "redirect":
+                self.redirect = True
+            elif key == "nosha":
+                self.sha = False
+            else:
+                raise SystemExit(f"unknown option {key!r} in {spec!r}")
+        self.served = 0
+        self.lock = threading.Lock()
+        self.hung = threading.Event()
+        self.stop = threading.Event()
+        self.url = None
+
+    def take(self, n):
+        """Bytes of n that may still be sent before the stall point"""
+        with self.lock:
+            if self.stall is not None:
+                n = max(0, min(n, self.stall - self.served))
+            self.served += n
+            if self.stall is not None and self.served >= self.stall:
+                self.hung.set()
+            return n
+
+
+def make_handler(source, image):
+    digest = hashlib.sha256(image).hexdigest()
+
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def log_message(self, *args):
+            pass
+
+        def hang(self):
+            source.stop.wait()
+            self.close_connection = True
+
+        def do_GET(self):
+            if source.hung.is_set():
+                return self.hang()
+            time.sleep(source.latency)
+            if source.status:
+                self.send_response(source.status)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            if source.redirect and not self.path.startswith("/cdn/"):
+                self.send_response(302)
+                self.send_header("Location", f"{source.url}cdn{self.path}")
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            if source.uptodate and self.headers["x-ota-version"] == source.uptodate:
+                self.send_response(304)
+                self.end_headers()
+                return
+
+            first, last = 0, len(image) - 1
+            value = self.headers["Range"] or ""
+            partial = value.startswith("bytes=") and "-" in value
+            if partial:
+                start, _, end = value[6:].partition("-")
+                first = int(start or 0)
+                last = min(int(end), last) if end else last
+                if first > last:
+                    self.send_response(416)
+                    self.send_header("Content-Range", f"bytes */{len(image)}")
+                    self.send_header("Content-Length", "0")
+                    self.end_headers()
+                    return
+            self.send_response(206 if partial else 200)
+            if partial:
+                self.send_header("Content-Range", f"bytes {first}-{last}/{len(image)}")
+            if source.sha:
+                self.send_header("X-Firmware-SHA256", digest)
+            self.send_header("Accept-Ranges", "bytes")
+            self.send_header("Content-Length", str(last - first + 1))
+            self.end_headers()
+
+            offset = first
+            while offset <= last:
+                piece = source.take(min(1024, last - offset + 1))
+                if piece == 0:
+                    return self.hang()
+                self.wfile.write(image[offset:offset + piece])
+                offset += piece
+                if source.rate:
+                    time.sleep(piece / source.rate)
+    return Handler
+
+
+def start_sources(specs, image):
+    sources = [Source(spec, len(image)) for spec in specs]
+    servers = []
+    for source in sources:
+        server = ThreadingHTTPServer(("127.0.0.1", 0), make_handler(source, image))
+        server.daemon_threads = True
+        source.url = f"http://127.0.0.1:{server.server_address[1]}/"
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        servers.append(server)
+    return sources, servers
+
+
+def stop_sources(sources, servers):
+    for source in sources:
+        source.stop.set()
+    for server in servers:
+        server.shutdown()
+
+
+def request(url, first, last, timeout, version):
+    headers = {"Range": f"bytes={first}-{last}", "User-Agent": "Pico-OTA"}
+    if version:
+        headers["x-ota-version"] = version
+    return urllib.request.urlopen(urllib.request.Request(url + "firmware.bin", headers=headers), timeout=timeout)
+
+
+def probe(source, version):
+    """Latency, rate and size, as probeSource() measures them"""
+    result = {"healthy": False, "uptodate": False, "latency": 0.0, "rate": 0.0, "size": 0, "estimate": None}
+    start = time.monotonic()
+    try:
+        response = request(source.url, 0, PROBE_BYTES - 1, PROBE_TIMEOUT, version)
+    except urllib.error.HTTPError as error:
+        result["latency"] = time.monotonic() - start
+        result["uptodate"] = error.code == 304
+        return result
+    except OSError:
+        return result
+    with response:
+        result["latency"] = time.monotonic() - start
+        content_range = response.headers["Content-Range"] or ""
+        size = int(content_range.rpartition("/")[2]) if "/" in content_range else int(
+            response.headers["Content-Length"] or 0)
+        body_start = time.monotonic()
+        try:
+            body = response.read(min(PROBE_BYTES, size))
+        except OSError:
+            return result
+        elapsed = max(time.monotonic() - body_start, 0.001)
+    result["size"] = size
+    result["rate"] = len(body) / elapsed
+    result["healthy"] = len(body) == min(PROBE_BYTES, size) and size > 0
+    result["estimate"] = result["latency"] + size / max(result["rate"], 1)
+    return result
+
+
+def transfer(source, data, size, retries, timeout, version):
+    """transferImage(): Range requests until done. Returns ok, refused, stalled or not-modified"""
+    failures = 0
+    while len(data) < size:
+        before = len(data)
+        try:
+            with request(source.url, len(data), min(len(data) + CHUNK, size) - 1, timeout, version) as response:
+                while len(data) < size:
+                    piece = response.read(min(1024, size - len(data)))
+                    if not piece:
+                        break
+                    data += piece
+                    source.received += len(piece)
+                if response.headers["X-Firmware-SHA256"]:
+                    source.digest = response.headers["X-Firmware-SHA256"]
+        except urllib.error.HTTPError as error:
+            if error.code == 304:
+                return "not-modified"
+            if error.code < 500:
+                return "refused"
+        except OSError:
+            pass
+        if len(data) > before:
+            failures = 0
+            continue
+        failures += 1
+        if failures > retries:
+            return "stalled"
+        time.sleep(0.1 * (1 << min(failures, 5)))  # Device: 1 s << failures
+    return "ok"
+
+
+def run_device(sources, size, expected, version, stall_timeout):
+    print(f"{'source':<10} {'latency':>9} {'rate kB/s':>10} {'size':>9} {'estimate':>9}  rank")
+    ranked = []
+    for source in sources:
+        source.probe = probe(source, version)
+        source.received = 0
+        source.digest = None
+        if source.probe["healthy"]:
+            ranked.append(source)
+    ranked.sort(key=lambda s: s.probe["estimate"])  # Stable: earlier sources win ties
+    ranked = [s for s in ranked if s.probe["size"] == ranked[0].probe["size"]] if ranked else []
+    for source in sources:
+        p = source.probe
+        rank = ranked.index(source) if source in ranked else "-"
+        state = "" if p["healthy"] else (" (up to date)" if p["uptodate"] else " (unhealthy)")
+        estimate = f"{p['estimate']:.2f} s" if p["estimate"] is not None else "-"
+        print(f"{source.name:<10} {p['latency'] * 1000:>6.0f} ms {p['rate'] / 1000:>10.0f} {p['size']:>9} "
+              f"{estimate:>9}  {rank}{state}")
+    print()
+    if not ranked:
+        print("no update" if any(s.probe["uptodate"] for s in sources) else "no source reachable")
+        return 0 if any(s.probe["uptodate"] for s in sources) else 1
+
+    data = bytearray()
+    start = time.monotonic()
+    digest = None
+    for n, source in enumerate(ranked):
+        if n > 0:
+            keep = digest is not None and len(data) > 0
+            print(f"  {ranked[n - 1].name} failed at byte {len(data)}, switching to {source.name}"
+                  f"{'' if keep else ' (from the start)'}")
+            if not keep:
+                data = bytearray()
+        last = n == len(ranked) - 1
+        result = transfer(source, data, size, DOWNLOAD_RETRIES if last else SOURCE_RETRIES, stall_timeout, version)
+        digest = digest or source.digest or expected
+        if result in ("ok", "not-modified"):
+            break
+    elapsed = time.monotonic() - start
+
+    print()
+    for source in sources:
+        print(f"  {source.name:<10} {source.received:>9} bytes")
+    if len(data) != size:
+        print(f"download failed at byte {len(data)} of {size}")
+        return 1
+    actual = hashlib.sha256(data).hexdigest()
+    if digest and actual != digest:
+        print("SHA-256 mismatch")
+        return 1
+    print(f"{size} bytes in {elapsed:.2f} s, {'SHA-256 verified' if digest else 'no digest to check'}")
+    return 0
+
+
+def cmd_serve(args):
+    image = open(args.image, "rb").read()
+    sources, _ = start_sources(args.source, image)
+    print(f"{args.image}: {len(image)} bytes, sha256 {hashlib.sha256(image).hexdigest()}")
+    for source in sources:
+        print(f"  {source.name:<10} {source.url}firmware.bin")
+    print("Ctrl+C to stop", flush=True)
+    try:
+        while True:
+            time.sleep(3600)
+    except KeyboardInterrupt:
+        return 0
+
+
+def cmd_run(args):
+    image = os.urandom(args.size)
+    sources, servers = start_sources(args.source or DEFAULT_SOURCES, image)
+    expected = hashlib.sha256(image).hexdigest() if args.signed else None
+    try:
+        return run_device(sources, len(image), expected, args.version, args.stall_timeout)
+    finally:
+        stop_sources(sources, servers)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("serve", help="serve an image from stand-ins for a real device")
+    p.add_argument("image")
+    p.add_argument("--source", action="append", required=True, help="stand-in SPEC (repeatable, in order)")
+
+    p = sub.add_parser("run", help="run the device model against stand-ins")
+    p.add_argument("--size", type=int, default=1024 * 1024, help="image size in bytes")
+    p.add_argument("--source", action="append", default=[], help="stand-in SPEC (repeatable, in order)")
+    p.add_argument("--signed", action="store_true", help="digest known up front, as from a signed manifest")
+    p.add_argument("--version", default="1.0.0", help="x-ota-version sent by the device")
+    p.add_argument("--stall-timeout", type=float, default=2.0, help="seconds without data (device: 10)")
+
+    args = parser.parse_args()
+    sys.exit(cmd_serve(args) if args.command == "serve" else cmd_run(args))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Loop jitter and update throughput of time-sliced updates, per step budget.
+
+    ota_step_sim.py [--budgets 500,1000,2000,5000,10000] [--work 1] [--size 1048576]
+                    [--rate 600] [--rtt 20] [--window 11680] [--chunk 32768]
+                    [--erase 45] [--program 12] [--cpu 1500] [--buffers 2] [--pico]
+
+Models a sketch whose loop() does --work ms of its own work and then calls
+otaLoop(), which runs otaUpdateStep() with the budget (see transferStep()
+and receiveBody() in src/pico_ota_http.cpp), against the blocking
+otaUpdateFromUrl() that holds loop() for the whole download:
+
+  - a range request of --chunk bytes blocks for one round trip (connect is
+    assumed done: the connection is kept alive), then the body arrives at
+    --rate, limited to --window unread bytes in the socket buffer
+  - a step reads 1 KB at a time at --cpu kB/s until the budget is used or
+    the socket is empty; it returns rather than waiting for data
+  - complete OTA_IMAGE_WRITE_BLOCK blocks are buffered (--buffers) and
+    programmed when the socket is empty or every buffer is full, stalling
+    the CPU for --erase + --program ms
+  - --pico adds the per-chunk checkpoint of Pico W / Pico 2 W: flush the
+    buffers and rewrite the journal (--journal ms)
+
+The socket keeps filling while the sketch does its own work, so throughput
+stays close to the blocking path until the loop's own work fills the TCP
+window. Prints, per budget, the longest, 99th percentile and mean loop period
+(start to start; the ideal is --work), and the download rate relative to
+the blocking path. Unsplittable steps (a flash block, a request's round
+trip) set the floor of the longest period whatever the budget.
+"""
+
+import argparse
+
+READ = 1024  # g_dlBuffer
+
+
+class Device:
+    """Network, socket buffer and flash, advanced as the CPU spends time"""
+
+    def __init__(self, args):
+        self.args = args
+        self.t = 0.0
+        self.rate = args.rate * 1000.0
+        self.cpu = args.cpu * 1000.0
+        self.flash = (args.erase + args.program) / 1000.0
+        self.offset = 0          # Bytes read from the socket (g_dl.offset)
+        self.arrived = 0.0       # Bytes of the current body in the socket so far
+        self.body = 0            # Length of the current body
+        self.body_read = 0
+        self.sending_from = None  # The server starts sending the body then
+        self.fill = 0            # Bytes in the block being filled
+        self.ready = 0           # Complete blocks waiting for flash
+        self.phase = "request"
+
+    def spend(self, seconds):
+        """CPU busy (or sleeping) for seconds while the network goes on"""
+        if self.sending_from is not None and self.body > 0:
+            start = max(self.t, self.sending_from)
+            end = self.t + seconds
+            if end > start:
+                room = self.args.window - (self.arrived - self.body_read)
+                self.arrived += min(self.rate * (end - start), room, self.body - self.arrived)
+        self.t += seconds
+
+    def available(self):
+        return int(self.arrived) - self.body_read
+
+    def write_block(self):
+        self.ready -= 1
+        self.spend(self.flash)
+
+    def flush(self):
+        while self.ready > 0:
+            self.write_block()
+        if self.fill > 0:
+            self.fill = 0
+            self.spend(self.flash)
+
+    def buffer(self, n):
+        """imageBufferWrite(): n bytes into the blocks, waiting for flash only when all are full"""
+        block = self.args.block
+        while n > 0:
+            take = min(block - self.fill, n)
+            self.fill += take
+            n -= take
+            if self.fill == block:
+                self.fill = 0
+                self.ready += 1
+                if self.ready == self.args.buffers:
+                    self.write_block()
+
+    def step(self, budget):
+        """One otaUpdateStep(); budget None runs the download to the end. True when done"""
+        start = self.t
+        while True:
+            if budget is not None and self.t - start >= budget:
+                return False
+            if self.phase == "request":
+                if self.offset >= self.args.size:
+                    self.flush()
+                    return True
+                self.body = min(self.args.chunk, self.args.size - self.offset)
+                self.body_read = 0
+                self.arrived = 0.0
+                self.sending_from = self.t + self.args.rtt / 2000.0
+                self.spend(self.args.rtt / 1000.0)  # HTTPClient::GET() waits for the headers
+                self.phase = "body"
+                continue
+
+            available = self.available()
+            if self.body_read == self.body:
+                if self.args.pico:
+                    self.flush()  # imageCheckpoint()
+                    self.spend(self.args.journal / 1000.0)
+                self.phase = "request"
+                continue
+            if available <= 0:
+                if self.ready > 0:
+                    self.write_block()  # imageWriteIdle()
+                if budget is not None:
+                    return False
+                self.spend(0.001)  # delay(1)
+                continue
+            n = min(available, READ)
+            self.spend(n / self.cpu)
+            self.body_read += n
+            self.offset += n
+            self.buffer(n)
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def run(args, budget_us):
+    """Loop periods (s) and download time (s) with the given budget, None = blocking"""
+    device = Device(args)
+    work = args.work / 1000.0
+    budget = None if budget_us is None else budget_us / 1e6
+    periods = []
+    last = None
+    begin = device.t
+    done = False
+    while not done:
+        if last is not None:
+            periods.append(device.t - last)
+        last = device.t
+        device.spend(work)
+        done = device.step(budget)
+    return periods, device.t - begin
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--budgets", default="500,1000,2000,5000,10000", help="step budgets in us, comma separated")
+    parser.add_argument("--work", type=float, default=1, help="the sketch's own work per loop() in ms")
+    parser.add_argument("--size", type=int, default=1024 * 1024, help="image size in bytes")
+    parser.add_argument("--rate", type=float, default=600, help="network rate in kB/s")
+    parser.add_argument("--rtt", type=float, default=20, help="round trip time in ms")
+    parser.add_argument("--window", type=int, default=11680, help="TCP receive window in bytes (lwIP TCP_WND)")
+    parser.add_argument("--chunk", type=int, default=32768, help="otaSetDownloadChunkSize() in bytes")
+    parser.add_argument("--block", type=int, default=4096, help="OTA_IMAGE_WRITE_BLOCK in bytes")
+    parser.add_argument("--erase", type=float, default=45, help="sector erase time in ms")
+    parser.add_argument("--program", type=float, default=12, help="time to program one block in ms")
+    parser.add_argument("--cpu", type=float, default=1500, help="read + hash rate of the sketch in kB/s")
+    parser.add_argument("--buffers", type=int, default=2, help="OTA_IMAGE_WRITE_BUFFERS")
+    parser.add_argument("--pico", action="store_true", help="checkpoint the staged image after every chunk")
+    parser.add_argument("--journal", type=float, default=10, help="with --pico: journal write time in ms")
+    args = parser.parse_args()
+
+    _, blocking = run(args, None)
+    base = args.size / blocking / 1e6
+    print(f"{args.size} bytes at {args.rate:.0f} kB/s, {args.rtt:.0f} ms RTT, "
+          f"{args.work:.1f} ms of loop() work, flash block {args.erase + args.program:.0f} ms")
+    print(f"{'budget':>10} {'loop max':>10} {'loop p99':>10} {'loop mean':>10} {'MB/s':>8} {'vs blocking':>12}")
+    print(f"{'blocking':>10} {blocking * 1000:>7.0f} ms {'-':>10} {'-':>10} {base:>8.3f} {'100%':>12}")
+    for budget in (int(b) for b in args.budgets.split(",")):
+        periods, total = run(args, budget)
+        rate = args.size / total / 1e6
+        print(f"{budget:>7} us {max(periods) * 1000:>7.1f} ms {percentile(periods, 0.99) * 1000:>7.1f} ms "
+              f"{sum(periods) / len(periods) * 1000:>7.2f} ms {rate:>8.3f} {rate / base:>11.0%}")
+
+
+if __name__ == "__main__":
+    main()
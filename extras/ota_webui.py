@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2026 Samuel F.
+"""Generate src/ota_webui.h from the web UI pages in extras/webui/.
+
+    ota_webui.py            rewrite src/ota_webui.h
+    ota_webui.py --check    fail if src/ota_webui.h is out of date
+
+Each page is gzip-compressed (level 9, no timestamp, so the output only
+changes when a page does) and written as a byte array the web server sends
+straight from flash with Content-Encoding: gzip. The ETag is derived from
+the compressed bytes. Run this after editing a page and commit both.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PAGES = [  # (source file, C name)
+    ("index.html", "kOtaWebIndex"),
+    ("update.html", "kOtaWebUpdate"),
+]
+OUTPUT = os.path.join(ROOT, "src", "ota_webui.h")
+
+
+def c_bytes(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("  " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def render():
+    parts = [
+        "// SPDX-License-Identifier: MIT\n"
+        "// Copyright (c) 2026 Samuel F.\n"
+        "\n"
+        "// Generated by extras/ota_webui.py from extras/webui/ - do not edit.\n"
+        "// gzip-compressed pages, sent from flash with Content-Encoding: gzip.\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stddef.h>\n"
+        "#include <stdint.h>\n"
+    ]
+    for source, name in PAGES:
+        html = open(os.path.join(ROOT, "extras", "webui", source), "rb").read()
+        data = gzip.compress(html, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(data).hexdigest()[:16]
+        parts.append(
+            f"\n// {source}: {len(html)} bytes, {len(data)} compressed\n"
+            f"static const uint8_t {name}[] PROGMEM = {{\n{c_bytes(data)}\n}};\n"
+            f"static const size_t {name}Len = {len(data)};\n"
+            f"static const char {name}Etag[] = \"\\\"{etag}\\\"\";\n")
+    return "".join(parts)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--check", action="store_true", help="only check that the header is current")
+    args = parser.parse_args()
+
+    text = render()
+    current = open(OUTPUT).read() if os.path.exists(OUTPUT) else ""
+    if args.check:
+        if text != current:
+            sys.exit(f"{OUTPUT} is out of date, run extras/ota_webui.py")
+        print(f"{OUTPUT}: up to date")
+        return
+    if text != current:
+        with open(OUTPUT, "w") as f:
+            f.write(text)
+    print(f"{OUTPUT}: {len(PAGES)} pages")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, same as zlib.crc32). Start with crc = 0 and feed the
+// previous result back in to checksum data that arrives in pieces.
+uint32_t otaCrc32(uint32_t crc, const void* data, size_t len);
@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_delta.h"
+
+#include <string.h>
+
+#include "ota_crc32.h"
+
+static uint32_t readLe32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool OtaDeltaPatcher::isPatch(const uint8_t* data, size_t len) {
+  return len >= 4 && memcmp(data, "OTAD", 4) == 0;
+}
+
+OtaDeltaPatcher::OtaDeltaPatcher() {
+  begin(nullptr, nullptr, nullptr);
+}
+
+void OtaDeltaPatcher::begin(OtaDeltaReadFn readSource, OtaDeltaWriteFn writeTarget, void* context) {
+  _read = readSource;
+  _write = writeTarget;
+  _context = context;
+  _state = STATE_HEADER;
+  _error = OTA_DELTA_ERR_NONE;
+  _headerLen = 0;
+  _sourceSize = 0;
+  _targetSize = 0;
+  _targetCrc = 0;
+  _varint = 0;
+  _varintShift = 0;
+  _diffLeft = 0;
+  _addLeft = 0;
+  _extraLen = 0;
+  _seek = 0;
+  _sourcePos = 0;
+  _produced = 0;
+  _crc = 0;
+}
+
+bool OtaDeltaPatcher::fail(OtaDeltaError error) {
+  _error = error;
+  _state = STATE_ERROR;
+  return false;
+}
+
+// Validate the header and make sure the running image is the patch source
+// before a single byte of output is produced. The CRC pass runs here, inside
+// the feed() that completes the header, rather than spread over later
+// calls: feed() consumes all of its input, so there is nowhere to park patch
+// bytes while the check is still running, and it costs one read of the
+// source - far less than the erase and write of the image that follows.
+bool OtaDeltaPatcher::parseHeader() {
+  if (!isPatch(_header, _headerLen) || _header[4] != 1) {
+    return fail(OTA_DELTA_ERR_HEADER);
+  }
+  _sourceSize = readLe32(_header + 8);
+  uint32_t sourceCrc = readLe32(_header + 12);
+  _targetSize = readLe32(_header + 16);
+  _targetCrc = readLe32(_header + 20);
+
+  uint32_t crc = 0;
+  for (uint32_t offset = 0; offset < _sourceSize;) {
+    uint32_t len = _sourceSize - offset;
+    if (len > sizeof(_window)) len = sizeof(_window);
+    if (!_read || !_read(offset, _window, len, _context)) {
+      return fail(OTA_DELTA_ERR_READ);
+    }
+    crc = otaCrc32(crc, _window, len);
+    offset += len;
+  }
+  if (crc != sourceCrc) {
+    return fail(OTA_DELTA_ERR_SOURCE_MISMATCH);
+  }
+
+  nextRecordOrDone();
+  return true;
+}
+
+// Returns true once the last byte of the value was consumed
+bool OtaDeltaPatcher::readVarint(uint8_t byte, uint32_t& value) {
+  if (_varintShift > 28) {
+    fail(OTA_DELTA_ERR_CORRUPT);
+    return false;
+  }
+  _varint |= (uint32_t)(byte & 0x7F) << _varintShift;
+  _varintShift += 7;
+  if (byte & 0x80) {
+    return false;
+  }
+  value = _varint;
+  _varint = 0;
+  _varintShift = 0;
+  return true;
+}
+
+bool OtaDeltaPatcher::emit(const uint8_t* data, size_t len) {
+  if (_produced + len > _targetSize) {
+    return fail(OTA_DELTA_ERR_CORRUPT);
+  }
+  if (!_write || !_write(data, len, _context)) {
+    return fail(OTA_DELTA_ERR_WRITE);
+  }
+  _crc = otaCrc32(_crc, data, len);
+  _produced += (uint32_t)len;
+  return true;
+}
+
+// Unchanged source bytes need no patch input, so the whole span is copied
+// through the window right away.
+bool OtaDeltaPatcher::copySource(uint32_t len) {
+  while (len > 0) {
+    size_t take = len < sizeof(_window) ? len : sizeof(_window);
+    if (!_read(_sourcePos, _window, take, _context)) {
+      return fail(OTA_DELTA_ERR_READ);
+    }
+    if (!emit(_window, take)) return false;
+    _sourcePos += (uint32_t)take;
+    len -= (uint32_t)take;
+  }
+  return true;
+}
+
+// Next copy/add pair, or - once the diff run is complete - apply the seek
+// and move on to the extra run.
+void OtaDeltaPatcher::advanceDiff() {
+  if (_diffLeft > 0) {
+    _state = STATE_COPY_LEN;
+    return;
+  }
+  _sourcePos = (uint32_t)((int64_t)_sourcePos + _seek);
+  _seek = 0;
+  _state = STATE_EXTRA;
+  if (_extraLen == 0) nextRecordOrDone();
+}
+
+void OtaDeltaPatcher::nextRecordOrDone() {
+  if (_produced < _targetSize) {
+    _state = STATE_DIFF_LEN;
+    return;
+  }
+  if (_crc != _targetCrc) {
+    fail(OTA_DELTA_ERR_TARGET_CRC);
+    return;
+  }
+  _state = STATE_DONE;
+}
+
+bool OtaDeltaPatcher::feed(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    uint32_t value;
+
+    switch (_state) {
+      case STATE_HEADER: {
+        size_t take = kHeaderSize - _headerLen;
+        if (take > len - i) take = len - i;
+        memcpy(_header + _headerLen, data + i, take);
+        _headerLen += (uint8_t)take;
+        i += take;
+        if (_headerLen == kHeaderSize && !parseHeader()) {
+          return false;
+        }
+        break;
+      }
+
+      case STATE_DIFF_LEN:
+        if (readVarint(data[i++], value)) {
+          if (value > _sourceSize || _sourcePos > _sourceSize - value) {
+            return fail(OTA_DELTA_ERR_CORRUPT);
+          }
+          _diffLeft = value;
+          _state = STATE_EXTRA_LEN;
+        }
+        break;
+
+      case STATE_EXTRA_LEN:
+        if (readVarint(data[i++], value)) {
+          _extraLen = value;
+          _state = STATE_SEEK;
+        }
+        break;
+
+      case STATE_SEEK:
+        if (readVarint(data[i++], value)) {
+          _seek = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+          int64_t newPos = (int64_t)_sourcePos + _diffLeft + _seek;
+          if (newPos < 0 || newPos > (int64_t)_sourceSize) {
+            return fail(OTA_DELTA_ERR_CORRUPT);
+          }
+          advanceDiff();
+        }
+        break;
+
+      case STATE_COPY_LEN:
+        if (readVarint(data[i++], value)) {
+          if (value > _diffLeft) {
+            return fail(OTA_DELTA_ERR_CORRUPT);
+          }
+          _diffLeft -= value;
+          if (!copySource(value)) return false;
+          _state = STATE_ADD_LEN;
+        }
+        break;
+
+      case STATE_ADD_LEN:
+        if (readVarint(data[i++], value)) {
+          if (value > _diffLeft) {
+            return fail(OTA_DELTA_ERR_CORRUPT);
+          }
+          _diffLeft -= value;
+          _addLeft = value;
+          if (_addLeft > 0) {
+            _state = STATE_ADD;
+          } else {
+            advanceDiff();
+          }
+        }
+        break;
+
+      case STATE_ADD: {
+        size_t take = _addLeft;
+        if (take > len - i) take = len - i;
+        if (take > sizeof(_window)) take = sizeof(_window);
+        if (!_read(_sourcePos, _window, take, _context)) {
+          return fail(OTA_DELTA_ERR_READ);
+        }
+        for (size_t k = 0; k < take; k++) {
+          _window[k] = (uint8_t)(_window[k] + data[i + k]);
+        }
+        if (!emit(_window, take)) return false;
+        i += take;
+        _sourcePos += (uint32_t)take;
+        _addLeft -= (uint32_t)take;
+        if (_addLeft == 0) advanceDiff();
+        break;
+      }
+
+      case STATE_EXTRA: {
+        size_t take = _extraLen;
+        if (take > len - i) take = len - i;
+        if (!emit(data + i, take)) return false;
+        i += take;
+        _extraLen -= (uint32_t)take;
+        if (_extraLen == 0) nextRecordOrDone();
+        break;
+      }
+
+      case STATE_DONE:
+        return fail(OTA_DELTA_ERR_CORRUPT);  // Trailing bytes after the last record
+
+      case STATE_ERROR:
+      default:
+        return false;
+    }
+
+    if (_state == STATE_ERROR) return false;
+  }
+  return true;
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming delta (binary patch) application.
+//
+// A patch rebuilds the new image from the image that is already running, so
+// only the changed bytes travel over the network. Patches are made on the
+// host with extras/ota_delta.py. Layout (all integers little endian, varints
+// are LEB128):
+//
+//   header (24 bytes)
+//     "OTAD"        magic
+//     u8            format version (1)
+//     u8[3]         reserved, 0
+//     u32           source image size
+//     u32           source image CRC-32 (checked before anything is written)
+//     u32           target image size
+//     u32           target image CRC-32 (checked when the patch ends)
+//   records, repeated until target size bytes were produced
+//     varint        diff length
+//     varint        extra length
+//     zigzag varint seek, applied to the source position after the diff run
+//     diff run      pairs until diff length bytes were produced:
+//                     varint copy  - source bytes copied unchanged
+//                     varint add   - followed by add bytes, each added
+//                                    (mod 256) to the next source byte
+//     extra run     extra length bytes copied to the output as-is
+//
+// The diff run is bsdiff's approximate match stored sparsely: relocated
+// code differs from the old image only in scattered pointer bytes, so most
+// of a run is plain copies. Source bytes are read through a callback into a
+// fixed window; neither image is ever held in RAM. Plain C++ (no Arduino
+// headers).
+
+#ifndef OTA_DELTA_WINDOW_SIZE
+#define OTA_DELTA_WINDOW_SIZE 256
+#endif
+
+enum OtaDeltaError {
+  OTA_DELTA_ERR_NONE = 0,
+  OTA_DELTA_ERR_HEADER,           // Bad magic or unsupported version
+  OTA_DELTA_ERR_SOURCE_MISMATCH,  // Running image is not the one the patch was made from
+  OTA_DELTA_ERR_CORRUPT,          // Record points outside the source or past the target
+  OTA_DELTA_ERR_READ,             // Source read callback failed
+  OTA_DELTA_ERR_WRITE,            // Output callback failed
+  OTA_DELTA_ERR_TARGET_CRC        // Rebuilt image does not match the expected CRC
+};
+
+// Read len bytes of the running image at offset
+typedef bool (*OtaDeltaReadFn)(uint32_t offset, uint8_t* buf, size_t len, void* context);
+// Consume len bytes of the rebuilt image (called in order)
+typedef bool (*OtaDeltaWriteFn)(const uint8_t* data, size_t len, void* context);
+
+class OtaDeltaPatcher {
+public:
+  static const size_t kHeaderSize = 24;
+
+  // True if data starts with the patch magic (needs at least 4 bytes)
+  static bool isPatch(const uint8_t* data, size_t len);
+
+  OtaDeltaPatcher();
+
+  void begin(OtaDeltaReadFn readSource, OtaDeltaWriteFn writeTarget, void* context);
+
+  // Feed the next piece of the patch. Returns false on error (see error()).
+  // The call that completes the header also checks the source CRC, which
+  // reads the whole running image once before returning: one pass over
+  // sourceSize() bytes, synchronous, once per patch. Later calls do work
+  // proportional to their input.
+  bool feed(const uint8_t* data, size_t len);
+
+  bool headerParsed() const { return _state > STATE_HEADER; }
+  bool done() const { return _state == STATE_DONE; }
+  OtaDeltaError error() const { return _error; }
+
+  uint32_t sourceSize() const { return _sourceSize; }
+  uint32_t targetSize() const { return _targetSize; }
+  uint32_t produced() const { return _produced; }
+
+private:
+  enum State : uint8_t {
+    STATE_HEADER,
+    STATE_DIFF_LEN,
+    STATE_EXTRA_LEN,
+    STATE_SEEK,
+    STATE_COPY_LEN,
+    STATE_ADD_LEN,
+    STATE_ADD,
+    STATE_EXTRA,
+    STATE_DONE,
+    STATE_ERROR
+  };
+
+  bool fail(OtaDeltaError error);
+  bool parseHeader();
+  bool readVarint(uint8_t byte, uint32_t& value);
+  bool copySource(uint32_t len);
+  bool emit(const uint8_t* data, size_t len);
+  void advanceDiff();
+  void nextRecordOrDone();
+
+  OtaDeltaReadFn _read;
+  OtaDeltaWriteFn _write;
+  void* _context;
+
+  uint8_t _state;
+  OtaDeltaError _error;
+
+  uint8_t _header[kHeaderSize];
+  uint8_t _headerLen;
+
+  uint32_t _sourceSize;
+  uint32_t _targetSize;
+  uint32_t _targetCrc;
+
+  uint32_t _varint;
+  uint8_t _varintShift;
+
+  uint32_t _diffLeft;    // Bytes left in the current diff run
+  uint32_t _addLeft;     // Bytes left in the current add span
+  uint32_t _extraLen;    // Extra length of the current record (then bytes left)
+  int32_t _seek;         // Source seek of the current record
+  uint32_t _sourcePos;
+  uint32_t _produced;
+  uint32_t _crc;         // CRC-32 of the output so far
+
+  uint8_t _window[OTA_DELTA_WINDOW_SIZE];
+};
@@ -0,0 +1,648 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_ed25519.h"
+
+#include <string.h>
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// SHA-512 (only needed for h = SHA-512(R || A || M))
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+static const uint64_t kSha512Rounds[80] = {
+  0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+  0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+  0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+  0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+  0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+  0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+  0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+  0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+  0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+  0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+  0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+  0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+  0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+  0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+  0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+  0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+  0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+  0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+  0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+  0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+  0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+  0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+  0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+  0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+  0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+  0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+  0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+namespace {
+
+class Sha512 {
+public:
+  Sha512() {
+    static const uint64_t kInitialState[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+    0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+    };
+    memcpy(_state, kInitialState, sizeof(_state));
+    _length = 0;
+    _blockLen = 0;
+  }
+
+  void update(const uint8_t* data, size_t len) {
+    _length += len;
+    while (len > 0) {
+      size_t take = sizeof(_block) - _blockLen;
+      if (take > len) take = len;
+      memcpy(_block + _blockLen, data, take);
+      _blockLen += take;
+      data += take;
+      len -= take;
+      if (_blockLen == sizeof(_block)) {
+        compress();
+        _blockLen = 0;
+      }
+    }
+  }
+
+  void finish(uint8_t digest[64]) {
+    uint64_t bitLength = _length * 8;
+    _block[_blockLen++] = 0x80;
+    if (_blockLen > 112) {
+      memset(_block + _blockLen, 0, sizeof(_block) - _blockLen);
+      compress();
+      _blockLen = 0;
+    }
+    memset(_block + _blockLen, 0, 120 - _blockLen);  // Length high word is always 0 here
+    for (int i = 0; i < 8; i++) {
+      _block[120 + i] = (uint8_t)(bitLength >> (56 - i * 8));
+    }
+    compress();
+    for (int i = 0; i < 64; i++) {
+      digest[i] = (uint8_t)(_state[i / 8] >> (56 - (i % 8) * 8));
+    }
+  }
+
+private:
+  static uint64_t rotr(uint64_t x, unsigned n) {
+    return (x >> n) | (x << (64 - n));
+  }
+
+  void compress() {
+    uint64_t w[16];
+    for (int i = 0; i < 16; i++) {
+      w[i] = 0;
+      for (int j = 0; j < 8; j++) {
+        w[i] = (w[i] << 8) | _block[i * 8 + j];
+      }
+    }
+
+    uint64_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+    uint64_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+    for (int i = 0; i < 80; i++) {
+      uint64_t wi;
+      if (i < 16) {
+        wi = w[i];
+      } else {
+        uint64_t w15 = w[(i + 1) & 15];
+        uint64_t w2 = w[(i + 14) & 15];
+        uint64_t s0 = rotr(w15, 1) ^ rotr(w15, 8) ^ (w15 >> 7);
+        uint64_t s1 = rotr(w2, 19) ^ rotr(w2, 61) ^ (w2 >> 6);
+        wi = w[i & 15] = w[i & 15] + s0 + w[(i + 9) & 15] + s1;
+      }
+      uint64_t t1 = h + (rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41)) + ((e & f) ^ (~e & g)) +
+                    kSha512Rounds[i] + wi;
+      uint64_t t2 = (rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+    _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+    _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+  }
+
+  uint64_t _state[8];
+  uint64_t _length;
+  uint8_t _block[128];
+  size_t _blockLen;
+};
+
+}  // namespace
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Field arithmetic mod p = 2^255 - 19
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+// Limb i holds bits [ceil(25.5 * i), ceil(25.5 * (i + 1))): 26 bits for even
+// i, 25 for odd. Every operation returns limbs carried to within half their
+// width, which keeps products of two operands (times 2 * 19) inside int64.
+struct Fe {
+  int32_t v[10];
+};
+
+static const uint8_t kLimbBits[10] = {26, 25, 26, 25, 26, 25, 26, 25, 26, 25};
+static const uint8_t kLimbShift[10] = {0, 26, 51, 77, 102, 128, 153, 179, 204, 230};
+
+// Carry each limb into [-2^(bits-1), 2^(bits-1)); 2^255 wraps to 19
+static void feCarry(Fe& h, int64_t t[10]) {
+  for (int i = 0; i < 10; i++) {
+    int bits = kLimbBits[i];
+    int64_t c = (t[i] + ((int64_t)1 << (bits - 1))) >> bits;
+    t[i] -= c * ((int64_t)1 << bits);
+    if (i < 9) {
+      t[i + 1] += c;
+    } else {
+      t[0] += c * 19;
+    }
+  }
+  int64_t c = (t[0] + ((int64_t)1 << 25)) >> 26;
+  t[0] -= c * ((int64_t)1 << 26);
+  t[1] += c;
+  for (int i = 0; i < 10; i++) {
+    h.v[i] = (int32_t)t[i];
+  }
+}
+
+static void feSet(Fe& h, int32_t value) {
+  memset(&h, 0, sizeof(h));
+  h.v[0] = value;
+}
+
+static void feAdd(Fe& h, const Fe& f, const Fe& g) {
+  int64_t t[10];
+  for (int i = 0; i < 10; i++) t[i] = (int64_t)f.v[i] + g.v[i];
+  feCarry(h, t);
+}
+
+static void feSub(Fe& h, const Fe& f, const Fe& g) {
+  int64_t t[10];
+  for (int i = 0; i < 10; i++) t[i] = (int64_t)f.v[i] - g.v[i];
+  feCarry(h, t);
+}
+
+static void feNeg(Fe& h, const Fe& f) {
+  for (int i = 0; i < 10; i++) h.v[i] = -f.v[i];
+}
+
+static void feMul(Fe& h, const Fe& f, const Fe& g) {
+  // Odd limbs sit half a bit above their nominal position, so odd * odd
+  // counts twice; wrapping past limb 9 multiplies by 19
+  int32_t g19[10];
+  for (int i = 0; i < 10; i++) {
+    g19[i] = g.v[i] * 19;
+  }
+  int64_t t[10] = {0};
+  for (int i = 0; i < 10; i++) {
+    int32_t fi = f.v[i];
+    int32_t fi2 = (i & 1) ? fi * 2 : fi;
+    for (int j = 0; j < 10; j++) {
+      int32_t a = (j & 1) ? fi2 : fi;
+      int32_t b = (i + j < 10) ? g.v[j] : g19[j];
+      t[(i + j) % 10] += (int64_t)a * b;
+    }
+  }
+  feCarry(h, t);
+}
+
+static void feSq(Fe& h, const Fe& f) {
+  int64_t t[10] = {0};
+  for (int i = 0; i < 10; i++) {
+    for (int j = i; j < 10; j++) {
+      int32_t a = f.v[i] * ((i == j) ? 1 : 2) * ((i & j & 1) ? 2 : 1);
+      int32_t b = (i + j < 10) ? f.v[j] : f.v[j] * 19;
+      t[(i + j) % 10] += (int64_t)a * b;
+    }
+  }
+  feCarry(h, t);
+}
+
+static void feSqTimes(Fe& h, const Fe& f, int n) {
+  feSq(h, f);
+  while (--n > 0) feSq(h, h);
+}
+
+// 255-bit little-endian value; the top bit is ignored
+static void feFromBytes(Fe& h, const uint8_t s[32]) {
+  int64_t t[10];
+  for (int i = 0; i < 10; i++) {
+    int shift = kLimbShift[i];
+    uint64_t word = 0;
+    for (int k = 0; k < 5 && shift / 8 + k < 32; k++) {
+      word |= (uint64_t)s[shift / 8 + k] << (8 * k);
+    }
+    word >>= shift % 8;
+    t[i] = (int64_t)(word & ((1u << kLimbBits[i]) - 1));
+  }
+  feCarry(h, t);
+}
+
+// Canonical encoding (fully reduced mod p)
+static void feToBytes(uint8_t s[32], const Fe& f) {
+  int64_t t[10];
+  for (int i = 0; i < 10; i++) t[i] = f.v[i];
+  // Floor carries until every limb is in [0, 2^bits) and the value < 2^255
+  int64_t top;
+  do {
+    for (int i = 0; i < 9; i++) {
+      int64_t c = t[i] >> kLimbBits[i];
+      t[i] -= c * ((int64_t)1 << kLimbBits[i]);
+      t[i + 1] += c;
+    }
+    top = t[9] >> 25;
+    t[9] -= top * ((int64_t)1 << 25);
+    t[0] += top * 19;
+  } while (top != 0);
+  uint64_t acc = 0;
+  int accBits = 0;
+  int pos = 0;
+  for (int i = 0; i < 10; i++) {
+    acc |= (uint64_t)t[i] << accBits;
+    accBits += kLimbBits[i];
+    while (accBits >= 8) {
+      s[pos++] = (uint8_t)acc;
+      acc >>= 8;
+      accBits -= 8;
+    }
+  }
+  s[31] = (uint8_t)acc;
+
+  // Subtract p if value + 19 reaches 2^255
+  uint8_t reduced[32];
+  unsigned carry = 19;
+  for (int i = 0; i < 32; i++) {
+    carry += s[i];
+    reduced[i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+  if (reduced[31] & 0x80) {
+    reduced[31] &= 0x7f;
+    memcpy(s, reduced, 32);
+  }
+}
+
+static bool feIsZero(const Fe& f) {
+  uint8_t s[32];
+  feToBytes(s, f);
+  uint8_t any = 0;
+  for (int i = 0; i < 32; i++) any |= s[i];
+  return any == 0;
+}
+
+static bool feIsNegative(const Fe& f) {
+  uint8_t s[32];
+  feToBytes(s, f);
+  return s[0] & 1;
+}
+
+// z^(2^250 - 1), shared by inversion and square roots
+static void fePow250(Fe& out, Fe& z11, const Fe& z) {
+  Fe z2, z9, t, z5, z10, z20, z50, z100;
+  feSq(z2, z);
+  feSqTimes(t, z2, 2);
+  feMul(z9, t, z);
+  feMul(z11, z9, z2);
+  feSq(t, z11);
+  feMul(z5, t, z9);          // 2^5 - 1
+  feSqTimes(t, z5, 5);
+  feMul(z10, t, z5);         // 2^10 - 1
+  feSqTimes(t, z10, 10);
+  feMul(z20, t, z10);        // 2^20 - 1
+  feSqTimes(t, z20, 20);
+  feMul(t, t, z20);          // 2^40 - 1
+  feSqTimes(t, t, 10);
+  feMul(z50, t, z10);        // 2^50 - 1
+  feSqTimes(t, z50, 50);
+  feMul(z100, t, z50);       // 2^100 - 1
+  feSqTimes(t, z100, 100);
+  feMul(t, t, z100);         // 2^200 - 1
+  feSqTimes(t, t, 50);
+  feMul(out, t, z50);        // 2^250 - 1
+}
+
+// z^(p - 2) = 1 / z
+static void feInvert(Fe& out, const Fe& z) {
+  Fe t, z11;
+  fePow250(t, z11, z);
+  feSqTimes(t, t, 5);
+  feMul(out, t, z11);
+}
+
+// z^((p - 5) / 8)
+static void fePow22523(Fe& out, const Fe& z) {
+  Fe t, z11;
+  fePow250(t, z11, z);
+  feSqTimes(t, t, 2);
+  feMul(out, t, z);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Curve points (extended twisted Edwards coordinates, a = -1)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+struct Ge {
+  Fe x, y, z, t;
+};
+
+// -121665 / 121666, its double, and sqrt(-1)
+static const uint8_t kCurveD[32] = {
+  0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+  0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52
+};
+static const uint8_t kCurveD2[32] = {
+  0x59, 0xf1, 0xb2, 0x26, 0x94, 0x9b, 0xd6, 0xeb, 0x56, 0xb1, 0x83, 0x82, 0x9a, 0x14, 0xe0, 0x00,
+  0x30, 0xd1, 0xf3, 0xee, 0xf2, 0x80, 0x8e, 0x19, 0xe7, 0xfc, 0xdf, 0x56, 0xdc, 0xd9, 0x06, 0x24
+};
+static const uint8_t kSqrtMinusOne[32] = {
+  0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+  0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b
+};
+// Base point, y = 4/5
+static const uint8_t kBasePoint[32] = {
+  0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+  0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
+};
+
+static Fe g_d2;
+
+static void geIdentity(Ge& r) {
+  feSet(r.x, 0);
+  feSet(r.y, 1);
+  feSet(r.z, 1);
+  feSet(r.t, 0);
+}
+
+static void geNeg(Ge& r, const Ge& p) {
+  feNeg(r.x, p.x);
+  r.y = p.y;
+  r.z = p.z;
+  feNeg(r.t, p.t);
+}
+
+static void geAdd(Ge& r, const Ge& p, const Ge& q) {
+  Fe a, b, c, d, e, f, g, h;
+  feSub(a, p.y, p.x);
+  feSub(e, q.y, q.x);
+  feMul(a, a, e);
+  feAdd(b, p.y, p.x);
+  feAdd(e, q.y, q.x);
+  feMul(b, b, e);
+  feMul(c, p.t, q.t);
+  feMul(c, c, g_d2);
+  feMul(d, p.z, q.z);
+  feAdd(d, d, d);
+  feSub(e, b, a);
+  feSub(f, d, c);
+  feAdd(g, d, c);
+  feAdd(h, b, a);
+  feMul(r.x, e, f);
+  feMul(r.y, g, h);
+  feMul(r.t, e, h);
+  feMul(r.z, f, g);
+}
+
+static void geDouble(Ge& r, const Ge& p) {
+  Fe a, b, c, e, f, g, h;
+  feSq(a, p.x);
+  feSq(b, p.y);
+  feSq(c, p.z);
+  feAdd(c, c, c);
+  feAdd(h, a, b);
+  feAdd(e, p.x, p.y);
+  feSq(e, e);
+  feSub(e, h, e);
+  feSub(g, a, b);
+  feAdd(f, c, g);
+  feMul(r.x, e, f);
+  feMul(r.y, g, h);
+  feMul(r.t, e, h);
+  feMul(r.z, f, g);
+}
+
+// RFC 8032 5.1.3: rejects non-canonical y and points off the curve
+static bool geDecode(Ge& r, const uint8_t s[32]) {
+  feFromBytes(r.y, s);
+  uint8_t check[32];
+  feToBytes(check, r.y);
+  check[31] |= s[31] & 0x80;
+  if (memcmp(check, s, 32) != 0) {
+    return false;
+  }
+
+  Fe d, u, v, v3, vx2;
+  feFromBytes(d, kCurveD);
+  feSet(r.z, 1);
+  feSq(u, r.y);
+  feMul(v, u, d);
+  feSub(u, u, r.z);          // y^2 - 1
+  feAdd(v, v, r.z);          // d y^2 + 1
+
+  // x = u v^3 (u v^7)^((p - 5) / 8)
+  feSq(v3, v);
+  feMul(v3, v3, v);
+  feSq(r.x, v3);
+  feMul(r.x, r.x, v);
+  feMul(r.x, r.x, u);
+  fePow22523(r.x, r.x);
+  feMul(r.x, r.x, v3);
+  feMul(r.x, r.x, u);
+
+  feSq(vx2, r.x);
+  feMul(vx2, vx2, v);
+  Fe diff;
+  feSub(diff, vx2, u);
+  if (!feIsZero(diff)) {
+    feAdd(diff, vx2, u);
+    if (!feIsZero(diff)) {
+      return false;
+    }
+    Fe sqrtMinusOne;
+    feFromBytes(sqrtMinusOne, kSqrtMinusOne);
+    feMul(r.x, r.x, sqrtMinusOne);
+  }
+
+  int sign = s[31] >> 7;
+  if (sign && feIsZero(r.x)) {
+    return false;
+  }
+  if (feIsNegative(r.x) != (sign != 0)) {
+    feNeg(r.x, r.x);
+  }
+  feMul(r.t, r.x, r.y);
+  return true;
+}
+
+static void geEncode(uint8_t s[32], const Ge& p) {
+  Fe zInv, x, y;
+  feInvert(zInv, p.z);
+  feMul(x, p.x, zInv);
+  feMul(y, p.y, zInv);
+  feToBytes(s, y);
+  s[31] ^= (uint8_t)(feIsNegative(x) << 7);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+static const uint8_t kOrder[32] = {
+  0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+static bool scalarIsCanonical(const uint8_t s[32]) {
+  for (int i = 31; i >= 0; i--) {
+    if (s[i] != kOrder[i]) return s[i] < kOrder[i];
+  }
+  return false;  // s == L
+}
+
+// Reduce a 512-bit little-endian value mod L (byte-wise, signed carries)
+static void scalarReduce(uint8_t out[32], const uint8_t in[64]) {
+  int64_t x[64];
+  for (int i = 0; i < 64; i++) x[i] = in[i];
+
+  // Fold bytes 63..32 down using 2^256 = -16 * (L - 2^252) mod L
+  for (int i = 63; i >= 32; i--) {
+    int64_t carry = 0;
+    int j;
+    for (j = i - 32; j < i - 12; j++) {
+      x[j] += carry - 16 * x[i] * kOrder[j - (i - 32)];
+      carry = (x[j] + 128) >> 8;
+      x[j] -= carry * 256;
+    }
+    x[j] += carry;
+    x[i] = 0;
+  }
+  int64_t carry = 0;
+  for (int j = 0; j < 32; j++) {
+    x[j] += carry - (x[31] >> 4) * kOrder[j];
+    carry = x[j] >> 8;
+    x[j] &= 255;
+  }
+  for (int j = 0; j < 32; j++) {
+    x[j] -= carry * kOrder[j];
+  }
+  for (int i = 0; i < 32; i++) {
+    x[i + 1] += x[i] >> 8;
+    out[i] = (uint8_t)(x[i] & 255);
+  }
+}
+
+// Signed sliding-window digits: each non-zero digit is odd and in [-15, 15]
+static void scalarSlide(int8_t r[256], const uint8_t a[32]) {
+  for (int i = 0; i < 256; i++) {
+    r[i] = (int8_t)((a[i >> 3] >> (i & 7)) & 1);
+  }
+  for (int i = 0; i < 256; i++) {
+    if (!r[i]) continue;
+    for (int b = 1; b <= 6 && i + b < 256; b++) {
+      if (!r[i + b]) continue;
+      if (r[i] + (r[i + b] << b) <= 15) {
+        r[i] = (int8_t)(r[i] + (r[i + b] << b));
+        r[i + b] = 0;
+      } else if (r[i] - (r[i + b] << b) >= -15) {
+        r[i] = (int8_t)(r[i] - (r[i + b] << b));
+        for (int k = i + b; k < 256; k++) {
+          if (!r[k]) {
+            r[k] = 1;
+            break;
+          }
+          r[k] = 0;
+        }
+      } else {
+        break;
+      }
+    }
+  }
+}
+
+// table[i] = (2i + 1) * p
+static void geOddMultiples(Ge table[8], const Ge& p) {
+  Ge p2;
+  geDouble(p2, p);
+  table[0] = p;
+  for (int i = 1; i < 8; i++) {
+    geAdd(table[i], table[i - 1], p2);
+  }
+}
+
+static void geAddDigit(Ge& r, const Ge table[8], int8_t digit) {
+  if (digit > 0) {
+    geAdd(r, r, table[digit / 2]);
+  } else if (digit < 0) {
+    Ge neg;
+    geNeg(neg, table[-digit / 2]);
+    geAdd(r, r, neg);
+  }
+}
+
+static Ge g_baseMultiples[8];
+static bool g_baseReady = false;
+
+bool otaEd25519Verify(const uint8_t signature[OTA_ED25519_SIGNATURE_SIZE],
+                      const uint8_t* message, size_t len,
+                      const uint8_t publicKey[OTA_ED25519_KEY_SIZE]) {
+  const uint8_t* sigR = signature;
+  const uint8_t* sigS = signature + 32;
+  if (!scalarIsCanonical(sigS)) {
+    return false;
+  }
+
+  if (!g_baseReady) {
+    feFromBytes(g_d2, kCurveD2);
+    Ge base;
+    geDecode(base, kBasePoint);
+    geOddMultiples(g_baseMultiples, base);
+    g_baseReady = true;
+  }
+
+  Ge a;
+  if (!geDecode(a, publicKey)) {
+    return false;
+  }
+  geNeg(a, a);
+
+  // h = SHA-512(R || A || M) mod L
+  uint8_t digest[64];
+  uint8_t h[32];
+  Sha512 sha;
+  sha.update(sigR, 32);
+  sha.update(publicKey, 32);
+  sha.update(message, len);
+  sha.finish(digest);
+  scalarReduce(h, digest);
+
+  // R' = [S]B + [h](-A), both scalars walked in one ladder
+  int8_t hDigits[256], sDigits[256];
+  scalarSlide(hDigits, h);
+  scalarSlide(sDigits, sigS);
+  Ge aMultiples[8];
+  geOddMultiples(aMultiples, a);
+
+  int i = 255;
+  while (i >= 0 && !hDigits[i] && !sDigits[i]) i--;
+  Ge r;
+  geIdentity(r);
+  for (; i >= 0; i--) {
+    geDouble(r, r);
+    geAddDigit(r, aMultiples, hDigits[i]);
+    geAddDigit(r, g_baseMultiples, sDigits[i]);
+  }
+
+  uint8_t encoded[32];
+  geEncode(encoded, r);
+  return memcmp(encoded, sigR, 32) == 0;
+}
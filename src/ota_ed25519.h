@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ed25519 signature verification (RFC 8032), verify only.
+//
+// Field elements use ten signed 25/26-bit limbs so every product fits a
+// 32x32->64 multiply; the check [S]B - [h]A == R is done with one
+// interleaved sliding-window ladder (about 253 doublings and 90 additions).
+// The odd multiples of the base point are computed on first use and kept
+// (1.3 KB of RAM); a verification needs about 2 KB of stack. Not for
+// concurrent use. Plain C++ (no Arduino headers).
+
+static const size_t OTA_ED25519_KEY_SIZE = 32;
+static const size_t OTA_ED25519_SIGNATURE_SIZE = 64;
+
+// True if signature is a valid signature of message under publicKey
+bool otaEd25519Verify(const uint8_t signature[OTA_ED25519_SIGNATURE_SIZE],
+                      const uint8_t* message, size_t len,
+                      const uint8_t publicKey[OTA_ED25519_KEY_SIZE]);
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_image_check.h"
+
+#include <string.h>
+
+// RP2040 / RP2350 memory map
+static const uint32_t kXipBase = 0x10000000;
+static const uint32_t kSramBase = 0x20000000;
+static const uint32_t kRp2040SramEnd = 0x20042000;
+static const uint32_t kRp2350SramEnd = 0x20082000;
+static const uint32_t kRp2040XipSize = 0x01000000;  // 16 MB
+static const uint32_t kRp2350XipSize = 0x02000000;  // Two 16 MB chip selects
+
+// RP2040 second stage bootloader: 252 bytes of code, then their CRC
+static const size_t kBoot2Size = 256;
+
+// RP2350 picobin block (RP2350 datasheet, "Block Format")
+static const uint32_t kBlockStart = 0xffffded3;
+static const uint32_t kBlockEnd = 0xab123579;
+static const uint8_t kItemImageType = 0x42;
+static const uint8_t kItemLast = 0xff;
+static const uint16_t kImageTypeExe = 0x0001;
+
+// ESP-IDF esp_image_header_t
+static const uint8_t kEspMagic = 0xE9;
+static const size_t kEspHeaderSize = 24;
+static const uint8_t kEspMaxSegments = 16;
+
+static uint32_t le32(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t* p) {
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+// CRC-32/MPEG-2 (not reflected, no final XOR), as the RP2040 boot ROM checks boot2
+static uint32_t crc32Mpeg2(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint32_t)data[i] << 24;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static bool parseEsp(const uint8_t* data, size_t len, OtaImageInfo& info) {
+  if (len < kEspHeaderSize || data[0] != kEspMagic) return false;
+  uint8_t segments = data[1];
+  uint8_t spiMode = data[2];
+  uint8_t flashSize = data[3] >> 4;
+  if (segments == 0 || segments > kEspMaxSegments || spiMode > 5 || flashSize > 7) return false;
+  info.kind = OTA_IMAGE_KIND_ESP;
+  info.flashSize = (uint32_t)1 << (20 + flashSize);  // 1 MB ... 128 MB
+  info.entry = le32(data + 4);
+  info.espChipId = le16(data + 12);
+  // IDF 5 stores major * 100 + minor; older images only the major revision
+  info.espMinRevision = le16(data + 15);
+  if (info.espMinRevision == 0) info.espMinRevision = (uint16_t)(data[14] * 100);
+  uint16_t maxRevision = le16(data + 17);
+  info.espMaxRevision = maxRevision == 0xFFFF ? 0 : maxRevision;
+  return true;
+}
+
+// IMAGE_TYPE flags of the first complete picobin block in data, -1 if none
+static int32_t findImageType(const uint8_t* data, size_t len) {
+  for (size_t at = 0; at + 4 <= len; at += 4) {
+    if (le32(data + at) != kBlockStart) continue;
+    int32_t flags = -1;
+    size_t pos = at + 4;
+    while (pos + 4 <= len) {
+      uint8_t type = data[pos];
+      size_t words = (type & 0x80) ? le16(data + pos + 1) : data[pos + 1];
+      if (type == kItemLast) {
+        // Size of the items before it, then the link to the next block and the end marker
+        if (words * 4 == pos - at - 4 && pos + 12 <= len && le32(data + pos + 8) == kBlockEnd) {
+          return flags;
+        }
+        break;
+      }
+      if (words == 0) break;
+      if (type == kItemImageType) flags = le16(data + pos + 2);
+      pos += words * 4;
+    }
+  }
+  return -1;
+}
+
+OtaImageCheckError otaImageCheck(const uint8_t* data, size_t len, uint32_t imageSize,
+                                 const OtaImageTarget& target, OtaImageInfo* info) {
+  OtaImageInfo local;
+  if (!info) info = &local;
+  memset(info, 0, sizeof(*info));
+
+  size_t vectors = 0;
+  bool arm = false;
+  if (!parseEsp(data, len, *info)) {
+    int32_t flags = findImageType(data, len);
+    if (flags >= 0 && ((flags >> 12) & 0x7) == 1) {
+      if ((flags & 0xF) != kImageTypeExe) return OTA_IMAGE_CHECK_ERR_FORMAT;
+      info->kind = OTA_IMAGE_KIND_RP2350;
+      arm = ((flags >> 8) & 0x7) == 0;  // Else RISC-V: no vector table at the start
+    } else if (len >= kBoot2Size && crc32Mpeg2(data, kBoot2Size - 4) == le32(data + kBoot2Size - 4)) {
+      info->kind = OTA_IMAGE_KIND_RP2040;
+      vectors = kBoot2Size;
+      arm = true;
+    } else {
+      return OTA_IMAGE_CHECK_ERR_FORMAT;
+    }
+  }
+
+  if (arm) {
+    if (len < vectors + 8) return OTA_IMAGE_CHECK_ERR_FORMAT;
+    info->stackPointer = le32(data + vectors);
+    info->entry = le32(data + vectors + 4);
+    bool rp2040 = info->kind == OTA_IMAGE_KIND_RP2040;
+    uint32_t sramEnd = rp2040 ? kRp2040SramEnd : kRp2350SramEnd;
+    uint32_t xipSize = rp2040 ? kRp2040XipSize : kRp2350XipSize;
+    if (info->stackPointer <= kSramBase || info->stackPointer > sramEnd ||
+        (info->entry & 1) == 0 || info->entry < kXipBase || info->entry - kXipBase >= xipSize) {
+      return OTA_IMAGE_CHECK_ERR_FORMAT;
+    }
+  }
+
+  if (info->kind != target.kind ||
+      (info->kind == OTA_IMAGE_KIND_ESP && info->espChipId != target.espChipId)) {
+    return OTA_IMAGE_CHECK_ERR_CHIP;
+  }
+  if (info->kind == OTA_IMAGE_KIND_ESP &&
+      (target.espChipRevision < info->espMinRevision ||
+       (info->espMaxRevision != 0 && target.espChipRevision > info->espMaxRevision))) {
+    return OTA_IMAGE_CHECK_ERR_REVISION;
+  }
+  if (target.flashSize && info->flashSize > target.flashSize) {
+    return OTA_IMAGE_CHECK_ERR_FLASH;
+  }
+  if (arm && target.maxImageSize && info->entry - kXipBase >= target.maxImageSize) {
+    return OTA_IMAGE_CHECK_ERR_FLASH;  // Would start in what is LittleFS here
+  }
+  if (imageSize && target.maxImageSize && imageSize > target.maxImageSize) {
+    return OTA_IMAGE_CHECK_ERR_SIZE;
+  }
+  return OTA_IMAGE_CHECK_OK;
+}
+
+const char* otaImageChipName(OtaImageKind kind, uint16_t espChipId) {
+  switch (kind) {
+    case OTA_IMAGE_KIND_RP2040: return "RP2040";
+    case OTA_IMAGE_KIND_RP2350: return "RP2350";
+    case OTA_IMAGE_KIND_ESP: break;
+    default: return "unknown";
+  }
+  switch (espChipId) {  // esp_chip_id_t
+    case 0x0000: return "ESP32";
+    case 0x0002: return "ESP32-S2";
+    case 0x0005: return "ESP32-C3";
+    case 0x0009: return "ESP32-S3";
+    case 0x000C: return "ESP32-C2";
+    case 0x000D: return "ESP32-C6";
+    case 0x0010: return "ESP32-H2";
+    case 0x0012: return "ESP32-P4";
+    case 0x0014: return "ESP32-C61";
+    case 0x0017: return "ESP32-C5";
+    default: return "ESP (unknown chip)";
+  }
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Pre-flight check of a firmware image from its first bytes, so an image
+// for another board is turned away before anything is erased or staged:
+//
+//   RP2040 (Pico W)      256-byte boot2 ending in its CRC-32/MPEG-2, then
+//                        the vector table: stack in SRAM, reset handler in
+//                        the sketch area
+//   RP2350 (Pico 2 W)    picobin IMAGE_DEF block naming an RP2350
+//                        executable (the SDK places it right after the
+//                        vector table), and for Arm images the vector table
+//   ESP32 family         esp_image_header_t: magic 0xE9, chip ID, chip
+//                        revision range and the flash size it was built for
+//
+// The image size, when known, must fit where the image is installed (the
+// sketch area before LittleFS, or the OTA partition). extras/ota_image_check.py
+// implements the same checks on .bin files and carries a corpus of real
+// and malformed headers, which the host tests also run through this code.
+// Plain C++ (no Arduino headers).
+
+static const size_t OTA_IMAGE_CHECK_MIN_BYTES = 264;  // RP2040: boot2 + stack pointer + reset vector
+
+enum OtaImageKind : uint8_t {
+  OTA_IMAGE_KIND_UNKNOWN = 0,
+  OTA_IMAGE_KIND_RP2040,
+  OTA_IMAGE_KIND_RP2350,
+  OTA_IMAGE_KIND_ESP          // ESP-IDF app image, chip in espChipId
+};
+
+enum OtaImageCheckError {
+  OTA_IMAGE_CHECK_OK = 0,
+  OTA_IMAGE_CHECK_ERR_FORMAT,    // Not a firmware image of a known kind
+  OTA_IMAGE_CHECK_ERR_CHIP,      // Firmware for another chip
+  OTA_IMAGE_CHECK_ERR_REVISION,  // ESP: not built for this chip revision
+  OTA_IMAGE_CHECK_ERR_FLASH,     // Built for more flash, or entry point outside the sketch area
+  OTA_IMAGE_CHECK_ERR_SIZE       // Larger than the space it is installed to
+};
+
+// The running device
+struct OtaImageTarget {
+  OtaImageKind kind;
+  uint16_t espChipId;        // ESP: CONFIG_IDF_FIRMWARE_CHIP_ID
+  uint16_t espChipRevision;  // ESP: major * 100 + minor
+  uint32_t flashSize;        // Bytes of flash, 0 = not checked
+  uint32_t maxImageSize;     // Sketch area / OTA partition, 0 = not checked
+};
+
+// What the header says
+struct OtaImageInfo {
+  OtaImageKind kind;
+  uint16_t espChipId;
+  uint16_t espMinRevision;   // major * 100 + minor
+  uint16_t espMaxRevision;   // 0 = no upper bound
+  uint32_t flashSize;        // ESP: flash size in the header, else 0
+  uint32_t stackPointer;     // Arm images: initial SP, else 0
+  uint32_t entry;            // Arm images: reset handler, ESP: entry address
+};
+
+// Check the first len bytes of an image of imageSize bytes (0 = unknown)
+// against target. len should be at least OTA_IMAGE_CHECK_MIN_BYTES unless
+// the image is shorter; the RP2350 IMAGE_DEF block must lie within it.
+// info (optional) is filled in as far as the header was understood.
+OtaImageCheckError otaImageCheck(const uint8_t* data, size_t len, uint32_t imageSize,
+                                 const OtaImageTarget& target, OtaImageInfo* info);
+
+// "RP2040", "RP2350", "ESP32-S3", ...
+const char* otaImageChipName(OtaImageKind kind, uint16_t espChipId);
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_lzss.h"
+
+#include <string.h>
+
+bool OtaLzssDecoder::isCompressed(const uint8_t* data, size_t len) {
+  return len >= 4 && memcmp(data, "OTAZ", 4) == 0;
+}
+
+OtaLzssDecoder::OtaLzssDecoder() {
+  begin(nullptr, nullptr);
+}
+
+void OtaLzssDecoder::begin(OtaLzssWriteFn write, void* context) {
+  _write = write;
+  _context = context;
+  _state = STATE_HEADER;
+  _error = OTA_LZSS_ERR_NONE;
+  _framed = true;
+  _headerLen = 0;
+  _windowBits = 0;
+  _lookaheadBits = 0;
+  _mask = 0;
+  _bits = 0;
+  _bitCount = 0;
+  _index = 0;
+  _head = 0;
+  _flushed = 0;
+  _pending = 0;
+  _produced = 0;
+  _outputSize = 0;
+}
+
+bool OtaLzssDecoder::beginRaw(uint8_t windowBits, uint8_t lookaheadBits, OtaLzssWriteFn write, void* context) {
+  begin(write, context);
+  _framed = false;
+  return configure(windowBits, lookaheadBits);
+}
+
+bool OtaLzssDecoder::fail(OtaLzssError error) {
+  _error = error;
+  _state = STATE_ERROR;
+  return false;
+}
+
+bool OtaLzssDecoder::configure(uint8_t windowBits, uint8_t lookaheadBits) {
+  if (windowBits < 4 || windowBits > OTA_LZSS_MAX_WINDOW_BITS ||
+      lookaheadBits < 3 || lookaheadBits >= windowBits) {
+    return fail(OTA_LZSS_ERR_PARAMS);
+  }
+  _windowBits = windowBits;
+  _lookaheadBits = lookaheadBits;
+  _mask = (uint16_t)((1u << windowBits) - 1);
+  memset(_window, 0, (size_t)_mask + 1);  // heatshrink decoders start from a zeroed window
+  _state = STATE_TAG;
+  return true;
+}
+
+bool OtaLzssDecoder::parseHeader() {
+  if (!isCompressed(_header, _headerLen) || _header[4] != 1) {
+    return fail(OTA_LZSS_ERR_HEADER);
+  }
+  _outputSize = (uint32_t)_header[8] | ((uint32_t)_header[9] << 8) |
+                ((uint32_t)_header[10] << 16) | ((uint32_t)_header[11] << 24);
+  if (!configure(_header[5], _header[6])) {
+    return false;
+  }
+  if (_outputSize == 0) {
+    _state = STATE_DONE;
+  }
+  return true;
+}
+
+// Hand the decoded bytes since the last flush to the writer
+bool OtaLzssDecoder::flush() {
+  if (_pending == 0) return true;
+  if (!_write || !_write(_window + _flushed, _pending, _context)) {
+    return fail(OTA_LZSS_ERR_WRITE);
+  }
+  _flushed = _head;
+  _pending = 0;
+  return true;
+}
+
+bool OtaLzssDecoder::put(uint8_t byte) {
+  if (_framed && _produced >= _outputSize) {
+    return fail(OTA_LZSS_ERR_CORRUPT);
+  }
+  _window[_head] = byte;
+  _head = (uint16_t)((_head + 1) & _mask);
+  _pending++;
+  _produced++;
+  if (_head == 0) {
+    return flush();  // Window wrapped: older bytes are about to be overwritten
+  }
+  return true;
+}
+
+// Decode as many tokens as the buffered bits allow
+bool OtaLzssDecoder::decodeBits() {
+  for (;;) {
+    switch (_state) {
+      case STATE_TAG:
+        if (_bitCount < 1) return true;
+        _bitCount--;
+        _state = ((_bits >> _bitCount) & 1) ? STATE_LITERAL : STATE_INDEX;
+        break;
+
+      case STATE_LITERAL:
+        if (_bitCount < 8) return true;
+        _bitCount -= 8;
+        if (!put((uint8_t)(_bits >> _bitCount))) return false;
+        _state = STATE_TAG;
+        break;
+
+      case STATE_INDEX:
+        if (_bitCount < _windowBits) return true;
+        _bitCount -= _windowBits;
+        _index = (uint16_t)((_bits >> _bitCount) & _mask);
+        _state = STATE_COUNT;
+        break;
+
+      case STATE_COUNT: {
+        if (_bitCount < _lookaheadBits) return true;
+        _bitCount -= _lookaheadBits;
+        uint16_t count = (uint16_t)(((_bits >> _bitCount) & ((1u << _lookaheadBits) - 1)) + 1);
+        uint16_t from = (uint16_t)((_head - _index - 1) & _mask);
+        for (uint16_t i = 0; i < count; i++) {
+          if (!put(_window[from])) return false;
+          from = (uint16_t)((from + 1) & _mask);
+        }
+        _state = STATE_TAG;
+        break;
+      }
+
+      default:
+        return true;
+    }
+
+    if (_framed && _produced == _outputSize) {
+      _state = STATE_DONE;  // Remaining bits are padding
+      return flush();
+    }
+  }
+}
+
+bool OtaLzssDecoder::feed(const uint8_t* data, size_t len) {
+  size_t i = 0;
+
+  if (_state == STATE_HEADER) {
+    size_t take = kHeaderSize - _headerLen;
+    if (take > len) take = len;
+    memcpy(_header + _headerLen, data, take);
+    _headerLen += (uint8_t)take;
+    i = take;
+    if (_headerLen < kHeaderSize) return true;
+    if (!parseHeader()) return false;
+  }
+
+  for (; i < len; i++) {
+    if (_state == STATE_DONE) {
+      return fail(OTA_LZSS_ERR_CORRUPT);  // Input after the announced size
+    }
+    if (_state == STATE_ERROR) {
+      return false;
+    }
+    _bits = (_bits << 8) | data[i];
+    _bitCount += 8;
+    if (!decodeBits()) return false;
+  }
+
+  if (_state == STATE_ERROR) return false;
+  return _state == STATE_DONE || flush();
+}
+
+bool OtaLzssDecoder::finish() {
+  if (_state == STATE_ERROR) return false;
+  if (_framed && _state != STATE_DONE) {
+    return fail(OTA_LZSS_ERR_CORRUPT);
+  }
+  if (!flush()) return false;
+  _state = STATE_DONE;
+  return true;
+}
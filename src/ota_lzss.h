@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming decoder for compressed firmware images.
+//
+// The bit stream is heatshrink's LZSS encoding (MSB first):
+//   1 + 8 bits                 literal byte
+//   0 + W bits + L bits        copy (L + 1) bytes from (W + 1) bytes back
+// where W is the window size in bits and L the lookahead size in bits.
+// Files made by extras/ota_compress.py carry a 12-byte header:
+//
+//   "OTAZ"   magic
+//   u8       format version (1)
+//   u8       W (window bits, 4..OTA_LZSS_MAX_WINDOW_BITS)
+//   u8       L (lookahead bits, 3..W-1)
+//   u8       reserved, 0
+//   u32      decompressed size, little endian
+//
+// A bare stream (HTTP "Content-Encoding: heatshrink") is decoded with
+// kDefaultWindowBits / kDefaultLookaheadBits and ends with the input.
+//
+// Output is produced in place in the window buffer and handed to the write
+// callback in contiguous runs, so the window is the only buffer. Plain C++
+// (no Arduino headers).
+
+#ifndef OTA_LZSS_MAX_WINDOW_BITS
+#define OTA_LZSS_MAX_WINDOW_BITS 12  // 4 KB window
+#endif
+
+enum OtaLzssError {
+  OTA_LZSS_ERR_NONE = 0,
+  OTA_LZSS_ERR_HEADER,      // Bad magic or unsupported version
+  OTA_LZSS_ERR_PARAMS,      // Window larger than OTA_LZSS_MAX_WINDOW_BITS
+  OTA_LZSS_ERR_CORRUPT,     // More output than the header announced, or truncated input
+  OTA_LZSS_ERR_WRITE        // Output callback failed
+};
+
+// Consume len decompressed bytes (called in order)
+typedef bool (*OtaLzssWriteFn)(const uint8_t* data, size_t len, void* context);
+
+class OtaLzssDecoder {
+public:
+  static const size_t kHeaderSize = 12;
+  static const uint8_t kDefaultWindowBits = 11;
+  static const uint8_t kDefaultLookaheadBits = 4;
+
+  // True if data starts with the header magic (needs at least 4 bytes)
+  static bool isCompressed(const uint8_t* data, size_t len);
+
+  OtaLzssDecoder();
+
+  // Framed stream: parameters and size come from the header
+  void begin(OtaLzssWriteFn write, void* context);
+  // Bare stream with known parameters and unknown size
+  bool beginRaw(uint8_t windowBits, uint8_t lookaheadBits, OtaLzssWriteFn write, void* context);
+
+  // Feed the next piece of compressed input. Returns false on error.
+  bool feed(const uint8_t* data, size_t len);
+  // End of input. Returns false if a framed stream is incomplete.
+  bool finish();
+
+  bool done() const { return _state == STATE_DONE; }
+  OtaLzssError error() const { return _error; }
+  bool sizeKnown() const { return _framed && _state > STATE_HEADER; }
+  uint32_t outputSize() const { return _outputSize; }  // Framed streams only
+  uint32_t produced() const { return _produced; }
+
+private:
+  enum State : uint8_t {
+    STATE_HEADER,
+    STATE_TAG,
+    STATE_LITERAL,
+    STATE_INDEX,
+    STATE_COUNT,
+    STATE_DONE,
+    STATE_ERROR
+  };
+
+  bool fail(OtaLzssError error);
+  bool configure(uint8_t windowBits, uint8_t lookaheadBits);
+  bool parseHeader();
+  bool decodeBits();
+  bool put(uint8_t byte);
+  bool flush();
+
+  OtaLzssWriteFn _write;
+  void* _context;
+
+  uint8_t _state;
+  OtaLzssError _error;
+  bool _framed;
+
+  uint8_t _header[kHeaderSize];
+  uint8_t _headerLen;
+
+  uint8_t _windowBits;
+  uint8_t _lookaheadBits;
+  uint16_t _mask;           // Window size - 1
+
+  uint32_t _bits;           // Unconsumed input bits, right aligned
+  uint8_t _bitCount;
+  uint16_t _index;          // Back-reference distance - 1 of the token being decoded
+
+  uint16_t _head;           // Next write position in the window
+  uint16_t _flushed;        // Start of the bytes not yet passed to _write
+  uint16_t _pending;        // Number of those bytes (never wraps past the window end)
+  uint32_t _produced;
+  uint32_t _outputSize;
+
+  uint8_t _window[1u << OTA_LZSS_MAX_WINDOW_BITS];
+};
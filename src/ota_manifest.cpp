@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_manifest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char kManifestMagic[] = "pico-ota-manifest v1\n";
+static const char kSignatureKey[] = "signature=";
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Start of the line beginning with key, or nullptr
+static const char* findLine(const char* text, size_t len, const char* key) {
+  size_t keyLen = strlen(key);
+  for (size_t i = 0; i + keyLen <= len; i++) {
+    if ((i == 0 || text[i - 1] == '\n') && memcmp(text + i, key, keyLen) == 0) {
+      return text + i;
+    }
+  }
+  return nullptr;
+}
+
+// Value of "key=value" in the signed part, up to the end of its line
+static bool fieldValue(const char* body, size_t bodyLen, const char* key, char* value, size_t valueSize) {
+  const char* line = findLine(body, bodyLen, key);
+  if (!line) return false;
+  line += strlen(key);
+  const char* end = (const char*)memchr(line, '\n', (size_t)(body + bodyLen - line));
+  if (!end) return false;
+  if (end > line && end[-1] == '\r') end--;
+  size_t n = (size_t)(end - line);
+  if (n == 0 || n >= valueSize) return false;
+  memcpy(value, line, n);
+  value[n] = '\0';
+  return true;
+}
+
+OtaManifestError otaManifestVerify(const char* text, size_t len,
+                                   const uint8_t publicKey[OTA_ED25519_KEY_SIZE],
+                                   OtaManifest* out) {
+  size_t magicLen = sizeof(kManifestMagic) - 1;
+  if (!text || len < magicLen || len > OTA_MANIFEST_MAX_SIZE || memcmp(text, kManifestMagic, magicLen) != 0) {
+    return OTA_MANIFEST_ERR_FORMAT;
+  }
+
+  const char* sigLine = findLine(text, len, kSignatureKey);
+  if (!sigLine) {
+    return OTA_MANIFEST_ERR_FORMAT;
+  }
+  const char* hex = sigLine + sizeof(kSignatureKey) - 1;
+  if ((size_t)(text + len - hex) < OTA_ED25519_SIGNATURE_SIZE * 2) {
+    return OTA_MANIFEST_ERR_FORMAT;
+  }
+  uint8_t signature[OTA_ED25519_SIGNATURE_SIZE];
+  for (size_t i = 0; i < sizeof(signature); i++) {
+    int hi = hexValue(hex[i * 2]);
+    int lo = hexValue(hex[i * 2 + 1]);
+    if (hi < 0 || lo < 0) return OTA_MANIFEST_ERR_FORMAT;
+    signature[i] = (uint8_t)((hi << 4) | lo);
+  }
+
+  size_t bodyLen = (size_t)(sigLine - text);
+  if (!otaEd25519Verify(signature, (const uint8_t*)text, bodyLen, publicKey)) {
+    return OTA_MANIFEST_ERR_SIGNATURE;
+  }
+
+  // Signed from here on
+  char size[16];
+  char digest[80];
+  if (!fieldValue(text, bodyLen, "version=", out->version, sizeof(out->version)) ||
+      !fieldValue(text, bodyLen, "size=", size, sizeof(size)) ||
+      !fieldValue(text, bodyLen, "sha256=", digest, sizeof(digest)) ||
+      !otaParseSha256Hex(digest, out->sha256)) {
+    return OTA_MANIFEST_ERR_FORMAT;
+  }
+  char* end = nullptr;
+  unsigned long value = strtoul(size, &end, 10);
+  if (!end || *end != '\0' || value == 0 || value > 0xFFFFFFFFUL) {
+    return OTA_MANIFEST_ERR_FORMAT;
+  }
+  out->size = (uint32_t)value;
+
+  char rollout[8];
+  out->rollout = 100;
+  if (fieldValue(text, bodyLen, "rollout=", rollout, sizeof(rollout))) {
+    value = strtoul(rollout, &end, 10);
+    if (!end || *end != '\0' || value > 100) {
+      return OTA_MANIFEST_ERR_FORMAT;
+    }
+    out->rollout = (uint8_t)value;
+  }
+  return OTA_MANIFEST_OK;
+}
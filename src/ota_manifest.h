@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ota_ed25519.h"
+#include "ota_sha256.h"
+#include "pico_ota_config.h"
+
+// Signed firmware manifest, written by extras/ota_sign.py:
+//
+//   pico-ota-manifest v1
+//   version=1.2.0
+//   size=412160
+//   sha256=<64 hex digits>
+//   rollout=25                      (optional)
+//   signature=<128 hex digits>
+//
+// The Ed25519 signature covers every byte before "signature=". Size and
+// digest describe the image that ends up installed (the .bin), whatever
+// encoding it is downloaded in. rollout is the percentage of devices that
+// should install this release (100 if absent); each device decides from a
+// hash of its MAC address. Fields are only read once the signature has
+// been checked. Plain C++ (no Arduino headers).
+
+static const size_t OTA_MANIFEST_MAX_SIZE = 512;
+
+enum OtaManifestError {
+  OTA_MANIFEST_OK = 0,
+  OTA_MANIFEST_ERR_FORMAT,      // Not a v1 manifest, or a field is missing
+  OTA_MANIFEST_ERR_SIGNATURE    // Signature does not match the public key
+};
+
+struct OtaManifest {
+  char version[OTA_MAX_VERSION_LEN];
+  uint32_t size;
+  uint8_t sha256[OtaSha256::kDigestSize];
+  uint8_t rollout;  // Percent of devices, 0-100
+};
+
+// Check text (len bytes, need not be NUL-terminated) against publicKey and
+// fill out on success
+OtaManifestError otaManifestVerify(const char* text, size_t len,
+                                   const uint8_t publicKey[OTA_ED25519_KEY_SIZE],
+                                   OtaManifest* out);
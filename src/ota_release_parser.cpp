@@ -0,0 +1,362 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_release_parser.h"
+
+#include <string.h>
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Asset name matching
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+static bool endsWith(const char* s, size_t sLen, const char* suffix, size_t suffixLen) {
+  return sLen >= suffixLen && memcmp(s + sLen - suffixLen, suffix, suffixLen) == 0;
+}
+
+bool otaMatchAssetPattern(const char* name, const char* pattern) {
+  if (!name) return false;
+  size_t nameLen = strlen(name);
+
+  if (!pattern || !*pattern) {
+    // No pattern - match .bin files
+    return endsWith(name, nameLen, ".bin", 4);
+  }
+
+  const char* star = strchr(pattern, '*');
+  if (!star) {
+    return strcmp(name, pattern) == 0;
+  }
+
+  // Simple wildcard pattern: prefix*suffix
+  size_t prefixLen = (size_t)(star - pattern);
+  const char* suffix = star + 1;
+  size_t suffixLen = strlen(suffix);
+  if (nameLen < prefixLen + suffixLen) return false;
+  return strncmp(name, pattern, prefixLen) == 0 && endsWith(name, nameLen, suffix, suffixLen);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Parser
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+OtaReleaseParser::OtaReleaseParser(const char* assetPattern, const char* deltaPattern) {
+  reset(assetPattern, deltaPattern);
+}
+
+void OtaReleaseParser::reset(const char* assetPattern, const char* deltaPattern) {
+  _pattern = assetPattern;
+  _deltaPattern = deltaPattern;
+
+  _containerBits = 0;
+  _depth = 0;
+  _lex = LEX_IDLE;
+  _capture = CAP_NONE;
+  _unicodeDigits = 0;
+  _unicodeValue = 0;
+  _expectKey = false;
+  _started = false;
+  _done = false;
+  _failed = false;
+
+  _key[0] = '\0';
+  _keyLen = 0;
+  _keyOverflow = false;
+
+  _tag[0] = '\0';
+  _tagLen = 0;
+  _tagOverflow = false;
+
+  _assetsDepth = 0;
+  _name[0] = '\0';
+  _nameLen = 0;
+  _nameOverflow = false;
+  _nameSeen = false;
+
+  _url[0] = '\0';
+  _deltaUrl[0] = '\0';
+  _urlTarget = _url;
+  _urlLen = 0;
+  _urlOverflow = false;
+  _urlSeen = false;
+  _assetFound = false;
+  _deltaFound = false;
+}
+
+bool OtaReleaseParser::keyIs(const char* key) const {
+  return !_keyOverflow && strcmp(_key, key) == 0;
+}
+
+bool OtaReleaseParser::feed(const char* data, size_t len) {
+  if (_failed) return false;
+
+  for (size_t i = 0; i < len && !_done; i++) {
+    char c = data[i];
+
+    switch (_lex) {
+      case LEX_STRING:
+        if (c == '"') {
+          endString();
+        } else if (c == '\\') {
+          _lex = LEX_ESCAPE;
+        } else {
+          appendChar(c);
+        }
+        break;
+
+      case LEX_ESCAPE:
+        _lex = LEX_STRING;
+        switch (c) {
+          case 'b': appendChar('\b'); break;
+          case 'f': appendChar('\f'); break;
+          case 'n': appendChar('\n'); break;
+          case 'r': appendChar('\r'); break;
+          case 't': appendChar('\t'); break;
+          case 'u':
+            _lex = LEX_UNICODE;
+            _unicodeDigits = 0;
+            _unicodeValue = 0;
+            break;
+          default: appendChar(c); break;  // \" \\ \/
+        }
+        break;
+
+      case LEX_UNICODE: {
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (uint32_t)(c - 'A' + 10);
+        else {
+          _failed = true;
+          return false;
+        }
+        _unicodeValue = (_unicodeValue << 4) | digit;
+        if (++_unicodeDigits == 4) {
+          appendCodepoint(_unicodeValue);
+          _lex = LEX_STRING;
+        }
+        break;
+      }
+
+      case LEX_LITERAL:
+        // Numbers, true, false, null: skip until the next delimiter
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+          _lex = LEX_IDLE;
+          if (!structural(c)) return false;
+        }
+        break;
+
+      case LEX_IDLE:
+      default:
+        if (!structural(c)) return false;
+        break;
+    }
+  }
+
+  return !_failed;
+}
+
+bool OtaReleaseParser::structural(char c) {
+  switch (c) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      return true;
+
+    case '{':
+    case '[': {
+      if (_depth >= kMaxDepth || (_started && _depth == 0) || (_depth == 0 && c != '{')) {
+        _failed = true;
+        return false;
+      }
+      bool isObject = (c == '{');
+
+      // A new object directly inside "assets" is one release asset
+      if (isObject && _assetsDepth > 0 && _depth == _assetsDepth) {
+        _nameLen = 0;
+        _name[0] = '\0';
+        _nameOverflow = false;
+        _nameSeen = false;
+        _urlLen = 0;
+        _urlOverflow = false;
+        _urlSeen = false;
+      }
+      if (!isObject && _depth == 1 && keyIs("assets")) {
+        _assetsDepth = _depth + 1;
+      }
+
+      if (isObject) _containerBits |= (1UL << _depth);
+      else _containerBits &= ~(1UL << _depth);
+      _depth++;
+      _started = true;
+      _expectKey = isObject;
+      return true;
+    }
+
+    case '}':
+    case ']': {
+      if (_depth == 0 || inObject() != (c == '}')) {
+        _failed = true;
+        return false;
+      }
+
+      if (c == '}' && _assetsDepth > 0 && _depth == _assetsDepth + 1) {
+        closeAsset();
+      }
+      if (c == ']' && _depth == _assetsDepth) {
+        _assetsDepth = 0;
+      }
+
+      _depth--;
+      _expectKey = false;
+      if (_depth == 0) {
+        _done = true;
+      }
+      return true;
+    }
+
+    case ':':
+      _expectKey = false;
+      return true;
+
+    case ',':
+      _expectKey = inObject();
+      return true;
+
+    case '"':
+      if (_depth == 0) {
+        _failed = true;
+        return false;
+      }
+      beginString();
+      return true;
+
+    default:
+      if (_depth == 0) {
+        _failed = true;
+        return false;
+      }
+      _lex = LEX_LITERAL;
+      return true;
+  }
+}
+
+// Closing one asset object: keep its URL if the name matched. A URL that
+// was captured into the scratch slot is moved to the delta slot if needed.
+void OtaReleaseParser::closeAsset() {
+  if (!_nameSeen || !_urlSeen || _nameOverflow || _urlOverflow) {
+    return;
+  }
+  if (!_assetFound && otaMatchAssetPattern(_name, _pattern)) {
+    _assetFound = true;  // Captured into _url, which now stays as is
+  } else if (_deltaPattern && !_deltaFound && otaMatchAssetPattern(_name, _deltaPattern)) {
+    if (_urlTarget != _deltaUrl) {
+      memcpy(_deltaUrl, _urlTarget, _urlLen + 1u);
+    }
+    _deltaFound = true;
+  }
+}
+
+void OtaReleaseParser::beginString() {
+  _lex = LEX_STRING;
+
+  if (inObject() && _expectKey) {
+    _capture = CAP_KEY;
+    _keyLen = 0;
+    _key[0] = '\0';
+    _keyOverflow = false;
+    return;
+  }
+
+  _capture = CAP_NONE;
+  if (_depth == 1 && keyIs("tag_name")) {
+    _capture = CAP_TAG;
+    _tagLen = 0;
+    _tag[0] = '\0';
+    _tagOverflow = false;
+  } else if (_assetsDepth > 0 && _depth == _assetsDepth + 1) {
+    if (keyIs("name")) {
+      _capture = CAP_ASSET_NAME;
+      _nameLen = 0;
+      _name[0] = '\0';
+      _nameOverflow = false;
+    } else if (keyIs("browser_download_url")) {
+      // Capture into whichever result slot is still free
+      if (!_assetFound) {
+        _urlTarget = _url;
+      } else if (_deltaPattern && !_deltaFound) {
+        _urlTarget = _deltaUrl;
+      } else {
+        return;
+      }
+      _capture = CAP_ASSET_URL;
+      _urlLen = 0;
+      _urlTarget[0] = '\0';
+      _urlOverflow = false;
+    }
+  }
+}
+
+void OtaReleaseParser::endString() {
+  _lex = LEX_IDLE;
+  switch (_capture) {
+    case CAP_ASSET_NAME: _nameSeen = true; break;
+    case CAP_ASSET_URL: _urlSeen = true; break;
+    default: break;
+  }
+  _capture = CAP_NONE;
+}
+
+// Append to the active capture buffer; overflow is remembered instead of
+// silently truncating so a cut-off URL is never used.
+void OtaReleaseParser::appendChar(char c) {
+  switch (_capture) {
+    case CAP_KEY:
+      if (_keyLen < kMaxKeyLen) {
+        _key[_keyLen++] = c;
+        _key[_keyLen] = '\0';
+      } else {
+        _keyOverflow = true;
+      }
+      break;
+    case CAP_TAG:
+      if (_tagLen + 1u < sizeof(_tag)) {
+        _tag[_tagLen++] = c;
+        _tag[_tagLen] = '\0';
+      } else {
+        _tagOverflow = true;
+      }
+      break;
+    case CAP_ASSET_NAME:
+      if (_nameLen + 1u < sizeof(_name)) {
+        _name[_nameLen++] = c;
+        _name[_nameLen] = '\0';
+      } else {
+        _nameOverflow = true;
+      }
+      break;
+    case CAP_ASSET_URL:
+      if (_urlLen + 1u < sizeof(_url)) {
+        _urlTarget[_urlLen++] = c;
+        _urlTarget[_urlLen] = '\0';
+      } else {
+        _urlOverflow = true;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void OtaReleaseParser::appendCodepoint(uint32_t cp) {
+  if (cp < 0x80) {
+    appendChar((char)cp);
+  } else if (cp < 0x800) {
+    appendChar((char)(0xC0 | (cp >> 6)));
+    appendChar((char)(0x80 | (cp & 0x3F)));
+  } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+    appendChar('?');  // Surrogate halves never appear in the fields we keep
+  } else {
+    appendChar((char)(0xE0 | (cp >> 12)));
+    appendChar((char)(0x80 | ((cp >> 6) & 0x3F)));
+    appendChar((char)(0x80 | (cp & 0x3F)));
+  }
+}
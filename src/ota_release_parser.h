@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico_ota_config.h"
+
+// Incremental parser for the GitHub "releases/latest" JSON document.
+// - Feed the HTTP body in chunks of any size (split points do not matter).
+// - Only tag_name and each asset's name / browser_download_url are kept;
+//   everything else is tokenized and dropped, so memory use is fixed.
+// - Two assets can be picked in one pass: the full image and, optionally, a
+//   delta patch (see ota_delta.h).
+// - Plain C++ (no Arduino headers) so it also builds on a desktop compiler.
+
+// Asset name matching used by the GitHub update path:
+// - empty/null pattern matches any name ending in ".bin"
+// - a single '*' acts as a wildcard ("firmware-*.bin")
+// - otherwise the name must match exactly
+bool otaMatchAssetPattern(const char* name, const char* pattern);
+
+class OtaReleaseParser {
+public:
+  explicit OtaReleaseParser(const char* assetPattern = nullptr, const char* deltaPattern = nullptr);
+
+  // Clear all state and start a new document. A null deltaPattern means no
+  // delta asset is wanted (an empty one matches "*.bin" like assetPattern).
+  void reset(const char* assetPattern = nullptr, const char* deltaPattern = nullptr);
+
+  // Consume the next chunk of the body. Returns false once the input is
+  // known to be malformed (further calls are ignored).
+  bool feed(const char* data, size_t len);
+
+  bool done() const { return _done; }                    // Top-level object closed
+  bool failed() const { return _failed; }                // Malformed or too deeply nested
+  bool hasTagName() const { return _tagLen > 0 && !_tagOverflow; }
+  bool hasAsset() const { return _assetFound; }
+  bool hasDeltaAsset() const { return _deltaFound; }
+  bool wantsDeltaAsset() const { return _deltaPattern != nullptr; }
+  const char* tagName() const { return _tag; }           // "" until parsed
+  const char* assetUrl() const { return _assetFound ? _url : ""; }
+  const char* deltaAssetUrl() const { return _deltaFound ? _deltaUrl : ""; }
+
+private:
+  enum LexState : uint8_t {
+    LEX_IDLE,
+    LEX_STRING,
+    LEX_ESCAPE,
+    LEX_UNICODE,
+    LEX_LITERAL
+  };
+
+  enum Capture : uint8_t {
+    CAP_NONE,
+    CAP_KEY,
+    CAP_TAG,
+    CAP_ASSET_NAME,
+    CAP_ASSET_URL
+  };
+
+  static const uint8_t kMaxDepth = 32;
+  static const size_t kMaxKeyLen = 24;
+
+  bool structural(char c);
+  void beginString();
+  void endString();
+  void appendChar(char c);
+  void appendCodepoint(uint32_t cp);
+  bool inObject() const { return _depth > 0 && (_containerBits & (1UL << (_depth - 1))); }
+  bool keyIs(const char* key) const;
+  void closeAsset();
+
+  const char* _pattern;
+  const char* _deltaPattern;
+
+  // Tokenizer state
+  uint32_t _containerBits;   // bit n set = level n+1 is an object, clear = array
+  uint8_t _depth;
+  uint8_t _lex;
+  uint8_t _capture;
+  uint8_t _unicodeDigits;
+  uint32_t _unicodeValue;
+  bool _expectKey;
+  bool _started;
+  bool _done;
+  bool _failed;
+
+  // Capture buffers (the URL buffers double as the results)
+  char _key[kMaxKeyLen + 1];
+  uint8_t _keyLen;
+  bool _keyOverflow;
+
+  char _tag[OTA_MAX_VERSION_LEN];
+  uint8_t _tagLen;
+  bool _tagOverflow;
+
+  uint8_t _assetsDepth;      // Depth of the "assets" array, 0 when outside it
+  char _name[OTA_MAX_ASSET_NAME_LEN];
+  uint16_t _nameLen;
+  bool _nameOverflow;
+  bool _nameSeen;
+
+  char _url[OTA_MAX_URL_LEN];
+  char _deltaUrl[OTA_MAX_URL_LEN];
+  char* _urlTarget;          // Buffer the current asset's URL is captured into
+  uint16_t _urlLen;
+  bool _urlOverflow;
+  bool _urlSeen;
+  bool _assetFound;
+  bool _deltaFound;
+};
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_semver.h"
+
+#include <string.h>
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static bool isIdentChar(char c) {
+  return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-';
+}
+
+// Decimal number without leading zeros that fits in 32 bits
+static bool parseNumber(const char*& s, uint32_t& value) {
+  if (!isDigit(*s) || (s[0] == '0' && isDigit(s[1]))) {
+    return false;
+  }
+  uint64_t n = 0;
+  while (isDigit(*s)) {
+    n = n * 10 + (uint64_t)(*s++ - '0');
+    if (n > 0xFFFFFFFFULL) return false;
+  }
+  value = (uint32_t)n;
+  return true;
+}
+
+// Dot-separated identifiers up to the first character that is neither;
+// numeric ones must not have leading zeros
+static bool parseIdentifiers(const char*& s, bool checkNumeric) {
+  for (;;) {
+    const char* start = s;
+    bool numeric = true;
+    while (isIdentChar(*s)) {
+      if (!isDigit(*s)) numeric = false;
+      s++;
+    }
+    size_t len = (size_t)(s - start);
+    if (len == 0) return false;
+    if (checkNumeric && numeric && len > 1 && start[0] == '0') return false;
+    if (*s != '.') return true;
+    s++;
+  }
+}
+
+bool otaSemverParse(const char* text, OtaSemver* out) {
+  if (!text || !out) return false;
+  const char* s = text;
+  if (*s == 'v' || *s == 'V') s++;
+
+  memset(out, 0, sizeof(*out));
+  if (!parseNumber(s, out->major)) return false;
+  if (*s == '.') {
+    s++;
+    if (!parseNumber(s, out->minor)) return false;
+    if (*s == '.') {
+      s++;
+      if (!parseNumber(s, out->patch)) return false;
+    }
+  }
+
+  if (*s == '-') {
+    s++;
+    const char* pre = s;
+    if (!parseIdentifiers(s, true)) return false;
+    if ((size_t)(s - pre) > 0xFFFF) return false;
+    out->pre = pre;
+    out->preLen = (uint16_t)(s - pre);
+  }
+  if (*s == '+') {
+    s++;
+    if (!parseIdentifiers(s, false)) return false;
+  }
+  return *s == '\0';
+}
+
+// Compare one pre-release identifier of each version (section 11.4)
+static int compareIdentifier(const char* a, size_t aLen, const char* b, size_t bLen) {
+  bool aNumeric = true;
+  bool bNumeric = true;
+  for (size_t i = 0; i < aLen; i++) aNumeric = aNumeric && isDigit(a[i]);
+  for (size_t i = 0; i < bLen; i++) bNumeric = bNumeric && isDigit(b[i]);
+
+  if (aNumeric && bNumeric) {
+    // No leading zeros, so the longer number is larger
+    if (aLen != bLen) return aLen < bLen ? -1 : 1;
+    return memcmp(a, b, aLen);
+  }
+  if (aNumeric != bNumeric) {
+    return aNumeric ? -1 : 1;  // Numeric identifiers have lower precedence
+  }
+  int c = memcmp(a, b, aLen < bLen ? aLen : bLen);
+  if (c != 0) return c;
+  return aLen == bLen ? 0 : (aLen < bLen ? -1 : 1);
+}
+
+static int comparePrerelease(const OtaSemver& a, const OtaSemver& b) {
+  if (!a.pre || !b.pre) {
+    // A release has higher precedence than its pre-releases
+    return (a.pre ? -1 : 0) + (b.pre ? 1 : 0);
+  }
+  const char* pa = a.pre;
+  const char* pb = b.pre;
+  const char* aEnd = a.pre + a.preLen;
+  const char* bEnd = b.pre + b.preLen;
+  while (pa < aEnd && pb < bEnd) {
+    const char* aDot = (const char*)memchr(pa, '.', (size_t)(aEnd - pa));
+    const char* bDot = (const char*)memchr(pb, '.', (size_t)(bEnd - pb));
+    if (!aDot) aDot = aEnd;
+    if (!bDot) bDot = bEnd;
+    int c = compareIdentifier(pa, (size_t)(aDot - pa), pb, (size_t)(bDot - pb));
+    if (c != 0) return c;
+    pa = aDot + 1;
+    pb = bDot + 1;
+  }
+  // All shared identifiers equal: more identifiers is higher
+  bool aMore = pa < aEnd;
+  bool bMore = pb < bEnd;
+  return (aMore ? 1 : 0) - (bMore ? 1 : 0);
+}
+
+int otaSemverCompare(const OtaSemver& a, const OtaSemver& b) {
+  if (a.major != b.major) return a.major < b.major ? -1 : 1;
+  if (a.minor != b.minor) return a.minor < b.minor ? -1 : 1;
+  if (a.patch != b.patch) return a.patch < b.patch ? -1 : 1;
+  int c = comparePrerelease(a, b);
+  return c < 0 ? -1 : (c > 0 ? 1 : 0);
+}
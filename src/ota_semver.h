@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Semantic versions (SemVer 2.0.0) without allocation.
+//
+// Accepted: an optional "v"/"V" prefix, MAJOR[.MINOR[.PATCH]] (missing parts
+// are 0, so release tags like "v1.4" work), then "-pre.release" and
+// "+build" as in the spec. Numbers must not have leading zeros. Precedence
+// follows section 11: pre-releases sort before the release, identifiers
+// compare numerically or in ASCII order, build metadata is ignored.
+// Plain C++ (no Arduino headers).
+
+struct OtaSemver {
+  uint32_t major;
+  uint32_t minor;
+  uint32_t patch;
+  const char* pre;      // Pre-release identifiers (points into the parsed text), nullptr if none
+  uint16_t preLen;
+};
+
+// Parse text into out. Returns false (out undefined) if text is not a version.
+bool otaSemverParse(const char* text, OtaSemver* out);
+
+// <0, 0 or >0 as a has lower, equal or higher precedence than b
+int otaSemverCompare(const OtaSemver& a, const OtaSemver& b);
+
+inline bool otaSemverIsPrerelease(const OtaSemver& v) {
+  return v.pre != nullptr;
+}
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "ota_sha256.h"
+
+#include <string.h>
+
+static const uint32_t kRoundConstants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr(uint32_t x, unsigned n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+void OtaSha256::begin() {
+  static const uint32_t kInitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  memcpy(_state, kInitialState, sizeof(_state));
+  _length = 0;
+  _blockLen = 0;
+}
+
+void OtaSha256::compress(const uint8_t* block) {
+  // 16-word rolling message schedule keeps the stack small
+  uint32_t w[16];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+           ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+  }
+
+  uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+  uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t wi;
+    if (i < 16) {
+      wi = w[i];
+    } else {
+      uint32_t w15 = w[(i + 1) & 15];
+      uint32_t w2 = w[(i + 14) & 15];
+      uint32_t s0 = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+      uint32_t s1 = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+      wi = w[i & 15] = w[i & 15] + s0 + w[(i + 9) & 15] + s1;
+    }
+    uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                  kRoundConstants[i] + wi;
+    uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+  _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+}
+
+void OtaSha256::update(const void* data, size_t len) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  _length += len;
+
+  if (_blockLen > 0) {
+    size_t take = sizeof(_block) - _blockLen;
+    if (take > len) take = len;
+    memcpy(_block + _blockLen, bytes, take);
+    _blockLen += (uint8_t)take;
+    bytes += take;
+    len -= take;
+    if (_blockLen < sizeof(_block)) return;
+    compress(_block);
+    _blockLen = 0;
+  }
+
+  // Whole blocks straight from the caller's buffer
+  while (len >= sizeof(_block)) {
+    compress(bytes);
+    bytes += sizeof(_block);
+    len -= sizeof(_block);
+  }
+
+  memcpy(_block, bytes, len);
+  _blockLen = (uint8_t)len;
+}
+
+void OtaSha256::finish(uint8_t digest[kDigestSize]) {
+  uint64_t bitLength = _length * 8;
+
+  _block[_blockLen++] = 0x80;
+  if (_blockLen > 56) {
+    memset(_block + _blockLen, 0, sizeof(_block) - _blockLen);
+    compress(_block);
+    _blockLen = 0;
+  }
+  memset(_block + _blockLen, 0, 56 - _blockLen);
+  for (int i = 0; i < 8; i++) {
+    _block[56 + i] = (uint8_t)(bitLength >> (56 - i * 8));
+  }
+  compress(_block);
+
+  for (int i = 0; i < 8; i++) {
+    digest[i * 4] = (uint8_t)(_state[i] >> 24);
+    digest[i * 4 + 1] = (uint8_t)(_state[i] >> 16);
+    digest[i * 4 + 2] = (uint8_t)(_state[i] >> 8);
+    digest[i * 4 + 3] = (uint8_t)_state[i];
+  }
+  begin();
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool otaParseSha256Hex(const char* hex, uint8_t digest[OtaSha256::kDigestSize]) {
+  if (!hex) return false;
+  while (*hex == ' ' || *hex == '\t' || *hex == '\r' || *hex == '\n') hex++;
+
+  for (size_t i = 0; i < OtaSha256::kDigestSize; i++) {
+    int hi = hexValue(hex[i * 2]);
+    int lo = (hi < 0) ? -1 : hexValue(hex[i * 2 + 1]);
+    if (lo < 0) return false;
+    digest[i] = (uint8_t)((hi << 4) | lo);
+  }
+  // A 65th hex digit means this was not a SHA-256 digest
+  return hexValue(hex[OtaSha256::kDigestSize * 2]) < 0;
+}
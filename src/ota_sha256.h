@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental SHA-256 (FIPS 180-4). Feed data in pieces of any size as it
+// streams past; the 64-byte block buffer is the only state besides the
+// hash itself. Plain C++ (no Arduino headers).
+class OtaSha256 {
+public:
+  static const size_t kDigestSize = 32;
+
+  OtaSha256() { begin(); }
+
+  void begin();
+  void update(const void* data, size_t len);
+  void finish(uint8_t digest[kDigestSize]);
+
+private:
+  void compress(const uint8_t* block);
+
+  uint32_t _state[8];
+  uint64_t _length;       // Bytes hashed so far
+  uint8_t _block[64];
+  uint8_t _blockLen;
+};
+
+// Parse 64 hex digits (case-insensitive). Leading whitespace is skipped and
+// anything after the digits is ignored, so a "sha256sum" line works as is.
+bool otaParseSha256Hex(const char* hex, uint8_t digest[OtaSha256::kDigestSize]);
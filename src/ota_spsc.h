@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+// Lock-free single-producer / single-consumer ring buffer.
+// - Exactly one thread (core, task) calls push() and exactly one calls pop();
+//   neither ever blocks or waits for the other.
+// - Items are copied in and out, so T should be a small plain struct.
+// - Only atomic loads and stores of 32-bit indices are used (no
+//   read-modify-write), which Cortex-M0+ supports without locks.
+// - Plain C++ (no Arduino headers) so it also builds on a desktop compiler.
+
+template <typename T, size_t N>
+class OtaSpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "OtaSpscQueue size must be a power of two");
+
+public:
+  // Producer side. Returns false (item dropped) if the queue is full.
+  bool push(const T& item) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= N) {
+      return false;
+    }
+    _items[head & (N - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);  // Publishes the item
+    return true;
+  }
+
+  // Consumer side. Returns false if the queue is empty.
+  bool pop(T* item) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (_head.load(std::memory_order_acquire) == tail) {
+      return false;
+    }
+    *item = _items[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);  // Hands the slot back
+    return true;
+  }
+
+  // Free slots as seen from the producer (exact there, a lower bound elsewhere)
+  size_t space() const {
+    return N - (size_t)(_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire));
+  }
+
+private:
+  T _items[N];
+  std::atomic<uint32_t> _head{0};  // Next slot to write, only stored by the producer
+  std::atomic<uint32_t> _tail{0};  // Next slot to read, only stored by the consumer
+};
+
+// Latest value of a small struct, written by one thread and read by any
+// number of others (a seqlock).
+// - The writer never waits; a reader that overlaps a write retries, so it
+//   only ever sees a complete value, never a mix of two.
+// - The value is kept as 32-bit atomic words and guarded by a sequence
+//   number that is odd while a write is in progress. As in OtaSpscQueue,
+//   only atomic loads and stores are used.
+// - Meant for status a reader polls, not for values that must all arrive
+//   (a reader sees the latest write only).
+
+template <typename T>
+class OtaSeqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "OtaSeqlock needs a plain struct");
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0, "OtaSeqlock needs a size in whole 32-bit words");
+  static const size_t kWords = sizeof(T) / sizeof(uint32_t);
+
+public:
+  // Writer side only
+  void write(const T& value) {
+    uint32_t words[kWords];
+    memcpy(words, &value, sizeof(T));
+    uint32_t seq = _seq.load(std::memory_order_relaxed);
+    _seq.store(seq + 1, std::memory_order_relaxed);  // Odd: readers retry
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; i++) {
+      _words[i].store(words[i], std::memory_order_relaxed);
+    }
+    _seq.store(seq + 2, std::memory_order_release);
+  }
+
+  // One attempt; false if it overlapped a write
+  bool tryRead(T* value) const {
+    uint32_t seq = _seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      return false;
+    }
+    uint32_t words[kWords];
+    for (size_t i = 0; i < kWords; i++) {
+      words[i] = _words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_seq.load(std::memory_order_relaxed) != seq) {
+      return false;
+    }
+    memcpy(value, words, sizeof(T));
+    return true;
+  }
+
+  // Retries until a read does not overlap a write (a write takes well
+  // under a microsecond, so this only spins while the writer is mid-write)
+  void read(T* value) const {
+    while (!tryRead(value)) {
+    }
+  }
+
+private:
+  std::atomic<uint32_t> _seq{0};
+  std::atomic<uint32_t> _words[kWords] = {};
+};
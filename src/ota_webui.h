@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Generated by extras/ota_webui.py from extras/webui/ - do not edit.
+// gzip-compressed pages, sent from flash with Content-Encoding: gzip.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// index.html: 832 bytes, 510 compressed
+static const uint8_t kOtaWebIndex[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x53, 0x4d, 0x6f, 0xdb, 0x30,
+  0x0c, 0xbd, 0xe7, 0x57, 0x68, 0xee, 0xa5, 0x05, 0xe2, 0xc4, 0xae, 0x97, 0x6d, 0x90, 0x3f, 0x80,
+  0xae, 0xed, 0x86, 0x9d, 0xda, 0x43, 0x77, 0xd8, 0x91, 0x96, 0x64, 0x5b, 0xa8, 0x2d, 0x09, 0x92,
+  0x9c, 0x0f, 0x04, 0xfb, 0xef, 0xa3, 0xec, 0x24, 0xe8, 0x8a, 0x42, 0x07, 0x5a, 0x14, 0xf9, 0xf8,
+  0xf8, 0x48, 0x17, 0x9f, 0x1e, 0x9e, 0xee, 0x5f, 0xfe, 0x3c, 0x3f, 0x92, 0xce, 0x0f, 0x7d, 0xb5,
+  0x28, 0xce, 0x46, 0x00, 0x47, 0x33, 0x08, 0x0f, 0x84, 0x75, 0x60, 0x9d, 0xf0, 0x65, 0x34, 0xfa,
+  0x26, 0xfe, 0x16, 0x9d, 0xdd, 0x0a, 0x06, 0x51, 0x46, 0x5b, 0x29, 0x76, 0x46, 0x5b, 0x1f, 0x11,
+  0xa6, 0x95, 0x17, 0x0a, 0xc3, 0x76, 0x92, 0xfb, 0xae, 0xe4, 0x62, 0x2b, 0x99, 0x88, 0xa7, 0xcb,
+  0x52, 0x2a, 0xe9, 0x25, 0xf4, 0xb1, 0x63, 0xd0, 0x8b, 0x32, 0x0d, 0x18, 0x5e, 0xfa, 0x5e, 0x54,
+  0x4f, 0x2f, 0x77, 0xe4, 0xb7, 0xe1, 0xe0, 0x45, 0xb1, 0x9e, 0x3d, 0x8b, 0xc2, 0xf9, 0x43, 0xb0,
+  0xb5, 0xe6, 0x87, 0x63, 0x83, 0xa0, 0x71, 0x03, 0x83, 0xec, 0x0f, 0xf4, 0xce, 0x22, 0xc4, 0xd2,
+  0x81, 0x72, 0xb1, 0x13, 0x56, 0x36, 0xf9, 0x00, 0xb6, 0x95, 0x8a, 0x7e, 0x4e, 0xcc, 0x3e, 0xaf,
+  0x81, 0xbd, 0xb6, 0x56, 0x8f, 0x8a, 0xd3, 0xab, 0x26, 0x09, 0x27, 0xff, 0xbb, 0x58, 0x05, 0x4e,
+  0x20, 0x95, 0xb0, 0xc7, 0x37, 0xef, 0xbb, 0x4e, 0x7a, 0x91, 0x1b, 0xe0, 0x5c, 0xaa, 0x96, 0x66,
+  0x53, 0xb6, 0xb6, 0x5c, 0xd8, 0xd8, 0x02, 0x97, 0xa3, 0xa3, 0x69, 0x70, 0x0d, 0xb0, 0x9f, 0xc9,
+  0xd3, 0x4d, 0x32, 0xdf, 0xa7, 0x62, 0x30, 0x7a, 0x8d, 0xe1, 0xfb, 0xd8, 0x75, 0xc0, 0xf5, 0x8e,
+  0x26, 0xe4, 0xd6, 0xec, 0x49, 0xc8, 0x20, 0xb6, 0xad, 0xe1, 0x3a, 0x59, 0x4e, 0x67, 0x95, 0xde,
+  0x60, 0xfd, 0x2e, 0x3d, 0x32, 0xdd, 0x6b, 0x4b, 0xaf, 0xb2, 0x2c, 0xcb, 0xbd, 0xd8, 0xfb, 0x18,
+  0x7a, 0xd9, 0x2a, 0xca, 0x50, 0x28, 0x61, 0x31, 0xc2, 0x1c, 0x3f, 0xf2, 0xc2, 0x91, 0x4b, 0x67,
+  0x7a, 0x38, 0xd0, 0xba, 0xd7, 0xec, 0xf5, 0x83, 0xcc, 0x33, 0xfb, 0x74, 0x83, 0x85, 0xb3, 0xf7,
+  0x02, 0x24, 0xc9, 0xd7, 0xba, 0x69, 0xf2, 0xb9, 0xf6, 0xdc, 0xee, 0x04, 0xc1, 0x05, 0xd3, 0x16,
+  0xbc, 0xd4, 0x8a, 0x2a, 0xad, 0xc4, 0xbb, 0xb6, 0x37, 0x97, 0x2e, 0x63, 0xaf, 0x0d, 0xbd, 0x0d,
+  0xa8, 0xc8, 0x85, 0x76, 0x7a, 0xfb, 0xbf, 0x80, 0x88, 0xbf, 0xf9, 0x52, 0x67, 0xf8, 0x58, 0xac,
+  0x4f, 0xc3, 0x2a, 0xd6, 0xa7, 0x8d, 0x09, 0x53, 0x43, 0xc3, 0xe5, 0x96, 0xb0, 0x1e, 0x9c, 0x2b,
+  0xa3, 0xcb, 0x0c, 0xc2, 0xd4, 0xbb, 0xb4, 0x7a, 0x96, 0x4c, 0x93, 0xb7, 0x73, 0x47, 0xdf, 0xa2,
+  0x30, 0xd5, 0xc3, 0xb4, 0x30, 0x94, 0x14, 0xce, 0x80, 0x22, 0x92, 0x97, 0x51, 0xa7, 0x9d, 0x8f,
+  0x2a, 0xac, 0x81, 0x0e, 0x34, 0x06, 0xc3, 0x80, 0x74, 0x56, 0x34, 0x65, 0xb4, 0x1e, 0xa7, 0xe4,
+  0xa8, 0xfa, 0xa9, 0x89, 0xd7, 0xe4, 0x87, 0xb4, 0xc3, 0x0e, 0xac, 0xb8, 0x60, 0x42, 0xa0, 0x84,
+  0x24, 0xc2, 0x3a, 0x31, 0x2b, 0x8d, 0xaf, 0xb8, 0x66, 0xe3, 0x80, 0xe2, 0xad, 0x5a, 0xe1, 0x1f,
+  0x7b, 0x11, 0x3e, 0xbf, 0x1f, 0x7e, 0xf1, 0xeb, 0xb9, 0xca, 0xcd, 0x2a, 0x08, 0x74, 0x3f, 0xaf,
+  0x30, 0x29, 0x09, 0xca, 0x3e, 0xe9, 0xb4, 0x0a, 0xaf, 0x39, 0x52, 0x98, 0x41, 0x10, 0xf4, 0xd4,
+  0xe0, 0x7a, 0xfe, 0x51, 0xfe, 0x01, 0xd4, 0xe4, 0xc4, 0x16, 0x40, 0x03, 0x00, 0x00,
+};
+static const size_t kOtaWebIndexLen = 510;
+static const char kOtaWebIndexEtag[] = "\"be48686c86d9ad24\"";
+
+// update.html: 2245 bytes, 1060 compressed
+static const uint8_t kOtaWebUpdate[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x56, 0x6d, 0x6f, 0xdb, 0x36,
+  0x10, 0xfe, 0xee, 0x5f, 0x71, 0x63, 0x50, 0xc0, 0x6e, 0x6d, 0x59, 0x76, 0x9a, 0x6e, 0x91, 0xad,
+  0x00, 0x5d, 0xd2, 0x22, 0x03, 0x5a, 0x34, 0x68, 0x3d, 0x60, 0xc3, 0xb0, 0x0f, 0xb4, 0x74, 0xb2,
+  0x88, 0x52, 0xa4, 0x4a, 0x51, 0x7e, 0xa9, 0xeb, 0xff, 0xbe, 0x23, 0x25, 0xb9, 0x4e, 0xda, 0x66,
+  0xd8, 0x6c, 0xc0, 0x12, 0x79, 0x6f, 0xcf, 0x3d, 0xf7, 0x02, 0xcf, 0x7f, 0xba, 0x79, 0x77, 0xbd,
+  0xf8, 0xf3, 0xee, 0x15, 0xe4, 0xb6, 0x90, 0x57, 0xbd, 0x79, 0xf7, 0x40, 0x9e, 0xd2, 0xa3, 0x40,
+  0xcb, 0x21, 0xc9, 0xb9, 0xa9, 0xd0, 0xc6, 0xac, 0xb6, 0xd9, 0xe8, 0x17, 0xd6, 0x5d, 0x2b, 0x5e,
+  0x60, 0xcc, 0xd6, 0x02, 0x37, 0xa5, 0x36, 0x96, 0x41, 0xa2, 0x95, 0x45, 0x45, 0x6a, 0x1b, 0x91,
+  0xda, 0x3c, 0x4e, 0x71, 0x2d, 0x12, 0x1c, 0xf9, 0xc3, 0x50, 0x28, 0x61, 0x05, 0x97, 0xa3, 0x2a,
+  0xe1, 0x12, 0xe3, 0x89, 0xf3, 0x61, 0x85, 0x95, 0x78, 0xf5, 0x5a, 0x98, 0x62, 0xc3, 0x0d, 0xc2,
+  0xef, 0x65, 0xca, 0x2d, 0xce, 0xc7, 0xcd, 0x75, 0x6f, 0x5e, 0xd9, 0x9d, 0x7b, 0x2e, 0x75, 0xba,
+  0xdb, 0x67, 0xe4, 0x79, 0x94, 0xf1, 0x42, 0xc8, 0x5d, 0xf4, 0xd2, 0x90, 0x9f, 0x61, 0xc5, 0x55,
+  0x35, 0xaa, 0xd0, 0x88, 0x6c, 0x56, 0x70, 0xb3, 0x12, 0x2a, 0x7a, 0x1e, 0x96, 0xdb, 0xd9, 0x92,
+  0x27, 0x1f, 0x57, 0x46, 0xd7, 0x2a, 0x8d, 0xce, 0xb2, 0xd0, 0x7d, 0x67, 0x87, 0x5e, 0xe0, 0x80,
+  0x71, 0xa1, 0xd0, 0xec, 0x4f, 0xe4, 0x9b, 0x5c, 0x58, 0x9c, 0x95, 0x3c, 0x4d, 0x85, 0x5a, 0x45,
+  0xe7, 0xde, 0x5a, 0x9b, 0x14, 0xcd, 0xc8, 0xf0, 0x54, 0xd4, 0x55, 0x34, 0x71, 0x57, 0x05, 0xdf,
+  0x36, 0x19, 0x44, 0x17, 0x61, 0x73, 0xf6, 0xc1, 0x78, 0x6d, 0x35, 0xa9, 0x6f, 0x47, 0x55, 0xce,
+  0x53, 0xbd, 0x89, 0x42, 0x98, 0x96, 0x5b, 0x70, 0x16, 0x60, 0x56, 0x4b, 0xde, 0x0f, 0x87, 0xfe,
+  0x1b, 0x4c, 0x06, 0x14, 0x3f, 0x9f, 0xec, 0x13, 0x2d, 0xb5, 0x89, 0xce, 0xce, 0xcf, 0xcf, 0x67,
+  0x16, 0xb7, 0x76, 0xc4, 0xa5, 0x58, 0xa9, 0x28, 0x21, 0xb6, 0xd0, 0x90, 0x86, 0x50, 0x65, 0x6d,
+  0xf7, 0xa9, 0xa8, 0x4a, 0xc9, 0x77, 0xd1, 0x52, 0xea, 0xe4, 0xe3, 0xac, 0x89, 0x3a, 0x09, 0xc3,
+  0x27, 0x4d, 0x20, 0xf1, 0xd9, 0xe1, 0x6c, 0x21, 0xd2, 0x4d, 0x07, 0xc5, 0x07, 0x0d, 0x3b, 0x27,
+  0x7f, 0xd9, 0x5d, 0x89, 0x71, 0x55, 0x2f, 0x0b, 0x61, 0xff, 0xde, 0x77, 0xd9, 0x4d, 0xa6, 0x0f,
+  0xb8, 0x09, 0xc3, 0x9f, 0x97, 0x59, 0x36, 0x6b, 0x60, 0x35, 0x4c, 0x34, 0x9e, 0xa3, 0xf0, 0x01,
+  0x0b, 0x17, 0x64, 0x99, 0xd4, 0xa6, 0x22, 0xbd, 0x52, 0x8b, 0x53, 0xbc, 0xf7, 0x42, 0x45, 0x04,
+  0x9e, 0x2f, 0x25, 0xa6, 0xa7, 0x14, 0x9f, 0x5d, 0x5e, 0x5e, 0x92, 0x76, 0x69, 0xf4, 0xca, 0x60,
+  0x55, 0xed, 0x4f, 0x52, 0xca, 0x51, 0xac, 0x72, 0x1b, 0x4d, 0x1d, 0xa7, 0x87, 0xde, 0x59, 0x65,
+  0xb9, 0xad, 0xab, 0xfd, 0xb7, 0xdc, 0x14, 0x42, 0x8d, 0x5a, 0xdd, 0x49, 0x30, 0xc5, 0x82, 0x94,
+  0xe7, 0xe3, 0xb6, 0x35, 0xe6, 0xe3, 0xb6, 0x49, 0x5d, 0x8f, 0xd0, 0x23, 0x15, 0x6b, 0x48, 0x24,
+  0xaf, 0xaa, 0x98, 0x1d, 0x2b, 0xee, 0x1a, 0x2d, 0x9f, 0x7c, 0xdb, 0x65, 0x74, 0xd7, 0x9b, 0x67,
+  0xda, 0x14, 0x20, 0xd2, 0x98, 0xb9, 0x17, 0x06, 0xd4, 0xd4, 0xb9, 0xa6, 0xd3, 0xdd, 0xbb, 0x0f,
+  0x0b, 0x06, 0x3c, 0xb1, 0x42, 0xab, 0x98, 0x8d, 0x6b, 0x6f, 0xc2, 0x00, 0x55, 0xe2, 0x33, 0x66,
+  0x45, 0x2d, 0xad, 0x28, 0xb9, 0xb1, 0x63, 0x67, 0x37, 0x22, 0x29, 0x77, 0x61, 0x3c, 0x29, 0xd0,
+  0xa8, 0x64, 0x42, 0xa2, 0x73, 0x91, 0x60, 0x49, 0xf3, 0x10, 0x2c, 0x85, 0x1a, 0x06, 0xda, 0xf2,
+  0xcf, 0xfe, 0x37, 0x65, 0xed, 0xe8, 0x64, 0x2d, 0x2a, 0x06, 0x06, 0x3f, 0xd5, 0xc2, 0x60, 0xfa,
+  0xc0, 0x8d, 0xe3, 0xa3, 0x53, 0xa6, 0x4e, 0x9b, 0x5e, 0xbc, 0x60, 0x40, 0x8d, 0x40, 0xa7, 0x17,
+  0xcf, 0x19, 0x50, 0xb3, 0x24, 0x98, 0x6b, 0x49, 0xd5, 0x8a, 0xd9, 0x87, 0xdb, 0x97, 0x23, 0x92,
+  0x43, 0x5f, 0x97, 0x0e, 0x37, 0x97, 0x83, 0x87, 0x98, 0x9a, 0x4a, 0x31, 0x9f, 0x70, 0xf7, 0xbe,
+  0xe6, 0xb2, 0x26, 0x51, 0xc3, 0x0a, 0x74, 0x2c, 0x39, 0x4b, 0x9f, 0x1b, 0x3d, 0xbb, 0xe2, 0x79,
+  0xb3, 0xee, 0x40, 0x5c, 0xf1, 0x6d, 0xcc, 0xa8, 0x92, 0x47, 0x17, 0x21, 0xbb, 0x9a, 0x8f, 0x3b,
+  0xb9, 0xb3, 0x6b, 0xe2, 0xf8, 0xba, 0x7a, 0x91, 0xf3, 0x49, 0x15, 0x72, 0x93, 0x9d, 0x18, 0x51,
+  0xda, 0xab, 0xde, 0x9a, 0x1b, 0xf0, 0x25, 0x88, 0x21, 0xd5, 0x49, 0x5d, 0x50, 0xc5, 0x83, 0x15,
+  0xda, 0x57, 0x12, 0xdd, 0xeb, 0xaf, 0xbb, 0xdf, 0xd2, 0x7e, 0x53, 0x99, 0xc1, 0xcc, 0xeb, 0x36,
+  0xce, 0xde, 0x50, 0x59, 0x1f, 0xb3, 0x68, 0x43, 0xb6, 0x36, 0x47, 0xf8, 0x8f, 0x58, 0x1c, 0xb3,
+  0x22, 0x1b, 0x17, 0x2f, 0xd0, 0xaa, 0xe1, 0x87, 0x8c, 0xb2, 0x5a, 0xf9, 0x3e, 0x80, 0x3e, 0x0e,
+  0x60, 0xdf, 0x03, 0xc0, 0xa0, 0x34, 0xb8, 0x26, 0xdb, 0x1b, 0xcc, 0x38, 0x35, 0x42, 0x9f, 0x8c,
+  0x00, 0x5c, 0xa8, 0x6d, 0x6e, 0xc8, 0x40, 0xe1, 0x06, 0xfe, 0x78, 0xfb, 0xe6, 0xd6, 0xda, 0xf2,
+  0x3d, 0x15, 0x15, 0xab, 0x56, 0x83, 0xa4, 0x81, 0x2e, 0x51, 0xf5, 0x9b, 0xf6, 0x1a, 0xc2, 0xb1,
+  0xb1, 0x8e, 0xe2, 0xba, 0x94, 0x9a, 0xa7, 0x14, 0xfd, 0x04, 0xf4, 0x49, 0xfc, 0x75, 0x03, 0x00,
+  0x40, 0x64, 0xee, 0x14, 0x48, 0x54, 0x2b, 0x9b, 0x5f, 0xeb, 0x82, 0x4a, 0xec, 0x46, 0xaf, 0x13,
+  0xc3, 0x31, 0xe9, 0xc0, 0xd7, 0x86, 0xbc, 0xbc, 0xe5, 0x36, 0x0f, 0xfc, 0x4c, 0x7a, 0x43, 0x8a,
+  0x82, 0x29, 0x3c, 0xa5, 0x7d, 0x15, 0xc2, 0x18, 0xe8, 0xc6, 0x52, 0x57, 0x4a, 0x8f, 0xc3, 0x7d,
+  0xbe, 0xf2, 0x1c, 0xb8, 0x06, 0xbc, 0x6e, 0xd6, 0x3a, 0xb9, 0xa1, 0x3e, 0x71, 0xb6, 0xb4, 0x51,
+  0x80, 0xc1, 0xb3, 0x87, 0x61, 0x9e, 0x01, 0x7b, 0xc2, 0x1a, 0x1f, 0x07, 0xfa, 0x3d, 0x1c, 0xb3,
+  0x56, 0xce, 0xe8, 0x5e, 0x2e, 0xa7, 0x99, 0x38, 0x95, 0x26, 0x22, 0xc4, 0x31, 0x4c, 0xc3, 0xf0,
+  0x6b, 0x1e, 0x8f, 0x01, 0xf1, 0x0d, 0x2b, 0x14, 0xa9, 0x48, 0xda, 0x3a, 0x43, 0x9a, 0xa0, 0xa5,
+  0xd6, 0x96, 0xa0, 0x05, 0x41, 0xc0, 0x8e, 0x99, 0xa0, 0x5d, 0x88, 0x02, 0x75, 0x6d, 0xfb, 0xf7,
+  0x82, 0x03, 0x6d, 0x58, 0xee, 0x4e, 0x41, 0x6e, 0x30, 0x73, 0x0e, 0xc7, 0x6c, 0x06, 0x87, 0x21,
+  0x4c, 0x68, 0xcb, 0x87, 0x2d, 0x11, 0x07, 0x40, 0x59, 0xe1, 0xbf, 0x83, 0x71, 0x09, 0x10, 0x0d,
+  0x25, 0x75, 0x0d, 0x2e, 0x48, 0x02, 0x5f, 0xbe, 0x40, 0xbf, 0x43, 0x98, 0x71, 0xda, 0x04, 0x29,
+  0xf4, 0x6f, 0x17, 0x8b, 0x3b, 0x4f, 0xda, 0x49, 0xba, 0x44, 0xd8, 0x80, 0x1d, 0x59, 0xff, 0x71,
+  0x43, 0x37, 0xb3, 0x3a, 0x08, 0xba, 0x15, 0xeb, 0xa8, 0xe4, 0x04, 0xed, 0xbb, 0x5c, 0xa3, 0x31,
+  0xda, 0x7c, 0x97, 0xec, 0x1f, 0xb3, 0x49, 0xaf, 0x0a, 0x1b, 0x6d, 0xa9, 0x2b, 0xdb, 0xd2, 0xf7,
+  0xff, 0x00, 0x79, 0x28, 0xff, 0xc9, 0xd4, 0x9a, 0x1a, 0x3b, 0xfc, 0x15, 0x52, 0x8b, 0xba, 0x11,
+  0x7a, 0x4d, 0x73, 0x78, 0x43, 0x8b, 0xb5, 0xef, 0x06, 0x72, 0x40, 0x24, 0x91, 0x5f, 0x5a, 0xfc,
+  0xed, 0xe6, 0x98, 0x8f, 0xdb, 0x95, 0x3f, 0x6e, 0xfe, 0xad, 0xfc, 0x03, 0xe8, 0xb3, 0xbc, 0x14,
+  0xc5, 0x08, 0x00, 0x00,
+};
+static const size_t kOtaWebUpdateLen = 1060;
+static const char kOtaWebUpdateEtag[] = "\"4580161aacb2b9e0\"";
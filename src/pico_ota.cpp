@@ -1,70 +1,98 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2026 Samuel F.
 
-#include "pico_ota.h"
-
-#include <Arduino.h>
-#include <ArduinoOTA.h>
-#include <WiFi.h>
-#include <WiFiClient.h>
-#include <WiFiClientSecure.h>
-#include <HTTPClient.h>
-#include <WebServer.h>
-#include <HTTPUpdateServer.h>
-
-#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
-#include <LittleFS.h>
-#include <HTTPUpdate.h>
-#elif defined(ARDUINO_ARCH_ESP32)
-#include <HTTPUpdate.h>
-#endif
+#include "pico_ota_internal.h"
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Static configuration & state
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 static unsigned long g_wifiTimeoutMs = 30000;  // Default: 30s
 static bool g_fsAutoFormat = true;             // Default: true (Pico W / Pico 2 W)
-static bool g_otaStarted = false;              // Tracks if ArduinoOTA.begin() was called
 
-// WiFi credentials storage for reconnect
-static String g_ssid;
-static String g_password;
-static String g_hostname;
+// WiFi credentials storage for reconnect (fixed sizes, see pico_ota_config.h)
+static char g_ssid[OTA_MAX_SSID_LEN];
+static char g_password[OTA_MAX_PASSWORD_LEN];
+static char g_hostname[OTA_MAX_HOSTNAME_LEN];
+static char g_otaPassword[OTA_MAX_CREDENTIAL_LEN];
 
 // WiFi Auto-Reconnect settings
 static bool g_autoReconnect = false;
-static unsigned long g_reconnectInterval = 30000;  // Default: 30s
+static unsigned long g_reconnectInterval = 30000;      // Default: 30s (first retry delay)
+static unsigned long g_reconnectMaxInterval = 300000;  // Default: 5 min (backoff cap)
 static int g_maxReconnectAttempts = 0;  // 0 = infinite
 static int g_reconnectAttempts = 0;
-static unsigned long g_lastReconnectAttempt = 0;
-static bool g_wasConnected = false;
+
+// WiFi connection state machine (advanced one step per otaLoop())
+static const unsigned long kWifiPollIntervalMs = 20;       // WiFi.status() polling period
+static const unsigned long kReconnectAttemptTimeoutMs = 10000;
+static OtaWifiState g_wifiState = OTA_WIFI_IDLE;
+static unsigned long g_wifiStateSinceMs = 0;
+static unsigned long g_wifiWaitMs = 0;             // Delay before next attempt (WAITING)
+static unsigned long g_wifiAttemptTimeoutMs = 0;   // Timeout of the attempt in flight (CONNECTING)
+static unsigned long g_wifiLastPollMs = 0;
+static bool g_asyncSetupPending = false;           // otaSetupAsync() waiting for first connection
 
 // User callbacks (optional)
-static void (*g_onStartCallback)() = nullptr;
 static void (*g_onProgressCallback)(unsigned int, unsigned int) = nullptr;
-static void (*g_onEndCallback)() = nullptr;
-static void (*g_onErrorCallback)(int) = nullptr;
+static void (*g_onProgressReport)(const OtaProgress*) = nullptr;
 static void (*g_onWifiDisconnectCallback)() = nullptr;
 static void (*g_onWifiReconnectCallback)() = nullptr;
 
-// Web Server for browser upload
-static WebServer* g_webServer = nullptr;
-static HTTPUpdateServer* g_httpUpdater = nullptr;
-static bool g_webServerRunning = false;
-static String g_webUsername;
-static String g_webPassword;
-static uint16_t g_webServerPort = 80;
-
-// GitHub OTA settings
-static String g_githubOwner;
-static String g_githubRepo;
-static String g_currentVersion;
-static String g_githubAssetPattern;
-static String g_latestVersion;
-static String g_latestAssetUrl;
+namespace ota_internal {
+bool g_otaStarted = false;  // Tracks if ArduinoOTA.begin() was called
+char g_currentVersion[OTA_MAX_VERSION_LEN];
+void (*g_onStartCallback)() = nullptr;
+void (*g_onEndCallback)() = nullptr;
+void (*g_onErrorCallback)(int) = nullptr;
+}  // namespace ota_internal
+
+// Heap low-water mark, sampled on the update paths and from otaLoop()
+static const unsigned long kHeapSampleIntervalMs = 1000;
+static uint32_t g_heapMinFree = UINT32_MAX;
+static unsigned long g_heapLastSampleMs = 0;
 
 namespace {
 
+uint32_t heapFree() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  return (uint32_t)rp2040.getFreeHeap();
+#else
+  return ESP.getFreeHeap();
+#endif
+}
+
+}  // namespace
+
+namespace ota_internal {
+
+void copyString(char* dest, size_t destSize, const char* src) {
+  if (destSize == 0) return;
+  // A loop, not strnlen(): GCC flags a bound past the end of a shorter src array
+  size_t len = 0;
+  while (src && len < destSize - 1 && src[len]) len++;
+  if (len) memcpy(dest, src, len);
+  dest[len] = '\0';
+}
+
+// copyString() for user settings: refuse (and say so) rather than truncate
+bool storeSetting(char* dest, size_t destSize, const char* src, const char* what) {
+  size_t len = src ? strlen(src) : 0;
+  if (len >= destSize) {
+    Serial.printf("[OTA] %s too long (max %u characters)\n", what, (unsigned)(destSize - 1));
+    dest[0] = '\0';
+    return false;
+  }
+  copyString(dest, destSize, src);
+  return true;
+}
+
+void heapSample() {
+  uint32_t freeBytes = heapFree();
+  if (freeBytes < g_heapMinFree) {
+    g_heapMinFree = freeBytes;
+  }
+}
+
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
 bool ensureLittleFsMounted() {
   if (LittleFS.begin()) {
@@ -88,6 +116,51 @@ bool ensureLittleFsMounted() {
 }
 #endif
 
+}  // namespace ota_internal
+
+namespace {
+
+// Hardware RNG: random() is unseeded, so every device would draw the same jitter
+uint32_t randomU32() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  return rp2040.hwrand32();
+#else
+  return esp_random();
+#endif
+}
+
+void setWifiState(OtaWifiState state, unsigned long nowMs) {
+  statsWifiState(g_wifiState, state, nowMs);
+  g_wifiState = state;
+  g_wifiStateSinceMs = nowMs;
+}
+
+// Start a connection attempt without waiting for the result
+void beginWifiAttempt(unsigned long nowMs, unsigned long timeoutMs) {
+  WiFi.disconnect();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  WiFi.beginNoBlock(g_ssid, g_password);
+#else
+  WiFi.begin(g_ssid, g_password);  // Non-blocking on ESP32
+#endif
+  g_wifiAttemptTimeoutMs = timeoutMs;
+  setWifiState(OTA_WIFI_CONNECTING, nowMs);
+}
+
+// Exponential backoff: interval, 2x, 4x ... capped at the max interval,
+// with +/-25% jitter so devices that lost the same AP do not retry in lockstep
+unsigned long nextReconnectDelay() {
+  unsigned long delayMs = g_reconnectInterval;
+  for (int i = 1; i < g_reconnectAttempts && delayMs < g_reconnectMaxInterval; i++) {
+    delayMs *= 2;
+  }
+  if (delayMs > g_reconnectMaxInterval) {
+    delayMs = g_reconnectMaxInterval;
+  }
+  unsigned long jitter = delayMs / 4;
+  return delayMs - jitter + randomU32() % (2 * jitter + 1);
+}
+
 bool connectWifi(const char *ssid, const char *password, unsigned long timeoutMs) {
   WiFi.mode(WIFI_STA);
   WiFi.begin(ssid, password);
@@ -127,6 +200,10 @@ void otaOnProgress(void (*callback)(unsigned int, unsigned int)) {
   g_onProgressCallback = callback;
 }
 
+void otaOnProgressReport(void (*callback)(const OtaProgress* progress)) {
+  g_onProgressReport = callback;
+}
+
 void otaOnEnd(void (*callback)()) {
   g_onEndCallback = callback;
 }
@@ -134,25 +211,38 @@ void otaOnEnd(void (*callback)()) {
 void otaOnError(void (*callback)(int)) {
   g_onErrorCallback = callback;
 }
+
+void otaSetCurrentVersion(const char* version) {
+  storeSetting(g_currentVersion, sizeof(g_currentVersion), version, "Version");
+}
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Setup helpers
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 static void configureArduinoOTA(const char *hostname, const char *otaPassword) {
   // Set callbacks if provided
-  if (g_onStartCallback) {
-    ArduinoOTA.onStart(g_onStartCallback);
-  }
-  if (g_onProgressCallback) {
-    ArduinoOTA.onProgress(g_onProgressCallback);
-  }
-  if (g_onEndCallback) {
-    ArduinoOTA.onEnd(g_onEndCallback);
-  }
-  if (g_onErrorCallback) {
-    ArduinoOTA.onError([](ota_error_t error) {
-      g_onErrorCallback((int)error);
-    });
-  }
+  ArduinoOTA.onStart([]() {
+    statsAdd(offsetof(OtaStats, updatesStarted), 1);
+    transferBegin(OTA_PROGRESS_IDE_UPLOAD, 0, 0);
+    if (g_onStartCallback) g_onStartCallback();
+  });
+  ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
+    transferProgress(progress, total);
+    progressDispatch();  // Between packets, as for web uploads
+  });
+  ArduinoOTA.onEnd([]() {
+    transferEnd();
+    progressPhase(OTA_PROGRESS_INSTALL);
+    bootGuardInstall(nullptr);  // IDE uploads are health-checked like pulled updates
+    statsAdd(offsetof(OtaStats, updatesInstalled), 1);
+    statsSeal();  // ArduinoOTA reboots after this
+    if (g_onEndCallback) g_onEndCallback();
+  });
+  ArduinoOTA.onError([](ota_error_t error) {
+    transferEnd();
+    statsAdd(offsetof(OtaStats, updatesFailed), 1);
+    if (g_onErrorCallback) g_onErrorCallback((int)error);
+  });
   
   if (hostname && *hostname) {
     ArduinoOTA.setHostname(hostname);
@@ -168,6 +258,8 @@ static void configureArduinoOTA(const char *hostname, const char *otaPassword) {
   ArduinoOTA.begin();
   g_otaStarted = true;
   Serial.println("[OTA] Ready for OTA updates");
+  peerAdvertise();
+  bootGuardCheckSpace();  // Once per boot, if otaSetBootGuard() has not already
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -190,9 +282,11 @@ bool otaSetupWithTimeout(const char *ssid,
                          const char *otaPassword,
                          bool allowFsFormat) {
   // Store credentials for auto-reconnect
-  g_ssid = ssid ? ssid : "";
-  g_password = password ? password : "";
-  g_hostname = hostname ? hostname : "";
+  if (!storeSetting(g_ssid, sizeof(g_ssid), ssid, "SSID") ||
+      !storeSetting(g_password, sizeof(g_password), password, "WiFi password") ||
+      !storeSetting(g_hostname, sizeof(g_hostname), hostname, "Hostname")) {
+    return false;
+  }
   
   // Temporarily override FS auto-format for this setup call
   bool originalFsAutoFormat = g_fsAutoFormat;
@@ -201,10 +295,13 @@ bool otaSetupWithTimeout(const char *ssid,
   if (!connectWifi(ssid, password, wifiTimeoutMs)) {
     Serial.println("[OTA] OTA disabled because WiFi connection failed");
     g_fsAutoFormat = originalFsAutoFormat;  // Restore
+    setWifiState(OTA_WIFI_WAITING, millis());  // Auto-reconnect (if enabled) retries from otaLoop()
+    g_wifiWaitMs = 0;
     return false;
   }
   
-  g_wasConnected = true;  // Mark as connected for auto-reconnect
+  g_asyncSetupPending = false;
+  setWifiState(OTA_WIFI_CONNECTED, millis());
   
   Serial.print("[OTA] WiFi connected, IP: ");
   Serial.println(WiFi.localIP());
@@ -216,6 +313,9 @@ bool otaSetupWithTimeout(const char *ssid,
     g_fsAutoFormat = originalFsAutoFormat;  // Restore
     return false;
   }
+#if OTA_STAGING
+  cleanupStagedImage();
+#endif
 #endif
 
   configureArduinoOTA(hostname, otaPassword);
@@ -223,6 +323,53 @@ bool otaSetupWithTimeout(const char *ssid,
   return true;
 }
 
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Public API: non-blocking setup (finished from otaLoop())
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+bool otaSetupAsync(const char *ssid,
+                   const char *password,
+                   const char *hostname,
+                   const char *otaPassword) {
+  if (!ssid || !*ssid) {
+    Serial.println("[OTA] otaSetupAsync: SSID is required");
+    return false;
+  }
+
+  if (!storeSetting(g_ssid, sizeof(g_ssid), ssid, "SSID") ||
+      !storeSetting(g_password, sizeof(g_password), password, "WiFi password") ||
+      !storeSetting(g_hostname, sizeof(g_hostname), hostname, "Hostname") ||
+      !storeSetting(g_otaPassword, sizeof(g_otaPassword), otaPassword, "OTA password")) {
+    return false;
+  }
+  g_asyncSetupPending = true;
+  g_reconnectAttempts = 0;
+
+  Serial.println("[OTA] Connecting WiFi in background");
+  WiFi.mode(WIFI_STA);
+  beginWifiAttempt(millis(), g_wifiTimeoutMs);
+  return true;
+}
+
+// First connection after otaSetupAsync(): finish what otaSetupWithTimeout() does
+static void completeAsyncSetup() {
+  g_asyncSetupPending = false;
+
+  Serial.print("[OTA] WiFi connected, IP: ");
+  Serial.println(WiFi.localIP());
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (!ensureLittleFsMounted()) {
+    Serial.println("[OTA] OTA disabled because filesystem is missing");
+    return;
+  }
+#if OTA_STAGING
+  cleanupStagedImage();
+#endif
+#endif
+
+  configureArduinoOTA(g_hostname, g_otaPassword);
+}
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // WiFi Auto-Reconnect
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -230,7 +377,10 @@ void otaSetAutoReconnect(bool enabled) {
   g_autoReconnect = enabled;
   if (enabled) {
     g_reconnectAttempts = 0;
-    g_lastReconnectAttempt = 0;
+    if (g_wifiState == OTA_WIFI_GAVE_UP) {
+      g_wifiWaitMs = 0;
+      setWifiState(OTA_WIFI_WAITING, millis());
+    }
   }
 }
 
@@ -238,6 +388,10 @@ void otaSetReconnectInterval(unsigned long ms) {
   g_reconnectInterval = ms;
 }
 
+void otaSetReconnectMaxInterval(unsigned long ms) {
+  g_reconnectMaxInterval = ms;
+}
+
 void otaSetMaxReconnectAttempts(int attempts) {
   g_maxReconnectAttempts = attempts;
 }
@@ -250,82 +404,135 @@ void otaOnWifiReconnect(void (*callback)()) {
   g_onWifiReconnectCallback = callback;
 }
 
-static void handleAutoReconnect() {
-  if (!g_autoReconnect) return;
-  
-  bool currentlyConnected = (WiFi.status() == WL_CONNECTED);
-  
-  // Detect disconnect
-  if (g_wasConnected && !currentlyConnected) {
-    g_wasConnected = false;
-    g_reconnectAttempts = 0;
-    Serial.println("[OTA] WiFi disconnected");
-    if (g_onWifiDisconnectCallback) {
-      g_onWifiDisconnectCallback();
-    }
+OtaWifiState otaGetWifiState() {
+  return g_wifiState;
+}
+
+static void onWifiConnected(unsigned long nowMs) {
+  setWifiState(OTA_WIFI_CONNECTED, nowMs);
+  g_reconnectAttempts = 0;
+
+  if (g_asyncSetupPending) {
+    completeAsyncSetup();
+    return;
   }
-  
-  // Attempt reconnect if needed
-  if (!currentlyConnected && g_ssid.length() > 0) {
-    // Check if max attempts reached
-    if (g_maxReconnectAttempts > 0 && g_reconnectAttempts >= g_maxReconnectAttempts) {
-      return;
-    }
-    
-    // Check if interval has passed
-    if (millis() - g_lastReconnectAttempt < g_reconnectInterval) {
-      return;
-    }
-    
-    g_lastReconnectAttempt = millis();
-    g_reconnectAttempts++;
-    
-    Serial.print("[OTA] Reconnect attempt ");
-    Serial.print(g_reconnectAttempts);
-    if (g_maxReconnectAttempts > 0) {
-      Serial.print("/");
-      Serial.print(g_maxReconnectAttempts);
-    }
-    Serial.println();
-    
-    WiFi.disconnect();
-    delay(100);
-    WiFi.begin(g_ssid.c_str(), g_password.c_str());
-    
-    // Brief wait for connection
-    unsigned long connectStart = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - connectStart < 10000) {
-      delay(100);
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      g_wasConnected = true;
-      g_reconnectAttempts = 0;
-      Serial.print("[OTA] Reconnected, IP: ");
-      Serial.println(WiFi.localIP());
-      if (g_onWifiReconnectCallback) {
-        g_onWifiReconnectCallback();
-      }
-    }
+
+  Serial.print("[OTA] Reconnected, IP: ");
+  Serial.println(WiFi.localIP());
+  if (g_onWifiReconnectCallback) {
+    g_onWifiReconnectCallback();
   }
-  
-  // Update connected state
-  if (currentlyConnected && !g_wasConnected) {
-    g_wasConnected = true;
+}
+
+static void onWifiAttemptFailed(unsigned long nowMs) {
+  g_reconnectAttempts++;
+
+  if (g_maxReconnectAttempts > 0 && g_reconnectAttempts >= g_maxReconnectAttempts) {
+    Serial.println("[OTA] WiFi reconnect attempts exhausted");
+    setWifiState(OTA_WIFI_GAVE_UP, nowMs);
+    return;
+  }
+
+  g_wifiWaitMs = nextReconnectDelay();
+  Serial.printf("[OTA] WiFi attempt %d failed, retrying in %lu ms\n", g_reconnectAttempts, g_wifiWaitMs);
+  setWifiState(OTA_WIFI_WAITING, nowMs);
+}
+
+// One non-blocking step of the WiFi state machine. Every path is O(1): the
+// driver is polled at most every kWifiPollIntervalMs and connection attempts
+// are started with non-blocking begin calls, then checked on later ticks.
+void ota_internal::handleAutoReconnect() {
+  if (!g_autoReconnect && !g_asyncSetupPending) return;
+
+  unsigned long now = millis();
+  if (now - g_wifiLastPollMs < kWifiPollIntervalMs) return;
+  g_wifiLastPollMs = now;
+
+  bool currentlyConnected = (WiFi.status() == WL_CONNECTED);
+
+  switch (g_wifiState) {
+    case OTA_WIFI_CONNECTED:
+      // Detect disconnect
+      if (!currentlyConnected) {
+        g_reconnectAttempts = 0;
+        Serial.println("[OTA] WiFi disconnected");
+        if (g_onWifiDisconnectCallback) {
+          g_onWifiDisconnectCallback();
+        }
+        g_wifiWaitMs = 0;  // First retry immediately
+        setWifiState(OTA_WIFI_WAITING, now);
+      }
+      break;
+
+    case OTA_WIFI_CONNECTING:
+      if (currentlyConnected) {
+        onWifiConnected(now);
+      } else if (now - g_wifiStateSinceMs >= g_wifiAttemptTimeoutMs) {
+        onWifiAttemptFailed(now);
+      }
+      break;
+
+    case OTA_WIFI_WAITING:
+      if (currentlyConnected) {
+        onWifiConnected(now);  // Driver reconnected on its own
+      } else if (now - g_wifiStateSinceMs >= g_wifiWaitMs && g_ssid[0]) {
+        Serial.print("[OTA] Reconnect attempt ");
+        Serial.print(g_reconnectAttempts + 1);
+        if (g_maxReconnectAttempts > 0) {
+          Serial.print("/");
+          Serial.print(g_maxReconnectAttempts);
+        }
+        Serial.println();
+        statsAdd(offsetof(OtaStats, reconnectAttempts), 1);
+        beginWifiAttempt(now, g_asyncSetupPending ? g_wifiTimeoutMs : kReconnectAttemptTimeoutMs);
+      }
+      break;
+
+    case OTA_WIFI_GAVE_UP:
+      if (currentlyConnected) {
+        onWifiConnected(now);
+      }
+      break;
+
+    case OTA_WIFI_IDLE:
+    default:
+      if (currentlyConnected) {
+        setWifiState(OTA_WIFI_CONNECTED, now);
+      }
+      break;
   }
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Runtime loop
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+static void handleBootGuard();  // Boot guard (below)
+
 void otaLoop() {
-  ArduinoOTA.handle();
+  if (g_otaStarted && !steppedUpdateActive()) {
+    ArduinoOTA.handle();  // Shares the update partition, so it waits for a time-sliced update
+  }
   handleAutoReconnect();
+
+  unsigned long now = millis();
+  if (now - g_heapLastSampleMs >= kHeapSampleIntervalMs) {
+    g_heapLastSampleMs = now;
+    heapSample();
+  }
   
+#if OTA_FEATURE_WEB
   // Handle web server if running
   if (g_webServerRunning && g_webServer) {
     g_webServer->handleClient();
   }
+#endif
+  handlePeerSharing();
+
+#if OTA_FEATURE_HTTP_PULL
+  handleSteppedUpdate();
+  handleUpdateSchedule();
+#endif
+  handleBootGuard();
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -339,370 +546,464 @@ bool otaIsReady() {
   return (WiFi.status() == WL_CONNECTED) && g_otaStarted;
 }
 
+void otaGetHeapStats(OtaHeapStats* stats) {
+  if (!stats) return;
+  heapSample();
+  stats->freeBytes = heapFree();
+  stats->minFreeBytes = g_heapMinFree;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  stats->totalBytes = (uint32_t)rp2040.getTotalHeap();
+#else
+  stats->totalBytes = ESP.getHeapSize();
+#endif
+}
+
+void otaResetHeapStats() {
+  g_heapMinFree = UINT32_MAX;
+  heapSample();
+}
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// HTTP Pull-Based OTA
+// Transfer progress
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-int otaUpdateFromUrl(const char* url) {
-  return otaUpdateFromUrl(url, "");
+// Progress of the current (or last) download / web upload. The rate is
+// measured over kRateSampleMs windows and smoothed so ETA does not jump.
+// g_transfer belongs to the core running the transfer (the worker, in
+// worker mode); otaGetTransferStatus() reads the copy published after each
+// change, which another core can read without seeing half an update.
+static const unsigned long kRateSampleMs = 500;
+static OtaSeqlock<OtaTransferStatus> g_transferPublished;
+static unsigned long g_transferSampleMs = 0;
+static uint32_t g_transferSampleBytes = 0;
+static unsigned long g_transferStartMs = 0;
+static uint32_t g_transferStartBytes = 0;  // Resumed downloads start past 0
+
+// Progress dispatcher (see otaSetProgressThrottle). transferProgress() runs
+// for every read and only marks a report due; progressDispatch() delivers
+// it from the points where the receive path has nothing to read.
+static uint32_t g_progressMinBytes = 4096;
+static uint32_t g_progressMinMs = 100;
+static bool g_progressDue = false;
+static uint32_t g_progressLastBytes = 0;
+static unsigned long g_progressLastMs = 0;
+
+namespace ota_internal {
+OtaTransferStatus g_transfer;
+OtaProgressPhase g_progressPhase = OTA_PROGRESS_DOWNLOAD;
+uint32_t g_transferWriteMs = 0;
+}  // namespace ota_internal
+
+void otaSetProgressThrottle(uint32_t minBytes, uint32_t minIntervalMs) {
+  g_progressMinBytes = minBytes;
+  g_progressMinMs = minIntervalMs;
+}
+
+static void progressDeliver() {
+  g_progressDue = false;
+  g_progressLastBytes = g_transfer.bytes;
+  g_progressLastMs = millis();
+  OtaProgress report;
+  report.phase = g_progressPhase;
+  report.bytes = g_transfer.bytes;
+  report.total = g_transfer.total;
+  report.bytesPerSecond = g_transfer.bytesPerSecond;
+  report.etaSeconds = g_transfer.etaSeconds;
+  report.elapsedMs = g_transfer.elapsedMs;
+  if (g_onProgressCallback && report.total > 0) {
+    g_onProgressCallback(report.bytes, report.total);
+  }
+  if (g_onProgressReport) g_onProgressReport(&report);
+  workerProgress(report);
+}
+
+namespace ota_internal {
+
+// Deliver the pending report, if any; cheap enough to call on every idle pass
+void progressDispatch() {
+  if (g_progressDue) progressDeliver();
+}
+
+// The transfer moved on to verifying or installing: report it now, since
+// the next step may take seconds (or end in a reboot)
+void progressPhase(OtaProgressPhase phase) {
+  g_progressPhase = phase;
+  g_transfer.etaSeconds = 0;
+  g_transferPublished.write(g_transfer);
+  progressDeliver();
+}
+
+void transferBegin(OtaProgressPhase phase, uint32_t bytes, uint32_t total) {
+  memset(&g_transfer, 0, sizeof(g_transfer));
+  g_transfer.active = true;
+  g_transfer.upload = phase != OTA_PROGRESS_DOWNLOAD;
+  g_transfer.bytes = bytes;
+  g_transfer.total = total;
+  g_transferSampleMs = millis();
+  g_transferSampleBytes = bytes;
+  g_transferStartMs = g_transferSampleMs;
+  g_transferStartBytes = bytes;
+  g_transferWriteMs = 0;
+  g_progressPhase = phase;
+  g_progressDue = false;
+  g_progressLastBytes = bytes;
+  g_progressLastMs = g_transferStartMs;
+  g_transferPublished.write(g_transfer);
+}
+
+// Record progress and mark a report due. It is delivered inline only when a
+// steady stream has left no idle point for twice the interval.
+void transferProgress(uint32_t bytes, uint32_t total) {
+  g_transfer.bytes = bytes;
+  g_transfer.total = total;
+  unsigned long now = millis();
+  unsigned long elapsed = now - g_transferSampleMs;
+  if (elapsed >= kRateSampleMs && bytes >= g_transferSampleBytes) {
+    uint32_t rate = (uint32_t)((uint64_t)(bytes - g_transferSampleBytes) * 1000 / elapsed);
+    g_transfer.bytesPerSecond = g_transfer.bytesPerSecond ? (g_transfer.bytesPerSecond * 3 + rate) / 4 : rate;
+    g_transferSampleMs = now;
+    g_transferSampleBytes = bytes;
+  }
+  g_transfer.elapsedMs = (uint32_t)(now - g_transferStartMs);
+  g_transfer.writeMs = g_transferWriteMs;
+  g_transfer.etaSeconds = (total > bytes && g_transfer.bytesPerSecond > 0)
+                              ? (total - bytes + g_transfer.bytesPerSecond - 1) / g_transfer.bytesPerSecond
+                              : 0;
+  g_transferPublished.write(g_transfer);
+  unsigned long sinceReport = now - g_progressLastMs;
+  if (bytes == total || (bytes - g_progressLastBytes >= g_progressMinBytes && sinceReport >= g_progressMinMs)) {
+    g_progressDue = true;
+  }
+  if (g_progressDue && sinceReport >= 2 * g_progressMinMs) progressDeliver();
+}
+
+// Finish the transfer and log its end-to-end rate (network, decoding and
+// flash together, unlike the smoothed bytesPerSecond)
+void transferEnd() {
+  if (!g_transfer.active) return;
+  progressDispatch();
+  g_transfer.active = false;
+  g_transfer.etaSeconds = 0;
+  g_transfer.elapsedMs = (uint32_t)(millis() - g_transferStartMs);
+  g_transfer.writeMs = g_transferWriteMs;
+  g_transferPublished.write(g_transfer);
+  uint32_t moved = g_transfer.bytes - g_transferStartBytes;
+  statsAdd(g_transfer.upload ? offsetof(OtaStats, bytesUploaded) : offsetof(OtaStats, bytesDownloaded), moved);
+  if (!g_transfer.upload) {
+    statsRecord(OTA_PHASE_DOWNLOAD, g_transfer.elapsedMs);
+  }
+  if (moved > 0 && g_transfer.elapsedMs > 0) {
+    uint32_t kbPerSecond = (uint32_t)((uint64_t)moved / g_transfer.elapsedMs);  // bytes/ms = kB/s
+    Serial.printf("[OTA] %lu bytes in %lu ms: %lu.%03lu MB/s, %lu ms writing flash\n", (unsigned long)moved,
+                  (unsigned long)g_transfer.elapsedMs, (unsigned long)(kbPerSecond / 1000),
+                  (unsigned long)(kbPerSecond % 1000), (unsigned long)g_transfer.writeMs);
+  }
+}
+
+}  // namespace ota_internal
+
+void otaGetTransferStatus(OtaTransferStatus* status) {
+  if (status) {
+    g_transferPublished.read(status);
+  }
+}
+
+#if OTA_FEATURE_HTTP_PULL || defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+uint8_t ota_internal::g_dlBuffer[1024];
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Boot guard (health-checked updates)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// With otaSetBootGuard(), an update starts out pending. Each boot of it is
+// counted, and a boot that does not reach otaMarkAppValid() within the
+// window is ended with a restart. After more than maxBoots such boots the
+// previous firmware is restored:
+// - Pico W / Pico 2 W: picoOTA overwrites the sketch area in place, so the
+//   running image is copied to LittleFS before an update is installed and
+//   handed back to picoOTA for the rollback.
+// - ESP32: the previous image is still in the other OTA partition, and the
+//   ESP-IDF rollback switches back to it.
+// The state is a small CRC-checked record in LittleFS (Pico) or NVS (ESP32),
+// rewritten once per boot while an update is pending; both spread writes
+// over their flash area.
+static const uint32_t kBootMagic = 0x424F544F;  // "OTOB"
+
+struct BootRecord {
+  uint32_t magic;
+  uint8_t status;       // OtaBootStatus
+  uint8_t boots;        // Starts of the pending image so far
+  uint8_t hasDigest;
+  uint8_t reserved;
+  uint8_t sha256[OtaSha256::kDigestSize];  // Pending image, or the one rolled back
+  uint32_t check;       // CRC32 of all fields above
+};
+
+static uint8_t g_bootMaxBoots = 0;           // 0 = guard off
+static unsigned long g_bootValidWindowMs = 0;
+static BootRecord g_bootRecord;              // As found at boot
+static bool g_bootPending = false;           // Running image waits for otaMarkAppValid()
+static bool g_bootSpaceChecked = false;      // bootGuardCheckSpace() ran this boot
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+static const char* kBootRecordPath = "ota_boot.bin";
+static const char* kPreviousImagePath = "ota_previous.bin";
+extern uint8_t __flash_binary_end;  // Linker symbol: end of the running image in flash
+#endif
+
+// Size of the running firmware as built (its .bin file)
+uint32_t ota_internal::runningImageSize() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  return (uint32_t)((uintptr_t)&__flash_binary_end - XIP_BASE);
+#else
+  return ESP.getSketchSize();
+#endif
 }
 
-int otaUpdateFromUrl(const char* url, const char* currentVersion) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[OTA] HTTP update failed: WiFi not connected");
-    return OTA_UPDATE_NO_WIFI;
-  }
-  
-  Serial.print("[OTA] Starting HTTP update from: ");
-  Serial.println(url);
-  
-  WiFiClient client;
-  
-  // Both platforms use lowercase 'httpUpdate'
-  httpUpdate.rebootOnUpdate(true);
-  t_httpUpdate_return ret;
-  if (currentVersion && *currentVersion) {
-    ret = httpUpdate.update(client, url, currentVersion);
-  } else {
-    ret = httpUpdate.update(client, url);
-  }
-  
-  switch (ret) {
-    case HTTP_UPDATE_OK:
-      Serial.println("[OTA] HTTP update successful, rebooting...");
-      return OTA_UPDATE_OK;
-    case HTTP_UPDATE_NO_UPDATES:
-      Serial.println("[OTA] No update available (version match)");
-      return OTA_UPDATE_NO_UPDATE;
-    case HTTP_UPDATE_FAILED:
-    default:
-      Serial.printf("[OTA] HTTP update failed: %s\n", httpUpdate.getLastErrorString().c_str());
-      return OTA_UPDATE_FAILED;
-  }
+static uint32_t bootRecordCheck(const BootRecord& record) {
+  return otaCrc32(0, reinterpret_cast<const uint8_t*>(&record), offsetof(BootRecord, check));
 }
 
-int otaUpdateFromHost(const char* host, uint16_t port, const char* path) {
-  return otaUpdateFromHost(host, port, path, "");
+static bool loadBootRecord(BootRecord& record) {
+  memset(&record, 0, sizeof(record));
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  File file = LittleFS.open(kBootRecordPath, "r");
+  if (!file) return false;
+  bool read = file.read(reinterpret_cast<uint8_t*>(&record), sizeof(record)) == (int)sizeof(record);
+  file.close();
+#else
+  Preferences prefs;
+  bool read = prefs.begin("pico_ota", true) && prefs.getBytes("boot", &record, sizeof(record)) == sizeof(record);
+  prefs.end();
+#endif
+  if (!read || record.magic != kBootMagic || record.check != bootRecordCheck(record)) {
+    memset(&record, 0, sizeof(record));
+    return false;
+  }
+  return true;
 }
 
-int otaUpdateFromHost(const char* host, uint16_t port, const char* path, const char* currentVersion) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[OTA] HTTP update failed: WiFi not connected");
-    return OTA_UPDATE_NO_WIFI;
+static void saveBootRecord(BootRecord& record) {
+  record.magic = kBootMagic;
+  record.check = bootRecordCheck(record);
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  File file = LittleFS.open(kBootRecordPath, "w");
+  if (file) {
+    file.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+    file.close();
   }
-  
-  Serial.printf("[OTA] Starting HTTP update from: %s:%d%s\n", host, port, path);
-  
-  WiFiClient client;
-  
-  // Both platforms use lowercase 'httpUpdate'
-  httpUpdate.rebootOnUpdate(true);
-  t_httpUpdate_return ret;
-  if (currentVersion && *currentVersion) {
-    ret = httpUpdate.update(client, host, port, path, currentVersion);
-  } else {
-    ret = httpUpdate.update(client, host, port, path);
-  }
-
-  switch (ret) {
-    case HTTP_UPDATE_OK:
-      Serial.println("[OTA] HTTP update successful, rebooting...");
-      return OTA_UPDATE_OK;
-    case HTTP_UPDATE_NO_UPDATES:
-      Serial.println("[OTA] No update available (version match)");
-      return OTA_UPDATE_NO_UPDATE;
-    default:
-      return OTA_UPDATE_FAILED;
+#else
+  Preferences prefs;
+  if (prefs.begin("pico_ota", false)) {
+    prefs.putBytes("boot", &record, sizeof(record));
+    prefs.end();
   }
+#endif
 }
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Web Browser Upload
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-void otaSetWebCredentials(const char* username, const char* password) {
-  g_webUsername = username ? username : "";
-  g_webPassword = password ? password : "";
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+// Copy the running firmware to LittleFS so a rollback can restore it
+static bool savePreviousImage() {
+  uint32_t size = runningImageSize();
+  FSInfo info;
+  if (!LittleFS.info(info) || info.totalBytes - info.usedBytes < size + 2 * OTA_IMAGE_WRITE_BLOCK) {
+    Serial.printf("[OTA] Rollback unavailable: keeping the running firmware needs %lu KB of LittleFS, "
+                  "%lu KB free; installing without rollback\n",
+                  (unsigned long)((size + 2 * OTA_IMAGE_WRITE_BLOCK + 1023) / 1024),
+                  (unsigned long)((info.totalBytes - info.usedBytes) / 1024));
+    return false;
+  }
+  File file = LittleFS.open(kPreviousImagePath, "w");
+  if (!file) return false;
+  bool written = true;
+  for (uint32_t offset = 0; offset < size && written; offset += sizeof(g_dlBuffer)) {
+    size_t len = size - offset < sizeof(g_dlBuffer) ? size - offset : sizeof(g_dlBuffer);
+    // Through RAM: flash is not readable while LittleFS programs it
+    memcpy(g_dlBuffer, reinterpret_cast<const uint8_t*>(XIP_BASE + offset), len);
+    written = file.write(g_dlBuffer, len) == len;
+  }
+  file.close();
+  if (!written) {
+    Serial.println("[OTA] Saving the running firmware failed, update has no rollback");
+    LittleFS.remove(kPreviousImagePath);
+  }
+  return written;
 }
+#endif
 
-void otaStartWebServer(uint16_t port) {
-  if (g_webServerRunning) {
-    Serial.println("[OTA] Web server already running");
-    return;
-  }
-  
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[OTA] Cannot start web server: WiFi not connected");
+// Say at startup, not at the first update, when an update could not be
+// rolled back. On Pico the running firmware is copied to LittleFS while
+// the new image is staged there too, so both must fit (the new one taken
+// as the size of the running one); once an update is pending, its
+// fallback is already saved.
+void ota_internal::bootGuardCheckSpace() {
+  if (g_bootMaxBoots == 0 || g_bootPending || g_bootSpaceChecked) {
     return;
   }
-  
-  g_webServerPort = port;
-  
-  // Create server and updater
-  g_webServer = new WebServer(port);
-  g_httpUpdater = new HTTPUpdateServer();
-  
-  // Setup HTTPUpdateServer with optional authentication
-  if (g_webUsername.length() > 0 && g_webPassword.length() > 0) {
-    g_httpUpdater->setup(g_webServer, "/update", g_webUsername.c_str(), g_webPassword.c_str());
-  } else {
-    g_httpUpdater->setup(g_webServer, "/update");
+  g_bootSpaceChecked = true;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  uint32_t image = runningImageSize();
+  uint32_t needed = 2 * image + 2 * OTA_IMAGE_WRITE_BLOCK;
+  FSInfo info;
+  if (!LittleFS.info(info)) {
+    Serial.println("[OTA] Rollback unavailable: LittleFS is not mounted");
+  } else if (info.totalBytes - info.usedBytes < needed) {
+    Serial.printf("[OTA] Rollback unavailable: LittleFS has %lu KB free of %lu KB, an update needs about "
+                  "%lu KB (the %lu KB running firmware plus the new image)\n",
+                  (unsigned long)((info.totalBytes - info.usedBytes) / 1024),
+                  (unsigned long)(info.totalBytes / 1024), (unsigned long)((needed + 1023) / 1024),
+                  (unsigned long)((image + 1023) / 1024));
+  }
+#else
+  if (!esp_ota_get_next_update_partition(nullptr)) {
+    Serial.println("[OTA] Rollback unavailable: the partition table has no second OTA partition");
   }
-  
-  // Root page with link to update
-  g_webServer->on("/", HTTP_GET, []() {
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<title>OTA Update</title>";
-    html += "<style>body{font-family:Arial,sans-serif;margin:40px;background:#f0f0f0;}";
-    html += ".container{background:white;padding:30px;border-radius:10px;max-width:500px;margin:auto;box-shadow:0 2px 10px rgba(0,0,0,0.1);}";
-    html += "h1{color:#333;text-align:center;}";
-    html += "a{display:block;text-align:center;padding:15px 30px;background:#007bff;color:white;text-decoration:none;border-radius:5px;margin-top:20px;}";
-    html += "a:hover{background:#0056b3;}</style></head>";
-    html += "<body><div class='container'>";
-    html += "<h1>Pico OTA Update</h1>";
-    html += "<p style='text-align:center;'>Device IP: " + WiFi.localIP().toString() + "</p>";
-    html += "<a href='/update'>Go to Firmware Update</a>";
-    html += "</div></body></html>";
-    g_webServer->send(200, "text/html", html);
-  });
-  
-  g_webServer->begin();
-  g_webServerRunning = true;
-  
-  Serial.print("[OTA] Web server started on port ");
-  Serial.println(port);
-  Serial.print("[OTA] Update URL: http://");
-  Serial.print(WiFi.localIP());
-  Serial.print(":");
-  Serial.print(port);
-  Serial.println("/update");
+#endif
 }
 
-void otaStopWebServer() {
-  if (!g_webServerRunning) {
+// An update is being installed: it stays pending until it proves itself
+void ota_internal::bootGuardInstall(const uint8_t* sha256) {
+  if (g_bootMaxBoots == 0) {
     return;
   }
-  
-  if (g_webServer) {
-    g_webServer->stop();
-    delete g_webServer;
-    g_webServer = nullptr;
+  BootRecord record;
+  memset(&record, 0, sizeof(record));
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  LittleFS.begin();  // Already mounted on the update paths; ArduinoOTA may have closed it
+  // Updating a pending image: keep the last confirmed one as the fallback
+  bool keepPrevious = g_bootPending && LittleFS.exists(kPreviousImagePath);
+  if (!keepPrevious && !savePreviousImage()) {
+    LittleFS.remove(kBootRecordPath);
+    return;
   }
-  
-  if (g_httpUpdater) {
-    delete g_httpUpdater;
-    g_httpUpdater = nullptr;
+#endif
+  record.status = OTA_BOOT_PENDING;
+  if (sha256) {
+    record.hasDigest = 1;
+    memcpy(record.sha256, sha256, sizeof(record.sha256));
   }
-  
-  g_webServerRunning = false;
-  Serial.println("[OTA] Web server stopped");
-}
-
-bool otaIsWebServerRunning() {
-  return g_webServerRunning;
-}
-
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// GitHub Release OTA
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-void otaSetGitHubRepo(const char* owner, const char* repo) {
-  g_githubOwner = owner ? owner : "";
-  g_githubRepo = repo ? repo : "";
+  saveBootRecord(record);
+  Serial.println("[OTA] New firmware must call otaMarkAppValid() or it will be rolled back");
 }
 
-void otaSetCurrentVersion(const char* version) {
-  g_currentVersion = version ? version : "";
-}
-
-void otaSetGitHubAssetName(const char* assetPattern) {
-  g_githubAssetPattern = assetPattern ? assetPattern : "";
-}
-
-const char* otaGetLatestGitHubVersion() {
-  return g_latestVersion.c_str();
-}
-
-// Simple JSON parser helper (avoids ArduinoJson dependency)
-static String extractJsonValue(const String& json, const char* key) {
-  String searchKey = String("\"") + key + "\"";
-  int keyPos = json.indexOf(searchKey);
-  if (keyPos < 0) return "";
-  
-  int colonPos = json.indexOf(':', keyPos + searchKey.length());
-  if (colonPos < 0) return "";
-  
-  // Skip whitespace
-  int valueStart = colonPos + 1;
-  while (valueStart < (int)json.length() && (json[valueStart] == ' ' || json[valueStart] == '\t')) {
-    valueStart++;
+// Only returns if there is nothing to roll back to
+static void bootGuardRollback() {
+  Serial.printf("[OTA] Firmware failed %u boots without otaMarkAppValid(), rolling back\n",
+                (unsigned)g_bootMaxBoots);
+  g_bootRecord.status = OTA_BOOT_ROLLED_BACK;
+  g_bootRecord.boots = 0;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (LittleFS.exists(kPreviousImagePath)) {
+    saveBootRecord(g_bootRecord);
+    picoOTA.begin();
+    picoOTA.addFile(kPreviousImagePath);
+    picoOTA.commit();
+    LittleFS.end();
+    statsSeal();
+    delay(100);
+    rp2040.reboot();
   }
-  
-  if (valueStart >= (int)json.length()) return "";
-  
-  // Check if value is a string (starts with ")
-  if (json[valueStart] == '"') {
-    valueStart++;
-    int valueEnd = json.indexOf('"', valueStart);
-    if (valueEnd < 0) return "";
-    return json.substring(valueStart, valueEnd);
+#else
+  saveBootRecord(g_bootRecord);
+  if (esp_ota_check_rollback_is_possible()) {
+    statsSeal();
+    esp_ota_mark_app_invalid_rollback_and_reboot();  // Returns only on failure
   }
-  
-  // Otherwise it's a number or boolean - find end
-  int valueEnd = valueStart;
-  while (valueEnd < (int)json.length() && json[valueEnd] != ',' && json[valueEnd] != '}') {
-    valueEnd++;
+  const esp_partition_t* previous = esp_ota_get_next_update_partition(nullptr);
+  if (previous && esp_ota_set_boot_partition(previous) == ESP_OK) {  // Checks the image first
+    statsSeal();
+    delay(100);
+    ESP.restart();
   }
-  return json.substring(valueStart, valueEnd);
+#endif
+  Serial.println("[OTA] No previous firmware to roll back to, keeping this one");
+  g_bootRecord.status = OTA_BOOT_NORMAL;
+  saveBootRecord(g_bootRecord);
 }
 
-// Find asset URL from GitHub release JSON
-static String findAssetUrl(const String& json, const String& pattern) {
-  // Look for "assets" array
-  int assetsPos = json.indexOf("\"assets\"");
-  if (assetsPos < 0) return "";
-  
-  int arrayStart = json.indexOf('[', assetsPos);
-  if (arrayStart < 0) return "";
-  
-  // Search through assets
-  int searchPos = arrayStart;
-  while (searchPos < (int)json.length()) {
-    int namePos = json.indexOf("\"name\"", searchPos);
-    if (namePos < 0) break;
-    
-    // Extract asset name
-    int colonPos = json.indexOf(':', namePos + 6);
-    if (colonPos < 0) break;
-    
-    int quoteStart = json.indexOf('"', colonPos + 1);
-    int quoteEnd = json.indexOf('"', quoteStart + 1);
-    if (quoteStart < 0 || quoteEnd < 0) break;
-    
-    String assetName = json.substring(quoteStart + 1, quoteEnd);
-    
-    // Check if matches pattern (simple wildcard support)
-    bool matches = false;
-    if (pattern.length() == 0) {
-      // No pattern - match .bin files
-      matches = assetName.endsWith(".bin");
-    } else if (pattern.indexOf('*') >= 0) {
-      // Simple wildcard pattern
-      String prefix = pattern.substring(0, pattern.indexOf('*'));
-      String suffix = pattern.substring(pattern.indexOf('*') + 1);
-      matches = assetName.startsWith(prefix) && assetName.endsWith(suffix);
-    } else {
-      matches = (assetName == pattern);
-    }
-    
-    if (matches) {
-      // Find browser_download_url for this asset
-      int urlPos = json.indexOf("\"browser_download_url\"", namePos);
-      if (urlPos >= 0) {
-        colonPos = json.indexOf(':', urlPos + 22);
-        quoteStart = json.indexOf('"', colonPos + 1);
-        quoteEnd = json.indexOf('"', quoteStart + 1);
-        if (quoteStart >= 0 && quoteEnd >= 0) {
-          return json.substring(quoteStart + 1, quoteEnd);
-        }
-      }
-    }
-    
-    searchPos = quoteEnd + 1;
-  }
-  
-  return "";
+#if OTA_FEATURE_HTTP_PULL
+// Installing this image again would only repeat the rollback
+bool ota_internal::bootImageRejected(const uint8_t* sha256) {
+  return g_bootRecord.status == OTA_BOOT_ROLLED_BACK && g_bootRecord.hasDigest &&
+         memcmp(g_bootRecord.sha256, sha256, sizeof(g_bootRecord.sha256)) == 0;
 }
+#endif
 
-int otaCheckGitHubUpdate(char* latestVersion, size_t maxLen) {
-  if (WiFi.status() != WL_CONNECTED) {
-    return OTA_UPDATE_NO_WIFI;
-  }
-  
-  if (g_githubOwner.length() == 0 || g_githubRepo.length() == 0) {
-    Serial.println("[OTA] GitHub repo not configured");
-    return OTA_UPDATE_FAILED;
-  }
-  
-  HTTPClient http;
-  WiFiClientSecure client;
-  client.setInsecure();  // Skip certificate verification
-  
-  String url = "https://api.github.com/repos/" + g_githubOwner + "/" + g_githubRepo + "/releases/latest";
-  
-  Serial.print("[OTA] Checking GitHub releases: ");
-  Serial.println(url);
-  
-  http.begin(client, url);
-  http.addHeader("User-Agent", "Pico-OTA");
-  http.addHeader("Accept", "application/vnd.github.v3+json");
-  
-  int httpCode = http.GET();
-  
-  if (httpCode != 200) {
-    Serial.printf("[OTA] GitHub API error: %d\n", httpCode);
-    http.end();
-    return OTA_UPDATE_HTTP_ERROR;
+static void handleBootGuard() {
+  if (g_bootPending && g_bootValidWindowMs > 0 && millis() >= g_bootValidWindowMs) {
+    Serial.println("[OTA] Firmware not marked valid in time, restarting");
+    statsSeal();
+    delay(100);
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+    rp2040.reboot();
+#else
+    ESP.restart();
+#endif
   }
-  
-  String payload = http.getString();
-  http.end();
-  
-  // Parse tag_name for version
-  g_latestVersion = extractJsonValue(payload, "tag_name");
-  if (g_latestVersion.length() == 0) {
-    Serial.println("[OTA] Failed to parse version from GitHub response");
-    return OTA_UPDATE_PARSE_ERROR;
+}
+
+void otaSetBootGuard(uint8_t maxBoots, unsigned long validWindowMs) {
+  g_bootMaxBoots = maxBoots;
+  g_bootValidWindowMs = validWindowMs;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (!ensureLittleFsMounted()) return;
+#endif
+  if (!loadBootRecord(g_bootRecord)) {
+    bootGuardCheckSpace();
+    return;  // No update installed under the guard
   }
-  
-  // Remove 'v' prefix if present
-  if (g_latestVersion.startsWith("v") || g_latestVersion.startsWith("V")) {
-    g_latestVersion = g_latestVersion.substring(1);
+  if (g_bootRecord.status == OTA_BOOT_ROLLED_BACK) {
+    Serial.println("[OTA] Running the previous firmware, the last update was rolled back");
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+    LittleFS.remove(kPreviousImagePath);  // Restored by now
+#endif
+    bootGuardCheckSpace();
+    return;
   }
-  
-  Serial.print("[OTA] Latest GitHub version: ");
-  Serial.println(g_latestVersion);
-  
-  // Copy to output if provided
-  if (latestVersion && maxLen > 0) {
-    strncpy(latestVersion, g_latestVersion.c_str(), maxLen - 1);
-    latestVersion[maxLen - 1] = '\0';
+  if (g_bootRecord.status != OTA_BOOT_PENDING) {
+    bootGuardCheckSpace();
+    return;
   }
-  
-  // Find download URL for firmware asset
-  g_latestAssetUrl = findAssetUrl(payload, g_githubAssetPattern);
-  if (g_latestAssetUrl.length() == 0) {
-    Serial.println("[OTA] No matching firmware asset found in release");
-    return OTA_UPDATE_NO_ASSET;
+  g_bootPending = true;
+  if (maxBoots == 0) {
+    otaMarkAppValid();  // Guard turned off by the new firmware
+    return;
   }
-  
-  Serial.print("[OTA] Asset URL: ");
-  Serial.println(g_latestAssetUrl);
-  
-  // Compare versions
-  if (g_currentVersion.length() > 0 && g_currentVersion == g_latestVersion) {
-    Serial.println("[OTA] Already running latest version");
-    return OTA_UPDATE_NO_UPDATE;
+  if (g_bootRecord.boots < 255) g_bootRecord.boots++;
+  if (g_bootRecord.boots > maxBoots) {
+    g_bootPending = false;
+    bootGuardRollback();
+    return;
   }
-  
-  return OTA_UPDATE_OK;  // Update available
+  saveBootRecord(g_bootRecord);
+  Serial.printf("[OTA] New firmware, boot %u of %u before rollback; waiting for otaMarkAppValid()\n",
+                (unsigned)g_bootRecord.boots, (unsigned)maxBoots);
 }
 
-int otaUpdateFromGitHub() {
-  // Check for update first
-  int checkResult = otaCheckGitHubUpdate(nullptr, 0);
-  
-  if (checkResult == OTA_UPDATE_NO_UPDATE) {
-    return OTA_UPDATE_NO_UPDATE;
+void otaMarkAppValid() {
+#if defined(ARDUINO_ARCH_ESP32)
+  // Set when the sketch defines verifyRollbackLater() to return true
+  esp_ota_img_states_t state;
+  if (esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) == ESP_OK &&
+      state == ESP_OTA_IMG_PENDING_VERIFY) {
+    esp_ota_mark_app_valid_cancel_rollback();
   }
-  
-  if (checkResult != OTA_UPDATE_OK) {
-    return checkResult;
+#endif
+  if (!g_bootPending) {
+    return;
   }
-  
-  if (g_latestAssetUrl.length() == 0) {
-    return OTA_UPDATE_NO_ASSET;
+  g_bootPending = false;
+  g_bootRecord.status = OTA_BOOT_NORMAL;
+  g_bootRecord.boots = 0;
+  saveBootRecord(g_bootRecord);
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  LittleFS.remove(kPreviousImagePath);
+#endif
+  Serial.println("[OTA] New firmware marked valid");
+}
+
+OtaBootStatus otaGetBootStatus() {
+  if (g_bootPending) {
+    return OTA_BOOT_PENDING;
   }
-  
-  Serial.println("[OTA] Starting GitHub OTA update...");
-  
-  // Download and install
-  return otaUpdateFromUrl(g_latestAssetUrl.c_str(), g_currentVersion.c_str());
+  return g_bootRecord.status == OTA_BOOT_ROLLED_BACK ? OTA_BOOT_ROLLED_BACK : OTA_BOOT_NORMAL;
 }
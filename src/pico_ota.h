@@ -5,6 +5,8 @@
 
 #include <Arduino.h>
 
+#include "pico_ota_config.h"
+
 #if defined(ARDUINO_ARCH_ESP32)
 	// Supported board: ESP32 (ESP32 core)
 #elif defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
@@ -24,11 +26,27 @@
 enum OtaUpdateResult {
     OTA_UPDATE_OK = 0,              // Update successful, device will reboot
     OTA_UPDATE_NO_UPDATE = 1,       // No update available (version check)
+    OTA_UPDATE_IN_PROGRESS = 2,     // Time-sliced update still running (otaUpdateStep())
     OTA_UPDATE_FAILED = -1,         // Update failed (download/write error)
     OTA_UPDATE_NO_WIFI = -2,        // WiFi not connected
     OTA_UPDATE_HTTP_ERROR = -3,     // HTTP request failed
     OTA_UPDATE_PARSE_ERROR = -4,    // Failed to parse response (GitHub JSON)
-    OTA_UPDATE_NO_ASSET = -5        // No suitable firmware asset found
+    OTA_UPDATE_NO_ASSET = -5,       // No suitable firmware asset found
+    OTA_UPDATE_VERIFY_FAILED = -6,  // Image does not match the expected SHA-256
+    OTA_UPDATE_BAD_SIGNATURE = -7,  // Signed mode: manifest missing or not signed by the key
+    OTA_UPDATE_RATE_LIMITED = -8,   // GitHub API rate limit: retry after otaGetGitHubRetryDelay()
+    OTA_UPDATE_WRONG_IMAGE = -9     // Not a firmware image for this board (checked before writing)
+};
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// WiFi Connection State (see otaGetWifiState)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+enum OtaWifiState {
+    OTA_WIFI_IDLE = 0,              // Not started (or not managed by the library)
+    OTA_WIFI_CONNECTING,            // Connection attempt in progress
+    OTA_WIFI_CONNECTED,             // Connected
+    OTA_WIFI_WAITING,               // Disconnected, waiting for the next retry (backoff)
+    OTA_WIFI_GAVE_UP                // Max reconnect attempts reached
 };
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -41,7 +59,8 @@ void otaSetFsAutoFormat(bool enabled);              // Default: true (Pico W / P
 // WiFi Auto-Reconnect (optional, call before otaSetup)
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 void otaSetAutoReconnect(bool enabled);                   // Default: false
-void otaSetReconnectInterval(unsigned long ms);           // Default: 30000ms
+void otaSetReconnectInterval(unsigned long ms);           // Default: 30000ms (first retry, doubles each failure)
+void otaSetReconnectMaxInterval(unsigned long ms);        // Default: 300000ms (backoff cap, +/-25% jitter)
 void otaSetMaxReconnectAttempts(int attempts);            // Default: 0 (infinite)
 void otaOnWifiDisconnect(void (*callback)());             // Called when WiFi drops
 void otaOnWifiReconnect(void (*callback)());              // Called when WiFi reconnects
@@ -71,6 +90,13 @@ bool otaSetupWithTimeout(const char *ssid,
 						 const char *otaPassword = nullptr,
 						 bool allowFsFormat = true);
 
+// Non-blocking setup: returns immediately, otaLoop() finishes the connection
+// and starts OTA once WiFi is up (retries with backoff until it succeeds)
+bool otaSetupAsync(const char *ssid,
+				   const char *password,
+				   const char *hostname = nullptr,
+				   const char *otaPassword = nullptr);
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Runtime (call in loop())
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -81,7 +107,106 @@ void otaLoop();
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 bool otaIsConnected();  // Returns true if Wi-Fi is connected
 bool otaIsReady();      // Returns true if OTA is ready (Wi-Fi connected + OTA started)
+OtaWifiState otaGetWifiState();  // Connection state machine (auto-reconnect / otaSetupAsync)
+
+// Heap usage. Library state and parsing buffers are fixed-size arrays (sizes
+// in pico_ota_config.h), so a steady free heap across update checks shows
+// the path does not allocate. The low-water mark is sampled on update
+// checks, downloads and uploads, and once a second from otaLoop().
+struct OtaHeapStats {
+  uint32_t freeBytes;     // Free heap now
+  uint32_t minFreeBytes;  // Lowest free heap seen since boot / otaResetHeapStats()
+  uint32_t totalBytes;    // Heap size
+};
+void otaGetHeapStats(OtaHeapStats* stats);
+void otaResetHeapStats();
+
+// Progress of the running (or last) HTTP download or upload. The same
+// byte counts go to the otaOnProgress() callback, which can call this for
+// the rate and ETA. The web server also serves it as JSON at /status.
+// otaGetTransferStatus() may be called from any core or task, including
+// while the background worker (below) runs the transfer.
+struct OtaTransferStatus {
+  bool active;              // Transfer in progress
+  bool upload;              // Web or IDE upload (false: HTTP download)
+  uint32_t bytes;           // Received so far
+  uint32_t total;           // Expected size, 0 if unknown (uploads: request size)
+  uint32_t bytesPerSecond;  // Smoothed over the last few seconds
+  uint32_t etaSeconds;      // 0 if unknown or done
+  uint32_t elapsedMs;       // Since the transfer started
+  uint32_t writeMs;         // Of elapsedMs, time spent writing flash
+};
+void otaGetTransferStatus(OtaTransferStatus* status);
+
+// Progress reports. Reads only update the counters; a report is due once
+// both minBytes and minIntervalMs have passed since the last one (and at
+// the end of the transfer), and is delivered where the receive path would
+// wait anyway: socket empty, between chunks, between upload packets. Phase
+// changes are reported at once. The report goes to otaOnProgress(), to the
+// callback below and, in worker mode, to the event queue. Defaults: 4096
+// bytes, 100 ms.
+enum OtaProgressPhase {
+  OTA_PROGRESS_DOWNLOAD = 0,  // HTTP download or LAN peer
+  OTA_PROGRESS_WEB_UPLOAD,    // Web upload (/update)
+  OTA_PROGRESS_IDE_UPLOAD,    // ArduinoOTA
+  OTA_PROGRESS_VERIFY,        // Image complete, checking the digest
+  OTA_PROGRESS_INSTALL,       // Verified, installing and rebooting
+};
+
+struct OtaProgress {
+  OtaProgressPhase phase;
+  uint32_t bytes;           // Received so far
+  uint32_t total;           // Expected size, 0 if unknown
+  uint32_t bytesPerSecond;  // Smoothed over the last few seconds
+  uint32_t etaSeconds;      // 0 if unknown or done
+  uint32_t elapsedMs;       // Since the transfer started
+};
+void otaOnProgressReport(void (*callback)(const OtaProgress* progress));
+void otaSetProgressThrottle(uint32_t minBytes, uint32_t minIntervalMs);
+
+// Telemetry: counters and a latency histogram per phase of the update
+// paths, always recorded. Each event costs a few word stores and no lock,
+// and the numbers can be read from any core or task. They survive the
+// reboots the library does itself (installed update, boot guard), other
+// resets start from zero. The web server serves them at /metrics as JSON,
+// or packed with ?format=binary (extras/ota_metrics.py reads both).
+enum OtaPhase {
+  OTA_PHASE_DNS = 0,      // Host name lookup
+  OTA_PHASE_CONNECT,      // TCP connect + TLS handshake (new connections only)
+  OTA_PHASE_FIRST_BYTE,   // Request sent -> response headers received
+  OTA_PHASE_DOWNLOAD,     // Whole image download (each attempt)
+  OTA_PHASE_FLASH_WRITE,  // One block written to flash / the staging file
+  OTA_PHASE_VERIFY,       // Manifest signature, image digest
+  OTA_PHASE_INSTALL,      // Image complete -> reboot
+  OTA_PHASE_BOOT,         // Power-on -> first WiFi connection
+  OTA_PHASE_RECONNECT,    // WiFi lost -> connected again (auto-reconnect)
+  OTA_PHASE_COUNT
+};
+
+struct OtaPhaseStats {
+  uint32_t count;
+  uint32_t totalMs;
+  uint32_t maxMs;
+  uint32_t buckets[OTA_STATS_BUCKETS];  // [0]: 0 ms, [i]: 2^(i-1) .. 2^i - 1 ms, last: all longer
+};
+
+struct OtaStats {
+  OtaPhaseStats phases[OTA_PHASE_COUNT];
+  uint32_t updatesStarted;     // Update calls, web and IDE uploads (once each, whatever it retries)
+  uint32_t updatesInstalled;   // ... that were installed
+  uint32_t updatesFailed;
+  uint32_t bytesDownloaded;    // From servers and LAN peers
+  uint32_t bytesUploaded;      // Web and IDE uploads
+  uint32_t bytesServed;        // Firmware served to LAN peers
+  uint32_t wifiDisconnects;    // Seen by auto-reconnect / otaSetupAsync()
+  uint32_t reconnectAttempts;
+};
+#if OTA_FEATURE_TELEMETRY
+void otaGetStats(OtaStats* stats);
+void otaResetStats();
+#endif
 
+#if OTA_FEATURE_HTTP_PULL
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // HTTP Pull-Based OTA (download firmware from URL)
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -91,10 +216,90 @@ int otaUpdateFromUrl(const char* url);
 // Update with version check (sends currentVersion to server)
 int otaUpdateFromUrl(const char* url, const char* currentVersion);
 
+// Update with version check and integrity check: the installed image must
+// hash to expectedSha256 (64 hex digits), otherwise it is discarded
+int otaUpdateFromUrl(const char* url, const char* currentVersion, const char* expectedSha256);
+
 // Update from IP:port/path
 int otaUpdateFromHost(const char* host, uint16_t port, const char* path);
 int otaUpdateFromHost(const char* host, uint16_t port, const char* path, const char* currentVersion);
 
+// Downloads use HTTP Range requests and resume after a dropped connection.
+// On Pico W / Pico 2 W the partial image is kept in LittleFS, so calling the
+// same URL again (even after a reboot) continues from the last checkpoint.
+void otaSetDownloadChunkSize(size_t bytes);  // Default: 32768 (bytes per Range request)
+void otaSetDownloadRetries(int retries);     // Default: 5 (consecutive failures without progress)
+void otaClearPendingDownload();              // Discard a partially downloaded image
+
+// Time-sliced updates: the same download as otaUpdateFromUrl(), but run in
+// slices so loop() keeps its timing. otaBeginUpdate() only records the
+// request; otaLoop() then advances it by otaUpdateStep() slices of the
+// budget set here, or the sketch calls otaUpdateStep() itself (budget 0).
+// A slice ends once budgetUs has passed, after at most one more 1 KB read
+// and the flash block write it may complete. Opening a connection and
+// waiting for a response's first byte are not divided (one round trip per
+// chunk on a kept-alive connection; raise otaSetDownloadChunkSize() to
+// need fewer), and the final step verifies, installs and reboots.
+// Callbacks (otaOnStart(), otaOnProgress(), ...) run inside the steps.
+// Until it ends, the blocking update calls return OTA_UPDATE_FAILED, web
+// uploads are refused and ArduinoOTA waits. LAN peers are not asked.
+bool otaBeginUpdate(const char* url, const char* currentVersion = "", const char* expectedSha256 = nullptr);
+int otaUpdateStep(uint32_t budgetUs);  // OTA_UPDATE_IN_PROGRESS, then the result; 0 = run to the end
+int otaGetUpdateResult();              // Same, without stepping
+void otaCancelUpdate();                // Pico W / Pico 2 W: the next update of the URL resumes
+void otaSetUpdateStepBudget(uint32_t budgetUs);  // otaLoop()'s slice, default 2000 us; 0 = none
+
+// Version policy for GitHub releases and signed manifests. Versions are
+// compared by SemVer 2.0 precedence ("v" prefix optional, see ota_semver.h);
+// anything that is not rejected here counts as an update.
+enum OtaVersionPolicy {
+  OTA_VERSION_UPGRADE_ONLY = 0,  // Only versions newer than the running one (default)
+  OTA_VERSION_ANY_CHANGE,        // Any different version, downgrades included
+};
+void otaSetVersionPolicy(OtaVersionPolicy policy);
+void otaSetAllowPrerelease(bool allow);          // Default: false (skip e.g. "1.4.0-rc.1")
+void otaSetMinimumVersion(const char* version);  // Never install older than this (nullptr = no bound)
+
+// Delta updates: a body starting with "OTAD" (made by extras/ota_delta.py) is
+// applied as a patch against the running firmware. Enabling this also sends
+// "x-ota-accept: delta" and makes otaUpdateFromGitHub() prefer a delta asset.
+void otaSetDeltaUpdates(bool enabled);       // Default: false
+
+// Signed mode: every pulled update (URL, host or GitHub) needs "<image URL>.manifest",
+// signed with the matching private key by extras/ota_sign.py. Its size and SHA-256
+// are checked while the image streams in. Pass nullptr to turn signed mode off.
+void otaSetSigningKey(const uint8_t* publicKey);  // 32-byte Ed25519 public key
+
+// LAN peer sharing (signed mode): devices serve their running firmware from
+// the web server (GET /ota/image, announced as mDNS "_pico-ota._tcp"), and
+// signed pulls try those peers before the server. Only the manifest then
+// crosses the uplink per device; the image is checked against it as usual.
+// Needs otaSetup...() (mDNS) and otaStartWebServer() to serve, and both
+// OTA_FEATURE_HTTP_PULL and OTA_FEATURE_WEB. Peers only serve each other
+// with a shared token (otaSetPeerToken(), sent as X-OTA-Peer-Token) or the
+// web credentials (otaSetWebCredentials(), the same on every device); with
+// neither, the image is not served.
+#if OTA_FEATURE_WEB
+void otaSetPeerSharing(bool enabled);  // Default: false
+void otaSetPeerToken(const char* token);  // Shared by the devices of a site (max 32 characters)
+#endif
+
+// TLS connection statistics. Release checks, manifests and downloads share
+// one connection per host and resume each host's TLS session (Pico W /
+// Pico 2 W), so most connections after the first skip the full handshake.
+struct OtaTlsStats {
+  uint32_t handshakes;          // TLS connections opened
+  uint32_t resumeAttempts;      // ... of which offered a cached session (Pico W / Pico 2 W)
+  uint32_t reusedConnections;   // Requests sent on an already open TLS connection
+  uint32_t handshakeMs;         // Total time spent connecting + handshaking
+  uint32_t lastHandshakeMs;
+  uint32_t maxHandshakeMs;
+};
+void otaGetTlsStats(OtaTlsStats* stats);
+void otaResetTlsStats();
+#endif  // OTA_FEATURE_HTTP_PULL
+
+#if OTA_FEATURE_WEB
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // Web Browser Upload Server
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -103,14 +308,151 @@ void otaStopWebServer();                            // Stop HTTP update server
 void otaSetWebCredentials(const char* username,     // Set HTTP Basic Auth (optional)
                           const char* password);
 bool otaIsWebServerRunning();                       // Check if web server is active
+#endif
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // GitHub Release OTA
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+void otaSetCurrentVersion(const char* version);               // e.g., "1.3.0" (also update sources, /status)
+
+#if OTA_FEATURE_GITHUB
 void otaSetGitHubRepo(const char* owner, const char* repo);  // e.g., "wedsamuel1230", "PICO_OTA"
-void otaSetCurrentVersion(const char* version);               // e.g., "1.3.0"
 void otaSetGitHubAssetName(const char* assetPattern);        // e.g., "firmware.bin" or "pico_w.bin"
+void otaSetGitHubDeltaAssetName(const char* deltaPattern);   // Default: "*-from-{from}.otad" ({from} = current version)
 
 int otaCheckGitHubUpdate(char* latestVersion = nullptr, size_t maxLen = 0);  // Check for updates
 int otaUpdateFromGitHub();                                                    // Download and install
 const char* otaGetLatestGitHubVersion();                                     // Get latest version string
+
+// Release metadata is cached with its ETag (in LittleFS on Pico W / Pico 2 W)
+// and revalidated with If-None-Match. Rate-limit answers (Retry-After,
+// X-RateLimit-Remaining: 0) make checks return OTA_UPDATE_RATE_LIMITED
+// without a request until the wait is over.
+unsigned long otaGetGitHubRetryDelay();       // Seconds until the next check may be sent (0 = now)
+void otaSetGitHubApiUrl(const char* baseUrl);  // Default: "https://api.github.com" (e.g. a local stand-in)
+#endif
+
+#if OTA_FEATURE_HTTP_PULL
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Multiple Update Sources (optional)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Places that hold the same image, e.g. a LAN mirror, a CDN and the GitHub
+// release. otaUpdateFromSources() probes each with a small Range request,
+// ranks them by latency + size / measured rate (earlier sources win ties)
+// and downloads from the fastest. A source that stalls or refuses partway
+// through hands over to the next; the bytes so far are kept when the
+// image's SHA-256 is known (signed mode, or X-Firmware-SHA256), otherwise
+// the next source starts from byte 0. Without signed mode, URL sources
+// should answer x-ota-version with 304 when up to date, as for
+// otaUpdateFromUrl().
+struct OtaSourceProbe {
+  bool healthy;             // Sent the first bytes of an image
+  bool upToDate;            // Answered 304, or the release is not newer (GitHub)
+  uint8_t rank;             // Download order, 0 = first; 255 = not used
+  uint32_t latencyMs;       // Connect + request -> response (redirects included)
+  uint32_t bytesPerSecond;  // Over the probe's body
+  uint32_t size;            // Image size it reported
+  uint32_t estimatedMs;     // latencyMs + size / bytesPerSecond
+};
+bool otaAddUpdateSource(const char* url);  // Up to OTA_MAX_SOURCES, most preferred first
+#if OTA_FEATURE_GITHUB
+bool otaAddGitHubSource();                 // The release asset of otaSetGitHubRepo()
+#endif
+void otaClearUpdateSources();
+int otaUpdateFromSources();                // Compares with otaSetCurrentVersion()
+bool otaGetSourceProbe(size_t index, OtaSourceProbe* probe);  // Result of the last probe
+#endif  // OTA_FEATURE_HTTP_PULL
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Boot Guard / Rollback (optional)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Updates installed while the guard is on (pulled, web or ArduinoOTA) boot
+// as "pending". The new firmware must call otaMarkAppValid() within
+// validWindowMs of booting (0 = no deadline), otherwise otaLoop() restarts
+// it; after more than maxBoots boots without it the previous firmware is put
+// back. Call otaSetBootGuard() first thing in setup(), in every firmware
+// version, so boots that crash early are counted too.
+// Pico W / Pico 2 W keep a copy of the running firmware in LittleFS while an
+// update is pending, so the FS needs room for it next to the staged image:
+// about twice the sketch size free. otaSetBootGuard() logs "Rollback
+// unavailable" with both numbers when there is less.
+enum OtaBootStatus {
+  OTA_BOOT_NORMAL = 0,    // Confirmed firmware (or guard never used)
+  OTA_BOOT_PENDING,       // New firmware waiting for otaMarkAppValid()
+  OTA_BOOT_ROLLED_BACK,   // The last update failed its boots and was undone
+};
+void otaSetBootGuard(uint8_t maxBoots = 3, unsigned long validWindowMs = 120000);
+void otaMarkAppValid();             // The new firmware works; drop the fallback
+OtaBootStatus otaGetBootStatus();
+
+#if OTA_FEATURE_HTTP_PULL
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Update Scheduler (optional)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// otaLoop() checks for and installs updates on its own, spread so a fleet
+// that powers on together does not hit the server at once: the first check
+// lands at a per-device point of the startup window after WiFi connects
+// (from a hash of the MAC address), and every interval varies by
+// +/- jitterPercent. Server hints stretch the next wait: Cache-Control:
+// max-age and Retry-After on update responses, and the GitHub API rate
+// limit. Failed checks retry sooner, with backoff. A scheduled update blocks
+// otaLoop() while it runs, unless timeSliced is set for a URL policy.
+// Staged rollouts ("rollout=" in a signed manifest) apply to every pull.
+struct OtaUpdatePolicy {
+  uint32_t intervalSeconds = 0;        // Between checks, 0 = no scheduled checks
+  uint8_t jitterPercent = 10;          // Each interval varies by up to +/- this much
+  uint32_t startupWindowSeconds = 300; // First check somewhere in [0, this) after WiFi connects
+  const char* url = nullptr;           // Image URL (otaUpdateFromUrl), nullptr = update sources or GitHub release
+  bool timeSliced = false;             // url: download with otaBeginUpdate(), pumped by otaLoop()
+};
+void otaSetUpdatePolicy(const OtaUpdatePolicy& policy);  // Call after otaSetCurrentVersion()
+unsigned long otaGetNextCheckDelay();  // Seconds until the next scheduled check (0 = due or off)
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Background Worker (optional)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Runs every library call on a worker so the application never blocks on a
+// download: on Pico W / Pico 2 W the worker is core 1 (call otaWorkerLoop()
+// from loop1()), on ESP32 otaWorkerBegin() starts a FreeRTOS task.
+// The application only sends requests and polls events; both go through
+// lock-free single-producer/single-consumer queues (ota_spsc.h), so:
+// - Configure and call otaSetup...() first, then otaWorkerBegin().
+// - After that, do not call otaLoop() or other library functions yourself;
+//   the worker runs otaLoop() between requests.
+// - Send requests from one core / task only, and poll events from one only.
+// - otaGetTransferStatus() is the one other call the application may make.
+// - Callbacks (otaOnProgress(), ...) run on the worker.
+enum OtaWorkerCommand {
+  OTA_COMMAND_CHECK_GITHUB = 0,   // otaCheckGitHubUpdate()
+  OTA_COMMAND_UPDATE_GITHUB,      // otaUpdateFromGitHub()
+  OTA_COMMAND_UPDATE_URL,         // otaUpdateFromUrl(url, currentVersion)
+};
+
+enum OtaEventType {
+  OTA_EVENT_STARTED = 0,  // The worker took the request
+  OTA_EVENT_PROGRESS,     // Progress report (see otaSetProgressThrottle())
+  OTA_EVENT_DONE,         // Finished with result >= 0 (OK, NO_UPDATE)
+  OTA_EVENT_ERROR,        // Finished with result < 0 (OTA_UPDATE_*)
+};
+
+struct OtaEvent {
+  OtaEventType type;
+  OtaWorkerCommand command;
+  int result;                         // DONE / ERROR: OTA_UPDATE_* code
+  uint32_t bytes;                     // PROGRESS
+  uint32_t total;                     // PROGRESS, 0 if unknown
+  OtaProgressPhase phase;             // PROGRESS
+  uint32_t bytesPerSecond;            // PROGRESS
+  uint32_t etaSeconds;                // PROGRESS, 0 if unknown
+  char version[OTA_MAX_VERSION_LEN];  // DONE of a GitHub check: latest release
+};
+
+bool otaWorkerBegin();         // Enter worker mode (ESP32: starts the task)
+void otaWorkerLoop();          // Pico W / Pico 2 W: call from loop1()
+#if OTA_FEATURE_GITHUB
+bool otaRequestGitHubCheck();  // Queue a request, false if the queue is full
+bool otaRequestGitHubUpdate();
+#endif
+bool otaRequestUpdateFromUrl(const char* url, const char* currentVersion = nullptr);
+bool otaPollEvent(OtaEvent* event);  // Next event, false if none
+#endif  // OTA_FEATURE_HTTP_PULL
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// Sizes of the library's fixed buffers. All settings, release metadata and
+// parsing scratch space are static arrays of these sizes, so nothing on the
+// update path allocates from the heap. Override any of them with a build flag
+// (e.g. -DOTA_MAX_URL_LEN=384 in platformio.ini or build_opt.h); values
+// include the terminating '\0'. Settings that do not fit are rejected with
+// a "[OTA] ... too long" message.
+// Plain preprocessor (no Arduino headers), shared with the portable modules.
+
+#ifndef OTA_MAX_SSID_LEN
+#define OTA_MAX_SSID_LEN 33        // 802.11: up to 32 bytes
+#endif
+
+#ifndef OTA_MAX_PASSWORD_LEN
+#define OTA_MAX_PASSWORD_LEN 65    // WPA2: up to 63 characters or 64 hex digits
+#endif
+
+#ifndef OTA_MAX_HOSTNAME_LEN
+#define OTA_MAX_HOSTNAME_LEN 33
+#endif
+
+#ifndef OTA_MAX_CREDENTIAL_LEN
+#define OTA_MAX_CREDENTIAL_LEN 33  // ArduinoOTA password, web user name / password
+#endif
+
+#ifndef OTA_MAX_GITHUB_NAME_LEN
+#define OTA_MAX_GITHUB_NAME_LEN 101  // Owner or repository name
+#endif
+
+#ifndef OTA_MAX_VERSION_LEN
+#define OTA_MAX_VERSION_LEN 32
+#endif
+
+#ifndef OTA_MAX_ASSET_NAME_LEN
+#define OTA_MAX_ASSET_NAME_LEN 96
+#endif
+
+#ifndef OTA_MAX_URL_LEN
+#define OTA_MAX_URL_LEN 256
+#endif
+
+#ifndef OTA_MAX_REDIRECT_URL_LEN
+#define OTA_MAX_REDIRECT_URL_LEN 1024  // Redirect targets: signed CDN links run to several hundred characters
+#endif
+
+#ifndef OTA_MAX_HOST_LEN
+#define OTA_MAX_HOST_LEN 96        // "host:port" of a server (open connection, TLS session cache)
+#endif
+
+#ifndef OTA_MAX_ETAG_LEN
+#define OTA_MAX_ETAG_LEN 72
+#endif
+
+#ifndef OTA_MAX_SOURCES
+#define OTA_MAX_SOURCES 4          // otaAddUpdateSource() / otaAddGitHubSource() entries
+#endif
+
+#ifndef OTA_IMAGE_WRITE_BLOCK
+#define OTA_IMAGE_WRITE_BLOCK 4096  // Image writes to flash (one flash sector)
+#endif
+
+#ifndef OTA_IMAGE_WRITE_BUFFERS
+#define OTA_IMAGE_WRITE_BUFFERS 2   // Blocks buffered while flash waits for a network gap
+#endif
+
+#ifndef OTA_IMAGE_CHECK_BYTES
+#define OTA_IMAGE_CHECK_BYTES 512   // Image header checked before anything is written (0 = no check)
+#endif
+
+#ifndef OTA_STATS_BUCKETS
+#define OTA_STATS_BUCKETS 18        // Latency histogram buckets per phase, the last one from 65.5 s up
+#endif
+
+#ifndef OTA_WORKER_STACK_SIZE
+#define OTA_WORKER_STACK_SIZE 8192  // ESP32 worker task (bytes), TLS needs most of it
+#endif
+
+// Feature modules. Each is on by default; build with -DOTA_FEATURE_<NAME>=0
+// (the same flag for the sketch and the library, e.g. build_opt.h or
+// platformio.ini build_flags) to leave its code, buffers and Arduino
+// libraries out of the image entirely. The API of a module that is off is
+// not declared, so using it is a compile error rather than a silent no-op.
+// ArduinoOTA, WiFi management, the boot guard and progress reporting are the
+// core and always built. extras/ota_size_report.py prints what each costs.
+
+#ifndef OTA_FEATURE_HTTP_PULL
+#define OTA_FEATURE_HTTP_PULL 1     // otaUpdateFromUrl/Host, time-sliced updates, update sources, scheduler, worker
+#endif
+
+#ifndef OTA_FEATURE_WEB
+#define OTA_FEATURE_WEB 1           // otaStartWebServer(): browser upload, /status, /metrics
+#endif
+
+#ifndef OTA_FEATURE_GITHUB
+#define OTA_FEATURE_GITHUB OTA_FEATURE_HTTP_PULL  // GitHub releases (needs HTTP_PULL)
+#endif
+
+#ifndef OTA_FEATURE_TELEMETRY
+#define OTA_FEATURE_TELEMETRY 1     // otaGetStats() counters and latency histograms
+#endif
+
+#if OTA_FEATURE_GITHUB && !OTA_FEATURE_HTTP_PULL
+#error "OTA_FEATURE_GITHUB needs OTA_FEATURE_HTTP_PULL"
+#endif
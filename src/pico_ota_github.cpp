@@ -0,0 +1,504 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+#if OTA_FEATURE_GITHUB
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// GitHub Release OTA
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+static char g_githubOwner[OTA_MAX_GITHUB_NAME_LEN];
+static char g_githubRepo[OTA_MAX_GITHUB_NAME_LEN];
+static char g_githubAssetPattern[OTA_MAX_ASSET_NAME_LEN];
+static char g_githubDeltaPattern[OTA_MAX_ASSET_NAME_LEN] = "*-from-{from}.otad";
+static char g_latestDeltaUrl[OTA_MAX_URL_LEN];
+static char g_githubApiUrl[OTA_MAX_URL_LEN] = "https://api.github.com";
+static unsigned long g_githubBackoffUntilMs = 0;  // No API requests before this (rate limit)
+static bool g_githubBackoff = false;
+
+namespace ota_internal {
+char g_latestVersion[OTA_MAX_VERSION_LEN];
+char g_latestAssetUrl[OTA_MAX_URL_LEN];
+}  // namespace ota_internal
+
+// "v1.2" and "1.2.0" name the same release
+static bool sameVersion(const char* a, const char* b) {
+  OtaSemver va;
+  OtaSemver vb;
+  if (otaSemverParse(a, &va) && otaSemverParse(b, &vb)) {
+    return otaSemverCompare(va, vb) == 0;
+  }
+  return strcmp(a, b) == 0;
+}
+
+void otaSetGitHubRepo(const char* owner, const char* repo) {
+  if (!storeSetting(g_githubOwner, sizeof(g_githubOwner), owner, "GitHub owner") ||
+      !storeSetting(g_githubRepo, sizeof(g_githubRepo), repo, "GitHub repository")) {
+    g_githubOwner[0] = '\0';
+  }
+}
+
+void otaSetGitHubAssetName(const char* assetPattern) {
+  storeSetting(g_githubAssetPattern, sizeof(g_githubAssetPattern), assetPattern, "Asset name");
+}
+
+void otaSetGitHubDeltaAssetName(const char* deltaPattern) {
+  storeSetting(g_githubDeltaPattern, sizeof(g_githubDeltaPattern), deltaPattern, "Delta asset name");
+}
+
+const char* otaGetLatestGitHubVersion() {
+  return g_latestVersion;
+}
+
+// Parser state is about 700 bytes, too much to put on the stack each check
+static OtaReleaseParser g_releaseParser;
+
+// "*-from-{from}.otad" -> "*-from-1.2.0.otad"; false if it does not fit
+static bool expandDeltaPattern(char* out, size_t outSize, const char* pattern, const char* version) {
+  size_t len = 0;
+  size_t versionLen = strlen(version);
+  while (*pattern) {
+    const char* part = pattern;
+    size_t partLen = 1;
+    if (strncmp(pattern, "{from}", 6) == 0) {
+      part = version;
+      partLen = versionLen;
+      pattern += 6;
+    } else {
+      pattern++;
+    }
+    if (len + partLen >= outSize) {
+      return false;
+    }
+    memcpy(out + len, part, partLen);
+    len += partLen;
+  }
+  out[len] = '\0';
+  return true;
+}
+
+// Copy a response header; false (and "") if it is missing or does not fit
+static bool headerValue(HTTPClient& http, const char* name, char* out, size_t outSize) {
+  const String& value = http.header(name);
+  bool fits = value.length() > 0 && value.length() < outSize;
+  copyString(out, outSize, fits ? value.c_str() : "");
+  return fits;
+}
+
+// Stream the release JSON through the incremental parser in small chunks.
+// Stops as soon as tag_name and a matching asset are known, so the long
+// release body at the end of the document is usually never received.
+static bool readReleaseJson(HTTPClient& http, OtaReleaseParser& parser) {
+  Stream* stream = http.getStreamPtr();
+  if (!stream) return false;
+
+  int remaining = http.getSize();  // -1 when the server sent no Content-Length
+  char chunk[64];
+  unsigned long lastDataMs = millis();
+
+  while (!parser.done() && (remaining > 0 || remaining == -1)) {
+    if (parser.hasTagName() && parser.hasAsset() &&
+        (!parser.wantsDeltaAsset() || parser.hasDeltaAsset())) {
+      break;
+    }
+
+    int available = stream->available();
+    if (available <= 0) {
+      if (!http.connected() || millis() - lastDataMs > 10000) {
+        break;
+      }
+      delay(1);
+      continue;
+    }
+
+    size_t toRead = (size_t)available < sizeof(chunk) ? (size_t)available : sizeof(chunk);
+    if (remaining > 0 && toRead > (size_t)remaining) {
+      toRead = (size_t)remaining;
+    }
+    size_t readLen = stream->readBytes(chunk, toRead);
+    if (readLen == 0) continue;
+
+    lastDataMs = millis();
+    if (remaining > 0) remaining -= (int)readLen;
+    if (!parser.feed(chunk, readLen)) {
+      return false;
+    }
+  }
+
+  return !parser.failed();
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Release metadata cache and rate limiting
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// The last release seen is kept with its ETag so later checks can send
+// If-None-Match; a 304 answer costs no JSON parsing and, for authenticated
+// requests, does not count against the GitHub rate limit.
+static const uint32_t kReleaseCacheMagic = 0x5241544F;  // "OTAR"
+static const unsigned long kRateLimitDefaultS = 60;     // GitHub: wait at least a minute
+static const unsigned long kRateLimitMaxS = 3600;
+
+struct ReleaseCache {
+  uint32_t magic;
+  uint32_t keyHash;     // FNV-1a of repo, asset patterns and running version
+  char etag[OTA_MAX_ETAG_LEN];
+  char tagName[OTA_MAX_VERSION_LEN];
+  char assetUrl[OTA_MAX_URL_LEN];
+  char deltaUrl[OTA_MAX_URL_LEN];
+  uint32_t check;       // CRC32 of all fields above
+};
+
+static ReleaseCache g_releaseCache;
+static bool g_releaseCacheLoaded = false;
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+static const char* kReleaseCachePath = "ota_release.bin";
+#endif
+
+static uint32_t releaseCacheCheck(const ReleaseCache& cache) {
+  return otaCrc32(0, reinterpret_cast<const uint8_t*>(&cache), offsetof(ReleaseCache, check));
+}
+
+// Everything that changes which release/assets a response maps to
+static uint32_t releaseCacheKey(const char* deltaPattern) {
+  // Hash of "<api>|<owner>/<repo>|<asset>|<delta>"
+  const char* parts[] = {g_githubApiUrl, "|", g_githubOwner, "/", g_githubRepo, "|",
+                         g_githubAssetPattern, "|", deltaPattern};
+  uint32_t hash = fnv1a("");
+  for (const char* part : parts) {
+    hash = fnv1a(part, hash);
+  }
+  return hash;
+}
+
+static bool releaseCacheValid(uint32_t keyHash) {
+  if (!g_releaseCacheLoaded) {
+    g_releaseCacheLoaded = true;
+    memset(&g_releaseCache, 0, sizeof(g_releaseCache));
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+    File file = LittleFS.open(kReleaseCachePath, "r");
+    if (file) {
+      file.read(reinterpret_cast<uint8_t*>(&g_releaseCache), sizeof(g_releaseCache));
+      file.close();
+    }
+#endif
+  }
+  return g_releaseCache.magic == kReleaseCacheMagic &&
+         g_releaseCache.check == releaseCacheCheck(g_releaseCache) &&
+         g_releaseCache.keyHash == keyHash && g_releaseCache.etag[0];
+}
+
+// Only called when the release changed, so flash is written rarely
+static void releaseCacheStore(uint32_t keyHash, const char* etag, const char* tagName,
+                              const char* assetUrl, const char* deltaUrl) {
+  memset(&g_releaseCache, 0, sizeof(g_releaseCache));
+  if (!etag[0] || strlen(tagName) >= sizeof(g_releaseCache.tagName)) {
+    return;  // Nothing usable for If-None-Match
+  }
+  g_releaseCache.magic = kReleaseCacheMagic;
+  g_releaseCache.keyHash = keyHash;
+  copyString(g_releaseCache.etag, sizeof(g_releaseCache.etag), etag);
+  copyString(g_releaseCache.tagName, sizeof(g_releaseCache.tagName), tagName);
+  copyString(g_releaseCache.assetUrl, sizeof(g_releaseCache.assetUrl), assetUrl);
+  copyString(g_releaseCache.deltaUrl, sizeof(g_releaseCache.deltaUrl), deltaUrl);
+  g_releaseCache.check = releaseCacheCheck(g_releaseCache);
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (ensureLittleFsMounted()) {
+    File file = LittleFS.open(kReleaseCachePath, "w");
+    if (file) {
+      file.write(reinterpret_cast<const uint8_t*>(&g_releaseCache), sizeof(g_releaseCache));
+      file.close();
+    }
+  }
+#endif
+}
+
+// "Sun, 06 Nov 1994 08:49:37 GMT" -> Unix time, 0 if unparsable
+static unsigned long parseHttpDate(const String& value) {
+  static const char kMonths[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  char month[4] = "";
+  int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+  if (sscanf(value.c_str(), "%*3s, %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6) {
+    return 0;
+  }
+  const char* found = strstr(kMonths, month);
+  if (!found || strlen(month) != 3 || year < 1970) {
+    return 0;
+  }
+  int m = (int)(found - kMonths) / 3 + 1;
+
+  // Days since 1970-01-01 (civil calendar, March-based year)
+  int y = year - (m <= 2);
+  int era = y / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  long days = (long)era * 146097 + doe - 719468;
+  return (unsigned long)days * 86400UL + hour * 3600UL + minute * 60UL + second;
+}
+
+// Seconds the API asks us to wait before the next request, 0 if none
+static unsigned long rateLimitDelay(HTTPClient& http, int httpCode) {
+  unsigned long delayS = 0;
+  String retryAfter = http.header("Retry-After");
+  if (retryAfter.length() > 0) {
+    delayS = strtoul(retryAfter.c_str(), nullptr, 10);
+  } else if (http.header("X-RateLimit-Remaining") == "0") {
+    // Reset is wall-clock time; the server's Date stands in for our clock
+    unsigned long reset = strtoul(http.header("X-RateLimit-Reset").c_str(), nullptr, 10);
+    unsigned long now = parseHttpDate(http.header("Date"));
+    delayS = (reset > now && now != 0) ? reset - now : kRateLimitDefaultS;
+  }
+  if (delayS == 0 && (httpCode == 403 || httpCode == 429)) {
+    delayS = kRateLimitDefaultS;  // Secondary rate limit without headers
+  }
+  return delayS < kRateLimitMaxS ? delayS : kRateLimitMaxS;
+}
+
+unsigned long otaGetGitHubRetryDelay() {
+  if (!g_githubBackoff) {
+    return 0;
+  }
+  long remainingMs = (long)(g_githubBackoffUntilMs - millis());
+  if (remainingMs <= 0) {
+    g_githubBackoff = false;
+    return 0;
+  }
+  return (unsigned long)(remainingMs + 999) / 1000;
+}
+
+void otaSetGitHubApiUrl(const char* baseUrl) {
+  if (!baseUrl || !*baseUrl || !storeSetting(g_githubApiUrl, sizeof(g_githubApiUrl), baseUrl, "API URL")) {
+    copyString(g_githubApiUrl, sizeof(g_githubApiUrl), "https://api.github.com");
+  }
+  size_t len = strlen(g_githubApiUrl);
+  if (len > 0 && g_githubApiUrl[len - 1] == '/') {
+    g_githubApiUrl[len - 1] = '\0';
+  }
+}
+
+int otaCheckGitHubUpdate(char* latestVersion, size_t maxLen) {
+  if (updateBusy()) {
+    return OTA_UPDATE_FAILED;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    return OTA_UPDATE_NO_WIFI;
+  }
+  
+  if (!g_githubOwner[0] || !g_githubRepo[0]) {
+    Serial.println("[OTA] GitHub repo not configured");
+    return OTA_UPDATE_FAILED;
+  }
+
+  unsigned long waitS = otaGetGitHubRetryDelay();
+  if (waitS > 0) {
+    Serial.printf("[OTA] GitHub API rate limited, next check allowed in %lu s\n", waitS);
+    return OTA_UPDATE_RATE_LIMITED;
+  }
+  
+  char url[OTA_MAX_URL_LEN];
+  if ((size_t)snprintf(url, sizeof(url), "%s/repos/%s/%s/releases/latest", g_githubApiUrl, g_githubOwner,
+                       g_githubRepo) >= sizeof(url)) {
+    Serial.println("[OTA] GitHub API URL too long");
+    return OTA_UPDATE_FAILED;
+  }
+  
+  Serial.print("[OTA] Checking GitHub releases: ");
+  Serial.println(url);
+
+  // Delta asset for the running version: "{from}" becomes g_currentVersion
+  char deltaPattern[OTA_MAX_ASSET_NAME_LEN];
+  bool wantDelta = g_deltaUpdates && g_currentVersion[0] &&
+                   expandDeltaPattern(deltaPattern, sizeof(deltaPattern), g_githubDeltaPattern, g_currentVersion) &&
+                   deltaPattern[0];
+  uint32_t cacheKey = releaseCacheKey(wantDelta ? deltaPattern : "");
+  bool cached = releaseCacheValid(cacheKey);
+  heapSample();
+  
+  // Shared client: the TLS session to the API host is resumed on later checks
+  WiFiClient* client = openConnection(url);
+  if (!client) {
+    return OTA_UPDATE_HTTP_ERROR;
+  }
+  HTTPClient& http = g_dlHttp;
+  http.setReuse(true);
+  http.setFollowRedirects(HTTPC_DISABLE_FOLLOW_REDIRECTS);
+  if (!http.begin(*client, url)) {
+    Serial.println("[OTA] GitHub API request could not be started");
+    closeConnection();
+    return OTA_UPDATE_HTTP_ERROR;
+  }
+  http.useHTTP10(true);  // No chunked transfer encoding, so the body can be parsed as it arrives
+  http.addHeader("User-Agent", "Pico-OTA");
+  http.addHeader("Accept", "application/vnd.github.v3+json");
+  if (cached) {
+    http.addHeader("If-None-Match", g_releaseCache.etag);
+  }
+  const char* headerKeys[] = {"ETag", "Retry-After", "X-RateLimit-Remaining", "X-RateLimit-Reset", "Date",
+                              "Cache-Control"};
+  http.collectHeaders(headerKeys, 6);
+  
+  unsigned long requestMs = millis();
+  int httpCode = http.GET();
+  if (httpCode > 0) {
+    statsRecord(OTA_PHASE_FIRST_BYTE, (uint32_t)(millis() - requestMs));
+    recordServerHint(http);
+  }
+
+  unsigned long delayS = httpCode > 0 ? rateLimitDelay(http, httpCode) : 0;
+  if (delayS > 0) {
+    g_githubBackoff = true;
+    g_githubBackoffUntilMs = millis() + delayS * 1000UL;
+    Serial.printf("[OTA] GitHub API rate limit reached, backing off for %lu s\n", delayS);
+  }
+  
+  const char* tagName;
+  if (httpCode == 304 && cached) {
+    http.end();
+    Serial.println("[OTA] GitHub release unchanged (304), using cached metadata");
+    tagName = g_releaseCache.tagName;
+    copyString(g_latestAssetUrl, sizeof(g_latestAssetUrl), g_releaseCache.assetUrl);
+    copyString(g_latestDeltaUrl, sizeof(g_latestDeltaUrl), g_releaseCache.deltaUrl);
+  } else if (httpCode != 200) {
+    Serial.printf("[OTA] GitHub API error: %d\n", httpCode);
+    http.end();
+    return (delayS > 0 && (httpCode == 403 || httpCode == 429)) ? OTA_UPDATE_RATE_LIMITED
+                                                                : OTA_UPDATE_HTTP_ERROR;
+  } else {
+    char etag[OTA_MAX_ETAG_LEN];
+    if (!headerValue(http, "ETag", etag, sizeof(etag))) {
+      etag[0] = '\0';  // Too long to send back, so not cached
+    }
+    g_releaseParser.reset(g_githubAssetPattern, wantDelta ? deltaPattern : nullptr);
+    OtaReleaseParser& parser = g_releaseParser;
+    bool parsed = readReleaseJson(http, parser);
+    http.end();
+    
+    // Parse tag_name for version
+    if (!parsed || !parser.hasTagName()) {
+      Serial.println("[OTA] Failed to parse version from GitHub response");
+      return OTA_UPDATE_PARSE_ERROR;
+    }
+    tagName = parser.tagName();
+    copyString(g_latestAssetUrl, sizeof(g_latestAssetUrl), parser.assetUrl());
+    copyString(g_latestDeltaUrl, sizeof(g_latestDeltaUrl), parser.deltaAssetUrl());
+    releaseCacheStore(cacheKey, etag, parser.tagName(), parser.assetUrl(), parser.deltaAssetUrl());
+  }
+  
+  // Remove 'v' prefix if present
+  copyString(g_latestVersion, sizeof(g_latestVersion), tagName + (tagName[0] == 'v' || tagName[0] == 'V'));
+  
+  Serial.print("[OTA] Latest GitHub version: ");
+  Serial.println(g_latestVersion);
+  
+  // Copy to output if provided
+  if (latestVersion && maxLen > 0) {
+    copyString(latestVersion, maxLen, g_latestVersion);
+  }
+  
+  // Find download URL for firmware asset
+  if (!g_latestAssetUrl[0]) {
+    Serial.println("[OTA] No matching firmware asset found in release");
+    return OTA_UPDATE_NO_ASSET;
+  }
+  
+  Serial.print("[OTA] Asset URL: ");
+  Serial.println(g_latestAssetUrl);
+
+  if (g_latestDeltaUrl[0]) {
+    Serial.print("[OTA] Delta asset URL: ");
+    Serial.println(g_latestDeltaUrl);
+  }
+  
+  // Compare versions (SemVer precedence, see otaSetVersionPolicy())
+  if (!versionIsUpdate(g_currentVersion, g_latestVersion)) {
+    return OTA_UPDATE_NO_UPDATE;
+  }
+  
+  return OTA_UPDATE_OK;  // Update available
+}
+
+// Fetch "<asset>.sha256" from the same release. Its digest covers the
+// installed image, so it applies to the delta path too.
+static bool fetchGitHubSha256(char* hex, size_t hexSize) {
+  if (fetchSmallFile(g_latestAssetUrl, ".sha256") != 200) {  // "<64 hex digits>  <file name>"
+    return false;
+  }
+
+  uint8_t digest[OtaSha256::kDigestSize];
+  if (hexSize < sizeof(digest) * 2 + 1 || !otaParseSha256Hex(g_smallFile, digest)) {
+    return false;
+  }
+  // Just the digits: the sidecar line goes on with the file name
+  for (size_t i = 0; i < sizeof(digest); i++) {
+    snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+  }
+  return true;
+}
+
+int otaUpdateFromGitHub() {
+  // Check for update first
+  int checkResult = otaCheckGitHubUpdate(nullptr, 0);
+  
+  if (checkResult == OTA_UPDATE_NO_UPDATE) {
+    return OTA_UPDATE_NO_UPDATE;
+  }
+  
+  if (checkResult != OTA_UPDATE_OK) {
+    return checkResult;
+  }
+  
+  if (!g_latestAssetUrl[0]) {
+    return OTA_UPDATE_NO_ASSET;
+  }
+  
+  Serial.println("[OTA] Starting GitHub OTA update...");
+
+  // Signed mode: one manifest (next to the full image) covers both the
+  // delta and the full download, and must be for the release's tag
+  OtaManifest manifest;
+  const OtaManifest* signedManifest = nullptr;
+  char digest[OtaSha256::kDigestSize * 2 + 1] = "";
+  if (g_signingKeySet) {
+    int result = fetchManifest(g_latestAssetUrl, manifest);
+    if (result == OTA_UPDATE_OK && !sameVersion(g_latestVersion, manifest.version)) {
+      Serial.println("[OTA] Manifest is for a different release");
+      result = OTA_UPDATE_BAD_SIGNATURE;
+    }
+    if (result != OTA_UPDATE_OK) {
+      statsManifestFailed();
+      if (g_onErrorCallback) g_onErrorCallback(result);
+      return result;
+    }
+    if (!rolloutIncludes(manifest)) {
+      return OTA_UPDATE_NO_UPDATE;
+    }
+    signedManifest = &manifest;
+  } else if (fetchGitHubSha256(digest, sizeof(digest))) {
+    Serial.println("[OTA] Using SHA-256 from release");
+  } else {
+    Serial.println("[OTA] No .sha256 asset in release, image will not be hash-checked");
+  }
+
+  statsAdd(offsetof(OtaStats, updatesStarted), 1);  // Once, even when the delta falls back to the full image
+  if (g_latestDeltaUrl[0]) {
+    Serial.print("[OTA] Starting HTTP update from: ");
+    Serial.println(g_latestDeltaUrl);
+    int result = downloadImage(g_latestDeltaUrl, g_currentVersion, digest, signedManifest);
+    transferEnd();
+    if (result != OTA_UPDATE_FAILED && result != OTA_UPDATE_VERIFY_FAILED) {
+      if (result < 0) statsAdd(offsetof(OtaStats, updatesFailed), 1);
+      return result;
+    }
+    Serial.println("[OTA] Delta update failed, falling back to the full image");
+  }
+  
+  // Download and install
+  Serial.print("[OTA] Starting HTTP update from: ");
+  Serial.println(g_latestAssetUrl);
+  return downloadFirmware(g_latestAssetUrl, g_currentVersion, digest, signedManifest);
+}
+
+#endif  // OTA_FEATURE_GITHUB
+
@@ -0,0 +1,1750 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// HTTP download engine
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Firmware is fetched with HTTP Range requests of g_downloadChunkSize bytes.
+// After each request the written bytes are flushed and a small journal is
+// rewritten, so an interrupted transfer continues where it stopped instead
+// of starting again from byte 0.
+// - Pico W / Pico 2 W: the image is staged in LittleFS and handed to picoOTA
+//   once complete, so a download can resume even after a reboot.
+// - ESP32: bytes go straight to the OTA partition through Update, so resume
+//   works across dropped connections within the same update call.
+// Every byte written to the image is also hashed with SHA-256 on its way to
+// flash; if an expected digest is known (API argument, X-Firmware-SHA256
+// header or GitHub .sha256 sidecar) the image is only installed if it matches.
+// The body may also be compressed (see ota_lzss.h) and/or a delta patch (see
+// ota_delta.h), detected from its first bytes. Decoder state lives in RAM,
+// so such a download resumes after a dropped connection but starts over
+// after a reboot.
+// Web uploads share the image writer and decoders (OTA_STAGING), not the
+// HTTP client.
+#if OTA_FEATURE_HTTP_PULL
+static const unsigned long kStallTimeoutMs = 10000;
+static const int kMaxRedirects = 5;
+
+enum ChunkResult {
+  CHUNK_OK,             // Received the requested range (or the whole image)
+  CHUNK_AGAIN,          // Redirect or protocol fallback, request again immediately
+  CHUNK_NOT_MODIFIED,   // Server says the current version is up to date (304)
+  CHUNK_RETRY,          // Transient failure (connection, 5xx, stall)
+  CHUNK_REFUSED,        // Server refused (4xx): another source may still have the image
+  CHUNK_FATAL,          // Non-recoverable (flash/FS error, bad redirect)
+  CHUNK_PENDING         // Not finished yet: a body follows, or a time slice ran out
+};
+
+static WiFiClient g_dlClient;
+static WiFiClientSecure g_dlSecureClient;
+
+static size_t g_downloadChunkSize = 32768;  // Default: 32 KB per Range request
+static int g_downloadRetries = 5;           // Consecutive failures without progress
+static uint8_t g_signingKey[OTA_ED25519_KEY_SIZE];
+static OtaVersionPolicy g_versionPolicy = OTA_VERSION_UPGRADE_ONLY;
+static bool g_allowPrerelease = false;
+static char g_minimumVersion[OTA_MAX_VERSION_LEN] = "";      // Empty = no lower bound
+
+namespace ota_internal {
+
+HTTPClient g_dlHttp;
+bool g_deltaUpdates = false;   // Advertise delta support / prefer delta assets
+bool g_signingKeySet = false;  // Signed mode: pulled updates need a manifest
+
+// Pass the previous result as hash to hash several strings as one
+uint32_t fnv1a(const char* s, uint32_t hash) {
+  while (*s) {
+    hash ^= (uint8_t)*s++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+}  // namespace ota_internal
+
+namespace {
+
+// "https://host:port/path" -> "host:port"; false if it does not fit
+bool extractHost(const char* url, char* host, size_t hostSize) {
+  const char* start = strstr(url, "://");
+  start = start ? start + 3 : url;
+  size_t len = strcspn(start, "/?#");
+  if (len >= hostSize) {
+    host[0] = '\0';
+    return false;
+  }
+  memcpy(host, start, len);
+  host[len] = '\0';
+  return true;
+}
+
+bool isHttpsUrl(const char* url) {
+  return strncmp(url, "https://", 8) == 0;
+}
+
+}  // namespace
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Connection reuse and TLS sessions
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// All requests (release checks, manifests, image chunks) go through one
+// client pair. A connection stays open while requests go to the same host,
+// and each host's TLS session is kept so reconnecting (the next redirect
+// hop, the next check) resumes it instead of a full handshake. Only one
+// connection is open at a time, so the TLS buffers are allocated once.
+static const int kTlsSessionSlots = 4;  // api.github.com, github.com, CDN, own server
+
+struct TlsSessionSlot {
+  char host[OTA_MAX_HOST_LEN];
+  unsigned long lastUsedMs;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  BearSSL::Session session;  // Filled in by the client after each handshake
+#endif
+};
+
+static TlsSessionSlot g_tlsSessions[kTlsSessionSlots];
+static OtaTlsStats g_tlsStats;
+static char g_connHost[OTA_MAX_HOST_LEN];  // "host:port" the shared client is connected to
+static bool g_connSecure = false;
+
+// Session for host, taking over the least recently used slot if it has none
+static TlsSessionSlot* tlsSessionFor(const char* host, bool& known) {
+  TlsSessionSlot* slot = &g_tlsSessions[0];
+  for (int i = 0; i < kTlsSessionSlots; i++) {
+    if (strcmp(g_tlsSessions[i].host, host) == 0) {
+      known = true;
+      g_tlsSessions[i].lastUsedMs = millis();
+      return &g_tlsSessions[i];
+    }
+    if (g_tlsSessions[i].lastUsedMs < slot->lastUsedMs) {
+      slot = &g_tlsSessions[i];
+    }
+  }
+  known = false;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  slot->session = BearSSL::Session();  // Never offer another host's session
+#endif
+  copyString(slot->host, sizeof(slot->host), host);
+  slot->lastUsedMs = millis();
+  return slot;
+}
+
+// Connected client for url's host: the open connection if it is to the same
+// host, otherwise a new one (resuming the host's TLS session if possible)
+WiFiClient* ota_internal::openConnection(const char* url) {
+  char hostPort[sizeof(g_connHost)];
+  if (!extractHost(url, hostPort, sizeof(hostPort))) {
+    Serial.printf("[OTA] Host name too long (max %u characters; see OTA_MAX_HOST_LEN)\n",
+                  (unsigned)(sizeof(hostPort) - 1));
+    return nullptr;
+  }
+  bool secure = isHttpsUrl(url);
+  WiFiClient* client = secure ? static_cast<WiFiClient*>(&g_dlSecureClient) : &g_dlClient;
+
+  if (secure == g_connSecure && strcmp(hostPort, g_connHost) == 0 && client->connected()) {
+    if (secure) g_tlsStats.reusedConnections++;
+    return client;
+  }
+
+  g_dlClient.stop();
+  g_dlSecureClient.stop();
+  g_connHost[0] = '\0';
+
+  char host[sizeof(hostPort)];
+  copyString(host, sizeof(host), hostPort);
+  uint16_t port = secure ? 443 : 80;
+  char* colon = strrchr(host, ':');
+  if (colon) {
+    port = (uint16_t)atoi(colon + 1);
+    *colon = '\0';
+  }
+
+  bool resumable = false;
+  if (secure) {
+    g_dlSecureClient.setInsecure();  // Skip certificate verification
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+    g_dlSecureClient.setSession(&tlsSessionFor(host, resumable)->session);
+#endif
+  }
+
+  // Resolved on its own to time the lookup; connect() then finds the
+  // address in the DNS cache and still has the name for TLS SNI
+  IPAddress address;
+  unsigned long startMs = millis();
+  bool resolved = WiFi.hostByName(host, address) == 1;
+  statsRecord(OTA_PHASE_DNS, (uint32_t)(millis() - startMs));
+  if (!resolved) {
+    Serial.printf("[OTA] Resolving %s failed\n", host);
+    return nullptr;
+  }
+
+  startMs = millis();
+  if (!client->connect(host, port)) {
+    Serial.printf("[OTA] Connecting to %s failed\n", hostPort);
+    return nullptr;
+  }
+  statsRecord(OTA_PHASE_CONNECT, (uint32_t)(millis() - startMs));
+  if (secure) {
+    unsigned long tookMs = millis() - startMs;
+    g_tlsStats.handshakes++;
+    if (resumable) g_tlsStats.resumeAttempts++;
+    g_tlsStats.handshakeMs += tookMs;
+    g_tlsStats.lastHandshakeMs = tookMs;
+    if (tookMs > g_tlsStats.maxHandshakeMs) g_tlsStats.maxHandshakeMs = tookMs;
+    Serial.printf("[OTA] TLS handshake with %s: %lu ms%s\n", host, tookMs,
+                  resumable ? " (session resumption offered)" : "");
+  }
+  g_connSecure = secure;
+  copyString(g_connHost, sizeof(g_connHost), hostPort);
+  return client;
+}
+
+// Drop the shared connection, e.g. with a response body still unread
+void ota_internal::closeConnection() {
+  g_dlHttp.end();
+  g_dlClient.stop();
+  g_dlSecureClient.stop();
+  g_connHost[0] = '\0';
+}
+
+void otaGetTlsStats(OtaTlsStats* stats) {
+  if (stats) {
+    *stats = g_tlsStats;
+  }
+}
+
+void otaResetTlsStats() {
+  memset(&g_tlsStats, 0, sizeof(g_tlsStats));
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Chunk transfer
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+namespace {
+
+// Wait between retries without blocking WiFi recovery
+void waitWithReconnect(unsigned long ms) {
+  unsigned long startMs = millis();
+  while (millis() - startMs < ms) {
+    handleAutoReconnect();
+    delay(10);
+  }
+}
+
+// "bytes 1000-1999/5000" -> first, last, total (total stays 0 for "*")
+bool parseContentRange(const String& value, uint32_t& first, uint32_t& last, uint32_t& total) {
+  const char* s = value.c_str();
+  if (strncmp(s, "bytes ", 6) != 0) return false;
+  char* end = nullptr;
+  first = (uint32_t)strtoul(s + 6, &end, 10);
+  if (!end || *end != '-') return false;
+  last = (uint32_t)strtoul(end + 1, &end, 10);
+  if (!end || *end != '/' || last < first) return false;
+  total = (end[1] == '*') ? 0 : (uint32_t)strtoul(end + 1, nullptr, 10);
+  return true;
+}
+
+// If-Range only accepts strong validators
+void storeEtag(const String& etag) {
+  copyString(g_dl.etag, sizeof(g_dl.etag), etag.startsWith("W/") ? "" : etag.c_str());
+}
+
+// Range offsets then count compressed bytes, as for any Content-Encoding
+void checkContentEncoding() {
+  if (g_dlHttp.header("Content-Encoding").equalsIgnoreCase("heatshrink")) {
+    pipelineUseContentEncoding();
+  }
+}
+
+// A digest passed by the caller takes precedence over the server's
+void storeDigestHeader() {
+  if (!g_dl.hasExpectedSha256) {
+    String value = g_dlHttp.header("X-Firmware-SHA256");
+    g_dl.hasExpectedSha256 = value.length() > 0 && otaParseSha256Hex(value.c_str(), g_dl.expectedSha256);
+  }
+}
+
+bool isRedirect(int code) {
+  return code == 301 || code == 302 || code == 303 || code == 307 || code == 308;
+}
+
+}  // namespace
+
+// Longest wait a response asked for since the last scheduled check:
+// Retry-After (seconds) or Cache-Control max-age
+static const uint32_t kServerHintMaxS = 7UL * 24 * 3600;
+static uint32_t g_serverHintS = 0;
+
+void ota_internal::recordServerHint(HTTPClient& http) {
+  uint32_t hint = 0;
+  String retryAfter = http.header("Retry-After");
+  if (retryAfter.length() > 0) {
+    hint = (uint32_t)strtoul(retryAfter.c_str(), nullptr, 10);
+  }
+  String cacheControl = http.header("Cache-Control");
+  const char* maxAge = strstr(cacheControl.c_str(), "max-age=");
+  if (maxAge) {
+    uint32_t seconds = (uint32_t)strtoul(maxAge + 8, nullptr, 10);
+    if (seconds > hint) hint = seconds;
+  }
+  if (hint > kServerHintMaxS) hint = kServerHintMaxS;
+  if (hint > g_serverHintS) g_serverHintS = hint;
+}
+
+// Response body of the current range request, received in one go
+// (blocking transfers) or a slice at a time (time-sliced updates)
+struct BodyState {
+  uint32_t expected;
+  uint32_t received;
+  bool lengthKnown;
+  unsigned long lastDataMs;
+};
+static BodyState g_body;
+
+static void bodyBegin(uint32_t expected, bool lengthKnown) {
+  g_body.expected = expected;
+  g_body.received = 0;
+  g_body.lengthKnown = lengthKnown;
+  g_body.lastDataMs = millis();
+}
+
+// Stream the response body into the image writer. With budgetUs 0 this
+// waits for the whole body; otherwise it returns CHUNK_PENDING once budgetUs
+// has passed or the socket has nothing to read.
+static ChunkResult receiveBody(uint32_t budgetUs) {
+  Stream* stream = g_dlHttp.getStreamPtr();
+  if (!stream) return CHUNK_RETRY;
+
+  uint32_t startUs = micros();
+  while (!g_body.lengthKnown || g_body.received < g_body.expected) {
+    int available = stream->available();
+    if (available <= 0) {
+      if (!g_dlHttp.connected()) break;
+      progressDispatch();
+      if (!imageWriteIdle()) return CHUNK_FATAL;
+      if (millis() - g_body.lastDataMs > kStallTimeoutMs) {
+        Serial.println("[OTA] Download stalled");
+        break;
+      }
+      if (budgetUs) return CHUNK_PENDING;
+      delay(1);
+      continue;
+    }
+    if (budgetUs && (uint32_t)(micros() - startUs) >= budgetUs) {
+      return CHUNK_PENDING;
+    }
+
+    size_t toRead = (size_t)available < sizeof(g_dlBuffer) ? (size_t)available : sizeof(g_dlBuffer);
+    if (g_body.lengthKnown && toRead > g_body.expected - g_body.received) {
+      toRead = g_body.expected - g_body.received;
+    }
+    size_t readLen = stream->readBytes(g_dlBuffer, toRead);
+    if (readLen == 0) continue;
+    g_body.lastDataMs = millis();
+
+    if (!pipelineWrite(g_dlBuffer, readLen)) {
+      return CHUNK_FATAL;
+    }
+
+    g_dl.crc = otaCrc32(g_dl.crc, g_dlBuffer, readLen);
+    g_dl.offset += readLen;
+    g_body.received += readLen;
+
+    transferProgress(g_dl.offset, g_dl.sizeKnown ? g_dl.totalSize : 0);
+  }
+
+  if (!g_body.lengthKnown && !g_dlHttp.connected()) {
+    // No Content-Length: the connection closing marks the end of the image
+    g_dl.totalSize = g_dl.offset;
+    g_dl.sizeKnown = true;
+    return CHUNK_OK;
+  }
+  return (g_body.received == g_body.expected) ? CHUNK_OK : CHUNK_RETRY;
+}
+
+// Location of a redirect into dest. Refused (and logged) rather than
+// followed truncated or to another scheme.
+static bool takeRedirect(const String& location, char* dest, size_t destSize) {
+  if (!location.startsWith("http://") && !location.startsWith("https://")) {
+    Serial.println("[OTA] Unsupported redirect target");
+    return false;
+  }
+  if (location.length() >= destSize) {
+    Serial.printf("[OTA] Redirect URL too long (%u characters, max %u; see OTA_MAX_REDIRECT_URL_LEN)\n",
+                  (unsigned)location.length(), (unsigned)(destSize - 1));
+    return false;
+  }
+  copyString(dest, destSize, location.c_str());
+  return true;
+}
+
+// Request the next range of the image. CHUNK_PENDING: the response body
+// follows, read it with receiveBody().
+static ChunkResult requestChunk() {
+  heapSample();
+  WiFiClient* client = openConnection(g_dl.url);
+  if (!client) {
+    return CHUNK_RETRY;
+  }
+
+  g_dlHttp.setReuse(true);  // Use the connection opened above (HTTP/1.0 still closes it)
+  g_dlHttp.useHTTP10(g_dl.http10);
+  g_dlHttp.setFollowRedirects(HTTPC_DISABLE_FOLLOW_REDIRECTS);
+  g_dlHttp.setTimeout((uint16_t)kStallTimeoutMs);
+  if (!g_dlHttp.begin(*client, g_dl.url)) {
+    closeConnection();
+    return CHUNK_FATAL;
+  }
+
+  g_dlHttp.addHeader("User-Agent", "Pico-OTA");
+  char range[48];
+  uint32_t rangeEnd = g_dl.offset + (uint32_t)g_downloadChunkSize - 1;
+  if (g_dl.sizeKnown && rangeEnd >= g_dl.totalSize) {
+    rangeEnd = g_dl.totalSize - 1;
+  }
+  snprintf(range, sizeof(range), "bytes=%lu-%lu", (unsigned long)g_dl.offset, (unsigned long)rangeEnd);
+  g_dlHttp.addHeader("Range", range);
+  if (g_dl.offset > 0 && g_dl.etag[0]) {
+    g_dlHttp.addHeader("If-Range", g_dl.etag);  // Full 200 response if the file changed
+  }
+  // Formats the pipeline can take; a server may answer with a patch for
+  // x-ota-version or a compressed body
+  g_dlHttp.addHeader("x-ota-accept", g_deltaUpdates ? "heatshrink, delta" : "heatshrink");
+  if (g_dl.currentVersion && *g_dl.currentVersion) {
+    g_dlHttp.addHeader("x-ota-version", g_dl.currentVersion);
+#if defined(ARDUINO_ARCH_ESP32)
+    g_dlHttp.addHeader("x-ESP32-version", g_dl.currentVersion);  // Header sent by HTTPUpdate
+#endif
+  }
+#if OTA_PEERS
+  // Peers only serve devices that know the token or the web credentials
+  if (g_dl.fromPeer && g_peerToken[0]) {
+    g_dlHttp.addHeader("X-OTA-Peer-Token", g_peerToken);
+  } else if (g_dl.fromPeer && g_webUsername[0] && g_webPassword[0]) {
+    g_dlHttp.setAuthorization(g_webUsername, g_webPassword);
+  }
+#endif
+
+  const char* headerKeys[] = {"Content-Range", "ETag",          "Location",   "Content-Encoding",
+                              "X-Firmware-SHA256", "Cache-Control", "Retry-After"};
+  g_dlHttp.collectHeaders(headerKeys, 7);
+
+  unsigned long requestMs = millis();
+  int httpCode = g_dlHttp.GET();
+  if (httpCode > 0) {
+    statsRecord(OTA_PHASE_FIRST_BYTE, (uint32_t)(millis() - requestMs));
+  }
+  if (httpCode <= 0) {
+    Serial.printf("[OTA] HTTP request failed: %s\n", HTTPClient::errorToString(httpCode).c_str());
+    g_dlHttp.end();
+    client->stop();
+    return CHUNK_RETRY;
+  }
+  recordServerHint(g_dlHttp);
+
+  if (isRedirect(httpCode)) {
+    String location = g_dlHttp.header("Location");
+    g_dlHttp.end();
+    return takeRedirect(location, g_dl.url, sizeof(g_dl.url)) ? CHUNK_AGAIN : CHUNK_FATAL;
+  }
+
+  if (httpCode == 304) {
+    g_dlHttp.end();
+    return CHUNK_NOT_MODIFIED;
+  }
+
+  if (httpCode == 200) {
+    // Range ignored, or If-Range found a newer file: the body is the whole image
+    if (g_dl.offset > 0) {
+      Serial.println("[OTA] Server sent the full image, restarting download");
+      imageRestart();
+    }
+    int size = g_dlHttp.getSize();
+    if (size <= 0 && !g_dl.http10) {
+      // Probably chunked transfer encoding; HTTP/1.0 gets a plain body instead
+      g_dlHttp.end();
+      client->stop();
+      g_dl.http10 = true;
+      return CHUNK_AGAIN;
+    }
+    g_dl.sizeKnown = size > 0;
+    g_dl.totalSize = size > 0 ? (uint32_t)size : 0;
+    storeEtag(g_dlHttp.header("ETag"));
+    storeDigestHeader();
+    checkContentEncoding();
+    bodyBegin(g_dl.totalSize, g_dl.sizeKnown);
+    return CHUNK_PENDING;
+  }
+
+  if (httpCode == 206) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t total = 0;
+    if (!parseContentRange(g_dlHttp.header("Content-Range"), first, last, total) || first != g_dl.offset) {
+      Serial.println("[OTA] Unexpected Content-Range in response");
+      g_dlHttp.end();
+      client->stop();
+      return CHUNK_RETRY;
+    }
+    if (total > 0 && g_dl.sizeKnown && total != g_dl.totalSize) {
+      // Same URL, different file (server sent no ETag to catch it)
+      Serial.println("[OTA] Image size changed on the server, restarting download");
+      g_dlHttp.end();
+      client->stop();
+      imageRestart();
+      g_dl.sizeKnown = false;
+      return CHUNK_RETRY;
+    }
+    if (total > 0) {
+      g_dl.totalSize = total;
+      g_dl.sizeKnown = true;
+    }
+    if (g_dl.offset == 0) {
+      storeEtag(g_dlHttp.header("ETag"));
+      checkContentEncoding();
+    }
+    storeDigestHeader();
+    bodyBegin(last - first + 1, true);
+    return CHUNK_PENDING;
+  }
+
+  g_dlHttp.end();
+
+  if (g_dl.fromPeer) {
+    Serial.printf("[OTA] Peer answered HTTP %d\n", httpCode);
+    return CHUNK_FATAL;  // Peer does not have the image; the server is next
+  }
+  if (httpCode == 416) {
+    if (g_dl.sizeKnown && g_dl.offset >= g_dl.totalSize) {
+      return CHUNK_OK;  // Nothing left to fetch
+    }
+    imageRestart();  // Journal does not match the file on the server
+    g_dl.sizeKnown = false;
+    return CHUNK_RETRY;
+  }
+  if ((httpCode == 403 || httpCode == 404 || httpCode == 410) && strcmp(g_dl.url, g_dl.originalUrl) != 0) {
+    // Signed CDN links expire; resolve the original URL again
+    copyString(g_dl.url, sizeof(g_dl.url), g_dl.originalUrl);
+    return CHUNK_RETRY;
+  }
+
+  Serial.printf("[OTA] HTTP error: %d\n", httpCode);
+  return (httpCode >= 500) ? CHUNK_RETRY : CHUNK_REFUSED;
+}
+
+// Fetching g_dl.url range by range, as a state machine so a time-sliced
+// update can advance it a slice at a time: request a range, receive its
+// body, or wait before a retry. transferImage() runs it to the end.
+enum TransferPhase : uint8_t {
+  TRANSFER_REQUEST,
+  TRANSFER_BODY,
+  TRANSFER_WAIT
+};
+
+struct TransferRun {
+  int retries;
+  int failures;
+  int redirects;
+  uint32_t offsetBefore;        // g_dl.offset when the current request was sent
+  TransferPhase phase;
+  unsigned long waitFromMs;
+  unsigned long waitMs;
+};
+static TransferRun g_run;
+
+static void transferStart(int retries) {
+  memset(&g_run, 0, sizeof(g_run));
+  g_run.retries = retries;
+  g_run.phase = TRANSFER_REQUEST;
+}
+
+static void transferWait() {
+  g_run.phase = TRANSFER_WAIT;
+  g_run.waitFromMs = millis();
+  g_run.waitMs = 1000UL << (g_run.failures < 5 ? g_run.failures : 5);
+}
+
+static ChunkResult transferResult() {
+  return (g_dl.sizeKnown && g_dl.offset == g_dl.totalSize) ? CHUNK_OK : CHUNK_RETRY;
+}
+
+// A request (or its body) ended with result: CHUNK_PENDING while the
+// transfer goes on, otherwise how it ended
+static ChunkResult transferChunkDone(ChunkResult result) {
+  if (g_dl.offset != g_run.offsetBefore) {
+    imageCheckpoint();
+  }
+  progressDispatch();
+  g_run.phase = TRANSFER_REQUEST;
+
+  if (result == CHUNK_AGAIN) {
+    if (++g_run.redirects > kMaxRedirects) {
+      Serial.println("[OTA] Too many redirects");
+      return transferResult();
+    }
+    return CHUNK_PENDING;
+  }
+  g_run.redirects = 0;
+
+  if (result == CHUNK_NOT_MODIFIED || result == CHUNK_REFUSED || result == CHUNK_FATAL) {
+    return result;
+  }
+  if (result == CHUNK_RETRY) {
+    if (g_dl.offset > g_run.offsetBefore) g_run.failures = 0;  // Progress resets the retry budget
+    if (++g_run.failures > g_run.retries) return transferResult();
+    Serial.printf("[OTA] Retrying download at byte %lu (%d/%d)\n",
+                  (unsigned long)g_dl.offset, g_run.failures, g_run.retries);
+    transferWait();
+    return CHUNK_PENDING;
+  }
+  g_run.failures = 0;
+  return CHUNK_PENDING;
+}
+
+// Advance the transfer. With budgetUs 0 it runs until the image is complete
+// (CHUNK_OK) or retries run out without progress (CHUNK_RETRY); otherwise
+// it returns CHUNK_PENDING once budgetUs has passed. Sending a request
+// (connect, time to first byte) is not divided.
+static ChunkResult transferStep(uint32_t budgetUs) {
+  uint32_t startUs = micros();
+  for (;;) {
+    uint32_t usedUs = micros() - startUs;
+    if (budgetUs && usedUs >= budgetUs) {
+      return CHUNK_PENDING;
+    }
+
+    ChunkResult result;
+    switch (g_run.phase) {
+      case TRANSFER_WAIT: {
+        unsigned long waitedMs = millis() - g_run.waitFromMs;
+        if (waitedMs < g_run.waitMs) {
+          if (budgetUs) return CHUNK_PENDING;  // otaLoop() keeps WiFi recovery going meanwhile
+          waitWithReconnect(g_run.waitMs - waitedMs);
+        }
+        g_run.phase = TRANSFER_REQUEST;
+        continue;
+      }
+
+      case TRANSFER_REQUEST:
+        if (g_dl.sizeKnown && g_dl.offset >= g_dl.totalSize) {
+          return transferResult();
+        }
+        if (WiFi.status() != WL_CONNECTED) {
+          if (++g_run.failures > g_run.retries) return transferResult();
+          transferWait();
+          continue;
+        }
+        g_run.offsetBefore = g_dl.offset;
+        result = requestChunk();
+        if (result == CHUNK_PENDING) {
+          g_run.phase = TRANSFER_BODY;
+          continue;
+        }
+        break;
+
+      case TRANSFER_BODY:
+      default:
+        result = receiveBody(budgetUs ? budgetUs - usedUs : 0);
+        if (result == CHUNK_PENDING) {
+          return CHUNK_PENDING;
+        }
+        g_dlHttp.end();
+        break;
+    }
+
+    result = transferChunkDone(result);
+    if (result != CHUNK_PENDING) {
+      return result;
+    }
+  }
+}
+
+#if OTA_PEERS
+// Fetch g_dl.url range by range until the image is complete. CHUNK_OK when
+// it is, CHUNK_RETRY once retries run out without progress.
+static ChunkResult transferImage(int retries) {
+  transferStart(retries);
+  return transferStep(0);
+}
+#endif
+
+// Identity for spreading checks and staged rollouts: FNV-1a of the MAC
+// address as "AA:BB:CC:DD:EE:FF" (extras/ota_fleet_sim.py uses the same)
+static uint32_t g_deviceHash = 0;
+
+static uint32_t deviceHash() {
+  if (g_deviceHash == 0) {
+    uint8_t mac[6] = {0};
+    WiFi.macAddress(mac);
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    if (mac[0] | mac[1] | mac[2] | mac[3] | mac[4] | mac[5]) {
+      g_deviceHash = fnv1a(text);
+    } else {
+      return fnv1a(text);  // Radio not up yet, ask again later
+    }
+  }
+  return g_deviceHash;
+}
+
+#if OTA_PEERS
+// LAN peers: with otaSetPeerSharing(true), devices that run a firmware image serve it
+// from their web server and announce that over mDNS (pico_ota_peers.cpp).
+// A signed pull knows the image's size and SHA-256 before the first
+// byte, so it asks those peers first and only goes to the server if none
+// of them has it. The image is held to the signed size and digest whichever
+// source it comes from.
+static const int kPeerMaxTries = 3;  // Peers asked per update
+static const int kPeerRetries = 1;   // Transfer retries per peer
+
+// The image bytes so far match the expected digest (without finishing g_dlSha)
+static bool peerImageVerified() {
+  OtaSha256 sha = g_dlSha;
+  uint8_t digest[OtaSha256::kDigestSize];
+  sha.finish(digest);
+  return g_dl.imageWritten == g_dl.expectedSize && memcmp(digest, g_dl.expectedSha256, sizeof(digest)) == 0;
+}
+
+// True if a peer delivered the whole image; otherwise g_dl is back at byte
+// 0 of the original URL
+static bool fetchFromPeers() {
+  if (!g_peerSharing || !g_dl.expectedSize || !g_dl.hasExpectedSha256 || g_dl.offset > 0) {
+    return false;
+  }
+  int count = (int)MDNS.queryService(kPeerService, "tcp");
+  if (count <= 0) {
+    return false;
+  }
+
+  char sha256[2 * OtaSha256::kDigestSize + 1];
+  for (size_t i = 0; i < OtaSha256::kDigestSize; i++) {
+    snprintf(sha256 + 2 * i, 3, "%02x", g_dl.expectedSha256[i]);
+  }
+  // Devices start at different peers so one of them does not serve everyone
+  uint32_t first = deviceHash() % (uint32_t)count;
+  int tries = 0;
+  for (int i = 0; i < count && tries < kPeerMaxTries; i++) {
+    int index = (int)((first + (uint32_t)i) % (uint32_t)count);
+    IPAddress ip = MDNS.IP(index);
+    if (ip == WiFi.localIP()) {
+      continue;
+    }
+    tries++;
+    String host = ip.toString();
+    snprintf(g_dl.url, sizeof(g_dl.url), "http://%s:%u/ota/image?sha256=%s&size=%lu", host.c_str(),
+             (unsigned)MDNS.port(index), sha256, (unsigned long)g_dl.expectedSize);
+    Serial.printf("[OTA] Asking peer %s for the image\n", host.c_str());
+
+    g_dl.fromPeer = true;
+    ChunkResult result = transferImage(kPeerRetries);
+    g_dl.fromPeer = false;
+    if (result == CHUNK_OK && peerImageVerified()) {
+      Serial.printf("[OTA] Image received from peer %s\n", host.c_str());
+      return true;
+    }
+    if (result == CHUNK_OK) {
+      Serial.printf("[OTA] Image from peer %s failed verification\n", host.c_str());
+    }
+    imageRestart();
+    g_dl.sizeKnown = false;
+    g_dl.totalSize = 0;
+  }
+  copyString(g_dl.url, sizeof(g_dl.url), g_dl.originalUrl);
+  return false;
+}
+#else
+static bool fetchFromPeers() {
+  return false;
+}
+#endif
+
+// Update sources (otaAddUpdateSource, probed and ranked further below).
+// During otaUpdateFromSources() the download starts at the best source and
+// g_sourceOrder[g_sourceNext..g_sourceRanked) are the fallbacks; other
+// downloads have no fallbacks (g_sourceRanked is 0).
+static const int kSourceRetries = 1;  // Transfer retries before moving to the next source
+
+struct UpdateSource {
+  char url[OTA_MAX_URL_LEN];  // GitHub: the release asset, filled in by the probe
+  bool github;
+  OtaSourceProbe probe;
+};
+static UpdateSource g_sources[OTA_MAX_SOURCES];
+static size_t g_sourceCount = 0;
+static uint8_t g_sourceOrder[OTA_MAX_SOURCES];  // Usable sources, best first
+static size_t g_sourceRanked = 0;
+static size_t g_sourceNext = 0;
+
+static void sourcesStart() {
+  transferStart(g_sourceNext < g_sourceRanked ? kSourceRetries : g_downloadRetries);
+}
+
+// transferStep() that moves on to the next source when one stalls or
+// refuses. The bytes so far are kept if the image is pinned by a digest
+// (every fallback reported the same size in its probe); without one the
+// next source starts from byte 0.
+static ChunkResult sourcesStep(uint32_t budgetUs) {
+  ChunkResult result = transferStep(budgetUs);
+  while ((result == CHUNK_RETRY || result == CHUNK_REFUSED) && g_sourceNext < g_sourceRanked) {
+    const char* next = g_sources[g_sourceOrder[g_sourceNext++]].url;
+    bool keep = g_dl.hasExpectedSha256 && g_dl.offset > 0;
+    Serial.printf("[OTA] Source failed at byte %lu, switching to %s%s\n", (unsigned long)g_dl.offset, next,
+                  keep ? "" : " (from the start)");
+    if (!keep) {
+      imageRestart();
+      g_dl.sizeKnown = false;
+      g_dl.totalSize = 0;
+    }
+    copyString(g_dl.url, sizeof(g_dl.url), next);
+    copyString(g_dl.originalUrl, sizeof(g_dl.originalUrl), next);
+    g_dl.etag[0] = '\0';  // Validators are per server
+    g_dl.http10 = false;
+    imageCheckpoint();  // Journal now names the new source
+    sourcesStart();
+    result = budgetUs ? CHUNK_PENDING : transferStep(0);
+  }
+  return result == CHUNK_REFUSED ? CHUNK_FATAL : result;
+}
+
+static ChunkResult transferFromSources() {
+  sourcesStart();
+  return sourcesStep(0);
+}
+
+// Reset all per-update state (downloads and web uploads)
+// Set up the download of url (resuming a journaled one) and announce it.
+// OTA_UPDATE_IN_PROGRESS when the transfer can start, else the result.
+static int downloadBegin(const char* url, const char* currentVersion, const char* expectedSha256,
+                         const OtaManifest* manifest) {
+  if (!url || strlen(url) >= sizeof(g_dl.url)) {
+    Serial.println("[OTA] HTTP update failed: invalid URL");
+    return OTA_UPDATE_FAILED;
+  }
+
+  sessionBegin();
+  if (expectedSha256 && *expectedSha256) {
+    if (!otaParseSha256Hex(expectedSha256, g_dl.expectedSha256)) {
+      Serial.println("[OTA] HTTP update failed: invalid SHA-256 digest");
+      return OTA_UPDATE_FAILED;
+    }
+    g_dl.hasExpectedSha256 = true;
+  }
+  if (manifest) {
+    // The signed digest wins over anything the caller or server supplies
+    memcpy(g_dl.expectedSha256, manifest->sha256, sizeof(g_dl.expectedSha256));
+    g_dl.hasExpectedSha256 = true;
+    g_dl.expectedSize = manifest->size;
+  }
+  if (g_dl.hasExpectedSha256 && bootImageRejected(g_dl.expectedSha256)) {
+    Serial.println("[OTA] This image was rolled back on this device, not installing it again");
+    return OTA_UPDATE_NO_UPDATE;
+  }
+  copyString(g_dl.url, sizeof(g_dl.url), url);
+  copyString(g_dl.originalUrl, sizeof(g_dl.originalUrl), url);
+  g_dl.currentVersion = currentVersion;
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  loadJournal();
+#endif
+  transferBegin(OTA_PROGRESS_DOWNLOAD, g_dl.offset, g_dl.totalSize);
+
+  if (g_onStartCallback) {
+    g_onStartCallback();
+  }
+  return OTA_UPDATE_IN_PROGRESS;
+}
+
+// The transfer ended with result: install the image and reboot, or report
+// why not
+static int downloadFinish(ChunkResult result) {
+  if (result == CHUNK_NOT_MODIFIED) {
+    imageSuspend();
+    Serial.println("[OTA] No update available (version match)");
+    return OTA_UPDATE_NO_UPDATE;
+  }
+  if (result == CHUNK_FATAL) {
+    int error = OTA_UPDATE_FAILED;
+    if (g_dl.imageRejected) {
+      error = OTA_UPDATE_WRONG_IMAGE;
+      imageRestart();  // Nothing of it is worth resuming
+    } else {
+      imageSuspend();
+    }
+    if (g_onErrorCallback) g_onErrorCallback(error);
+    return error;
+  }
+  if (result != CHUNK_OK) {
+    imageSuspend();
+    Serial.printf("[OTA] HTTP update failed at byte %lu, will resume on next attempt\n",
+                  (unsigned long)g_dl.offset);
+    if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_FAILED);
+    return OTA_UPDATE_FAILED;
+  }
+
+  progressPhase(OTA_PROGRESS_VERIFY);
+  if (!pipelineFinish()) {
+    int error = g_dl.imageRejected ? OTA_UPDATE_WRONG_IMAGE : OTA_UPDATE_FAILED;
+    imageRestart();
+    if (g_onErrorCallback) g_onErrorCallback(error);
+    return error;
+  }
+  if (!imageVerify()) {
+    imageRestart();
+    if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_VERIFY_FAILED);
+    return OTA_UPDATE_VERIFY_FAILED;
+  }
+
+  transferEnd();  // Reports the rate before the reboot
+  progressPhase(OTA_PROGRESS_INSTALL);
+  if (g_onEndCallback) {
+    g_onEndCallback();
+  }
+  imageCommitAndReboot();
+  if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_FAILED);
+  return OTA_UPDATE_FAILED;  // Only reached if installing the image failed
+}
+
+// Download url into the update partition, resuming if possible, then reboot
+int ota_internal::downloadImage(const char* url, const char* currentVersion, const char* expectedSha256,
+                                const OtaManifest* manifest) {
+  int result = downloadBegin(url, currentVersion, expectedSha256, manifest);
+  if (result != OTA_UPDATE_IN_PROGRESS) {
+    return result;
+  }
+  return downloadFinish(fetchFromPeers() ? CHUNK_OK : transferFromSources());
+}
+
+int ota_internal::downloadFirmware(const char* url, const char* currentVersion, const char* expectedSha256,
+                                   const OtaManifest* manifest) {
+  int result = downloadImage(url, currentVersion, expectedSha256, manifest);
+  transferEnd();
+  if (result < 0) {
+    statsAdd(offsetof(OtaStats, updatesFailed), 1);
+  }
+  return result;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// HTTP Pull-Based OTA
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Body of the last small file fetched (manifest or .sha256 sidecar)
+char ota_internal::g_smallFile[OTA_MANIFEST_MAX_SIZE + 1];
+static char g_smallFileUrl[OTA_MAX_REDIRECT_URL_LEN];  // Its URL, after redirects
+
+// GET "<url><suffix>" into g_smallFile (NUL-terminated); returns the HTTP code
+int ota_internal::fetchSmallFile(const char* url, const char* suffix) {
+  char* current = g_smallFileUrl;
+  if ((size_t)snprintf(current, sizeof(g_smallFileUrl), "%s%s", url, suffix) >= sizeof(g_smallFileUrl)) {
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
+  g_smallFile[0] = '\0';
+  bool http10 = false;
+
+  // Redirects (release asset -> CDN) are followed here rather than inside
+  // HTTPClient so every hop goes through openConnection()
+  for (int attempt = 0; attempt <= kMaxRedirects + 1; attempt++) {
+    WiFiClient* client = openConnection(current);
+    if (!client) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    g_dlHttp.setReuse(true);
+    g_dlHttp.useHTTP10(http10);
+    g_dlHttp.setFollowRedirects(HTTPC_DISABLE_FOLLOW_REDIRECTS);
+    if (!g_dlHttp.begin(*client, current)) {
+      closeConnection();
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    g_dlHttp.addHeader("User-Agent", "Pico-OTA");
+    const char* headerKeys[] = {"Location"};
+    g_dlHttp.collectHeaders(headerKeys, 1);
+
+    unsigned long requestMs = millis();
+    int httpCode = g_dlHttp.GET();
+    if (httpCode > 0) {
+      statsRecord(OTA_PHASE_FIRST_BYTE, (uint32_t)(millis() - requestMs));
+    }
+    if (isRedirect(httpCode)) {
+      String location = g_dlHttp.header("Location");
+      g_dlHttp.end();
+      if (!takeRedirect(location, current, sizeof(g_smallFileUrl))) {
+        return httpCode;
+      }
+      continue;
+    }
+
+    int size = g_dlHttp.getSize();
+    if (httpCode == 200 && size <= 0 && !http10) {
+      // Chunked body: ask again for a plain HTTP/1.0 one
+      g_dlHttp.end();
+      client->stop();
+      http10 = true;
+      continue;
+    }
+    if (httpCode == 200 && (size <= 0 || (size_t)size >= sizeof(g_smallFile))) {
+      httpCode = HTTPC_ERROR_TOO_LESS_RAM;
+    } else if (httpCode == 200) {
+      Stream* stream = g_dlHttp.getStreamPtr();
+      if (!stream || stream->readBytes(g_smallFile, (size_t)size) != (size_t)size) {
+        httpCode = HTTPC_ERROR_READ_TIMEOUT;
+        size = 0;
+      }
+      g_smallFile[size] = '\0';
+    }
+    g_dlHttp.end();
+    return httpCode;
+  }
+  Serial.println("[OTA] Too many redirects");
+  return HTTPC_ERROR_CONNECTION_REFUSED;
+}
+
+// Whether candidate should replace the running version under the version
+// policy. Versions that are not SemVer fall back to a plain string compare.
+bool ota_internal::versionIsUpdate(const char* current, const char* candidate) {
+  OtaSemver next;
+  if (!otaSemverParse(candidate, &next)) {
+    if (g_minimumVersion[0]) {
+      Serial.printf("[OTA] Version '%s' is not a semantic version, minimum version cannot be checked\n", candidate);
+      return false;
+    }
+    if (current && *current && strcmp(current, candidate) == 0) {
+      Serial.println("[OTA] Already running latest version");
+      return false;
+    }
+    return true;
+  }
+  if (otaSemverIsPrerelease(next) && !g_allowPrerelease) {
+    Serial.printf("[OTA] Skipping pre-release %s\n", candidate);
+    return false;
+  }
+  OtaSemver bound;
+  if (g_minimumVersion[0] && otaSemverParse(g_minimumVersion, &bound) && otaSemverCompare(next, bound) < 0) {
+    Serial.printf("[OTA] Version %s is below the minimum %s\n", candidate, g_minimumVersion);
+    return false;
+  }
+
+  OtaSemver running;
+  if (!current || !*current) {
+    return true;
+  }
+  if (!otaSemverParse(current, &running)) {
+    return strcmp(current, candidate) != 0;
+  }
+  int order = otaSemverCompare(next, running);
+  if (order == 0) {
+    Serial.println("[OTA] Already running latest version");
+    return false;
+  }
+  if (order < 0 && g_versionPolicy == OTA_VERSION_UPGRADE_ONLY) {
+    Serial.printf("[OTA] Version %s is older than the running %s, not downgrading\n", candidate, current);
+    return false;
+  }
+  return true;
+}
+
+// Staged rollout: each release picks its own devices (hash of MAC and
+// version), and raising the percentage only adds devices
+bool ota_internal::rolloutIncludes(const OtaManifest& manifest) {
+  if (manifest.rollout >= 100) {
+    return true;
+  }
+  if (fnv1a(manifest.version, deviceHash()) % 100 < manifest.rollout) {
+    Serial.printf("[OTA] Device is in the %u%% rollout of %s\n", (unsigned)manifest.rollout, manifest.version);
+    return true;
+  }
+  Serial.printf("[OTA] Version %s is rolled out to %u%% of devices, not this one yet\n", manifest.version,
+                (unsigned)manifest.rollout);
+  return false;
+}
+
+// Fetch and check "<imageUrl>.manifest" against the signing key
+int ota_internal::fetchManifest(const char* imageUrl, OtaManifest& manifest) {
+  int httpCode = fetchSmallFile(imageUrl, ".manifest");
+  if (httpCode != 200) {
+    Serial.printf("[OTA] Signed manifest not available (HTTP %d)\n", httpCode);
+    return OTA_UPDATE_BAD_SIGNATURE;
+  }
+
+  unsigned long startMs = millis();
+  OtaManifestError error = otaManifestVerify(g_smallFile, strlen(g_smallFile), g_signingKey, &manifest);
+  statsRecord(OTA_PHASE_VERIFY, (uint32_t)(millis() - startMs));
+  if (error != OTA_MANIFEST_OK) {
+    Serial.println(error == OTA_MANIFEST_ERR_SIGNATURE ? "[OTA] Manifest signature is invalid"
+                                                      : "[OTA] Manifest is malformed");
+    return OTA_UPDATE_BAD_SIGNATURE;
+  }
+  Serial.printf("[OTA] Manifest for %s verified (%lu ms)\n", manifest.version, millis() - startMs);
+  return OTA_UPDATE_OK;
+}
+
+// An update attempt that could not check its manifest: started and failed
+void ota_internal::statsManifestFailed() {
+  statsAdd(offsetof(OtaStats, updatesStarted), 1);
+  statsAdd(offsetof(OtaStats, updatesFailed), 1);
+}
+
+// Download url, first checking its signed manifest when signed mode is on.
+// Counts as one update attempt, however many peers and sources it tries.
+static int signedDownload(const char* url, const char* currentVersion, const char* expectedSha256) {
+  if (!g_signingKeySet) {
+    statsAdd(offsetof(OtaStats, updatesStarted), 1);
+    return downloadFirmware(url, currentVersion, expectedSha256, nullptr);
+  }
+  OtaManifest manifest;
+  int result = fetchManifest(url, manifest);
+  if (result != OTA_UPDATE_OK) {
+    statsManifestFailed();
+    if (g_onErrorCallback) g_onErrorCallback(result);
+    return result;
+  }
+  if (!versionIsUpdate(currentVersion, manifest.version) || !rolloutIncludes(manifest)) {
+    return OTA_UPDATE_NO_UPDATE;
+  }
+  statsAdd(offsetof(OtaStats, updatesStarted), 1);
+  return downloadFirmware(url, currentVersion, expectedSha256, &manifest);
+}
+
+void otaSetDownloadChunkSize(size_t bytes) {
+  g_downloadChunkSize = bytes < sizeof(g_dlBuffer) ? sizeof(g_dlBuffer) : bytes;
+}
+
+void otaSetDownloadRetries(int retries) {
+  g_downloadRetries = retries < 0 ? 0 : retries;
+}
+
+void otaSetDeltaUpdates(bool enabled) {
+  g_deltaUpdates = enabled;
+}
+
+void otaSetSigningKey(const uint8_t* publicKey) {
+  g_signingKeySet = publicKey != nullptr;
+  if (publicKey) {
+    memcpy(g_signingKey, publicKey, sizeof(g_signingKey));
+  }
+}
+
+void otaSetVersionPolicy(OtaVersionPolicy policy) {
+  g_versionPolicy = policy;
+}
+
+void otaSetAllowPrerelease(bool allow) {
+  g_allowPrerelease = allow;
+}
+
+void otaSetMinimumVersion(const char* version) {
+  storeSetting(g_minimumVersion, sizeof(g_minimumVersion), version, "Minimum version");
+}
+
+int otaUpdateFromUrl(const char* url) {
+  return otaUpdateFromUrl(url, "");
+}
+
+int otaUpdateFromUrl(const char* url, const char* currentVersion) {
+  return otaUpdateFromUrl(url, currentVersion, nullptr);
+}
+
+int otaUpdateFromUrl(const char* url, const char* currentVersion, const char* expectedSha256) {
+  if (updateBusy()) {
+    return OTA_UPDATE_FAILED;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[OTA] HTTP update failed: WiFi not connected");
+    return OTA_UPDATE_NO_WIFI;
+  }
+  
+  Serial.print("[OTA] Starting HTTP update from: ");
+  Serial.println(url);
+  
+  return signedDownload(url, currentVersion, expectedSha256);
+}
+
+int otaUpdateFromHost(const char* host, uint16_t port, const char* path) {
+  return otaUpdateFromHost(host, port, path, "");
+}
+
+int otaUpdateFromHost(const char* host, uint16_t port, const char* path, const char* currentVersion) {
+  if (updateBusy()) {
+    return OTA_UPDATE_FAILED;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[OTA] HTTP update failed: WiFi not connected");
+    return OTA_UPDATE_NO_WIFI;
+  }
+  
+  Serial.printf("[OTA] Starting HTTP update from: %s:%d%s\n", host, port, path);
+  
+  char url[OTA_MAX_URL_LEN];
+  int len = snprintf(url, sizeof(url), "http://%s:%u%s%s", host, (unsigned)port,
+                     (path && *path == '/') ? "" : "/", path ? path : "");
+  if (len < 0 || (size_t)len >= sizeof(url)) {
+    Serial.println("[OTA] HTTP update failed: URL too long");
+    return OTA_UPDATE_FAILED;
+  }
+  return signedDownload(url, currentVersion, nullptr);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Time-sliced updates
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// The download path of otaUpdateFromUrl(), cut into stages that
+// otaUpdateStep() runs one at a time: the signed manifest (one small
+// request), the transfer in transferStep() slices, then verification and
+// install. Between steps the connection stays open and TCP keeps filling
+// the socket buffer, so a loop that returns within a few ms loses little
+// throughput (extras/ota_step_sim.py models it). LAN peers are skipped:
+// their mDNS query alone blocks for a second or more.
+enum StepStage : uint8_t {
+  STEP_IDLE,
+  STEP_START,           // Manifest and download setup
+  STEP_TRANSFER,
+  STEP_FINISH           // Verify and install
+};
+
+struct SteppedUpdate {
+  StepStage stage;
+  char url[OTA_MAX_URL_LEN];
+  char version[OTA_MAX_VERSION_LEN];
+  char sha256[2 * OtaSha256::kDigestSize + 1];
+  OtaManifest manifest;
+  ChunkResult transfer;   // How the transfer ended, for STEP_FINISH
+  int result;             // OTA_UPDATE_IN_PROGRESS, then the result
+};
+static SteppedUpdate g_step = {STEP_IDLE, "", "", "", {}, CHUNK_OK, OTA_UPDATE_NO_UPDATE};
+static uint32_t g_stepBudgetUs = 2000;  // otaLoop()'s slice, 0 = the sketch calls otaUpdateStep()
+
+bool ota_internal::steppedUpdateActive() {
+  return g_step.stage != STEP_IDLE;
+}
+
+// The time-sliced update owns the download session until it ends
+bool ota_internal::updateBusy() {
+  if (!steppedUpdateActive()) return false;
+  Serial.println("[OTA] A time-sliced update is in progress");
+  return true;
+}
+
+static int stepDone(int result) {
+  transferEnd();
+  if (result < 0) {
+    statsAdd(offsetof(OtaStats, updatesFailed), 1);
+  }
+  g_step.stage = STEP_IDLE;
+  g_step.result = result;
+  return result;
+}
+
+static int stepStart() {
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[OTA] HTTP update failed: WiFi not connected");
+    g_step.stage = STEP_IDLE;
+    g_step.result = OTA_UPDATE_NO_WIFI;
+    return OTA_UPDATE_NO_WIFI;
+  }
+  const OtaManifest* manifest = nullptr;
+  if (g_signingKeySet) {
+    int result = fetchManifest(g_step.url, g_step.manifest);
+    if (result != OTA_UPDATE_OK) {
+      statsAdd(offsetof(OtaStats, updatesStarted), 1);  // stepDone() counts the failure
+      if (g_onErrorCallback) g_onErrorCallback(result);
+      return stepDone(result);
+    }
+    if (!versionIsUpdate(g_step.version, g_step.manifest.version) || !rolloutIncludes(g_step.manifest)) {
+      return stepDone(OTA_UPDATE_NO_UPDATE);
+    }
+    manifest = &g_step.manifest;
+  }
+  statsAdd(offsetof(OtaStats, updatesStarted), 1);
+  int result = downloadBegin(g_step.url, g_step.version, g_step.sha256, manifest);
+  if (result != OTA_UPDATE_IN_PROGRESS) {
+    return stepDone(result);
+  }
+  sourcesStart();
+  g_step.stage = STEP_TRANSFER;
+  return OTA_UPDATE_IN_PROGRESS;
+}
+
+static int stepOnce(uint32_t budgetUs) {
+  switch (g_step.stage) {
+    case STEP_START:
+      return stepStart();
+    case STEP_TRANSFER:
+      g_step.transfer = sourcesStep(budgetUs);
+      if (g_step.transfer != CHUNK_PENDING) {
+        g_step.stage = STEP_FINISH;  // Hashing and install get a step of their own
+      }
+      return OTA_UPDATE_IN_PROGRESS;
+    case STEP_FINISH:
+      return stepDone(downloadFinish(g_step.transfer));  // Reboots on success
+    case STEP_IDLE:
+    default:
+      return g_step.result;
+  }
+}
+
+void ota_internal::handleSteppedUpdate() {
+  if (steppedUpdateActive() && g_stepBudgetUs > 0) {
+    otaUpdateStep(g_stepBudgetUs);
+  }
+}
+
+bool otaBeginUpdate(const char* url, const char* currentVersion, const char* expectedSha256) {
+  if (updateBusy()) {
+    return false;
+  }
+  if (g_transfer.active) {
+    Serial.println("[OTA] A transfer is in progress");
+    return false;
+  }
+  if (!url || !*url || !storeSetting(g_step.url, sizeof(g_step.url), url, "Update URL") ||
+      !storeSetting(g_step.version, sizeof(g_step.version), currentVersion, "Version") ||
+      !storeSetting(g_step.sha256, sizeof(g_step.sha256), expectedSha256, "SHA-256 digest")) {
+    return false;
+  }
+  Serial.printf("[OTA] Starting time-sliced update from: %s\n", url);
+  g_step.stage = STEP_START;
+  g_step.result = OTA_UPDATE_IN_PROGRESS;
+  return true;
+}
+
+int otaUpdateStep(uint32_t budgetUs) {
+  int result = stepOnce(budgetUs);
+  while (budgetUs == 0 && steppedUpdateActive()) {
+    result = stepOnce(0);
+  }
+  return result;
+}
+
+int otaGetUpdateResult() {
+  return g_step.result;
+}
+
+void otaCancelUpdate() {
+  if (!steppedUpdateActive()) {
+    return;
+  }
+  if (g_step.stage != STEP_START) {
+    closeConnection();  // A body may be half read
+    imageSuspend();     // Pico: the next update of this URL resumes here
+    statsAdd(offsetof(OtaStats, updatesFailed), 1);  // Started in stepStart()
+  }
+  Serial.println("[OTA] Update cancelled");
+  transferEnd();
+  g_step.stage = STEP_IDLE;
+  g_step.result = OTA_UPDATE_FAILED;
+}
+
+void otaSetUpdateStepBudget(uint32_t budgetUs) {
+  g_stepBudgetUs = budgetUs;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Multiple update sources
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Each source is probed with a Range request for the first kProbeBytes:
+// the time to the first byte (connect, TLS and redirects included) is its
+// latency, the body gives a rate and Content-Range the image size. The
+// download client is blocking and one TLS connection already needs most of
+// the RAM a Pico W can spare, so probes run one after another, each bounded
+// by kProbeTimeoutMs; a probe that ends cleanly leaves its connection open
+// for the download. Sources are ranked by latency + size / rate.
+static const uint32_t kProbeBytes = 8192;
+static const uint16_t kProbeTimeoutMs = 3000;
+static char g_probeUrl[OTA_MAX_REDIRECT_URL_LEN];  // The probed URL, after redirects
+
+static void probeSource(UpdateSource& source) {
+  OtaSourceProbe& probe = source.probe;
+  memset(&probe, 0, sizeof(probe));
+  probe.rank = 255;
+#if OTA_FEATURE_GITHUB
+  if (source.github) {
+    int check = otaCheckGitHubUpdate(nullptr, 0);
+    probe.upToDate = check == OTA_UPDATE_NO_UPDATE;
+    if (check != OTA_UPDATE_OK || !g_latestAssetUrl[0]) {
+      return;
+    }
+    copyString(source.url, sizeof(source.url), g_latestAssetUrl);
+  }
+#endif
+
+  char* url = g_probeUrl;
+  copyString(url, sizeof(g_probeUrl), source.url);
+  unsigned long startMs = millis();
+  for (int hop = 0; hop <= kMaxRedirects; hop++) {
+    WiFiClient* client = openConnection(url);
+    if (!client) {
+      return;
+    }
+    g_dlHttp.setReuse(true);
+    g_dlHttp.useHTTP10(false);
+    g_dlHttp.setFollowRedirects(HTTPC_DISABLE_FOLLOW_REDIRECTS);
+    g_dlHttp.setTimeout(kProbeTimeoutMs);
+    if (!g_dlHttp.begin(*client, url)) {
+      closeConnection();
+      return;
+    }
+    char range[32];
+    snprintf(range, sizeof(range), "bytes=0-%lu", (unsigned long)(kProbeBytes - 1));
+    g_dlHttp.addHeader("User-Agent", "Pico-OTA");
+    g_dlHttp.addHeader("Range", range);
+    if (g_currentVersion[0]) {
+      g_dlHttp.addHeader("x-ota-version", g_currentVersion);  // Up to date: 304, as for downloads
+    }
+    const char* headerKeys[] = {"Content-Range", "Location"};
+    g_dlHttp.collectHeaders(headerKeys, 2);
+
+    int httpCode = g_dlHttp.GET();
+    if (isRedirect(httpCode)) {
+      String location = g_dlHttp.header("Location");
+      g_dlHttp.end();
+      if (!takeRedirect(location, url, sizeof(g_probeUrl))) {
+        return;
+      }
+      continue;
+    }
+    probe.latencyMs = (uint32_t)(millis() - startMs);
+    if (httpCode == 304) {
+      probe.upToDate = true;
+      g_dlHttp.end();
+      return;
+    }
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t want = 0;
+    if (httpCode == 206 && parseContentRange(g_dlHttp.header("Content-Range"), first, last, probe.size) &&
+        first == 0) {
+      want = last + 1;
+    } else if (httpCode == 200 && g_dlHttp.getSize() > 0) {
+      probe.size = (uint32_t)g_dlHttp.getSize();
+      want = probe.size < kProbeBytes ? probe.size : kProbeBytes;
+    }
+    Stream* stream = g_dlHttp.getStreamPtr();
+    if (want == 0 || probe.size == 0 || !stream) {
+      Serial.printf("[OTA] Source %s answered HTTP %d\n", source.url, httpCode);
+      g_dlHttp.end();
+      client->stop();
+      return;
+    }
+
+    uint32_t received = 0;
+    unsigned long bodyStartMs = millis();
+    while (received < want && millis() - bodyStartMs < kProbeTimeoutMs) {
+      int available = stream->available();
+      if (available <= 0) {
+        if (!g_dlHttp.connected()) break;
+        delay(1);
+        continue;
+      }
+      size_t toRead = (size_t)available < sizeof(g_dlBuffer) ? (size_t)available : sizeof(g_dlBuffer);
+      if (toRead > want - received) toRead = want - received;
+      received += (uint32_t)stream->readBytes(g_dlBuffer, toRead);
+    }
+    unsigned long bodyMs = millis() - bodyStartMs;
+    g_dlHttp.end();
+    if (httpCode == 200 || received < want) {
+      client->stop();  // Rest of the body is still on its way
+    }
+    probe.bytesPerSecond = (uint32_t)((uint64_t)received * 1000 / (bodyMs ? bodyMs : 1));
+    probe.healthy = received == want;
+    uint64_t estimate = probe.latencyMs + (uint64_t)probe.size * 1000 / (probe.bytesPerSecond ? probe.bytesPerSecond : 1);
+    probe.estimatedMs = estimate > UINT32_MAX ? UINT32_MAX : (uint32_t)estimate;
+    return;
+  }
+}
+
+// Probe every source and rank the healthy ones that report the same image
+// size as the best into g_sourceOrder
+static size_t rankSources() {
+  size_t ranked = 0;
+  for (size_t i = 0; i < g_sourceCount; i++) {
+    probeSource(g_sources[i]);
+    const OtaSourceProbe& probe = g_sources[i].probe;
+    if (probe.healthy) {
+      Serial.printf("[OTA] Source %s: %lu ms to first byte, %lu B/s, %lu bytes\n", g_sources[i].url,
+                    (unsigned long)probe.latencyMs, (unsigned long)probe.bytesPerSecond,
+                    (unsigned long)probe.size);
+    }
+    if (!probe.healthy) {
+      continue;
+    }
+    // Insertion sort, stable: earlier sources win ties
+    size_t at = ranked;
+    while (at > 0 && g_sources[g_sourceOrder[at - 1]].probe.estimatedMs > probe.estimatedMs) {
+      g_sourceOrder[at] = g_sourceOrder[at - 1];
+      at--;
+    }
+    g_sourceOrder[at] = (uint8_t)i;
+    ranked++;
+  }
+  g_dlHttp.setTimeout((uint16_t)kStallTimeoutMs);
+
+  size_t kept = 0;
+  for (size_t r = 0; r < ranked; r++) {
+    UpdateSource& source = g_sources[g_sourceOrder[r]];
+    if (source.probe.size == g_sources[g_sourceOrder[0]].probe.size) {
+      source.probe.rank = (uint8_t)kept;
+      g_sourceOrder[kept++] = g_sourceOrder[r];
+    }
+  }
+  return kept;
+}
+
+bool otaAddUpdateSource(const char* url) {
+  if (g_sourceCount >= OTA_MAX_SOURCES) {
+    Serial.printf("[OTA] Too many update sources (max %u)\n", (unsigned)OTA_MAX_SOURCES);
+    return false;
+  }
+  UpdateSource& source = g_sources[g_sourceCount];
+  memset(&source, 0, sizeof(source));
+  if (!url || !*url || !storeSetting(source.url, sizeof(source.url), url, "Update source URL")) {
+    return false;
+  }
+  g_sourceCount++;
+  return true;
+}
+
+#if OTA_FEATURE_GITHUB
+bool otaAddGitHubSource() {
+  if (g_sourceCount >= OTA_MAX_SOURCES) {
+    Serial.printf("[OTA] Too many update sources (max %u)\n", (unsigned)OTA_MAX_SOURCES);
+    return false;
+  }
+  UpdateSource& source = g_sources[g_sourceCount++];
+  memset(&source, 0, sizeof(source));
+  source.github = true;
+  return true;
+}
+#endif
+
+void otaClearUpdateSources() {
+  g_sourceCount = 0;
+}
+
+bool otaGetSourceProbe(size_t index, OtaSourceProbe* probe) {
+  if (index >= g_sourceCount || !probe) {
+    return false;
+  }
+  *probe = g_sources[index].probe;
+  return true;
+}
+
+int otaUpdateFromSources() {
+  if (updateBusy()) {
+    return OTA_UPDATE_FAILED;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[OTA] HTTP update failed: WiFi not connected");
+    return OTA_UPDATE_NO_WIFI;
+  }
+  if (g_sourceCount == 0) {
+    Serial.println("[OTA] No update sources, call otaAddUpdateSource() first");
+    return OTA_UPDATE_FAILED;
+  }
+
+  size_t ranked = rankSources();
+  if (ranked == 0) {
+    for (size_t i = 0; i < g_sourceCount; i++) {
+      if (g_sources[i].probe.upToDate) {
+        Serial.println("[OTA] No update available");
+        return OTA_UPDATE_NO_UPDATE;
+      }
+    }
+    Serial.println("[OTA] No update source is reachable");
+    if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_HTTP_ERROR);
+    return OTA_UPDATE_HTTP_ERROR;
+  }
+
+  // Signed mode: every source carries the manifest, take the first that verifies
+  OtaManifest manifest;
+  const OtaManifest* signedManifest = nullptr;
+  if (g_signingKeySet) {
+    int result = OTA_UPDATE_BAD_SIGNATURE;
+    for (size_t r = 0; r < ranked && result != OTA_UPDATE_OK; r++) {
+      result = fetchManifest(g_sources[g_sourceOrder[r]].url, manifest);
+    }
+    if (result != OTA_UPDATE_OK) {
+      statsManifestFailed();
+      if (g_onErrorCallback) g_onErrorCallback(result);
+      return result;
+    }
+    if (!versionIsUpdate(g_currentVersion, manifest.version) || !rolloutIncludes(manifest)) {
+      return OTA_UPDATE_NO_UPDATE;
+    }
+    signedManifest = &manifest;
+    // Only sources holding the signed image stay in the list
+    size_t kept = 0;
+    for (size_t r = 0; r < ranked; r++) {
+      UpdateSource& source = g_sources[g_sourceOrder[r]];
+      source.probe.rank = 255;
+      if (source.probe.size == manifest.size) {
+        source.probe.rank = (uint8_t)kept;
+        g_sourceOrder[kept++] = g_sourceOrder[r];
+      }
+    }
+    ranked = kept;
+    if (ranked == 0) {
+      Serial.println("[OTA] No source has the image of the signed manifest");
+      statsManifestFailed();
+      if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_BAD_SIGNATURE);
+      return OTA_UPDATE_BAD_SIGNATURE;
+    }
+  }
+
+  const char* best = g_sources[g_sourceOrder[0]].url;
+  Serial.printf("[OTA] Starting HTTP update from: %s (%u source%s)\n", best, (unsigned)ranked,
+                ranked == 1 ? "" : "s");
+  g_sourceRanked = ranked;
+  g_sourceNext = 1;
+  statsAdd(offsetof(OtaStats, updatesStarted), 1);  // Once, whichever sources the transfer fails over to
+  int result = downloadFirmware(best, g_currentVersion, nullptr, signedManifest);
+  g_sourceRanked = 0;
+  return result;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Update scheduler
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Waits are derived from the device hash and a check counter, so each
+// device follows its own fixed sequence and the fleet stays spread out
+// (extras/ota_fleet_sim.py models it). Waits are kept below 30 days so the
+// millis() arithmetic cannot wrap.
+static const uint32_t kScheduleMaxIntervalS = 30UL * 24 * 3600;
+static const uint32_t kScheduleRetryS = 60;  // First retry after a failed check, doubles
+static OtaUpdatePolicy g_updatePolicy;
+static char g_scheduleUrl[OTA_MAX_URL_LEN];
+static bool g_scheduleArmed = false;    // Waiting for WiFi to place the first check
+static bool g_scheduleRunning = false;
+static bool g_scheduleStepped = false;  // A timeSliced check is downloading
+static unsigned long g_scheduleFromMs = 0;
+static uint32_t g_scheduleWaitS = 0;
+static uint32_t g_scheduleChecks = 0;
+static uint8_t g_scheduleFailures = 0;
+
+static uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352DUL;
+  x ^= x >> 15;
+  x *= 0x846CA68BUL;
+  x ^= x >> 16;
+  return x;
+}
+
+// This check's offset in [0, 2 * jitter of seconds]
+static uint32_t scheduleOffset(uint32_t seconds) {
+  uint32_t spread = (uint32_t)((uint64_t)seconds * g_updatePolicy.jitterPercent / 100);
+  return mix32(deviceHash() + g_scheduleChecks * 0x9E3779B9UL) % (2 * spread + 1);
+}
+
+static void scheduleNext(uint32_t seconds) {
+  g_scheduleFromMs = millis();
+  g_scheduleWaitS = seconds < kScheduleMaxIntervalS ? seconds : kScheduleMaxIntervalS;
+  Serial.printf("[OTA] Next update check in %lu s\n", (unsigned long)g_scheduleWaitS);
+}
+
+static void scheduleAfter(int result) {
+  uint32_t interval = g_updatePolicy.intervalSeconds;
+  uint32_t base = interval;
+  // A wrong image will not be right a minute later: no quick retry for it
+  if (result == OTA_UPDATE_OK || result == OTA_UPDATE_NO_UPDATE || result == OTA_UPDATE_RATE_LIMITED ||
+      result == OTA_UPDATE_WRONG_IMAGE) {
+    g_scheduleFailures = 0;
+  } else {
+    // Failed: retry sooner (60 s, 120 s, ...) but never later than usual
+    uint8_t shift = g_scheduleFailures < 16 ? g_scheduleFailures : 16;
+    uint32_t retry = kScheduleRetryS << shift;
+    base = retry < interval ? retry : interval;
+    if (g_scheduleFailures < 255) g_scheduleFailures++;
+  }
+  uint32_t spread = (uint32_t)((uint64_t)base * g_updatePolicy.jitterPercent / 100);
+  uint32_t wait = base - spread + scheduleOffset(base);
+
+  // The server may ask for longer; spread that too, but only upwards
+  uint32_t hint = g_serverHintS;
+#if OTA_FEATURE_GITHUB
+  if (!g_scheduleUrl[0]) {
+    unsigned long rateLimit = otaGetGitHubRetryDelay();
+    if (rateLimit > hint) hint = (uint32_t)rateLimit;
+  }
+#endif
+  if (hint > wait) {
+    wait = hint + scheduleOffset(hint) / 2;
+  }
+  g_scheduleChecks++;
+  scheduleNext(wait);
+}
+
+void ota_internal::handleUpdateSchedule() {
+  if (g_updatePolicy.intervalSeconds == 0 || g_scheduleRunning) {
+    return;
+  }
+  if (g_scheduleStepped) {
+    if (steppedUpdateActive()) return;
+    g_scheduleStepped = false;
+    scheduleAfter(otaGetUpdateResult());
+    return;
+  }
+  if (g_scheduleArmed) {
+    // Fleets come back together after an outage: place the first check in
+    // the startup window once WiFi is up (and the MAC can be read)
+    if (WiFi.status() != WL_CONNECTED) return;
+    g_scheduleArmed = false;
+    uint32_t window = g_updatePolicy.startupWindowSeconds;
+    scheduleNext(window > 0 ? deviceHash() % window : 0);
+    return;
+  }
+  if (millis() - g_scheduleFromMs < g_scheduleWaitS * 1000UL || steppedUpdateActive()) {
+    return;
+  }
+
+  g_serverHintS = 0;
+  int result = OTA_UPDATE_NO_WIFI;
+  if (WiFi.status() == WL_CONNECTED) {
+    Serial.println("[OTA] Scheduled update check");
+    if (g_scheduleUrl[0] && g_updatePolicy.timeSliced) {
+      g_scheduleStepped = otaBeginUpdate(g_scheduleUrl, g_currentVersion);
+      if (g_scheduleStepped) return;  // otaLoop() pumps it, the result is picked up above
+      result = OTA_UPDATE_FAILED;
+    } else {
+      g_scheduleRunning = true;
+      if (g_scheduleUrl[0]) {
+        result = otaUpdateFromUrl(g_scheduleUrl, g_currentVersion);
+      } else {
+#if OTA_FEATURE_GITHUB
+        result = g_sourceCount > 0 ? otaUpdateFromSources() : otaUpdateFromGitHub();
+#else
+        result = otaUpdateFromSources();
+#endif
+      }
+      g_scheduleRunning = false;
+    }
+  }
+  scheduleAfter(result);  // Only reached without an update (a successful one reboots)
+}
+
+void otaSetUpdatePolicy(const OtaUpdatePolicy& policy) {
+  g_updatePolicy = policy;
+  g_updatePolicy.url = nullptr;
+  if (g_updatePolicy.jitterPercent > 100) {
+    g_updatePolicy.jitterPercent = 100;
+  }
+  if (g_updatePolicy.intervalSeconds > kScheduleMaxIntervalS) {
+    g_updatePolicy.intervalSeconds = kScheduleMaxIntervalS;
+  }
+  if (!storeSetting(g_scheduleUrl, sizeof(g_scheduleUrl), policy.url, "Update URL")) {
+    g_updatePolicy.intervalSeconds = 0;  // Never fall back to a different source
+  }
+  g_scheduleArmed = true;
+  g_scheduleChecks = 0;
+  g_scheduleFailures = 0;
+}
+
+unsigned long otaGetNextCheckDelay() {
+  if (g_updatePolicy.intervalSeconds == 0 || g_scheduleArmed) {
+    return 0;
+  }
+  unsigned long elapsedS = (millis() - g_scheduleFromMs) / 1000;
+  return elapsedS < g_scheduleWaitS ? g_scheduleWaitS - elapsedS : 0;
+}
+
+#endif  // OTA_FEATURE_HTTP_PULL
@@ -0,0 +1,742 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+#if OTA_STAGING
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Firmware image writer
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+namespace ota_internal {
+DownloadSession g_dl;
+OtaSha256 g_dlSha;
+}  // namespace ota_internal
+
+static OtaDeltaPatcher g_dlDelta;
+static OtaLzssDecoder g_dlLzss;
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+static const char* kStagedImagePath = "ota_image.bin";
+static const char* kJournalPath = "ota_journal.bin";
+static const uint32_t kJournalMagic = 0x4A41544F;  // "OTAJ"
+extern uint8_t _FS_start;  // Linker symbol: end of the sketch area in flash
+
+struct DownloadJournal {
+  uint32_t magic;
+  uint32_t urlHash;     // FNV-1a of the original URL
+  uint32_t totalSize;
+  uint32_t committed;   // Bytes of the staged file covered by crc
+  uint32_t crc;         // CRC32 of staged bytes [0, committed)
+  char etag[OTA_MAX_ETAG_LEN];
+  uint32_t check;       // CRC32 of all fields above
+};
+
+static File g_stagedFile;
+
+static void clearStagedDownload() {
+  if (g_stagedFile) {
+    g_stagedFile.close();
+  }
+  LittleFS.remove(kJournalPath);
+  LittleFS.remove(kStagedImagePath);
+}
+
+#if OTA_FEATURE_HTTP_PULL
+static uint32_t journalCheck(const DownloadJournal& journal) {
+  return otaCrc32(0, reinterpret_cast<const uint8_t*>(&journal), offsetof(DownloadJournal, check));
+}
+
+static void saveJournal() {
+  DownloadJournal journal;
+  memset(&journal, 0, sizeof(journal));
+  journal.magic = kJournalMagic;
+  journal.urlHash = fnv1a(g_dl.originalUrl);
+  journal.totalSize = g_dl.totalSize;
+  journal.committed = g_dl.offset;
+  journal.crc = g_dl.crc;
+  copyString(journal.etag, sizeof(journal.etag), g_dl.etag);
+  journal.check = journalCheck(journal);
+
+  File file = LittleFS.open(kJournalPath, "w");
+  if (file) {
+    file.write(reinterpret_cast<const uint8_t*>(&journal), sizeof(journal));
+    file.close();
+  }
+}
+
+// Recompute the CRC of the staged prefix so a half-written flash page after
+// power loss is never resumed from. The same pass restores the SHA-256 state.
+static bool verifyStagedPrefix(uint32_t length, uint32_t expectedCrc) {
+  File file = LittleFS.open(kStagedImagePath, "r");
+  if (!file || file.size() < length) {
+    if (file) file.close();
+    return false;
+  }
+  uint32_t crc = 0;
+  uint32_t remaining = length;
+  while (remaining > 0) {
+    size_t toRead = remaining < sizeof(g_dlBuffer) ? remaining : sizeof(g_dlBuffer);
+    int readLen = file.read(g_dlBuffer, toRead);
+    if (readLen <= 0) break;
+    crc = otaCrc32(crc, g_dlBuffer, (size_t)readLen);
+    g_dlSha.update(g_dlBuffer, (size_t)readLen);
+    remaining -= (uint32_t)readLen;
+  }
+  file.close();
+  if (remaining != 0 || crc != expectedCrc) {
+    g_dlSha.begin();
+    return false;
+  }
+  return true;
+}
+
+// Pick up a previous partial download of the same URL
+void ota_internal::loadJournal() {
+  File file = LittleFS.open(kJournalPath, "r");
+  if (!file) return;
+
+  DownloadJournal journal;
+  bool valid = file.read(reinterpret_cast<uint8_t*>(&journal), sizeof(journal)) == (int)sizeof(journal);
+  file.close();
+
+  valid = valid && journal.magic == kJournalMagic && journal.check == journalCheck(journal);
+  if (!valid || journal.urlHash != fnv1a(g_dl.originalUrl)) {
+    clearStagedDownload();
+    return;
+  }
+
+  journal.etag[sizeof(journal.etag) - 1] = '\0';
+  if (!verifyStagedPrefix(journal.committed, journal.crc)) {
+    Serial.println("[OTA] Staged download failed verification, starting over");
+    clearStagedDownload();
+    return;
+  }
+
+  g_dl.totalSize = journal.totalSize;
+  g_dl.sizeKnown = journal.totalSize > 0;
+  g_dl.offset = journal.committed;
+  g_dl.imageWritten = journal.committed;
+  g_dl.crc = journal.crc;
+  if (journal.committed > 0) {
+    g_dl.encoding = ENCODING_NONE;  // Only plain images are journaled
+    g_dl.format = FORMAT_RAW;
+  }
+  copyString(g_dl.etag, sizeof(g_dl.etag), journal.etag);
+  Serial.printf("[OTA] Resuming download at %lu / %lu bytes\n",
+                (unsigned long)g_dl.offset, (unsigned long)g_dl.totalSize);
+}
+#endif  // OTA_FEATURE_HTTP_PULL
+
+// Remove an image left behind by a completed update (no journal = not resumable)
+void ota_internal::cleanupStagedImage() {
+  if (!LittleFS.exists(kJournalPath) && LittleFS.exists(kStagedImagePath)) {
+    LittleFS.remove(kStagedImagePath);
+  }
+}
+#endif
+
+// Image bytes are collected in OTA_IMAGE_WRITE_BUFFERS blocks that end on
+// OTA_IMAGE_WRITE_BLOCK boundaries of the image, so flash is programmed in
+// whole sectors instead of once per network read. A complete block waits
+// until the socket has nothing to read (imageWriteIdle) and is programmed
+// then: the TCP receive window is fully open during the flash stall, so the
+// sender keeps transmitting through it. Only when every block is full does a
+// write wait for flash. extras/ota_pipeline_sim.py models the gain.
+static_assert(OTA_IMAGE_WRITE_BUFFERS >= 1, "OTA_IMAGE_WRITE_BUFFERS must be at least 1");
+static uint8_t g_imageBlocks[OTA_IMAGE_WRITE_BUFFERS][OTA_IMAGE_WRITE_BLOCK];
+static size_t g_imageBlockLen[OTA_IMAGE_WRITE_BUFFERS];
+static size_t g_imageFirst = 0;        // Oldest complete block
+static size_t g_imageReady = 0;        // Complete blocks waiting for flash
+static size_t g_imageBuffered = 0;     // Bytes in all blocks
+static uint32_t g_imageSinkBytes = 0;  // Bytes already handed to flash
+
+static void imageBuffersReset(uint32_t written) {
+  memset(g_imageBlockLen, 0, sizeof(g_imageBlockLen));
+  g_imageFirst = 0;
+  g_imageReady = 0;
+  g_imageBuffered = 0;
+  g_imageSinkBytes = written;
+}
+
+static bool imageSinkWrite(const uint8_t* data, size_t len) {
+  unsigned long start = millis();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  bool written = g_stagedFile.write(data, len) == len;
+#else
+  bool written = Update.write(const_cast<uint8_t*>(data), len) == len;
+#endif
+  uint32_t tookMs = (uint32_t)(millis() - start);
+  g_imageSinkBytes += (uint32_t)len;
+  g_transferWriteMs += tookMs;
+  statsRecord(OTA_PHASE_FLASH_WRITE, tookMs);
+  return written;
+}
+
+// Program the oldest complete block
+static bool imageWriteReady() {
+  if (g_imageReady == 0) return true;
+  size_t index = g_imageFirst;
+  size_t len = g_imageBlockLen[index];
+  bool written = imageSinkWrite(g_imageBlocks[index], len);
+  g_imageBlockLen[index] = 0;
+  g_imageFirst = (index + 1) % OTA_IMAGE_WRITE_BUFFERS;
+  g_imageReady--;
+  g_imageBuffered -= len;
+  return written;
+}
+
+// Program everything buffered, the partly filled block included
+static bool imageFlushBuffers() {
+  bool written = true;
+  while (g_imageReady > 0) {
+    written = imageWriteReady() && written;
+  }
+  size_t fill = g_imageFirst;
+  if (g_imageBlockLen[fill] > 0) {
+    written = imageSinkWrite(g_imageBlocks[fill], g_imageBlockLen[fill]) && written;
+    g_imageBlockLen[fill] = 0;
+  }
+  g_imageBuffered = 0;
+  return written;
+}
+
+static bool imageBufferWrite(const uint8_t* data, size_t len) {
+  const size_t block = OTA_IMAGE_WRITE_BLOCK;
+  while (len > 0) {
+    size_t used = (size_t)((g_imageSinkBytes + g_imageBuffered) % block);
+    if (g_imageBuffered == 0 && used == 0 && len >= block) {
+      // Aligned and nothing pending: whole blocks go straight to flash
+      size_t direct = len - len % block;
+      if (!imageSinkWrite(data, direct)) return false;
+      data += direct;
+      len -= direct;
+      continue;
+    }
+    size_t fill = (g_imageFirst + g_imageReady) % OTA_IMAGE_WRITE_BUFFERS;
+    size_t take = block - used < len ? block - used : len;
+    memcpy(g_imageBlocks[fill] + g_imageBlockLen[fill], data, take);
+    g_imageBlockLen[fill] += take;
+    g_imageBuffered += take;
+    data += take;
+    len -= take;
+    if (used + take == block) {
+      g_imageReady++;
+      // No block left to fill: wait for flash now
+      if (g_imageReady == OTA_IMAGE_WRITE_BUFFERS && !imageWriteReady()) return false;
+    }
+  }
+  return true;
+}
+
+// Size of the image being written, 0 if unknown
+static uint32_t expectedImageSize() {
+  if (g_dl.format == FORMAT_DELTA) {
+    return g_dlDelta.targetSize();
+  }
+  if (g_dl.encoding == ENCODING_LZSS) {
+    return g_dlLzss.sizeKnown() ? g_dlLzss.outputSize() : 0;
+  }
+  return g_dl.sizeKnown ? g_dl.totalSize : 0;
+}
+
+// Largest image this device can install: the sketch area before LittleFS,
+// or the next OTA partition. 0 if unknown.
+static uint32_t imageSpace() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  return (uint32_t)((uintptr_t)&_FS_start - XIP_BASE);
+#else
+  const esp_partition_t* next = esp_ota_get_next_update_partition(nullptr);
+  return next ? next->size : 0;
+#endif
+}
+
+static uint32_t g_imageSpace = 0;  // imageSpace() of the open image
+
+static bool imageOpen() {
+  uint32_t imageSize = expectedImageSize();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  size_t existing = 0;
+  if (LittleFS.exists(kStagedImagePath)) {
+    g_stagedFile = LittleFS.open(kStagedImagePath, "r+");
+    if (g_stagedFile) existing = g_stagedFile.size();
+  } else {
+    g_stagedFile = LittleFS.open(kStagedImagePath, "w");
+  }
+  if (!g_stagedFile) {
+    Serial.println("[OTA] Cannot open staging file in LittleFS");
+    return false;
+  }
+
+  if (imageSize > 0) {
+    FSInfo info;
+    if (LittleFS.info(info) && imageSize > info.totalBytes - info.usedBytes + existing) {
+      Serial.printf("[OTA] Not enough LittleFS space for %lu byte image\n", (unsigned long)imageSize);
+      g_stagedFile.close();
+      return false;
+    }
+  }
+
+  // Drop anything past the verified prefix and continue from there
+  g_stagedFile.truncate(g_dl.imageWritten);
+  g_stagedFile.seek(g_dl.imageWritten, SeekSet);
+#else
+  if (g_dl.imageWritten != 0) {
+    return false;  // Update cannot reopen a partially written partition
+  }
+  if (!Update.begin(imageSize > 0 ? imageSize : UPDATE_SIZE_UNKNOWN)) {
+    Serial.printf("[OTA] Update.begin failed: %s\n", Update.errorString());
+    return false;
+  }
+#endif
+  imageBuffersReset(g_dl.imageWritten);
+  g_imageSpace = imageSpace();
+  g_dl.imageOpen = true;
+  return true;
+}
+
+// Image bytes, in order, into the open image
+static bool imageAppend(const uint8_t* data, size_t len) {
+  if (g_dl.expectedSize && len > g_dl.expectedSize - g_dl.imageWritten) {
+    Serial.println("[OTA] Image is larger than its signed manifest");
+    return false;
+  }
+  if (g_imageSpace && len > g_imageSpace - g_dl.imageWritten) {
+    Serial.printf("[OTA] Image rejected: larger than the %lu bytes it can be installed to\n",
+                  (unsigned long)g_imageSpace);
+    g_dl.imageRejected = true;
+    return false;
+  }
+  if (!imageBufferWrite(data, len)) {
+    Serial.println("[OTA] Writing firmware image failed");
+    return false;
+  }
+  g_dlSha.update(data, len);  // Hashed while the next bytes are still in flight
+  g_dl.imageWritten += (uint32_t)len;
+  return true;
+}
+
+#if OTA_IMAGE_CHECK_BYTES > 0
+// Pre-flight check: the first OTA_IMAGE_CHECK_BYTES of the image are held
+// back and checked (ota_image_check.h) before the staging file is opened
+// or a flash sector erased, so an image for another board is turned away
+// within the first packets of the transfer
+static_assert(OTA_IMAGE_CHECK_BYTES >= OTA_IMAGE_CHECK_MIN_BYTES, "OTA_IMAGE_CHECK_BYTES is too small");
+static_assert(OTA_IMAGE_CHECK_BYTES <= 0xFFFF, "OTA_IMAGE_CHECK_BYTES is too large");
+static uint8_t g_imageHeader[OTA_IMAGE_CHECK_BYTES];
+
+// The device the image has to be built for
+static void imageTarget(OtaImageTarget& target) {
+  memset(&target, 0, sizeof(target));
+  target.maxImageSize = imageSpace();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  target.kind = OTA_IMAGE_KIND_RP2350;
+#elif defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  target.kind = OTA_IMAGE_KIND_RP2040;
+#else
+  target.kind = OTA_IMAGE_KIND_ESP;
+  target.espChipId = CONFIG_IDF_FIRMWARE_CHIP_ID;
+  esp_chip_info_t chip;
+  esp_chip_info(&chip);
+  target.espChipRevision = chip.revision;  // major * 100 + minor
+  uint32_t flashSize = 0;
+  if (esp_flash_get_physical_size(nullptr, &flashSize) == ESP_OK) {
+    target.flashSize = flashSize;
+  }
+#endif
+}
+
+static const char* imageCheckErrorString(OtaImageCheckError error) {
+  switch (error) {
+    case OTA_IMAGE_CHECK_ERR_FORMAT: return "not a firmware image for this board";
+    case OTA_IMAGE_CHECK_ERR_CHIP: return "built for another chip";
+    case OTA_IMAGE_CHECK_ERR_REVISION: return "not built for this chip revision";
+    case OTA_IMAGE_CHECK_ERR_FLASH: return "built for a different flash layout";
+    case OTA_IMAGE_CHECK_ERR_SIZE: return "larger than the space it can be installed to";
+    default: return "unknown error";
+  }
+}
+
+// Check the held header, then open the image and write it
+static bool imageHeaderRelease() {
+  g_dl.headerChecked = true;
+  OtaImageTarget target;
+  imageTarget(target);
+  OtaImageInfo info;
+  OtaImageCheckError error = otaImageCheck(g_imageHeader, g_dl.headerLen, expectedImageSize(), target, &info);
+  if (error == OTA_IMAGE_CHECK_ERR_CHIP) {
+    Serial.printf("[OTA] Image rejected: built for %s, this device is %s\n",
+                  otaImageChipName(info.kind, info.espChipId), otaImageChipName(target.kind, target.espChipId));
+  } else if (error != OTA_IMAGE_CHECK_OK) {
+    Serial.printf("[OTA] Image rejected: %s\n", imageCheckErrorString(error));
+  }
+  if (error != OTA_IMAGE_CHECK_OK) {
+    g_dl.imageRejected = true;
+    return false;
+  }
+  return imageOpen() && imageAppend(g_imageHeader, g_dl.headerLen);
+}
+#endif
+
+static bool imageWrite(const uint8_t* data, size_t len) {
+#if OTA_IMAGE_CHECK_BYTES > 0
+  // A resumed image was checked when its first bytes arrived
+  if (!g_dl.imageOpen && !g_dl.headerChecked && g_dl.imageWritten == 0) {
+    size_t take = OTA_IMAGE_CHECK_BYTES - g_dl.headerLen;
+    if (take > len) take = len;
+    memcpy(g_imageHeader + g_dl.headerLen, data, take);
+    g_dl.headerLen += (uint16_t)take;
+    data += take;
+    len -= take;
+    if (g_dl.headerLen < OTA_IMAGE_CHECK_BYTES) {
+      return true;
+    }
+    if (!imageHeaderRelease()) {
+      return false;
+    }
+  }
+#endif
+  if (!g_dl.imageOpen && !imageOpen()) {
+    return false;
+  }
+  return imageAppend(data, len);
+}
+
+#if OTA_FEATURE_HTTP_PULL
+// The socket has nothing to read: program a waiting block meanwhile
+bool ota_internal::imageWriteIdle() {
+  if (!g_dl.imageOpen || g_imageReady == 0) return true;
+  if (!imageWriteReady()) {
+    Serial.println("[OTA] Writing firmware image failed");
+    return false;
+  }
+  return true;
+}
+#endif
+
+// Check the finished image against the expected digest, if there is one
+bool ota_internal::imageVerify() {
+  if (g_dl.expectedSize && g_dl.imageWritten != g_dl.expectedSize) {
+    Serial.println("[OTA] Image size differs from its signed manifest");
+    return false;
+  }
+  if (!g_dl.hasExpectedSha256) {
+    return true;
+  }
+  unsigned long startMs = millis();
+  uint8_t digest[OtaSha256::kDigestSize];
+  g_dlSha.finish(digest);
+  statsRecord(OTA_PHASE_VERIFY, (uint32_t)(millis() - startMs));
+  if (memcmp(digest, g_dl.expectedSha256, sizeof(digest)) != 0) {
+    Serial.println("[OTA] SHA-256 mismatch, image discarded");
+    return false;
+  }
+  Serial.println("[OTA] SHA-256 verified");
+  return true;
+}
+
+#if OTA_FEATURE_HTTP_PULL
+// Only a plain image can be resumed from its staged bytes after a reboot
+static bool imageJournaled() {
+  return g_dl.encoding == ENCODING_NONE && g_dl.format == FORMAT_RAW;
+}
+
+// Make the bytes written so far durable and record them in the journal
+void ota_internal::imageCheckpoint() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (g_dl.imageOpen && imageJournaled()) {
+    if (!imageFlushBuffers()) {
+      Serial.println("[OTA] Writing firmware image failed");
+      return;  // Journal keeps the previous checkpoint
+    }
+    g_stagedFile.flush();
+    saveJournal();
+  }
+#endif
+}
+#endif  // OTA_FEATURE_HTTP_PULL
+
+// Throw away what was written and start the image again from byte 0
+bool ota_internal::imageRestart() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (g_dl.imageOpen) {
+    g_stagedFile.close();
+  }
+  LittleFS.remove(kJournalPath);
+  LittleFS.remove(kStagedImagePath);
+#else
+  if (g_dl.imageOpen) {
+    Update.end();  // Not finished: aborts the update
+  }
+#endif
+  imageBuffersReset(0);
+  g_dl.imageOpen = false;
+  g_dl.offset = 0;
+  g_dl.crc = 0;
+  g_dl.imageWritten = 0;
+  g_dl.encoding = ENCODING_UNKNOWN;
+  g_dl.encodingSniffLen = 0;
+  g_dl.format = FORMAT_UNKNOWN;
+  g_dl.sniffLen = 0;
+  g_dl.headerLen = 0;
+  g_dl.headerChecked = false;
+  g_dl.etag[0] = '\0';
+  g_dlSha.begin();
+  return true;
+}
+
+#if OTA_FEATURE_HTTP_PULL
+// Leave the update unfinished. The Pico staging file and journal stay in
+// LittleFS so the next call with the same URL resumes (plain images only).
+void ota_internal::imageSuspend() {
+  if (!g_dl.imageOpen) return;
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  if (!imageJournaled() || !imageFlushBuffers()) {
+    imageRestart();
+    return;
+  }
+  g_stagedFile.flush();
+  saveJournal();
+  g_stagedFile.close();
+#else
+  Update.end();  // Not finished: aborts the update
+#endif
+  g_dl.imageOpen = false;
+}
+#endif
+
+static void statsInstalled(unsigned long startMs) {
+  statsRecord(OTA_PHASE_INSTALL, (uint32_t)(millis() - startMs));
+  statsAdd(offsetof(OtaStats, updatesInstalled), 1);
+  statsSeal();
+}
+
+// Install the completed image and reboot. Only returns on failure.
+void ota_internal::imageCommitAndReboot() {
+  unsigned long startMs = millis();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  bool flushed = imageFlushBuffers();
+  g_stagedFile.close();
+  g_dl.imageOpen = false;
+  if (!flushed) {
+    Serial.println("[OTA] Writing firmware image failed");
+    imageRestart();
+    return;
+  }
+  LittleFS.remove(kJournalPath);
+  bootGuardInstall(g_dl.hasExpectedSha256 ? g_dl.expectedSha256 : nullptr);
+
+  picoOTA.begin();
+  picoOTA.addFile(kStagedImagePath);
+  picoOTA.commit();
+  LittleFS.end();
+  statsInstalled(startMs);
+
+  Serial.println("[OTA] Update successful, rebooting...");
+  delay(100);
+  rp2040.reboot();
+#else
+  if (!imageFlushBuffers()) {
+    Serial.println("[OTA] Writing firmware image failed");
+    imageRestart();  // Aborts the update
+    return;
+  }
+  g_dl.imageOpen = false;
+  if (!Update.end(true)) {
+    Serial.printf("[OTA] Update.end failed: %s\n", Update.errorString());
+    return;
+  }
+  bootGuardInstall(g_dl.hasExpectedSha256 ? g_dl.expectedSha256 : nullptr);
+  statsInstalled(startMs);
+
+  Serial.println("[OTA] Update successful, rebooting...");
+  delay(100);
+  ESP.restart();
+#endif
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Image pipeline (compressed / delta / raw)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Source for delta patches: the firmware that is running right now
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+bool ota_internal::readRunningImage(uint32_t offset, uint8_t* buf, size_t len, void*) {
+  uint32_t sketchArea = (uint32_t)((uintptr_t)&_FS_start - XIP_BASE);
+  if (offset > sketchArea || len > sketchArea - offset) {
+    return false;
+  }
+  memcpy(buf, reinterpret_cast<const uint8_t*>(XIP_BASE + offset), len);
+  return true;
+}
+#else
+bool ota_internal::readRunningImage(uint32_t offset, uint8_t* buf, size_t len, void*) {
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  if (!running || offset > running->size || len > running->size - offset) {
+    return false;
+  }
+  return esp_partition_read(running, offset, buf, len) == ESP_OK;
+}
+#endif
+
+static bool writePatchedImage(const uint8_t* data, size_t len, void*) {
+  return imageWrite(data, len);
+}
+
+static const char* deltaErrorString(OtaDeltaError error) {
+  switch (error) {
+    case OTA_DELTA_ERR_HEADER: return "unsupported patch format";
+    case OTA_DELTA_ERR_SOURCE_MISMATCH: return "patch was made for different firmware";
+    case OTA_DELTA_ERR_CORRUPT: return "patch is corrupt";
+    case OTA_DELTA_ERR_READ: return "cannot read running firmware";
+    case OTA_DELTA_ERR_WRITE: return "write failed";
+    case OTA_DELTA_ERR_TARGET_CRC: return "rebuilt image CRC mismatch";
+    default: return "unknown error";
+  }
+}
+
+static bool deltaFeed(const uint8_t* data, size_t len) {
+  if (g_dlDelta.feed(data, len)) {
+    return true;
+  }
+  Serial.printf("[OTA] Delta update failed: %s\n", deltaErrorString(g_dlDelta.error()));
+  return false;
+}
+
+// Collect the first bytes of a stream; true once the buffer is full
+static bool sniffBytes(uint8_t* buf, uint8_t& bufLen, const uint8_t*& data, size_t& len) {
+  size_t take = 4 - bufLen;
+  if (take > len) take = len;
+  memcpy(buf + bufLen, data, take);
+  bufLen += (uint8_t)take;
+  data += take;
+  len -= take;
+  return bufLen == 4;
+}
+
+// Decide the image format from the sniffed bytes and pass them on
+static bool imageStageStart() {
+  if (OtaDeltaPatcher::isPatch(g_dl.sniff, g_dl.sniffLen)) {
+    Serial.println("[OTA] Delta patch received, rebuilding image from running firmware");
+    g_dl.format = FORMAT_DELTA;
+    g_dlDelta.begin(readRunningImage, writePatchedImage, nullptr);
+    // The feed() that completes the 24-byte header checks the running
+    // image's CRC in one go, so that otaLoop() call takes longer than the rest
+    return deltaFeed(g_dl.sniff, g_dl.sniffLen);
+  }
+  g_dl.format = FORMAT_RAW;
+  return imageWrite(g_dl.sniff, g_dl.sniffLen);
+}
+
+// Decoded bytes: a plain image or a delta patch
+static bool imageStageWrite(const uint8_t* data, size_t len) {
+  if (g_dl.format == FORMAT_UNKNOWN) {
+    if (!sniffBytes(g_dl.sniff, g_dl.sniffLen, data, len)) {
+      return true;
+    }
+    if (!imageStageStart()) {
+      return false;
+    }
+  }
+  if (len == 0) {
+    return true;
+  }
+  return (g_dl.format == FORMAT_DELTA) ? deltaFeed(data, len) : imageWrite(data, len);
+}
+
+static bool writeDecompressed(const uint8_t* data, size_t len, void*) {
+  return imageStageWrite(data, len);
+}
+
+static const char* lzssErrorString(OtaLzssError error) {
+  switch (error) {
+    case OTA_LZSS_ERR_HEADER: return "unsupported format";
+    case OTA_LZSS_ERR_PARAMS: return "window too large (raise OTA_LZSS_MAX_WINDOW_BITS)";
+    case OTA_LZSS_ERR_CORRUPT: return "stream is corrupt or truncated";
+    case OTA_LZSS_ERR_WRITE: return "write failed";
+    default: return "unknown error";
+  }
+}
+
+static bool lzssFeed(const uint8_t* data, size_t len) {
+  if (g_dlLzss.feed(data, len)) {
+    return true;
+  }
+  if (g_dlLzss.error() != OTA_LZSS_ERR_WRITE) {  // Write errors were reported by the next stage
+    Serial.printf("[OTA] Decompression failed: %s\n", lzssErrorString(g_dlLzss.error()));
+  }
+  return false;
+}
+
+// Decide the transfer encoding from the sniffed bytes and pass them on
+static bool transportStart() {
+  if (OtaLzssDecoder::isCompressed(g_dl.encodingSniff, g_dl.encodingSniffLen)) {
+    Serial.println("[OTA] Compressed image received");
+    g_dl.encoding = ENCODING_LZSS;
+    g_dlLzss.begin(writeDecompressed, nullptr);
+    return lzssFeed(g_dl.encodingSniff, g_dl.encodingSniffLen);
+  }
+  g_dl.encoding = ENCODING_NONE;
+  return imageStageWrite(g_dl.encodingSniff, g_dl.encodingSniffLen);
+}
+
+#if OTA_FEATURE_HTTP_PULL
+// Server announced "Content-Encoding: heatshrink": a bare stream without the
+// "OTAZ" header, decoded with the default window parameters
+void ota_internal::pipelineUseContentEncoding() {
+  g_dl.encoding = ENCODING_LZSS;
+  g_dlLzss.beginRaw(OtaLzssDecoder::kDefaultWindowBits, OtaLzssDecoder::kDefaultLookaheadBits,
+                    writeDecompressed, nullptr);
+}
+#endif
+
+// Every downloaded or uploaded byte goes through here
+bool ota_internal::pipelineWrite(const uint8_t* data, size_t len) {
+  if (g_dl.encoding == ENCODING_UNKNOWN) {
+    if (!sniffBytes(g_dl.encodingSniff, g_dl.encodingSniffLen, data, len)) {
+      return true;
+    }
+    if (!transportStart()) {
+      return false;
+    }
+  }
+  if (len == 0) {
+    return true;
+  }
+  return (g_dl.encoding == ENCODING_LZSS) ? lzssFeed(data, len) : imageStageWrite(data, len);
+}
+
+// The transfer is complete: flush what is still held back in each stage
+bool ota_internal::pipelineFinish() {
+  if (g_dl.encoding == ENCODING_UNKNOWN && g_dl.encodingSniffLen > 0 && !transportStart()) {
+    return false;
+  }
+  if (g_dl.encoding == ENCODING_LZSS && !g_dlLzss.finish()) {
+    Serial.printf("[OTA] Decompression failed: %s\n", lzssErrorString(g_dlLzss.error()));
+    return false;
+  }
+  if (g_dl.format == FORMAT_UNKNOWN && g_dl.sniffLen > 0 && !imageStageStart()) {
+    return false;
+  }
+  if (g_dl.format == FORMAT_DELTA && !g_dlDelta.done()) {
+    Serial.println("[OTA] Delta update failed: patch is truncated");
+    return false;
+  }
+#if OTA_IMAGE_CHECK_BYTES > 0
+  // An image shorter than the pre-flight window is checked whole
+  if (!g_dl.imageOpen && !g_dl.headerChecked && g_dl.headerLen > 0 && !imageHeaderRelease()) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+void ota_internal::sessionBegin() {
+  memset(&g_dl, 0, sizeof(g_dl));
+  g_dlSha.begin();
+}
+
+void otaClearPendingDownload() {
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+  clearStagedDownload();
+#endif
+}
+#endif  // OTA_STAGING
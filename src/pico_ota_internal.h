@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Shared by the library's own source files only; not part of the API.
+//
+// The library is split by feature module (see pico_ota_config.h), one
+// source file each, and a file whose module is off compiles to nothing:
+//   pico_ota.cpp            core: setup, WiFi, otaLoop(), progress, boot guard
+//   pico_ota_telemetry.cpp  OTA_FEATURE_TELEMETRY: otaGetStats() counters
+//   pico_ota_image.cpp      OTA_STAGING: image writer and decoders
+//   pico_ota_http.cpp       OTA_FEATURE_HTTP_PULL: download engine, sources, scheduler
+//   pico_ota_worker.cpp     OTA_FEATURE_HTTP_PULL: background worker
+//   pico_ota_peers.cpp      OTA_PEERS: serving the running image to LAN peers
+//   pico_ota_web.cpp        OTA_FEATURE_WEB: browser upload, /status, /metrics
+//   pico_ota_github.cpp     OTA_FEATURE_GITHUB: release checks
+// State and helpers used by more than one of them are declared below, in
+// namespace ota_internal so they cannot clash with names in the sketch.
+// Everything else stays static in its file.
+
+#ifndef PICO_OTA_INTERNAL_H
+#define PICO_OTA_INTERNAL_H
+
+#include "pico_ota.h"
+
+#include <Arduino.h>
+#include <ArduinoOTA.h>
+#include <WiFi.h>
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <new>
+
+#include "ota_crc32.h"
+#include "ota_delta.h"
+#include "ota_image_check.h"
+#include "ota_lzss.h"
+#include "ota_manifest.h"
+#include "ota_release_parser.h"
+#include "ota_semver.h"
+#include "ota_sha256.h"
+#include "ota_spsc.h"
+#include "pico_ota_config.h"
+
+// Feature modules (see pico_ota_config.h). Only the Arduino libraries of
+// the modules that are on are included, so the others are not even built.
+#if OTA_FEATURE_HTTP_PULL
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#endif
+#if OTA_FEATURE_WEB
+#include <WebServer.h>
+#endif
+
+// The image writer and decoders serve both HTTP pulls and web uploads;
+// LAN peers fetch over HTTP from each other's web servers
+#define OTA_STAGING (OTA_FEATURE_HTTP_PULL || OTA_FEATURE_WEB)
+#define OTA_PEERS (OTA_FEATURE_HTTP_PULL && OTA_FEATURE_WEB)
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+#include <LEAmDNS.h>
+#include <LittleFS.h>
+#include <PicoOTA.h>
+#elif defined(ARDUINO_ARCH_ESP32)
+#include <ESPmDNS.h>
+#include <Preferences.h>
+#include <Update.h>
+#include <esp_chip_info.h>
+#include <esp_flash.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#endif
+
+namespace ota_internal {
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Core (pico_ota.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+extern bool g_otaStarted;                     // ArduinoOTA.begin() was called
+extern char g_currentVersion[OTA_MAX_VERSION_LEN];  // otaSetCurrentVersion()
+extern void (*g_onStartCallback)();
+extern void (*g_onEndCallback)();
+extern void (*g_onErrorCallback)(int);
+
+void copyString(char* dest, size_t destSize, const char* src);
+bool storeSetting(char* dest, size_t destSize, const char* src, const char* what);
+void heapSample();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+bool ensureLittleFsMounted();
+#endif
+void handleAutoReconnect();
+
+// Transfer progress of the current download or web upload
+extern OtaTransferStatus g_transfer;
+extern OtaProgressPhase g_progressPhase;
+extern uint32_t g_transferWriteMs;            // Time spent in flash writes
+void transferBegin(OtaProgressPhase phase, uint32_t bytes, uint32_t total);
+void transferProgress(uint32_t bytes, uint32_t total);
+void transferEnd();
+void progressDispatch();
+void progressPhase(OtaProgressPhase phase);
+
+// Boot guard
+uint32_t runningImageSize();
+void bootGuardInstall(const uint8_t* sha256);
+void bootGuardCheckSpace();
+#if OTA_FEATURE_HTTP_PULL
+bool bootImageRejected(const uint8_t* sha256);
+#endif
+
+#if OTA_FEATURE_HTTP_PULL || defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+extern uint8_t g_dlBuffer[1024];              // Network reads; the boot guard's copy buffer on Pico
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Telemetry (pico_ota_telemetry.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Without OTA_FEATURE_TELEMETRY the recording calls are empty
+#if OTA_FEATURE_TELEMETRY
+void statsAdd(size_t offset, uint32_t n);     // offset: offsetof(OtaStats, <counter>)
+void statsRecord(OtaPhase phase, uint32_t ms);
+void statsSeal();
+void statsWifiState(OtaWifiState from, OtaWifiState to, unsigned long nowMs);
+#else
+inline void statsAdd(size_t, uint32_t) {}
+inline void statsRecord(OtaPhase, uint32_t) {}
+inline void statsSeal() {}
+inline void statsWifiState(OtaWifiState, OtaWifiState, unsigned long) {}
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Image writer (pico_ota_image.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_STAGING
+enum TransferEncoding : uint8_t {
+  ENCODING_UNKNOWN,     // Fewer than 4 bytes received so far
+  ENCODING_NONE,
+  ENCODING_LZSS         // "OTAZ" file or Content-Encoding: heatshrink
+};
+
+enum ImageFormat : uint8_t {
+  FORMAT_UNKNOWN,       // Fewer than 4 (decoded) bytes so far
+  FORMAT_RAW,           // Plain firmware image
+  FORMAT_DELTA          // Patch against the running firmware
+};
+
+struct DownloadSession {
+  char url[OTA_MAX_REDIRECT_URL_LEN]; // Current URL (after redirects)
+  char originalUrl[OTA_MAX_URL_LEN];  // As given by the caller, re-resolved if the CDN link expires
+  char etag[OTA_MAX_ETAG_LEN];        // Validator sent back with If-Range
+  const char* currentVersion;
+  uint32_t totalSize;                 // 0 until the server reports it
+  bool sizeKnown;
+  uint32_t offset;                    // Bytes written to the image so far
+  uint32_t crc;                       // CRC32 of bytes [0, offset)
+  uint32_t imageWritten;              // Bytes written to the image (differs from offset if encoded)
+  uint8_t encoding;                   // TransferEncoding
+  uint8_t encodingSniff[4];           // First bytes of the body, held until the encoding is known
+  uint8_t encodingSniffLen;
+  uint8_t format;                     // ImageFormat
+  uint8_t sniff[4];                   // First decoded bytes, held until the format is known
+  uint8_t sniffLen;
+  uint8_t expectedSha256[OtaSha256::kDigestSize];
+  bool hasExpectedSha256;
+  uint32_t expectedSize;              // From a signed manifest, 0 if unknown
+  uint16_t headerLen;                 // First image bytes held for the pre-flight check
+  bool headerChecked;
+  bool imageRejected;                 // Pre-flight check failed: OTA_UPDATE_WRONG_IMAGE
+  bool imageOpen;
+  bool http10;                        // Server answered with a chunked body: ask for HTTP/1.0
+  bool fromPeer;                      // Fetching from a LAN peer: any HTTP error ends the attempt
+};
+
+extern DownloadSession g_dl;
+extern OtaSha256 g_dlSha;                     // Hash of the image bytes written so far
+
+void sessionBegin();
+bool pipelineWrite(const uint8_t* data, size_t len);
+bool pipelineFinish();
+bool imageVerify();
+bool imageRestart();
+void imageCommitAndReboot();
+bool readRunningImage(uint32_t offset, uint8_t* buf, size_t len, void*);
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+void cleanupStagedImage();
+#endif
+#if OTA_FEATURE_HTTP_PULL
+void pipelineUseContentEncoding();
+bool imageWriteIdle();
+void imageCheckpoint();
+void imageSuspend();
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+void loadJournal();
+#endif
+#endif
+#endif  // OTA_STAGING
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// HTTP download engine (pico_ota_http.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_FEATURE_HTTP_PULL
+extern HTTPClient g_dlHttp;
+extern bool g_deltaUpdates;
+extern bool g_signingKeySet;
+extern char g_smallFile[OTA_MANIFEST_MAX_SIZE + 1];
+
+uint32_t fnv1a(const char* s, uint32_t hash = 2166136261UL);  // Pass the previous result to hash on
+WiFiClient* openConnection(const char* url);
+void closeConnection();
+void recordServerHint(HTTPClient& http);
+int fetchSmallFile(const char* url, const char* suffix);
+bool versionIsUpdate(const char* current, const char* candidate);
+bool rolloutIncludes(const OtaManifest& manifest);
+int fetchManifest(const char* imageUrl, OtaManifest& manifest);
+void statsManifestFailed();
+int downloadImage(const char* url, const char* currentVersion, const char* expectedSha256,
+                  const OtaManifest* manifest);
+int downloadFirmware(const char* url, const char* currentVersion, const char* expectedSha256,
+                     const OtaManifest* manifest);
+
+// Time-sliced updates and the scheduler, driven from otaLoop()
+bool updateBusy();
+bool steppedUpdateActive();
+void handleSteppedUpdate();
+void handleUpdateSchedule();
+#else
+inline bool steppedUpdateActive() { return false; }
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Background worker (pico_ota_worker.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_FEATURE_HTTP_PULL
+void workerProgress(const OtaProgress& report);
+#else
+inline void workerProgress(const OtaProgress&) {}
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// LAN peer sharing (pico_ota_peers.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_PEERS
+const char* const kPeerService = "pico-ota";  // mDNS service "_pico-ota._tcp"
+extern bool g_peerSharing;                    // Serve the running image to, and fetch from, LAN peers
+extern char g_peerToken[OTA_MAX_CREDENTIAL_LEN];  // Shared secret between peers (otaSetPeerToken)
+extern bool g_peerSending;
+
+void peerAdvertise();
+void handlePeerSharing();
+void handlePeerImage();
+void peerSendEnd();
+#else
+inline void peerAdvertise() {}
+inline void handlePeerSharing() {}
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Web server (pico_ota_web.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_FEATURE_WEB
+extern WebServer* g_webServer;
+extern bool g_webServerRunning;
+extern char g_webUsername[OTA_MAX_CREDENTIAL_LEN];
+extern char g_webPassword[OTA_MAX_CREDENTIAL_LEN];
+extern uint16_t g_webServerPort;
+#endif
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// GitHub releases (pico_ota_github.cpp)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#if OTA_FEATURE_GITHUB
+extern char g_latestVersion[OTA_MAX_VERSION_LEN];
+extern char g_latestAssetUrl[OTA_MAX_URL_LEN];
+#endif
+
+}  // namespace ota_internal
+
+#if OTA_STAGING && !OTA_FEATURE_HTTP_PULL
+void otaClearPendingDownload();  // Only in pico_ota.h with HTTP pulls; web uploads call it too
+#endif
+
+using namespace ota_internal;  // Library sources only; sketches include pico_ota.h
+
+#endif  // PICO_OTA_INTERNAL_H
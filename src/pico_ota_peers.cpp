@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+#if OTA_PEERS
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// LAN Peer Sharing
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// GET /ota/image?sha256=<hex>&size=<bytes> on the web server returns the
+// running firmware if it is <size> bytes long and hashes to <sha256>, with
+// Range support; anything else is a 404. Images are addressed by digest, so
+// the server never has to know versions or manifests, and a receiver checks
+// what it gets against its own signed manifest. The mDNS service
+// "_pico-ota._tcp" is announced once ArduinoOTA and the web server are up
+// and the running image is hashed.
+// - Requests need the X-OTA-Peer-Token header (otaSetPeerToken()) or the
+//   web credentials; with neither set, nothing is served.
+// - The running image is hashed once per boot, kPeerSliceBytes per
+//   otaLoop(), so a request never starts a hash.
+// - The body goes out kPeerSliceBytes per otaLoop() as well, to one peer at
+//   a time; others get a 503 and move on to the next peer or the server.
+static const uint32_t kPeerSliceBytes = 4096;
+static const unsigned long kPeerStallMs = 10000;  // Peer stopped reading: drop it
+static bool g_peerAdvertised = false;
+static bool g_peerRefusedLogged = false;
+
+namespace ota_internal {
+bool g_peerSharing = false;
+char g_peerToken[OTA_MAX_CREDENTIAL_LEN] = "";
+bool g_peerSending = false;
+}  // namespace ota_internal
+
+// Digest of the running image
+static OtaSha256 g_peerHash;
+static uint32_t g_peerHashed = 0;
+static uint32_t g_peerImageSize = 0;  // 0 until the first slice
+static uint8_t g_peerImageSha256[OtaSha256::kDigestSize];
+static bool g_peerImageReady = false;
+
+// Response being sent
+static WiFiClient g_peerClient;
+static uint32_t g_peerOffset = 0;
+static uint32_t g_peerEnd = 0;  // Exclusive
+static unsigned long g_peerLastWriteMs = 0;
+
+void ota_internal::peerAdvertise() {
+  if (!g_peerSharing || g_peerAdvertised || !g_peerImageReady || !g_otaStarted || !g_webServerRunning) {
+    return;
+  }
+  if (MDNS.addService(kPeerService, "tcp", g_webServerPort)) {
+    g_peerAdvertised = true;
+    Serial.printf("[OTA] Sharing firmware with LAN peers on port %u\n", (unsigned)g_webServerPort);
+  }
+}
+
+// Hash the next slice of the running image; g_dlBuffer is free, since
+// downloads only hold data in it within a call or step
+static void peerHashStep() {
+  if (g_peerImageSize == 0) {
+    g_peerImageSize = runningImageSize();
+    g_peerHash.begin();
+  }
+  for (uint32_t budget = kPeerSliceBytes; budget > 0 && g_peerHashed < g_peerImageSize;) {
+    uint32_t len = g_peerImageSize - g_peerHashed;
+    if (len > sizeof(g_dlBuffer)) len = sizeof(g_dlBuffer);
+    if (len > budget) len = budget;
+    if (!readRunningImage(g_peerHashed, g_dlBuffer, len, nullptr)) {
+      Serial.println("[OTA] Could not read the running firmware, not sharing it");
+      g_peerSharing = false;
+      return;
+    }
+    g_peerHash.update(g_dlBuffer, len);
+    g_peerHashed += len;
+    budget -= len;
+  }
+  if (g_peerHashed == g_peerImageSize) {
+    g_peerHash.finish(g_peerImageSha256);
+    g_peerImageReady = true;
+    peerAdvertise();
+  }
+}
+
+void ota_internal::peerSendEnd() {
+  g_peerClient.stop();
+  g_peerClient = WiFiClient();
+  g_peerSending = false;
+}
+
+// Send the next slice of the response
+static void peerSendStep() {
+  if (!g_peerClient.connected()) {
+    peerSendEnd();
+    return;
+  }
+  for (uint32_t budget = kPeerSliceBytes; budget > 0 && g_peerOffset < g_peerEnd;) {
+    uint32_t len = g_peerEnd - g_peerOffset;
+    if (len > sizeof(g_dlBuffer)) len = sizeof(g_dlBuffer);
+    if (len > budget) len = budget;
+    if (!readRunningImage(g_peerOffset, g_dlBuffer, len, nullptr)) {
+      peerSendEnd();
+      return;
+    }
+    size_t sent = g_peerClient.write(g_dlBuffer, len);
+    statsAdd(offsetof(OtaStats, bytesServed), (uint32_t)sent);
+    g_peerOffset += (uint32_t)sent;
+    budget -= len;
+    if (sent > 0) {
+      g_peerLastWriteMs = millis();
+    }
+    if (sent < len) {
+      break;  // Send buffer full; the rest goes on a later pass
+    }
+  }
+  if (g_peerOffset >= g_peerEnd || millis() - g_peerLastWriteMs >= kPeerStallMs) {
+    peerSendEnd();
+  }
+}
+
+void ota_internal::handlePeerSharing() {
+  if (g_peerSending) {
+    peerSendStep();
+  } else if (g_peerSharing && !g_peerImageReady) {
+    peerHashStep();
+  }
+}
+
+// Constant time, so the token cannot be guessed byte by byte from timing
+static bool peerTokenMatches(const String& token) {
+  size_t len = strlen(g_peerToken);
+  if (token.length() != len) {
+    return false;
+  }
+  uint8_t diff = 0;
+  for (size_t i = 0; i < len; i++) {
+    diff |= (uint8_t)(token[i] ^ g_peerToken[i]);
+  }
+  return diff == 0;
+}
+
+static bool peerAuthorized() {
+  if (g_peerToken[0] && peerTokenMatches(g_webServer->header("X-OTA-Peer-Token"))) {
+    return true;
+  }
+  return g_webUsername[0] && g_webPassword[0] && g_webServer->authenticate(g_webUsername, g_webPassword);
+}
+
+// "bytes=100-199" or "bytes=100-" against an image of size bytes
+static bool parseRangeRequest(const char* value, uint32_t size, uint32_t& first, uint32_t& last) {
+  if (strncmp(value, "bytes=", 6) != 0) return false;
+  char* end = nullptr;
+  first = (uint32_t)strtoul(value + 6, &end, 10);
+  if (!end || *end != '-') return false;
+  last = end[1] ? (uint32_t)strtoul(end + 1, nullptr, 10) : size - 1;
+  if (last >= size) last = size - 1;
+  return true;
+}
+
+void ota_internal::handlePeerImage() {
+  if (!g_peerSharing) {
+    g_webServer->send(404, "text/plain", "Image not available");
+    return;
+  }
+  if (!g_peerToken[0] && !(g_webUsername[0] && g_webPassword[0])) {
+    if (!g_peerRefusedLogged) {
+      g_peerRefusedLogged = true;
+      Serial.println("[OTA] Not serving LAN peers: set otaSetPeerToken() or web credentials");
+    }
+    g_webServer->send(403, "text/plain", "Peer sharing needs a token or credentials");
+    return;
+  }
+  if (!peerAuthorized()) {
+    g_webServer->requestAuthentication();
+    return;
+  }
+  uint8_t sha256[OtaSha256::kDigestSize];
+  uint32_t size = (uint32_t)strtoul(g_webServer->arg("size").c_str(), nullptr, 10);
+  if (!g_peerImageReady || size != g_peerImageSize ||
+      !otaParseSha256Hex(g_webServer->arg("sha256").c_str(), sha256) ||
+      memcmp(sha256, g_peerImageSha256, sizeof(sha256)) != 0) {
+    g_webServer->send(404, "text/plain", "Image not available");
+    return;
+  }
+  if (g_peerSending) {
+    g_webServer->sendHeader("Retry-After", "5");
+    g_webServer->send(503, "text/plain", "Serving another peer");
+    return;
+  }
+
+  uint32_t first = 0;
+  uint32_t last = size - 1;
+  String range = g_webServer->header("Range");
+  bool partial = parseRangeRequest(range.c_str(), size, first, last);
+  char header[48];
+  if (partial && first > last) {
+    snprintf(header, sizeof(header), "bytes */%lu", (unsigned long)size);
+    g_webServer->sendHeader("Content-Range", header);
+    g_webServer->send(416, "text/plain", "");
+    return;
+  }
+  if (partial) {
+    snprintf(header, sizeof(header), "bytes %lu-%lu/%lu", (unsigned long)first, (unsigned long)last,
+             (unsigned long)size);
+    g_webServer->sendHeader("Content-Range", header);
+  }
+  g_webServer->sendHeader("Accept-Ranges", "bytes");
+  g_webServer->setContentLength(last - first + 1);
+  g_webServer->send(partial ? 206 : 200, "application/octet-stream", "");
+  // Holding a copy of the client keeps the connection open past this handler
+  g_peerClient = g_webServer->client();
+  g_peerSending = true;
+  g_peerOffset = first;
+  g_peerEnd = last + 1;
+  g_peerLastWriteMs = millis();
+}
+
+void otaSetPeerSharing(bool enabled) {
+  g_peerSharing = enabled;
+  peerAdvertise();  // The announcement stays until reboot; requests get a 404 when off
+}
+
+void otaSetPeerToken(const char* token) {
+  storeSetting(g_peerToken, sizeof(g_peerToken), token, "Peer token");
+}
+
+#endif  // OTA_PEERS
+
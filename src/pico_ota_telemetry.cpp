@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Telemetry
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// The counters behind otaGetStats(), laid out word for word like OtaStats.
+// Only the thread doing OTA work records, with plain atomic loads and
+// stores (no read-modify-write, which Cortex-M0+ lacks), so readers on the
+// other core or task never wait; a snapshot taken mid-event may show the
+// count of a phase without its time yet.
+// The block lives in RAM that reset leaves alone. Before the library
+// reboots it is sealed with a CRC, and the next boot keeps it if the seal
+// holds, so an update's numbers outlive the reboot that installs it.
+// Without OTA_FEATURE_TELEMETRY the recording calls are empty inlines
+// (pico_ota_internal.h) and this file compiles to nothing.
+#if OTA_FEATURE_TELEMETRY
+static const uint32_t kStatsMagic = 0x5341544F;  // "OTAS"
+static const size_t kStatsWords = sizeof(OtaStats) / sizeof(uint32_t);
+static_assert(sizeof(OtaStats) == kStatsWords * sizeof(uint32_t), "OtaStats must be made of uint32_t only");
+
+struct StatsBlock {
+  uint32_t magic;  // kStatsMagic only while sealed for a reboot
+  uint32_t crc;
+  std::atomic<uint32_t> words[kStatsWords];
+};
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_RASPBERRY_PI_PICO_2W)
+static StatsBlock g_stats __attribute__((section(".uninitialized_data.ota_stats")));
+#else
+static StatsBlock g_stats RTC_NOINIT_ATTR;
+#endif
+
+static bool g_statsConnectedOnce = false;  // OTA_PHASE_BOOT recorded
+static bool g_statsWifiLost = false;
+static unsigned long g_statsWifiLostMs = 0;
+
+static std::atomic<uint32_t>& statsWord(size_t offset) {
+  return g_stats.words[offset / sizeof(uint32_t)];
+}
+
+// offset: offsetof(OtaStats, <counter>)
+void ota_internal::statsAdd(size_t offset, uint32_t n) {
+  std::atomic<uint32_t>& word = statsWord(offset);
+  word.store(word.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Bucket 0 holds 0 ms, bucket i 2^(i-1) .. 2^i - 1 ms, the last one the rest
+static size_t statsBucket(uint32_t ms) {
+  size_t bucket = 0;
+  while (ms && bucket < OTA_STATS_BUCKETS - 1) {
+    ms >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void ota_internal::statsRecord(OtaPhase phase, uint32_t ms) {
+  size_t base = offsetof(OtaStats, phases) + (size_t)phase * sizeof(OtaPhaseStats);
+  statsAdd(base + offsetof(OtaPhaseStats, count), 1);
+  statsAdd(base + offsetof(OtaPhaseStats, totalMs), ms);
+  std::atomic<uint32_t>& maxMs = statsWord(base + offsetof(OtaPhaseStats, maxMs));
+  if (ms > maxMs.load(std::memory_order_relaxed)) {
+    maxMs.store(ms, std::memory_order_relaxed);
+  }
+  statsAdd(base + offsetof(OtaPhaseStats, buckets) + statsBucket(ms) * sizeof(uint32_t), 1);
+}
+
+static uint32_t statsCrc() {
+  uint32_t crc = 0;
+  for (size_t i = 0; i < kStatsWords; i++) {
+    uint32_t word = g_stats.words[i].load(std::memory_order_relaxed);
+    crc = otaCrc32(crc, &word, sizeof(word));
+  }
+  return crc;
+}
+
+static void statsClear() {
+  for (size_t i = 0; i < kStatsWords; i++) {
+    g_stats.words[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+// Called right before the library reboots the device
+void ota_internal::statsSeal() {
+  g_stats.crc = statsCrc();
+  g_stats.magic = kStatsMagic;
+}
+
+// Keep a sealed block, clear anything else (power-on, crash, watchdog)
+static bool statsRestore() {
+  bool kept = g_stats.magic == kStatsMagic && g_stats.crc == statsCrc();
+  if (!kept) {
+    statsClear();
+  }
+  g_stats.magic = 0;
+  return kept;
+}
+static const bool g_statsKept = statsRestore();  // Before setup(), so nothing records yet
+
+// WiFi state changes: time to the first connection after boot, outages
+void ota_internal::statsWifiState(OtaWifiState from, OtaWifiState to, unsigned long nowMs) {
+  if (from == OTA_WIFI_CONNECTED && to != OTA_WIFI_CONNECTED) {
+    statsAdd(offsetof(OtaStats, wifiDisconnects), 1);
+    g_statsWifiLost = true;
+    g_statsWifiLostMs = nowMs;
+  } else if (from != OTA_WIFI_CONNECTED && to == OTA_WIFI_CONNECTED) {
+    if (!g_statsConnectedOnce) {
+      g_statsConnectedOnce = true;
+      statsRecord(OTA_PHASE_BOOT, (uint32_t)nowMs);
+      if (g_statsKept) {
+        Serial.println("[OTA] Telemetry kept across the reboot");
+      }
+    } else if (g_statsWifiLost) {
+      statsRecord(OTA_PHASE_RECONNECT, (uint32_t)(nowMs - g_statsWifiLostMs));
+    }
+    g_statsWifiLost = false;
+  }
+}
+
+void otaGetStats(OtaStats* stats) {
+  if (!stats) return;
+  uint32_t* words = reinterpret_cast<uint32_t*>(stats);
+  for (size_t i = 0; i < kStatsWords; i++) {
+    words[i] = g_stats.words[i].load(std::memory_order_relaxed);
+  }
+}
+
+void otaResetStats() {
+  statsClear();
+}
+
+#endif  // OTA_FEATURE_TELEMETRY
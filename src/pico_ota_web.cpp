@@ -0,0 +1,360 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+#include "ota_webui.h"
+
+#if OTA_FEATURE_WEB
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Web Browser Upload
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Uploads go through the same pipeline as downloads, so a browser can send
+// a plain .bin, a compressed .otaz or a delta .otad file.
+// The pages are pre-compressed in ota_webui.h (extras/ota_webui.py).
+namespace ota_internal {
+WebServer* g_webServer = nullptr;  // Constructed in g_webServerStorage
+bool g_webServerRunning = false;
+char g_webUsername[OTA_MAX_CREDENTIAL_LEN];
+char g_webPassword[OTA_MAX_CREDENTIAL_LEN];
+uint16_t g_webServerPort = 80;
+}  // namespace ota_internal
+
+alignas(WebServer) static uint8_t g_webServerStorage[sizeof(WebServer)];
+static bool g_uploadOk = false;              // Upload in progress / finished without error
+static uint32_t g_uploadTotal = 0;           // Request size of the upload in progress
+
+// Send a page as stored: gzip-compressed, straight from flash. Browsers
+// revalidate with If-None-Match and get a 304 while the firmware is the same.
+static void sendWebPage(const uint8_t* page, size_t len, const char* etag) {
+  g_webServer->sendHeader("Cache-Control", "no-cache");
+  g_webServer->sendHeader("ETag", etag);
+  if (strcmp(g_webServer->header("If-None-Match").c_str(), etag) == 0) {
+    g_webServer->send(304);
+    return;
+  }
+  g_webServer->sendHeader("Content-Encoding", "gzip");
+  g_webServer->send_P(200, "text/html", reinterpret_cast<const char*>(page), len);
+}
+
+static bool webAuthorized() {
+  if (!g_webUsername[0] || !g_webPassword[0]) {
+    return true;
+  }
+  return g_webServer->authenticate(g_webUsername, g_webPassword);
+}
+
+static void handleUpdateUpload() {
+  if (steppedUpdateActive()) {
+    return;  // The download owns the staging area; handleUpdateDone() answers
+  }
+  HTTPUpload& upload = g_webServer->upload();
+
+  switch (upload.status) {
+    case UPLOAD_FILE_START:
+      g_uploadOk = webAuthorized();
+      if (!g_uploadOk) {
+        return;
+      }
+      Serial.printf("[OTA] Web upload: %s\n", upload.filename.c_str());
+      otaClearPendingDownload();  // Staging area is reused for the upload
+      sessionBegin();
+      g_uploadTotal = (uint32_t)g_webServer->clientContentLength();  // Includes the multipart framing
+      statsAdd(offsetof(OtaStats, updatesStarted), 1);
+      transferBegin(OTA_PROGRESS_WEB_UPLOAD, 0, g_uploadTotal);
+      if (g_onStartCallback) {
+        g_onStartCallback();
+      }
+      break;
+
+    case UPLOAD_FILE_WRITE:
+      if (g_uploadOk && !pipelineWrite(upload.buf, upload.currentSize)) {
+        g_uploadOk = false;
+        imageRestart();
+      }
+      if (g_uploadOk) {
+        g_dl.offset += (uint32_t)upload.currentSize;
+        transferProgress(g_dl.offset, g_uploadTotal);
+        progressDispatch();  // Between packets: the server reads the next one after this
+      }
+      break;
+
+    case UPLOAD_FILE_END:
+      heapSample();
+      if (g_uploadOk && !pipelineFinish()) {
+        g_uploadOk = false;
+        imageRestart();
+      }
+      if (g_uploadOk) {
+        transferProgress(g_dl.offset, g_dl.offset);
+        Serial.printf("[OTA] Web upload complete: %lu bytes\n", (unsigned long)g_dl.offset);
+      }
+      transferEnd();
+      break;
+
+    case UPLOAD_FILE_ABORTED:
+    default:
+      if (g_uploadOk) {
+        Serial.println("[OTA] Web upload aborted");
+        imageRestart();
+      }
+      transferEnd();
+      g_uploadOk = false;
+      break;
+  }
+}
+
+static void handleUpdateDone() {
+  if (!webAuthorized()) {
+    g_webServer->requestAuthentication();
+    return;
+  }
+  if (steppedUpdateActive()) {
+    g_webServer->send(503, "text/plain", "Update failed: a download is in progress");
+    return;
+  }
+  if (!g_uploadOk || !g_dl.imageOpen) {
+    g_uploadOk = false;
+    if (g_dl.imageRejected) {
+      g_webServer->send(400, "text/plain", "Update failed: not a firmware image for this board");
+    } else {
+      g_webServer->send(500, "text/plain", "Update failed");
+    }
+    statsAdd(offsetof(OtaStats, updatesFailed), 1);
+    if (g_onErrorCallback) g_onErrorCallback(g_dl.imageRejected ? OTA_UPDATE_WRONG_IMAGE : OTA_UPDATE_FAILED);
+    return;
+  }
+
+  // Expected digest from the form field or, for scripted uploads, a header
+  String digest = g_webServer->arg("sha256");
+  if (digest.length() == 0) {
+    digest = g_webServer->header("X-Firmware-SHA256");
+  }
+  if (digest.length() > 0) {
+    progressPhase(OTA_PROGRESS_VERIFY);
+    g_dl.hasExpectedSha256 = otaParseSha256Hex(digest.c_str(), g_dl.expectedSha256);
+    if (!g_dl.hasExpectedSha256 || !imageVerify()) {
+      imageRestart();
+      g_uploadOk = false;
+      g_webServer->send(400, "text/plain", "Update failed: SHA-256 mismatch");
+      statsAdd(offsetof(OtaStats, updatesFailed), 1);
+      if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_VERIFY_FAILED);
+      return;
+    }
+  }
+
+  g_webServer->send(200, "text/html", "<META http-equiv=\"refresh\" content=\"15;URL=/\">Update Success! Rebooting...");
+  progressPhase(OTA_PROGRESS_INSTALL);
+  if (g_onEndCallback) {
+    g_onEndCallback();
+  }
+  delay(100);  // Let the response go out
+  imageCommitAndReboot();
+  g_uploadOk = false;
+  statsAdd(offsetof(OtaStats, updatesFailed), 1);
+  if (g_onErrorCallback) g_onErrorCallback(OTA_UPDATE_FAILED);  // Only reached if installing failed
+}
+
+#if OTA_FEATURE_TELEMETRY
+// otaGetStats() for scrapers. JSON by default, streamed in pieces of
+// kMetricsPiece bytes; ?format=binary sends an 8-byte header ("OTAM",
+// format version, phase, bucket and counter counts) and then the OtaStats
+// words, little-endian as both platforms store them.
+static const size_t kMetricsPiece = 256;
+static const char* const kStatsPhaseNames[OTA_PHASE_COUNT] = {
+    "dns", "connect", "firstByte", "download", "flashWrite", "verify", "install", "boot", "reconnect"};
+struct StatsCounter {
+  const char* name;
+  size_t offset;
+};
+static const StatsCounter kStatsCounters[] = {
+    {"updatesStarted", offsetof(OtaStats, updatesStarted)},
+    {"updatesInstalled", offsetof(OtaStats, updatesInstalled)},
+    {"updatesFailed", offsetof(OtaStats, updatesFailed)},
+    {"bytesDownloaded", offsetof(OtaStats, bytesDownloaded)},
+    {"bytesUploaded", offsetof(OtaStats, bytesUploaded)},
+    {"bytesServed", offsetof(OtaStats, bytesServed)},
+    {"wifiDisconnects", offsetof(OtaStats, wifiDisconnects)},
+    {"reconnectAttempts", offsetof(OtaStats, reconnectAttempts)},
+};
+static const size_t kStatsCounterCount = sizeof(kStatsCounters) / sizeof(kStatsCounters[0]);
+static_assert(sizeof(OtaStats) == sizeof(OtaPhaseStats) * OTA_PHASE_COUNT + kStatsCounterCount * sizeof(uint32_t),
+              "kStatsCounters must list every OtaStats counter");
+
+struct MetricsStream {
+  char buf[kMetricsPiece];
+  size_t len = 0;
+
+  void flush() {
+    if (len) g_webServer->sendContent(buf, len);
+    len = 0;
+  }
+
+  void printf(const char* format, ...) {
+    char item[64];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(item, sizeof(item), format, args);
+    va_end(args);
+    if (n <= 0) return;
+    size_t itemLen = (size_t)n < sizeof(item) ? (size_t)n : sizeof(item) - 1;
+    if (len + itemLen > sizeof(buf)) flush();
+    memcpy(buf + len, item, itemLen);
+    len += itemLen;
+  }
+};
+
+static void handleMetrics() {
+  if (!webAuthorized()) {
+    g_webServer->requestAuthentication();
+    return;
+  }
+  OtaStats stats;
+  otaGetStats(&stats);
+  g_webServer->sendHeader("Cache-Control", "no-store");
+
+  if (g_webServer->arg("format") == "binary") {
+    uint8_t packet[8 + sizeof(stats)];
+    memcpy(packet, "OTAM", 4);
+    packet[4] = 1;
+    packet[5] = OTA_PHASE_COUNT;
+    packet[6] = OTA_STATS_BUCKETS;
+    packet[7] = (uint8_t)kStatsCounterCount;
+    memcpy(packet + 8, &stats, sizeof(stats));
+    g_webServer->send_P(200, "application/octet-stream", reinterpret_cast<const char*>(packet), sizeof(packet));
+    return;
+  }
+
+  g_webServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  g_webServer->send(200, "application/json", "");
+  MetricsStream out;
+  out.printf("{\"uptimeMs\":%lu,\"phases\":{", millis());
+  for (size_t p = 0; p < OTA_PHASE_COUNT; p++) {
+    const OtaPhaseStats& phase = stats.phases[p];
+    out.printf("%s\"%s\":{\"count\":%lu,", p ? "," : "", kStatsPhaseNames[p], (unsigned long)phase.count);
+    out.printf("\"totalMs\":%lu,\"maxMs\":%lu,\"buckets\":[", (unsigned long)phase.totalMs,
+               (unsigned long)phase.maxMs);
+    for (size_t b = 0; b < OTA_STATS_BUCKETS; b++) {
+      out.printf("%s%lu", b ? "," : "", (unsigned long)phase.buckets[b]);
+    }
+    out.printf("]}");
+  }
+  out.printf("}");
+  for (const StatsCounter& counter : kStatsCounters) {
+    uint32_t value;
+    memcpy(&value, reinterpret_cast<const uint8_t*>(&stats) + counter.offset, sizeof(value));
+    out.printf(",\"%s\":%lu", counter.name, (unsigned long)value);
+  }
+  out.printf("}");
+  out.flush();
+  g_webServer->sendContent("");  // Ends the chunked body
+}
+#endif
+
+void otaSetWebCredentials(const char* username, const char* password) {
+  if (!storeSetting(g_webUsername, sizeof(g_webUsername), username, "Web user name") ||
+      !storeSetting(g_webPassword, sizeof(g_webPassword), password, "Web password")) {
+    g_webUsername[0] = '\0';  // Never leave half of the credentials set
+    g_webPassword[0] = '\0';
+  }
+}
+
+void otaStartWebServer(uint16_t port) {
+  if (g_webServerRunning) {
+    Serial.println("[OTA] Web server already running");
+    return;
+  }
+  
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[OTA] Cannot start web server: WiFi not connected");
+    return;
+  }
+  
+  g_webServerPort = port;
+  
+  g_webServer = new (g_webServerStorage) WebServer(port);
+  
+  // Upload form and handler, with optional authentication
+  g_webServer->on("/update", HTTP_GET, []() {
+    if (!webAuthorized()) {
+      g_webServer->requestAuthentication();
+      return;
+    }
+    sendWebPage(kOtaWebUpdate, kOtaWebUpdateLen, kOtaWebUpdateEtag);
+  });
+  g_webServer->on("/update", HTTP_POST, handleUpdateDone, handleUpdateUpload);
+  const char* headerKeys[] = {"X-Firmware-SHA256", "If-None-Match", "Range", "X-OTA-Peer-Token"};
+  g_webServer->collectHeaders(headerKeys, 4);
+
+#if OTA_PEERS
+  // Running firmware for LAN peers (404 unless otaSetPeerSharing(true))
+  g_webServer->on("/ota/image", HTTP_GET, handlePeerImage);
+#endif
+  
+  // Transfer progress for scripts and dashboards
+  g_webServer->on("/status", HTTP_GET, []() {
+    if (!webAuthorized()) {
+      g_webServer->requestAuthentication();
+      return;
+    }
+    char json[288];
+    snprintf(json, sizeof(json),
+             "{\"active\":%s,\"upload\":%s,\"phase\":%d,\"bytes\":%lu,\"total\":%lu,"
+             "\"bytesPerSecond\":%lu,\"etaSeconds\":%lu,\"elapsedMs\":%lu,\"writeMs\":%lu,"
+             "\"version\":\"%s\"}",
+             g_transfer.active ? "true" : "false", g_transfer.upload ? "true" : "false", (int)g_progressPhase,
+             (unsigned long)g_transfer.bytes, (unsigned long)g_transfer.total,
+             (unsigned long)g_transfer.bytesPerSecond, (unsigned long)g_transfer.etaSeconds,
+             (unsigned long)g_transfer.elapsedMs, (unsigned long)g_transfer.writeMs, g_currentVersion);
+    g_webServer->sendHeader("Cache-Control", "no-store");
+    g_webServer->send(200, "application/json", json);
+  });
+
+#if OTA_FEATURE_TELEMETRY
+  // Telemetry (otaGetStats) as JSON, or binary with ?format=binary
+  g_webServer->on("/metrics", HTTP_GET, handleMetrics);
+#endif
+
+  // Root page with link to update (shows the address the browser used)
+  g_webServer->on("/", HTTP_GET, []() {
+    sendWebPage(kOtaWebIndex, kOtaWebIndexLen, kOtaWebIndexEtag);
+  });
+  
+  g_webServer->begin();
+  g_webServerRunning = true;
+  
+  Serial.print("[OTA] Web server started on port ");
+  Serial.println(port);
+  Serial.print("[OTA] Update URL: http://");
+  Serial.print(WiFi.localIP());
+  Serial.print(":");
+  Serial.print(port);
+  Serial.println("/update");
+  peerAdvertise();
+}
+
+void otaStopWebServer() {
+  if (!g_webServerRunning) {
+    return;
+  }
+  
+#if OTA_PEERS
+  if (g_peerSending) {
+    peerSendEnd();  // A peer download in progress goes with the server
+  }
+#endif
+  if (g_webServer) {
+    g_webServer->stop();
+    g_webServer->~WebServer();
+    g_webServer = nullptr;
+  }
+  
+  g_webServerRunning = false;
+  Serial.println("[OTA] Web server stopped");
+}
+
+bool otaIsWebServerRunning() {
+  return g_webServerRunning;
+}
+
+#endif  // OTA_FEATURE_WEB
+
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "pico_ota_internal.h"
+
+#if OTA_FEATURE_HTTP_PULL
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Background worker
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Queues (see otaWorkerBegin): commands go from the application to the
+// worker, events back; each has one producer and one consumer.
+struct OtaCommand {
+  OtaWorkerCommand type;
+  char url[OTA_MAX_URL_LEN];
+  char version[OTA_MAX_VERSION_LEN];
+};
+static const size_t kWorkerEventReserve = 2;  // Slots kept free for STARTED / DONE / ERROR
+static OtaSpscQueue<OtaCommand, 4> g_workerCommands;
+static OtaSpscQueue<OtaEvent, 16> g_workerEvents;
+static std::atomic<bool> g_workerMode{false};
+static OtaWorkerCommand g_workerCurrent = OTA_COMMAND_CHECK_GITHUB;
+
+static void workerPost(OtaEventType type, int result, uint32_t bytes, uint32_t total, const char* version) {
+  OtaEvent event;
+  memset(&event, 0, sizeof(event));
+  event.type = type;
+  event.command = g_workerCurrent;
+  event.result = result;
+  event.bytes = bytes;
+  event.total = total;
+  if (version) copyString(event.version, sizeof(event.version), version);
+  if (!g_workerEvents.push(event)) {
+    Serial.println("[OTA] Worker event queue full, event dropped");
+  }
+}
+
+// Progress events never take the reserved slots, so a slow consumer loses
+// progress updates but always sees how a request ended
+void ota_internal::workerProgress(const OtaProgress& report) {
+  if (!g_workerMode.load(std::memory_order_relaxed)) return;
+  if (g_workerEvents.space() <= kWorkerEventReserve) return;
+  OtaEvent event;
+  memset(&event, 0, sizeof(event));
+  event.type = OTA_EVENT_PROGRESS;
+  event.command = g_workerCurrent;
+  event.bytes = report.bytes;
+  event.total = report.total;
+  event.phase = report.phase;
+  event.bytesPerSecond = report.bytesPerSecond;
+  event.etaSeconds = report.etaSeconds;
+  g_workerEvents.push(event);
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void workerTask(void*) {
+  for (;;) {
+    otaWorkerLoop();
+    vTaskDelay(1);
+  }
+}
+#endif
+
+bool otaWorkerBegin() {
+  if (g_workerMode.load()) {
+    return true;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  // Core 0 (next to the WiFi stack), the Arduino loop() runs on core 1
+  if (xTaskCreatePinnedToCore(workerTask, "ota_worker", OTA_WORKER_STACK_SIZE, nullptr, 1, nullptr, 0) != pdPASS) {
+    Serial.println("[OTA] Could not start the worker task");
+    return false;
+  }
+#endif
+  // On Arduino-Pico the library cannot start core 1 itself (LittleFS
+  // writes pause the other core through the core's own setup1/loop1 hook),
+  // so the sketch calls otaWorkerLoop() from loop1()
+  g_workerMode.store(true);
+  Serial.println("[OTA] Worker mode enabled");
+  return true;
+}
+
+void otaWorkerLoop() {
+  // loop1() starts while setup() may still be configuring the library
+  if (!g_workerMode.load()) {
+    return;
+  }
+  OtaCommand command;
+  if (g_workerCommands.pop(&command)) {
+    g_workerCurrent = command.type;
+    workerPost(OTA_EVENT_STARTED, 0, 0, 0, nullptr);
+
+    int result = OTA_UPDATE_FAILED;
+    const char* version = nullptr;
+    switch (command.type) {
+#if OTA_FEATURE_GITHUB
+      case OTA_COMMAND_CHECK_GITHUB:
+        result = otaCheckGitHubUpdate(nullptr, 0);
+        version = g_latestVersion;
+        break;
+      case OTA_COMMAND_UPDATE_GITHUB:
+        result = otaUpdateFromGitHub();
+        version = g_latestVersion;
+        break;
+#else
+      case OTA_COMMAND_CHECK_GITHUB:
+      case OTA_COMMAND_UPDATE_GITHUB:
+        break;  // Not requestable without OTA_FEATURE_GITHUB
+#endif
+      case OTA_COMMAND_UPDATE_URL:
+        result = otaUpdateFromUrl(command.url, command.version[0] ? command.version : nullptr);
+        break;
+    }
+    workerPost(result < 0 ? OTA_EVENT_ERROR : OTA_EVENT_DONE, result, 0, 0, version);
+  }
+  otaLoop();
+}
+
+static bool workerRequest(OtaWorkerCommand type, const char* url, const char* version) {
+  if (!g_workerMode.load()) {
+    Serial.println("[OTA] Worker not started, call otaWorkerBegin() first");
+    return false;
+  }
+  OtaCommand command;
+  memset(&command, 0, sizeof(command));
+  command.type = type;
+  if (!storeSetting(command.url, sizeof(command.url), url, "URL") ||
+      !storeSetting(command.version, sizeof(command.version), version, "Version")) {
+    return false;
+  }
+  return g_workerCommands.push(command);
+}
+
+#if OTA_FEATURE_GITHUB
+bool otaRequestGitHubCheck() {
+  return workerRequest(OTA_COMMAND_CHECK_GITHUB, nullptr, nullptr);
+}
+
+bool otaRequestGitHubUpdate() {
+  return workerRequest(OTA_COMMAND_UPDATE_GITHUB, nullptr, nullptr);
+}
+#endif
+
+bool otaRequestUpdateFromUrl(const char* url, const char* currentVersion) {
+  if (!url || !url[0]) {
+    return false;
+  }
+  return workerRequest(OTA_COMMAND_UPDATE_URL, url, currentVersion);
+}
+
+bool otaPollEvent(OtaEvent* event) {
+  return event && g_workerEvents.pop(event);
+}
+#endif  // OTA_FEATURE_HTTP_PULL
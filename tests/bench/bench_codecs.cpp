@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Decoder throughput on its own, without the network or flash around it:
+// output bytes per second of the LZSS decoder on an image compressed by
+// extras/ota_compress.py.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "extras.h"
+#include "images.h"
+#include "ota_lzss.h"
+
+namespace {
+
+bool discard(const uint8_t*, size_t, void*) { return true; }
+
+// (image, compressed) for -w windowBits -l 4; empty without Python
+const std::pair<std::string, std::string>& compressedImage(int windowBits) {
+  static std::pair<std::string, std::string> cache[OTA_LZSS_MAX_WINDOW_BITS + 1];
+  std::pair<std::string, std::string>& entry = cache[windowBits];
+  if (entry.first.empty() && extras::available()) {
+    entry.first = images::codeLike(256 * 1024);
+    extras::ScratchDir dir;
+    if (extras::run("ota_compress.py", {"compress", dir.write("in.bin", entry.first), dir.path("out.otaz"),
+                                        "-w", std::to_string(windowBits), "-l", "4"}) == 0) {
+      entry.second = dir.read("out.otaz");
+    }
+  }
+  return entry;
+}
+
+void BM_LzssDecode(benchmark::State& state) {
+  const auto& image = compressedImage((int)state.range(0));
+  if (image.second.empty()) {
+    state.SkipWithError("extras/ota_compress.py did not run");
+    return;
+  }
+  const uint8_t* blob = reinterpret_cast<const uint8_t*>(image.second.data());
+  static OtaLzssDecoder decoder;  // Window buffer as on the device: static, not on the stack
+  for (auto _ : state) {
+    decoder.begin(discard, nullptr);
+    // Network-sized pieces, as the download loop hands them over
+    for (size_t pos = 0; pos < image.second.size(); pos += 1024) {
+      size_t len = image.second.size() - pos < 1024 ? image.second.size() - pos : 1024;
+      decoder.feed(blob + pos, len);
+    }
+    if (!decoder.finish()) state.SkipWithError("decode failed");
+  }
+  state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)image.first.size());
+  state.counters["ratio"] = (double)image.second.size() / (double)image.first.size();
+}
+BENCHMARK(BM_LzssDecode)->Arg(8)->Arg(OTA_LZSS_MAX_WINDOW_BITS)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
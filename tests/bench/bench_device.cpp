@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Whole-library benchmarks on the simulated board (real clock): download
+// throughput through the pipeline into LittleFS, how long one otaLoop()
+// holds the sketch during a time-sliced update, and the heap the library
+// takes while an update runs. Browser upload throughput is timed on the
+// virtual clock against a flash cost model, per image write buffering.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "device.h"
+#include "images.h"
+
+namespace {
+
+const char* kUrl = "http://updates.local/fw.bin";
+
+// Fresh board with an image on the server, the sketch set up
+void prepare(images::FileServer& server, size_t size) {
+  device::powerOn();
+  mock::clock().real = true;
+  server.files.clear();
+  server.add("/fw.bin", images::rp2040(size));
+  mock::onHttp(std::ref(server));
+  device::setup();
+}
+
+void BM_UrlUpdateThroughput(benchmark::State& state) {
+  images::FileServer server;
+  size_t size = (size_t)state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    prepare(server, size);
+    state.ResumeTiming();
+    bool rebooted = device::run([] { otaUpdateFromUrl(kUrl); });
+    if (!rebooted) state.SkipWithError("update did not install");
+  }
+  state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)size);
+}
+BENCHMARK(BM_UrlUpdateThroughput)->Arg(64 * 1024)->Arg(512 * 1024)->Unit(benchmark::kMillisecond);
+
+// Time of each otaLoop() call while otaBeginUpdate() downloads; the
+// counters are the worst call and the 99th percentile in microseconds
+void BM_OtaLoopLatency(benchmark::State& state) {
+  images::FileServer server;
+  std::vector<double> callsUs;
+  for (auto _ : state) {
+    state.PauseTiming();
+    prepare(server, 512 * 1024);
+    otaSetUpdateStepBudget((uint32_t)state.range(0));
+    otaBeginUpdate(kUrl, "", nullptr);
+    state.ResumeTiming();
+    device::run([&] {
+      while (otaGetUpdateResult() == OTA_UPDATE_IN_PROGRESS) {
+        uint64_t startUs = mock::nowUs();
+        otaLoop();
+        callsUs.push_back((double)(mock::nowUs() - startUs));
+      }
+    });
+  }
+  if (callsUs.empty()) return;
+  std::sort(callsUs.begin(), callsUs.end());
+  state.counters["calls"] = (double)callsUs.size();
+  state.counters["p99_us"] = callsUs[callsUs.size() * 99 / 100];
+  state.counters["max_us"] = callsUs.back();
+}
+BENCHMARK(BM_OtaLoopLatency)->Arg(2000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Most heap the library holds during an update, over what it held before:
+// it works from static buffers, so this stays at a few short Strings
+void BM_UpdatePeakHeap(benchmark::State& state) {
+  images::FileServer server;
+  long peak = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    prepare(server, 256 * 1024);
+    long base = device::heapInUse();
+    device::resetHeapPeak();
+    state.ResumeTiming();
+    device::run([] { otaUpdateFromUrl(kUrl); });
+    peak = std::max(peak, device::heapPeak() - base);
+  }
+  state.counters["peak_heap_bytes"] = (double)peak;
+}
+BENCHMARK(BM_UpdatePeakHeap)->Unit(benchmark::kMillisecond);
+
+// A browser upload of 256 KiB into the library built with
+// OTA_IMAGE_WRITE_BUFFERS x OTA_IMAGE_WRITE_BLOCK (tests/CMakeLists.txt).
+// Flash costs virtual time per KiB and per write() call, so the time is
+// what the buffering saves on the board; flash_writes counts the calls.
+void BM_WebUploadThroughput(benchmark::State& state) {
+  std::string module = std::string(OTA_DEVICE_VARIANTS) + "/pico_ota_device_" + std::to_string(state.range(0)) +
+                       "x" + std::to_string(state.range(1)) + ".so";
+  std::string image = images::rp2040(256 * 1024);
+  mock::WebRequest upload;
+  upload.method = HTTP_POST;
+  upload.uri = "/update";
+  upload.filename = "fw.bin";
+  for (size_t pos = 0; pos < image.size(); pos += HTTP_UPLOAD_BUFLEN) {
+    upload.upload.push_back(image.substr(pos, HTTP_UPLOAD_BUFLEN));
+  }
+  size_t writes = 0;
+  for (auto _ : state) {
+    device::powerOn(module.c_str());
+    mock::fs().usPerKiB = 2000;  // About 500 KiB/s programming a sector
+    mock::fs().usPerWrite = 400;
+    device::setup();
+    otaStartWebServer(80);
+    auto request = mock::webRequest(upload);
+    size_t writesBefore = mock::fs().writes;
+    uint64_t startUs = mock::nowUs();
+    device::loopUntil([&] { return request->handled; }, 60000);
+    state.SetIterationTime((double)(mock::nowUs() - startUs) / 1e6);
+    writes = mock::fs().writes - writesBefore;
+    if (!device::rebooted() || mock::runningImage() != image) state.SkipWithError("upload did not install");
+  }
+  state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)image.size());
+  state.counters["flash_writes"] = (double)writes;
+}
+BENCHMARK(BM_WebUploadThroughput)
+    ->ArgNames({"buffers", "block"})
+    ->Args({1, 4096})
+    ->Args({2, 1024})
+    ->Args({2, 4096})
+    ->Args({2, 16384})
+    ->Args({4, 4096})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
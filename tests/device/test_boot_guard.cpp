@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Boot guard: an update boots pending, is kept once it confirms itself,
+// restarted when it does not in time, and rolled back after too many
+// boots; and the LittleFS space rollback needs on Pico is reported up front
+
+#include "device_test.h"
+#include "images.h"
+
+namespace {
+
+const char* kUrl = "http://updates.local/fw.bin";
+
+class BootGuardTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    original = images::rp2040(64 * 1024, 5);
+    update = images::rp2040(80 * 1024, 6);
+    mock::setRunningImage(original);
+    server.add("/fw.bin", update);
+    mock::onHttp(std::ref(server));
+    boot();
+  }
+
+  // setup() of every firmware version: the guard first
+  void boot() {
+    otaSetBootGuard(3, 120000);
+    device::setup();
+  }
+
+  // Install the update (digest known up front) and boot it
+  void installUpdate() {
+    std::string sha256 = images::sha256Hex(update);
+    ASSERT_TRUE(device::run([&] { otaUpdateFromUrl(kUrl, nullptr, sha256.c_str()); }));
+    ASSERT_EQ(mock::runningImage(), update);
+    mock::clearSerialLog();
+    boot();
+  }
+
+  // A boot of the update that never confirms: otaLoop() restarts it
+  bool timeOut() {
+    device::loopUntil([] { return false; }, 130000);
+    if (!device::rebooted()) return false;
+    mock::clearSerialLog();
+    return !device::run([&] { boot(); });  // The fourth boot rolls back instead
+  }
+
+  images::FileServer server;
+  std::string original;
+  std::string update;
+};
+
+TEST_F(BootGuardTest, UpdateBootsPending) {
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_NORMAL);
+  EXPECT_FALSE(mock::logged("Rollback unavailable"));
+
+  installUpdate();
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_PENDING);
+  EXPECT_TRUE(mock::logged("boot 1 of 3"));
+  EXPECT_EQ(mock::fsRead("ota_previous.bin"), original);
+}
+
+TEST_F(BootGuardTest, ConfirmedUpdateIsKept) {
+  installUpdate();
+  otaMarkAppValid();
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_NORMAL);
+  EXPECT_FALSE(mock::fsExists("ota_previous.bin"));
+
+  // Past the window and on the next boots, nothing happens
+  EXPECT_FALSE(device::loopUntil([] { return false; }, 130000));
+  EXPECT_FALSE(device::rebooted());
+  device::reboot();
+  boot();
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_NORMAL);
+  EXPECT_EQ(mock::runningImage(), update);
+}
+
+TEST_F(BootGuardTest, UnconfirmedBootIsRestartedAfterTheWindow) {
+  installUpdate();
+  device::loopUntil([] { return false; }, 110000);
+  EXPECT_FALSE(device::rebooted());
+
+  device::loopUntil([] { return false; }, 20000);
+  EXPECT_TRUE(device::rebooted());
+  EXPECT_TRUE(mock::logged("not marked valid in time"));
+  mock::clearSerialLog();
+  boot();
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_PENDING);
+  EXPECT_TRUE(mock::logged("boot 2 of 3"));
+}
+
+TEST_F(BootGuardTest, RollbackAfterTooManyBoots) {
+  installUpdate();
+  EXPECT_TRUE(timeOut());  // Boot 2
+  EXPECT_TRUE(timeOut());  // Boot 3
+  EXPECT_FALSE(timeOut());  // Boot 4 rolls back and reboots
+  EXPECT_TRUE(mock::logged("rolling back"));
+  EXPECT_EQ(mock::runningImage(), original);
+
+  mock::clearSerialLog();
+  boot();
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_ROLLED_BACK);
+  EXPECT_TRUE(mock::logged("last update was rolled back"));
+  EXPECT_FALSE(mock::fsExists("ota_previous.bin"));
+
+  // The same image is not installed again once its digest is known
+  int result = OTA_UPDATE_OK;
+  std::string sha256 = images::sha256Hex(update);
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl, nullptr, sha256.c_str()); }));
+  EXPECT_EQ(result, OTA_UPDATE_NO_UPDATE);
+}
+
+// 1 MB sketch area and 1 MB LittleFS with an 800 KB sketch: the copy of the
+// running firmware and the new image do not both fit
+TEST(BootGuardSpace, RollbackUnavailableIsReportedAtStartup) {
+  device::powerOn();
+  std::string original = images::rp2040(800 * 1024, 5);
+  std::string update = images::rp2040(760 * 1024, 6);
+  mock::setRunningImage(original);
+  images::FileServer server;
+  server.add("/fw.bin", update);
+  mock::onHttp(std::ref(server));
+
+  otaSetBootGuard(3, 120000);
+  EXPECT_TRUE(mock::logged("Rollback unavailable: LittleFS has "));
+  EXPECT_TRUE(mock::logged("free of 1024 KB, an update needs about 1608 KB (the 800 KB running firmware"));
+  device::setup();
+
+  // The update still installs, without a fallback
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl(kUrl); }));
+  EXPECT_TRUE(mock::logged("Rollback unavailable: keeping the running firmware needs 808 KB of LittleFS"));
+  EXPECT_EQ(mock::runningImage(), update);
+  otaSetBootGuard(3, 120000);
+  EXPECT_EQ(otaGetBootStatus(), OTA_BOOT_NORMAL);
+}
+
+}  // namespace
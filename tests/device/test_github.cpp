@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Release checks against a stand-in for the GitHub API: the release found,
+// the cached copy reused on 304, and the waits a rate limit asks for
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "device_test.h"
+#include "fixtures.h"
+#include "images.h"
+
+namespace {
+
+const char* kAsset = "/wedsamuel1230/PICO_OTA/releases/download/v1.4.0/firmware-picow.bin";
+const char* kLatest = "/repos/wedsamuel1230/PICO_OTA/releases/latest";
+
+class GitHubTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    SetUpFirmware();
+    release = fixtures::read("releases/typical.json");
+    api = [this](const mock::HttpRequest& request) { return latestRelease(request); };
+    mock::onHttp([this](const mock::HttpRequest& request) {
+      mock::HttpResponse response;
+      if (request.host == "api.github.com" && request.path == kLatest) {
+        return api(request);
+      } else if (request.host == "github.com") {
+        return files(request);
+      } else {
+        response.code = 404;
+      }
+      return response;
+    });
+  }
+
+  // setup() of the sketch, on every boot
+  void SetUpFirmware() {
+    device::setup();
+    otaSetGitHubRepo("wedsamuel1230", "PICO_OTA");
+    otaSetGitHubAssetName("firmware-picow.bin");
+    otaSetCurrentVersion("1.3.0");
+  }
+
+  // The release, with its ETag when one is set: 304 when it matches
+  mock::HttpResponse latestRelease(const mock::HttpRequest& request) {
+    mock::HttpResponse response;
+    if (!etag.empty()) {
+      response.headers["ETag"] = etag;
+      if (request.header("if-none-match") == etag) {
+        response.code = 304;
+        return response;
+      }
+    }
+    response.body = release;
+    return response;
+  }
+
+  // Requests to the releases API so far
+  std::vector<mock::HttpRequest> apiRequests() const {
+    std::vector<mock::HttpRequest> found;
+    for (const mock::HttpRequest& request : mock::net().requests) {
+      if (request.host == "api.github.com") found.push_back(request);
+    }
+    return found;
+  }
+
+  std::string release;
+  std::string etag;
+  std::function<mock::HttpResponse(const mock::HttpRequest&)> api;  // The releases/latest endpoint
+  images::FileServer files;  // Release assets
+};
+
+TEST_F(GitHubTest, NewerReleaseIsReported) {
+  char latest[16] = "";
+  EXPECT_EQ(otaCheckGitHubUpdate(latest, sizeof(latest)), OTA_UPDATE_OK);
+  EXPECT_STREQ(latest, "1.4.0");
+}
+
+// HTTPClient::begin() refusing the request leaves no half-set-up
+// connection behind, and the next check or download works
+TEST_F(GitHubTest, RequestThatCannotStartFailsAndCloses) {
+  mock::net().failBegin = true;
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_HTTP_ERROR);
+  EXPECT_TRUE(mock::logged("GitHub API request could not be started"));
+  EXPECT_TRUE(mock::net().requests.empty());
+  ASSERT_FALSE(mock::net().sockets.empty());
+  for (const auto& socket : mock::net().sockets) EXPECT_FALSE(socket->open);
+
+  mock::net().failBegin = false;
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+
+  // The same for the image download, after the API connection was kept alive
+  std::string image = images::rp2040(32 * 1024);
+  files.add(kAsset, image);
+  std::string url = std::string("https://github.com") + kAsset;
+  size_t before = mock::net().sockets.size();
+  mock::net().failBegin = true;
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(url.c_str()); }));
+  EXPECT_EQ(result, OTA_UPDATE_FAILED);
+  ASSERT_GT(mock::net().sockets.size(), before);
+  for (const auto& socket : mock::net().sockets) EXPECT_FALSE(socket->open);
+
+  mock::net().failBegin = false;
+  EXPECT_TRUE(device::run([&] { otaUpdateFromUrl(url.c_str()); }));
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+// The .sha256 asset is a sha256sum line; its digest (not the file name
+// after it) is what the download is checked against
+TEST_F(GitHubTest, UpdateIsCheckedAgainstTheSha256Asset) {
+  std::string image = images::rp2040(32 * 1024);
+  files.add(kAsset, image);
+  files.add(std::string(kAsset) + ".sha256", images::sha256Hex(image) + "  firmware-picow.bin\n");
+
+  EXPECT_TRUE(device::run([] { otaUpdateFromGitHub(); }));
+  EXPECT_TRUE(mock::logged("Using SHA-256 from release"));
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+TEST_F(GitHubTest, ImageNotMatchingTheSha256AssetIsNotInstalled) {
+  std::string image = images::rp2040(32 * 1024);
+  files.add(kAsset, image);
+  files.add(std::string(kAsset) + ".sha256", images::sha256Hex(image + "x") + "  firmware-picow.bin\n");
+  std::string running = mock::runningImage();
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromGitHub(); }));
+  EXPECT_EQ(result, OTA_UPDATE_VERIFY_FAILED);
+  EXPECT_EQ(mock::runningImage(), running);
+}
+
+// The delta asset is missing, the full image does not match its digest:
+// both downloads belong to one update, which failed once
+TEST_F(GitHubTest, DeltaFallbackIsOneUpdate) {
+  otaSetDeltaUpdates(true);
+  std::string image = images::rp2040(32 * 1024);
+  files.add(kAsset, image);
+  files.add(std::string(kAsset) + ".sha256", images::sha256Hex(image + "x") + "  firmware-picow.bin\n");
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromGitHub(); }));
+  EXPECT_EQ(result, OTA_UPDATE_VERIFY_FAILED);
+  EXPECT_TRUE(mock::logged("Delta update failed, falling back to the full image"));
+  OtaStats stats;
+  otaGetStats(&stats);
+  EXPECT_EQ(stats.updatesStarted, 1u);
+  EXPECT_EQ(stats.updatesFailed, 1u);
+}
+
+// ━━━ Release cache and rate limits ━━━
+
+TEST_F(GitHubTest, UnchangedReleaseComesFromTheCacheOn304) {
+  etag = "W/\"4f1c-v1.4.0\"";
+  ASSERT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+  ASSERT_EQ(apiRequests().size(), 1u);
+  EXPECT_EQ(apiRequests()[0].header("if-none-match"), "");
+
+  release = "{ not sent again }";
+  char latest[16] = "";
+  EXPECT_EQ(otaCheckGitHubUpdate(latest, sizeof(latest)), OTA_UPDATE_OK);
+  ASSERT_EQ(apiRequests().size(), 2u);
+  EXPECT_EQ(apiRequests()[1].header("if-none-match"), etag);
+  EXPECT_TRUE(mock::logged("GitHub release unchanged (304), using cached metadata"));
+  EXPECT_STREQ(latest, "1.4.0");
+
+  // The cached asset URL is what gets downloaded
+  std::string image = images::rp2040(32 * 1024);
+  files.add(kAsset, image);
+  EXPECT_TRUE(device::run([] { otaUpdateFromGitHub(); }));
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+TEST_F(GitHubTest, CacheIsKeptInLittleFsAcrossAReboot) {
+  etag = "\"v1.4.0\"";
+  ASSERT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+  EXPECT_TRUE(mock::fsExists("ota_release.bin"));
+
+  device::reboot();
+  SetUpFirmware();
+  mock::clearSerialLog();
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+  EXPECT_EQ(apiRequests().back().header("if-none-match"), etag);
+  EXPECT_TRUE(mock::logged("unchanged (304)"));
+  EXPECT_STREQ(otaGetLatestGitHubVersion(), "1.4.0");
+}
+
+// No request goes out until the wait is over
+TEST_F(GitHubTest, RetryAfterIsWaitedOut) {
+  api = [this](const mock::HttpRequest& request) {
+    mock::HttpResponse response;
+    if (apiRequests().size() > 1) return latestRelease(request);
+    response.code = 429;
+    response.headers["Retry-After"] = "30";
+    return response;
+  };
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_RATE_LIMITED);
+  EXPECT_EQ(otaGetGitHubRetryDelay(), 30u);
+
+  delay(20000);
+  EXPECT_EQ(otaGetGitHubRetryDelay(), 10u);
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_RATE_LIMITED);
+  EXPECT_EQ(otaUpdateFromGitHub(), OTA_UPDATE_RATE_LIMITED);
+  EXPECT_EQ(apiRequests().size(), 1u);
+
+  delay(10000);
+  EXPECT_EQ(otaGetGitHubRetryDelay(), 0u);
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+  EXPECT_EQ(apiRequests().size(), 2u);
+}
+
+// The primary limit: 403 with no requests left until X-RateLimit-Reset,
+// timed against the server's Date
+TEST_F(GitHubTest, ExhaustedRateLimitWaitsUntilTheReset) {
+  api = [](const mock::HttpRequest&) {
+    mock::HttpResponse response;
+    response.code = 403;
+    response.headers["X-RateLimit-Remaining"] = "0";
+    response.headers["X-RateLimit-Reset"] = "1792152120";  // Two minutes after Date
+    response.headers["Date"] = "Fri, 16 Oct 2026 12:00:00 GMT";
+    return response;
+  };
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_RATE_LIMITED);
+  EXPECT_EQ(otaGetGitHubRetryDelay(), 120u);
+  EXPECT_TRUE(mock::logged("backing off for 120 s"));
+}
+
+// The last request of the window still answers; the next check waits
+TEST_F(GitHubTest, LastRequestOfTheWindowStillAnswers) {
+  api = [this](const mock::HttpRequest& request) {
+    mock::HttpResponse response = latestRelease(request);
+    response.headers["X-RateLimit-Remaining"] = "0";
+    return response;
+  };
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_OK);
+  EXPECT_EQ(otaGetGitHubRetryDelay(), 60u);  // No usable reset time: the default minute
+  EXPECT_EQ(otaCheckGitHubUpdate(nullptr, 0), OTA_UPDATE_RATE_LIMITED);
+  EXPECT_EQ(apiRequests().size(), 1u);
+}
+
+}  // namespace
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Text longer than its fixed buffer is refused with a message naming the
+// limit, never cut short and used
+
+#include "device_test.h"
+#include "images.h"
+
+namespace {
+
+class LimitsTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    mock::onHttp(std::ref(server));
+  }
+
+  images::FileServer server;
+};
+
+TEST_F(LimitsTest, MinimumVersionTooLongIsRefused) {
+  std::string version = "1.0.0-" + std::string(OTA_MAX_VERSION_LEN, 'a');
+  otaSetMinimumVersion(version.c_str());
+  EXPECT_TRUE(mock::logged("Minimum version too long (max " + std::to_string(OTA_MAX_VERSION_LEN - 1)));
+
+  // No bound was set, so an older release still installs
+  std::string image = images::rp2040(8 * 1024);
+  server.add("/fw.bin", image);
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl("http://updates.local/fw.bin"); }));
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+// Longer than the 64 characters host buffers used to have
+TEST_F(LimitsTest, LongServerNameWorks) {
+  std::string host = "github-production-release-asset-2e65be.s3.eu-central-1.amazonaws.com";
+  ASSERT_GT(host.size() + 4, 64u);
+  std::string image = images::rp2040(8 * 1024);
+  server.add("/fw.bin", image);
+  std::string url = "http://" + host + ":8080/fw.bin";
+
+  EXPECT_TRUE(device::run([&] { otaUpdateFromUrl(url.c_str()); }));
+  EXPECT_EQ(mock::runningImage(), image);
+  EXPECT_EQ(mock::net().requests.back().host, host);
+}
+
+TEST_F(LimitsTest, ServerNameTooLongIsRefusedBeforeConnecting) {
+  std::string url = "http://" + std::string(OTA_MAX_HOST_LEN, 'h') + ".example/fw.bin";
+  ASSERT_LT(url.size(), (size_t)OTA_MAX_URL_LEN);
+  server.add("/fw.bin", images::rp2040(8 * 1024));
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(url.c_str()); }));
+  EXPECT_LT(result, 0);
+  EXPECT_TRUE(mock::logged("Host name too long"));
+  EXPECT_EQ(mock::net().connects, 0u);
+}
+
+}  // namespace
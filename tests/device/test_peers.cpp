@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// LAN peer sharing: who may fetch the running image from /ota/image, that
+// it goes out a slice per otaLoop(), and a signed pull that takes the image
+// from a peer and only the manifest from the server
+
+#include "device_test.h"
+#include "extras.h"
+#include "images.h"
+
+namespace {
+
+const char* kToken = "site-7f3a";
+
+class PeerServeTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    running = images::rp2040(96 * 1024, 7);
+    mock::setRunningImage(running);
+    device::setup();
+    otaStartWebServer(80);
+    otaSetPeerSharing(true);
+  }
+
+  // The running image is hashed over several passes, then announced
+  void waitUntilShared() {
+    ASSERT_TRUE(device::loopUntil([] { return !mock::mdns().services.empty(); }, 5000));
+  }
+
+  mock::WebRequest imageRequest(const std::string& token = kToken) {
+    mock::WebRequest request;
+    request.uri = "/ota/image";
+    request.args["sha256"] = images::sha256Hex(running);
+    request.args["size"] = std::to_string(running.size());
+    if (!token.empty()) request.headers["x-ota-peer-token"] = token;
+    return request;
+  }
+
+  std::string running;
+};
+
+TEST_F(PeerServeTest, ImageGoesOutASlicePerLoop) {
+  otaSetPeerToken(kToken);
+  waitUntilShared();
+
+  auto request = mock::webRequest(imageRequest());
+  device::run([] { otaLoop(); });
+  EXPECT_EQ(request->code, 200);
+  EXPECT_EQ(request->responseHeaders["Content-Length"], std::to_string(running.size()));
+  EXPECT_EQ(request->body().size(), 4096u);
+  EXPECT_FALSE(request->closed());
+
+  EXPECT_TRUE(device::loopUntil([&] { return request->closed(); }, 5000));
+  EXPECT_EQ(request->body(), running);
+}
+
+TEST_F(PeerServeTest, RangeIsServed) {
+  otaSetPeerToken(kToken);
+  waitUntilShared();
+
+  mock::WebRequest range = imageRequest();
+  range.headers["range"] = "bytes=1000-";
+  auto request = mock::webRequest(range);
+  EXPECT_TRUE(device::loopUntil([&] { return request->closed(); }, 5000));
+  EXPECT_EQ(request->code, 206);
+  EXPECT_EQ(request->body(), running.substr(1000));
+}
+
+TEST_F(PeerServeTest, WrongTokenIsRefused) {
+  otaSetPeerToken(kToken);
+  waitUntilShared();
+
+  auto wrong = mock::webRequest(imageRequest("site-7f3b"));
+  auto missing = mock::webRequest(imageRequest(""));
+  device::loopUntil([&] { return missing->handled; }, 1000);
+  EXPECT_EQ(wrong->code, 401);
+  EXPECT_EQ(missing->code, 401);
+  EXPECT_TRUE(wrong->body().empty());
+}
+
+TEST_F(PeerServeTest, WebCredentialsAreAccepted) {
+  otaSetWebCredentials("admin", "secret");
+  waitUntilShared();
+
+  mock::WebRequest withCredentials = imageRequest("");
+  withCredentials.user = "admin";
+  withCredentials.password = "secret";
+  auto request = mock::webRequest(withCredentials);
+  EXPECT_TRUE(device::loopUntil([&] { return request->closed(); }, 5000));
+  EXPECT_EQ(request->code, 200);
+  EXPECT_EQ(request->body(), running);
+}
+
+TEST_F(PeerServeTest, NothingIsServedWithoutTokenOrCredentials) {
+  waitUntilShared();
+
+  auto request = mock::webRequest(imageRequest(""));
+  device::loopUntil([&] { return request->handled; }, 1000);
+  EXPECT_EQ(request->code, 403);
+  EXPECT_TRUE(mock::logged("Not serving LAN peers"));
+}
+
+// Only the digest hashed at boot is compared; a request never starts a hash
+TEST_F(PeerServeTest, OtherImagesAreNotFound) {
+  otaSetPeerToken(kToken);
+  auto early = mock::webRequest(imageRequest());
+  device::run([] { otaLoop(); });
+  EXPECT_EQ(early->code, 404);  // Not hashed yet
+
+  waitUntilShared();
+  mock::WebRequest other = imageRequest();
+  other.args["sha256"] = images::sha256Hex(running + "x");
+  auto otherDigest = mock::webRequest(other);
+  mock::WebRequest shorter = imageRequest();
+  shorter.args["size"] = std::to_string(running.size() - 1);
+  auto otherSize = mock::webRequest(shorter);
+  device::loopUntil([&] { return otherSize->handled; }, 1000);
+  EXPECT_EQ(otherDigest->code, 404);
+  EXPECT_EQ(otherSize->code, 404);
+}
+
+TEST_F(PeerServeTest, OnePeerAtATime) {
+  otaSetPeerToken(kToken);
+  waitUntilShared();
+
+  auto first = mock::webRequest(imageRequest());
+  auto second = mock::webRequest(imageRequest());
+  device::loopUntil([&] { return second->handled; }, 1000);
+  EXPECT_EQ(first->code, 200);
+  EXPECT_EQ(second->code, 503);
+  EXPECT_TRUE(device::loopUntil([&] { return first->closed(); }, 5000));
+  EXPECT_EQ(first->body(), running);
+}
+
+// ━━━ Fetching from a peer ━━━
+
+// RFC 8032 TEST 1 key pair
+const char* kSecretKey = "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60";
+const uint8_t kPublicKey[32] = {0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe,
+                                0xd3, 0xc9, 0x64, 0x07, 0x3a, 0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6,
+                                0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a};
+
+TEST(PeerFetchTest, SignedUpdateComesFromAPeerWithTheToken) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+  device::powerOn();
+
+  std::string image = images::rp2040(64 * 1024, 3);
+  extras::ScratchDir dir;
+  ASSERT_EQ(extras::run("ota_sign.py", {"sign", dir.write("signing.key", kSecretKey), dir.write("fw.bin", image),
+                                        "--version", "1.4.0", "-o", dir.path("fw.bin.manifest")}),
+            0);
+  images::FileServer server;
+  server.add("/fw.bin", image);
+  server.add("/fw.bin.manifest", dir.read("fw.bin.manifest"));
+  images::FileServer peer;
+  peer.add("/ota/image", image);
+  mock::onHttp([&](const mock::HttpRequest& request) {
+    if (request.host != "192.168.1.77") return server(request);
+    if (request.header("x-ota-peer-token") != kToken) {
+      mock::HttpResponse refused;
+      refused.code = 401;
+      return refused;
+    }
+    return peer(request);
+  });
+  mock::mdns().peers.push_back({IPAddress(192, 168, 1, 77), 80});
+
+  device::setup();
+  otaSetSigningKey(kPublicKey);
+  otaSetPeerSharing(true);
+  otaSetPeerToken(kToken);
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl("http://updates.local/fw.bin", "1.0.0"); }));
+  EXPECT_EQ(mock::runningImage(), image);
+  EXPECT_TRUE(mock::logged("Image received from peer 192.168.1.77"));
+  for (const mock::HttpRequest& request : mock::net().requests) {
+    EXPECT_NE(request.path, "/fw.bin") << "image fetched from the server";
+  }
+}
+
+}  // namespace
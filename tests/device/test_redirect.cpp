@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Redirects to signed CDN links, whose query strings run far past the
+// length of a configured URL
+
+#include <cstring>
+
+#include "device_test.h"
+#include "images.h"
+
+namespace {
+
+const char* kUrl = "http://updates.local/fw.bin";
+
+class RedirectTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    mock::onHttp([this](const mock::HttpRequest& request) {
+      if (request.host == "updates.local") {
+        mock::HttpResponse response;
+        response.code = 302;
+        response.headers["Location"] = location;
+        return response;
+      }
+      return cdn(request);
+    });
+  }
+
+  // Like the links release hosts hand out: a signature and credentials in the query
+  static std::string signedLink(size_t length) {
+    std::string link = "https://cdn.example.com/fw.bin?X-Amz-Signature=";
+    while (link.size() < length) link += static_cast<char>('a' + link.size() % 26);
+    return link;
+  }
+
+  images::FileServer cdn;
+  std::string location;
+};
+
+TEST_F(RedirectTest, LongSignedLinkIsFollowed) {
+  std::string image = images::rp2040(32 * 1024);
+  cdn.add("/fw.bin", image);
+  location = signedLink(700);
+  ASSERT_GT(location.size(), (size_t)OTA_MAX_URL_LEN);
+
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(mock::runningImage(), image);
+  bool fetched = false;
+  for (const mock::HttpRequest& request : mock::net().requests) {
+    if (request.host == "cdn.example.com" && request.path == location.substr(strlen("https://cdn.example.com"))) {
+      fetched = true;
+    }
+  }
+  EXPECT_TRUE(fetched);
+}
+
+TEST_F(RedirectTest, LinkPastTheRedirectBufferFailsCleanly) {
+  cdn.add("/fw.bin", images::rp2040(8 * 1024));
+  location = signedLink(OTA_MAX_REDIRECT_URL_LEN + 10);
+  std::string running = mock::runningImage();
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl); }));
+  EXPECT_NE(result, OTA_UPDATE_OK);
+  EXPECT_TRUE(mock::logged("Redirect URL too long"));
+  EXPECT_EQ(mock::runningImage(), running);
+  EXPECT_EQ(mock::fs().bytesWritten, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Telemetry counters: an update call counts as one update started, however
+// many retries, resumes and sources it goes through, and as one failure
+// when it fails; a signed manifest offering nothing is not counted
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "device_test.h"
+#include "extras.h"
+#include "images.h"
+
+namespace {
+
+const char* kUrl = "http://updates.local/fw.bin";
+
+class StatsTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    image = images::rp2040(64 * 1024);
+    server.add("/fw.bin", image);
+    // Source probes are answered; each host cuts the first download off
+    // after 5000 bytes and answers 503 to the resumes after it
+    mock::onHttp([this](const mock::HttpRequest& request) {
+      mock::HttpResponse response = server(request);
+      if (request.header("range") == "bytes=0-8191") return response;
+      if (downloads[request.host]++ == 0) {
+        response.dropAfter = 5000;
+      } else {
+        response = mock::HttpResponse();
+        response.code = 503;
+      }
+      return response;
+    });
+    otaSetDownloadRetries(3);
+  }
+
+  OtaStats counters() {
+    OtaStats stats;
+    otaGetStats(&stats);
+    return stats;
+  }
+
+  images::FileServer server;
+  std::string image;
+  std::map<std::string, int> downloads;  // Per host
+};
+
+TEST_F(StatsTest, ResumedDownloadIsOneUpdate) {
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(result, OTA_UPDATE_FAILED);
+  EXPECT_GT(mock::net().requests.size(), 2u);
+  EXPECT_EQ(counters().updatesStarted, 1u);
+  EXPECT_EQ(counters().updatesFailed, 1u);
+
+  // Trying again is a second update
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(counters().updatesStarted, 2u);
+  EXPECT_EQ(counters().updatesFailed, 2u);
+}
+
+TEST_F(StatsTest, SourceFailoverIsOneUpdate) {
+  otaAddUpdateSource(kUrl);
+  otaAddUpdateSource("http://mirror.local/fw.bin");
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromSources(); }));
+  EXPECT_EQ(result, OTA_UPDATE_FAILED);
+  bool mirrorUsed = false;
+  for (const mock::HttpRequest& request : mock::net().requests) {
+    if (request.host == "mirror.local" && request.header("range").rfind("bytes=0-", 0) != 0) mirrorUsed = true;
+  }
+  EXPECT_TRUE(mirrorUsed);
+  EXPECT_EQ(counters().updatesStarted, 1u);
+  EXPECT_EQ(counters().updatesFailed, 1u);
+}
+
+TEST_F(StatsTest, TimeSlicedUpdateIsOneUpdate) {
+  ASSERT_TRUE(otaBeginUpdate(kUrl, "", ""));
+  EXPECT_FALSE(device::run([] { otaUpdateStep(0); }));
+  EXPECT_EQ(otaGetUpdateResult(), OTA_UPDATE_FAILED);
+  EXPECT_EQ(counters().updatesStarted, 1u);
+  EXPECT_EQ(counters().updatesFailed, 1u);
+
+  // Cancelled before its first step: nothing was started
+  ASSERT_TRUE(otaBeginUpdate(kUrl, "", ""));
+  otaCancelUpdate();
+  EXPECT_EQ(counters().updatesStarted, 1u);
+
+  // Cancelled during the transfer: started and failed
+  ASSERT_TRUE(otaBeginUpdate(kUrl, "", ""));
+  EXPECT_EQ(otaUpdateStep(1000), OTA_UPDATE_IN_PROGRESS);
+  otaCancelUpdate();
+  EXPECT_EQ(counters().updatesStarted, 2u);
+  EXPECT_EQ(counters().updatesFailed, 2u);
+}
+
+// ━━━ Signed mode ━━━
+
+// RFC 8032 TEST 1 key pair
+const char* kSecretKey = "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60";
+const uint8_t kPublicKey[32] = {0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe,
+                                0xd3, 0xc9, 0x64, 0x07, 0x3a, 0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6,
+                                0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a};
+
+// A manifest that offers nothing to this device is a poll, not an update
+class SignedStatsTest : public StatsTest {
+ protected:
+  void sign(const std::vector<std::string>& options) {
+    extras::ScratchDir dir;
+    std::vector<std::string> args = {"sign", dir.write("signing.key", kSecretKey), dir.write("fw.bin", image)};
+    args.insert(args.end(), options.begin(), options.end());
+    args.insert(args.end(), {"-o", dir.path("fw.bin.manifest")});
+    ASSERT_EQ(extras::run("ota_sign.py", args), 0);
+    server.add("/fw.bin.manifest", dir.read("fw.bin.manifest"));
+    mock::onHttp(std::ref(server));  // Nothing is cut off here
+    otaSetSigningKey(kPublicKey);
+  }
+
+  void expectNoUpdateCounted() {
+    EXPECT_EQ(otaUpdateFromUrl(kUrl, "1.4.0"), OTA_UPDATE_NO_UPDATE);
+    otaAddUpdateSource(kUrl);
+    otaSetCurrentVersion("1.4.0");
+    EXPECT_EQ(otaUpdateFromSources(), OTA_UPDATE_NO_UPDATE);
+    ASSERT_TRUE(otaBeginUpdate(kUrl, "1.4.0", ""));
+    EXPECT_EQ(otaUpdateStep(0), OTA_UPDATE_NO_UPDATE);
+    EXPECT_EQ(counters().updatesStarted, 0u);
+    EXPECT_EQ(counters().updatesFailed, 0u);
+  }
+};
+
+TEST_F(SignedStatsTest, SameVersionManifestIsNotAnUpdate) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+  sign({"--version", "1.4.0"});
+  expectNoUpdateCounted();
+}
+
+TEST_F(SignedStatsTest, RolloutWithoutThisDeviceIsNotAnUpdate) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+  sign({"--version", "1.5.0", "--rollout", "0"});
+  expectNoUpdateCounted();
+  EXPECT_TRUE(mock::logged("not this one yet"));
+}
+
+}  // namespace
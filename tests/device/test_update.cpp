@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Pulled and uploaded updates, end to end: from the request to the image
+// running after the reboot
+
+#include "device_test.h"
+#include "images.h"
+
+namespace {
+
+const char* kUrl = "http://updates.local/fw.bin";
+
+class UpdateTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    mock::onHttp(std::ref(server));
+  }
+
+  images::FileServer server;
+};
+
+TEST_F(UpdateTest, UrlUpdateInstallsAndReboots) {
+  std::string image = images::rp2040(100 * 1024);
+  server.add("/fw.bin", image);
+  device::resetHeapPeak();
+
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(mock::picoOta().commits, 1u);
+  EXPECT_EQ(mock::runningImage(), image);
+  EXPECT_EQ(device::boots(), 2u);
+  EXPECT_LT(device::heapPeak(), 256);  // Static buffers; only a few short Strings
+}
+
+TEST_F(UpdateTest, SameVersionIsNoUpdate) {
+  server.add("/fw.bin", images::rp2040(8 * 1024), "1.2.0");
+
+  int result = OTA_UPDATE_FAILED;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl, "1.2.0"); }));
+  EXPECT_EQ(result, OTA_UPDATE_NO_UPDATE);
+  EXPECT_EQ(mock::picoOta().commits, 0u);
+}
+
+TEST_F(UpdateTest, DroppedConnectionResumesWithRange) {
+  std::string image = images::rp2040(100 * 1024);
+  server.add("/fw.bin", image);
+  bool dropped = false;
+  mock::onHttp([&](const mock::HttpRequest& request) {
+    mock::HttpResponse response = server(request);
+    if (!dropped) {
+      dropped = true;
+      response.dropAfter = 5000;
+    }
+    return response;
+  });
+
+  EXPECT_TRUE(device::run([] { otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(mock::runningImage(), image);
+  bool resumed = false;
+  for (const mock::HttpRequest& request : mock::net().requests) {
+    if (request.header("range").rfind("bytes=5000-", 0) == 0) resumed = true;
+  }
+  EXPECT_TRUE(resumed);
+}
+
+TEST_F(UpdateTest, ImageForAnotherBoardIsRefusedBeforeStaging) {
+  std::string image(64 * 1024, '\x5A');
+  server.add("/fw.bin", image);
+  std::string running = mock::runningImage();
+
+  int result = OTA_UPDATE_OK;
+  EXPECT_FALSE(device::run([&] { result = otaUpdateFromUrl(kUrl); }));
+  EXPECT_EQ(result, OTA_UPDATE_WRONG_IMAGE);
+  EXPECT_EQ(mock::runningImage(), running);
+  EXPECT_EQ(mock::fs().bytesWritten, 0u);
+}
+
+TEST_F(UpdateTest, WebUploadInstallsAndReboots) {
+  otaStartWebServer(80);
+  std::string image = images::rp2040(40 * 1024);
+  mock::WebRequest upload;
+  upload.method = HTTP_POST;
+  upload.uri = "/update";
+  upload.filename = "fw.bin";
+  for (size_t pos = 0; pos < image.size(); pos += 4096) upload.upload.push_back(image.substr(pos, 4096));
+  auto request = mock::webRequest(upload);
+
+  device::loopUntil([] { return false; }, 5000);
+  EXPECT_TRUE(device::rebooted());
+  EXPECT_EQ(request->code, 200);
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// The web UI pages: sent gzip-compressed with an ETag, 304 when the browser
+// already has them, and served without the heap growing request by request
+
+#include <memory>
+#include <string>
+
+#include "device_test.h"
+
+namespace {
+
+class WebTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    otaStartWebServer(80);
+  }
+
+  // A GET the server answers within the next otaLoop() calls
+  std::shared_ptr<mock::WebRequest> get(const std::string& uri, const std::string& ifNoneMatch = "") {
+    mock::WebRequest request;
+    request.uri = uri;
+    if (!ifNoneMatch.empty()) request.headers["if-none-match"] = ifNoneMatch;
+    auto sent = mock::webRequest(request);
+    device::loopUntil([&] { return sent->handled; }, 1000);
+    return sent;
+  }
+};
+
+TEST_F(WebTest, PagesAreSentGzipped) {
+  for (const char* uri : {"/", "/update"}) {
+    auto page = get(uri);
+    ASSERT_EQ(page->code, 200) << uri;
+    EXPECT_EQ(page->contentType, "text/html") << uri;
+    EXPECT_EQ(page->responseHeaders["Content-Encoding"], "gzip") << uri;
+    EXPECT_EQ(page->responseHeaders["Cache-Control"], "no-cache") << uri;
+    const std::string& etag = page->responseHeaders["ETag"];
+    ASSERT_GE(etag.size(), 3u) << uri;
+    EXPECT_EQ(etag.front(), '"') << uri;
+    EXPECT_EQ(etag.back(), '"') << uri;
+    ASSERT_GE(page->body().size(), 18u) << uri;  // gzip header and trailer
+    EXPECT_EQ(page->body().substr(0, 2), "\x1f\x8b") << uri;
+  }
+  EXPECT_NE(get("/")->responseHeaders["ETag"], get("/update")->responseHeaders["ETag"]);
+}
+
+TEST_F(WebTest, MatchingETagGets304) {
+  for (const char* uri : {"/", "/update"}) {
+    std::string etag = get(uri)->responseHeaders["ETag"];
+
+    auto cached = get(uri, etag);
+    EXPECT_EQ(cached->code, 304) << uri;
+    EXPECT_EQ(cached->responseHeaders["ETag"], etag) << uri;
+    EXPECT_EQ(cached->responseHeaders.count("Content-Encoding"), 0u) << uri;
+    EXPECT_TRUE(cached->body().empty()) << uri;
+
+    // A copy from older firmware is sent again
+    auto stale = get(uri, "\"0000000000000000\"");
+    EXPECT_EQ(stale->code, 200) << uri;
+    EXPECT_FALSE(stale->body().empty()) << uri;
+  }
+}
+
+TEST_F(WebTest, UpdatePageNeedsTheCredentials) {
+  otaSetWebCredentials("admin", "secret");
+  EXPECT_EQ(get("/update")->code, 401);
+  EXPECT_EQ(get("/")->code, 200);  // The root page only links to it
+
+  mock::WebRequest request;
+  request.uri = "/update";
+  request.user = "admin";
+  request.password = "secret";
+  auto sent = mock::webRequest(request);
+  device::loopUntil([&] { return sent->handled; }, 1000);
+  EXPECT_EQ(sent->code, 200);
+}
+
+TEST_F(WebTest, PagesDoNotGrowTheHeap) {
+  std::string indexEtag = get("/")->responseHeaders["ETag"];
+  std::string updateEtag = get("/update")->responseHeaders["ETag"];
+  long before = device::heapInUse();
+  for (int i = 0; i < 50; i++) {
+    get("/");
+    get("/update");
+    get("/", indexEtag);
+    get("/update", updateEtag);
+  }
+  EXPECT_EQ(device::heapInUse(), before);
+}
+
+}  // namespace
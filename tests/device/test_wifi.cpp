@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// The WiFi state machine behind auto-reconnect and otaSetupAsync(): the
+// states it goes through when the access point drops and returns, backoff
+// that doubles up to the cap with +/-25% jitter, giving up after the last
+// attempt, and otaLoop() returning at once on every path
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "device_test.h"
+
+namespace {
+
+struct Transition {
+  OtaWifiState state;
+  unsigned long ms;
+};
+
+class WifiTest : public DeviceTest {
+ protected:
+  // otaLoop() for ms of virtual time (1 ms between calls), recording each
+  // state change and the longest time one otaLoop() call took
+  void drive(unsigned long ms) {
+    unsigned long startMs = millis();
+    while (millis() - startMs < ms) {
+      uint64_t beforeUs = mock::nowUs();
+      otaLoop();
+      slowestLoopUs = std::max(slowestLoopUs, mock::nowUs() - beforeUs);
+      OtaWifiState state = otaGetWifiState();
+      if (transitions.empty() || transitions.back().state != state) transitions.push_back({state, millis()});
+      delay(1);
+    }
+  }
+
+  // The access point goes away: the link drops and no attempt succeeds
+  void accessPointDown() {
+    mock::wifi().connectOnBegin = false;
+    mock::wifi().connected = false;
+  }
+
+  std::vector<OtaWifiState> states() const {
+    std::vector<OtaWifiState> sequence;
+    for (const Transition& t : transitions) sequence.push_back(t.state);
+    return sequence;
+  }
+
+  // How long each WAITING lasted before the attempt it led to
+  std::vector<unsigned long> waits() const {
+    std::vector<unsigned long> result;
+    for (size_t i = 0; i + 1 < transitions.size(); i++) {
+      if (transitions[i].state == OTA_WIFI_WAITING && transitions[i + 1].state == OTA_WIFI_CONNECTING) {
+        result.push_back(transitions[i + 1].ms - transitions[i].ms);
+      }
+    }
+    return result;
+  }
+
+  std::vector<Transition> transitions;
+  uint64_t slowestLoopUs = 0;
+};
+
+// The driver is polled every 20 ms, so a wait can run that much over
+void expectWait(unsigned long wait, unsigned long nominal) {
+  EXPECT_GE(wait, nominal * 3 / 4) << "nominal " << nominal;
+  EXPECT_LE(wait, nominal * 5 / 4 + 25) << "nominal " << nominal;
+}
+
+TEST_F(WifiTest, ReconnectsWhenTheAccessPointReturns) {
+  static int disconnects = 0;
+  static int reconnects = 0;
+  disconnects = reconnects = 0;
+  otaOnWifiDisconnect([] { disconnects++; });
+  otaOnWifiReconnect([] { reconnects++; });
+  otaSetAutoReconnect(true);
+  otaSetReconnectInterval(1000);
+  device::setup();
+  drive(100);
+
+  accessPointDown();
+  drive(30000);  // First retry at once, then 1 s, 2 s, 4 s ... apart; 10 s per attempt
+  EXPECT_EQ(disconnects, 1);
+  EXPECT_EQ(reconnects, 0);
+
+  mock::wifi().connectOnBegin = true;
+  drive(20000);
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_CONNECTED);
+  EXPECT_EQ(reconnects, 1);
+  EXPECT_TRUE(mock::logged("Reconnected, IP: 192.168.1.50"));
+
+  std::vector<OtaWifiState> sequence = states();
+  ASSERT_GE(sequence.size(), 6u);
+  EXPECT_EQ(sequence[0], OTA_WIFI_CONNECTED);
+  for (size_t i = 1; i + 1 < sequence.size(); i += 2) {
+    EXPECT_EQ(sequence[i], OTA_WIFI_WAITING) << "transition " << i;
+    EXPECT_EQ(sequence[i + 1], OTA_WIFI_CONNECTING) << "transition " << i + 1;
+  }
+  EXPECT_EQ(sequence.back(), OTA_WIFI_CONNECTED);
+
+  // Each failed attempt ends after its 10 s timeout
+  for (size_t i = 0; i + 1 < transitions.size(); i++) {
+    if (transitions[i].state == OTA_WIFI_CONNECTING && transitions[i + 1].state == OTA_WIFI_WAITING) {
+      EXPECT_NEAR((double)(transitions[i + 1].ms - transitions[i].ms), 10000, 25);
+    }
+  }
+  EXPECT_LT(slowestLoopUs, 1000u);
+}
+
+TEST_F(WifiTest, BackoffDoublesUpToTheCapWithJitter) {
+  otaSetAutoReconnect(true);
+  otaSetReconnectInterval(1000);
+  otaSetReconnectMaxInterval(4000);
+  device::setup();
+  drive(100);
+  accessPointDown();
+  drive(150000);
+
+  std::vector<unsigned long> w = waits();
+  ASSERT_GE(w.size(), 8u);
+  EXPECT_LE(w[0], 25u);  // The drop itself: retry at once
+  expectWait(w[1], 1000);
+  expectWait(w[2], 2000);
+  std::set<unsigned long> capped;
+  for (size_t i = 3; i < w.size(); i++) {
+    expectWait(w[i], 4000);
+    capped.insert(w[i] / 20);  // In poll periods
+  }
+  EXPECT_GT(capped.size(), 1u) << "every capped wait was the same: no jitter";
+  EXPECT_LT(slowestLoopUs, 1000u);
+}
+
+TEST_F(WifiTest, GivesUpAfterTheLastAttempt) {
+  otaSetAutoReconnect(true);
+  otaSetReconnectInterval(1000);
+  otaSetMaxReconnectAttempts(3);
+  device::setup();
+  drive(100);
+  accessPointDown();
+  drive(60000);
+
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_GAVE_UP);
+  EXPECT_TRUE(mock::logged("WiFi reconnect attempts exhausted"));
+  std::vector<OtaWifiState> sequence = states();
+  EXPECT_EQ(std::count(sequence.begin(), sequence.end(), OTA_WIFI_CONNECTING), 3);
+  unsigned gaveUpAt = mock::wifi().beginCalls;
+  drive(60000);
+  EXPECT_EQ(mock::wifi().beginCalls, gaveUpAt);  // No more attempts
+
+  // Still picks up a link the driver brings back on its own
+  mock::wifi().connected = true;
+  drive(100);
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_CONNECTED);
+
+  // Enabling auto-reconnect again starts over after a drop
+  accessPointDown();
+  drive(100);
+  otaSetAutoReconnect(true);
+  mock::wifi().connectOnBegin = true;
+  drive(12000);
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_CONNECTED);
+  EXPECT_LT(slowestLoopUs, 1000u);
+}
+
+TEST_F(WifiTest, AsyncSetupCompletesFromLoop) {
+  accessPointDown();
+  otaSetWifiTimeout(2000);
+  otaSetReconnectInterval(1000);
+  uint64_t beforeUs = mock::nowUs();
+  ASSERT_TRUE(otaSetupAsync("test-ssid", "test-password", "pico-test", nullptr));
+  EXPECT_LT(mock::nowUs() - beforeUs, 1000u);  // Returned without waiting for WiFi
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_CONNECTING);
+  EXPECT_FALSE(otaIsReady());
+
+  drive(5000);  // The first attempt times out after 2 s; retries take the same timeout
+  EXPECT_FALSE(otaIsReady());
+  std::vector<OtaWifiState> sequence = states();
+  ASSERT_GE(sequence.size(), 3u);
+  EXPECT_EQ(sequence[0], OTA_WIFI_CONNECTING);
+  EXPECT_EQ(sequence[1], OTA_WIFI_WAITING);
+  EXPECT_NEAR((double)(transitions[1].ms - transitions[0].ms), 2000, 25);
+  EXPECT_FALSE(mock::logged("WiFi connected"));
+
+  mock::wifi().connectOnBegin = true;
+  drive(5000);
+  EXPECT_EQ(otaGetWifiState(), OTA_WIFI_CONNECTED);
+  EXPECT_TRUE(otaIsReady());
+  EXPECT_TRUE(mock::logged("WiFi connected, IP: 192.168.1.50"));
+  EXPECT_LT(slowestLoopUs, 1000u);
+}
+
+}  // namespace
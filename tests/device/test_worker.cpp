@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// The background worker on its own thread, as on core 1: the test thread
+// only sends the request, polls events and reads otaGetTransferStatus()
+// while the worker downloads. Build with -DOTA_TEST_TSAN=ON to have
+// ThreadSanitizer check what the two share.
+
+#include <atomic>
+#include <thread>
+
+#include "device_test.h"
+#include "images.h"
+
+namespace {
+
+class WorkerTest : public DeviceTest {
+ protected:
+  void SetUp() override {
+    DeviceTest::SetUp();
+    device::setup();
+    mock::onHttp(std::ref(server));
+    mock::net().usPerKiB = 500;  // 2 MB/s, so rate and ETA are measured
+    otaSetProgressThrottle(4096, 0);
+    ASSERT_TRUE(otaWorkerBegin());
+  }
+
+  // loop1(): the worker until it reboots the board or stop is set
+  void startWorker() {
+    worker = std::thread([this] {
+      try {
+        while (!stop.load()) otaWorkerLoop();
+      } catch (const mock::Reboot&) {
+        workerRebooted.store(true);
+      }
+    });
+  }
+
+  void joinWorker() {
+    stop.store(true);
+    worker.join();
+    if (workerRebooted.load()) device::reboot();
+  }
+
+  images::FileServer server;
+  std::thread worker;
+  std::atomic<bool> stop{false};
+  std::atomic<bool> workerRebooted{false};
+};
+
+TEST_F(WorkerTest, StatusAndEventsFromAnotherThread) {
+  std::string image = images::rp2040(512 * 1024);
+  server.add("/fw.bin", image);
+  startWorker();
+  ASSERT_TRUE(otaRequestUpdateFromUrl("http://updates.local/fw.bin"));
+
+  unsigned statusReads = 0;
+  unsigned inconsistent = 0;
+  uint32_t lastBytes = 0;
+  uint32_t lastEvent = 0;
+  unsigned progressEvents = 0;
+  bool started = false;
+  bool eventsOrdered = true;
+  while (!workerRebooted.load()) {
+    OtaTransferStatus status;
+    otaGetTransferStatus(&status);
+    statusReads++;
+    if (status.active) {
+      // One transfer, so bytes only grow and the total is the image size
+      if (status.total != image.size() || status.bytes > status.total || status.bytes < lastBytes ||
+          status.writeMs > status.elapsedMs) {
+        inconsistent++;
+      }
+      lastBytes = status.bytes;
+    }
+    OtaEvent event;
+    while (otaPollEvent(&event)) {
+      if (event.type == OTA_EVENT_STARTED) started = true;
+      if (event.type == OTA_EVENT_PROGRESS && event.phase == OTA_PROGRESS_DOWNLOAD) {
+        eventsOrdered = eventsOrdered && event.bytes >= lastEvent && event.total == image.size();
+        lastEvent = event.bytes;
+        progressEvents++;
+      }
+      EXPECT_NE(event.type, OTA_EVENT_ERROR) << event.result;
+    }
+    std::this_thread::yield();
+  }
+  joinWorker();
+
+  EXPECT_TRUE(started);
+  EXPECT_GT(progressEvents, 1u);
+  EXPECT_TRUE(eventsOrdered);
+  EXPECT_GT(statusReads, 1u);
+  EXPECT_EQ(inconsistent, 0u);
+  EXPECT_EQ(mock::runningImage(), image);
+}
+
+}  // namespace
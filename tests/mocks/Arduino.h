@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// Host stand-in for the parts of the Arduino-Pico core the library uses.
+// Time is virtual (see mock_board.h): delay() advances it instead of
+// sleeping, so retries and timeouts run in microseconds of real time.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <new>
+#include <string>
+
+#define PROGMEM
+#define PGM_P const char*
+#define F(x) x
+#define LOW 0
+#define HIGH 1
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+// Allocates with the operator new of the code that builds the String, so
+// the library's own heap use can be told apart (support/device_api.cpp)
+template <class T>
+struct StringAllocator {
+  typedef T value_type;
+  StringAllocator() {}
+  template <class U>
+  StringAllocator(const StringAllocator<U>&) {}
+  T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+  void deallocate(T* p, size_t) { ::operator delete(p); }
+  bool operator==(const StringAllocator&) const { return true; }
+  bool operator!=(const StringAllocator&) const { return false; }
+};
+
+class String {
+ public:
+  typedef std::basic_string<char, std::char_traits<char>, StringAllocator<char>> Storage;
+
+  String(const char* s = "") : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s.data(), s.size()) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : String(std::to_string(v)) {}
+  String(unsigned int v) : String(std::to_string(v)) {}
+  String(long v) : String(std::to_string(v)) {}
+  String(unsigned long v) : String(std::to_string(v)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  std::string str() const { return std::string(s_.data(), s_.size()); }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { s_ += o; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : '\0'; }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(s_.find(c, from)); }
+  int indexOf(const String& c, unsigned int from = 0) const { return pos(s_.find(c.s_, from)); }
+  String substring(unsigned int a) const { return a < s_.size() ? String(s_.substr(a)) : String(); }
+  String substring(unsigned int a, unsigned int b) const {
+    return a < s_.size() && b > a ? String(s_.substr(a, b - a)) : String();
+  }
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const {
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+  bool equalsIgnoreCase(const String& o) const { return strcasecmp(s_.c_str(), o.s_.c_str()) == 0; }
+  long toInt() const { return atol(s_.c_str()); }
+  void trim() {
+    size_t first = s_.find_first_not_of(" \t\r\n");
+    size_t last = s_.find_last_not_of(" \t\r\n");
+    s_ = first == Storage::npos ? Storage() : s_.substr(first, last - first + 1);
+  }
+
+ private:
+  static int pos(size_t p) { return p == Storage::npos ? -1 : (int)p; }
+  String(const Storage& s) : s_(s) {}
+  Storage s_;
+};
+
+class Print;
+
+class Printable {
+ public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+  }
+  size_t write(const char* s) { return write(reinterpret_cast<const uint8_t*>(s), strlen(s)); }
+  size_t write(const char* s, size_t n) { return write(reinterpret_cast<const uint8_t*>(s), n); }
+
+  size_t print(const char* s) { return write(s ? s : ""); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+  size_t print(const Printable& p) { return p.printTo(*this); }
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T& v) { return print(v) + println(); }
+  size_t println(double v, int digits) { return print(v, digits) + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t readBytes(uint8_t* buffer, size_t length);
+  size_t readBytes(char* buffer, size_t length) { return readBytes(reinterpret_cast<uint8_t*>(buffer), length); }
+  void setTimeout(unsigned long timeoutMs) { timeoutMs_ = timeoutMs; }
+
+ protected:
+  unsigned long timeoutMs_ = 1000;
+};
+
+// Serial output is collected (mock::serialLog()) and echoed to stderr when
+// OTA_TEST_VERBOSE is set
+class HardwareSerial : public Stream {
+ public:
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class IPAddress : public Printable {
+ public:
+  IPAddress() : addr_(0) {}
+  IPAddress(uint32_t addr) : addr_(addr) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : addr_((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+  uint8_t operator[](int i) const { return (uint8_t)(addr_ >> (8 * i)); }
+  operator uint32_t() const { return addr_; }
+  bool operator==(const IPAddress& o) const { return addr_ == o.addr_; }
+  bool operator!=(const IPAddress& o) const { return addr_ != o.addr_; }
+  String toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+  }
+  size_t printTo(Print& p) const override { return p.print(toString()); }
+
+ private:
+  uint32_t addr_;
+};
+
+// Flash of the simulated board (mock_board.h sets the sketch area and the
+// running image). The linker symbols the library reads are mapped onto it.
+extern uint8_t g_mockFlash[];
+extern uint8_t* g_mockFsStart;
+extern uint8_t* g_mockFlashBinaryEnd;
+#define XIP_BASE ((uintptr_t)g_mockFlash)
+// No parentheses: "extern uint8_t _FS_start;" must stay a plain declaration
+#define _FS_start *g_mockFsStart
+#define __flash_binary_end *g_mockFlashBinaryEnd
+
+class RP2040 {
+ public:
+  uint32_t hwrand32();
+  [[noreturn]] void reboot();  // Throws mock::Reboot
+  [[noreturn]] void restart() { reboot(); }
+  int getFreeHeap() { return 180 * 1024; }
+  int getUsedHeap() { return 40 * 1024; }
+  int getTotalHeap() { return 220 * 1024; }
+  uint32_t f_cpu() { return 133000000; }
+  void idleOtherCore() {}
+  void resumeOtherCore() {}
+  uint32_t getCycleCount() { return (uint32_t)micros() * 133; }
+};
+extern RP2040 rp2040;
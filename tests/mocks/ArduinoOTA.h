@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <functional>
+
+typedef enum { OTA_AUTH_ERROR, OTA_BEGIN_ERROR, OTA_CONNECT_ERROR, OTA_RECEIVE_ERROR, OTA_END_ERROR } ota_error_t;
+
+// Keeps the callbacks so a test can play an IDE upload through them
+class ArduinoOTAClass {
+ public:
+  void onStart(std::function<void()> fn) { start = std::move(fn); }
+  void onEnd(std::function<void()> fn) { end_ = std::move(fn); }
+  void onProgress(std::function<void(unsigned int, unsigned int)> fn) { progress = std::move(fn); }
+  void onError(std::function<void(ota_error_t)> fn) { error = std::move(fn); }
+  void setHostname(const char*) {}
+  void setPassword(const char*) {}
+  void begin(bool = true) { begun = true; }
+  void handle() {}
+  void end() { begun = false; }
+
+  std::function<void()> start;
+  std::function<void()> end_;
+  std::function<void(unsigned int, unsigned int)> progress;
+  std::function<void(ota_error_t)> error;
+  bool begun = false;
+};
+extern ArduinoOTAClass ArduinoOTA;
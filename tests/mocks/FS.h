@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <memory>
+
+namespace mock {
+struct FsNode;
+}
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+// A file of the RAM file system (mock::fs()); copies share the open file
+class File : public Stream {
+ public:
+  File() {}
+  File(std::shared_ptr<mock::FsNode> node, bool read, bool write, bool append);
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size);
+  size_t readBytes(uint8_t* buffer, size_t length) override { int n = read(buffer, length); return n > 0 ? n : 0; }
+  using Stream::readBytes;
+  int peek() override;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  bool truncate(uint32_t size);
+  void flush() {}
+  void close();
+  operator bool() const { return state_ != nullptr; }
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+struct FSInfo {
+  size_t totalBytes;
+  size_t usedBytes;
+  size_t blockSize;
+  size_t pageSize;
+  size_t maxOpenFiles;
+  size_t maxPathLength;
+};
+
+class FS {
+ public:
+  bool begin();
+  void end();
+  bool format();
+  File open(const char* path, const char* mode);
+  File open(const String& path, const char* mode) { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+  bool mkdir(const char*) { return true; }
+  bool info(FSInfo& info);
+};
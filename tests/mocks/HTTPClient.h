@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <WiFiClient.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+typedef enum {
+  HTTPC_DISABLE_FOLLOW_REDIRECTS,
+  HTTPC_STRICT_FOLLOW_REDIRECTS,
+  HTTPC_FORCE_FOLLOW_REDIRECTS
+} followRedirects_t;
+
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+#define HTTPC_ERROR_CONNECTION_REFUSED HTTPC_ERROR_CONNECTION_FAILED
+#define HTTP_CODE_OK 200
+
+// Requests go to the handler installed with mock::onHttp() over the
+// connection the caller opened, as with the Arduino-Pico HTTPClient
+class HTTPClient {
+ public:
+  bool begin(WiFiClient& client, const String& url);
+  void end();
+  void setReuse(bool reuse) { reuse_ = reuse; }
+  void useHTTP10(bool http10 = true) { http10_ = http10; }
+  void setTimeout(uint16_t timeoutMs) { timeoutMs_ = timeoutMs; }
+  void setFollowRedirects(followRedirects_t follow) { follow_ = follow; }
+  void setUserAgent(const String& agent) { addHeader("User-Agent", agent); }
+  void setAuthorization(const char* user, const char* password);
+  void addHeader(const String& name, const String& value, bool first = false, bool replace = true);
+  void collectHeaders(const char* headerKeys[], const size_t count);
+  String header(const char* name);
+  bool hasHeader(const char* name);
+  int GET();
+  int getSize() { return size_; }
+  WiFiClient* getStreamPtr() { return connected() ? client_ : nullptr; }
+  WiFiClient& getStream() { return *client_; }
+  bool connected() { return client_ && client_->connected(); }
+  static String errorToString(int error);
+
+ private:
+  WiFiClient* client_ = nullptr;
+  std::string url_;
+  std::vector<std::pair<std::string, std::string>> requestHeaders_;
+  std::vector<std::string> collect_;
+  std::map<std::string, std::string> responseHeaders_;  // Lower-case names
+  int size_ = -1;
+  bool reuse_ = true;
+  bool http10_ = false;
+  bool canReuse_ = false;
+  uint16_t timeoutMs_ = 5000;
+  followRedirects_t follow_ = HTTPC_DISABLE_FOLLOW_REDIRECTS;
+};
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+
+// Peers answering a query come from mock::mdnsPeers()
+class MDNSResponder {
+ public:
+  void* addService(const char* service, const char* proto, uint16_t port);
+  uint32_t queryService(const char* service, const char* proto, uint16_t timeoutMs = 1000);
+  IPAddress IP(uint32_t index);
+  uint16_t port(uint32_t index);
+};
+extern MDNSResponder MDNS;
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+
+// commit() installs the queued file at once: its bytes become the running
+// image in the mock flash (mock::picoOtaCommits() counts them)
+class PicoOTA {
+ public:
+  void begin();
+  bool addFile(const char* path, uint32_t offset = 0, uint32_t flashAddr = 0, uint32_t len = 0);
+  bool commit();
+};
+extern PicoOTA picoOTA;
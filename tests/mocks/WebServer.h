@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <WiFiClient.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN 1436
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  String type;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+namespace mock {
+struct WebRequest;
+}
+
+// Serves the requests queued with mock::webRequest(), one per
+// handleClient(), and writes the response to the request's connection
+class WebServer {
+ public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit WebServer(int port);
+  ~WebServer();
+  void begin() {}
+  void stop() {}
+  void handleClient();
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn) { on(uri, method, fn, nullptr); }
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction upload);
+  void onNotFound(THandlerFunction fn) { notFound_ = std::move(fn); }
+  bool authenticate(const char* user, const char* password);
+  void requestAuthentication();
+  void send(int code, const char* contentType = nullptr, const String& content = String());
+  void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t length) { contentLength_ = length; }
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t length);
+  void collectHeaders(const char* headerKeys[], const size_t count);
+  String header(const char* name);
+  bool hasHeader(const char* name);
+  String arg(const char* name);
+  bool hasArg(const char* name);
+  size_t clientContentLength();
+  HTTPUpload& upload() { return upload_; }
+  WiFiClient& client() { return client_; }
+  HTTPMethod method();
+  String uri();
+
+ private:
+  struct Route {
+    std::string uri;
+    HTTPMethod method;
+    THandlerFunction fn;
+    THandlerFunction upload;
+  };
+  void runUpload(const Route& route);
+
+  int port_;
+  std::vector<Route> routes_;
+  THandlerFunction notFound_;
+  std::vector<std::string> collect_;
+  std::shared_ptr<mock::WebRequest> request_;
+  WiFiClient client_;
+  std::map<std::string, std::string> responseHeaders_;
+  size_t contentLength_ = CONTENT_LENGTH_NOT_SET;
+  HTTPUpload upload_;
+};
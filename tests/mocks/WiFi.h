@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL,
+  WL_SCAN_COMPLETED,
+  WL_CONNECTED,
+  WL_CONNECT_FAILED,
+  WL_CONNECTION_LOST,
+  WL_DISCONNECTED
+} wl_status_t;
+
+#define WIFI_STA 1
+
+// Connection state comes from mock_board.h (mock::wifi())
+class WiFiClass {
+ public:
+  void mode(int) {}
+  int begin(const char* ssid, const char* password);
+  int beginNoBlock(const char* ssid, const char* password);
+  bool disconnect(bool wifiOff = false);
+  wl_status_t status();
+  IPAddress localIP();
+  uint8_t* macAddress(uint8_t* mac);
+  int32_t RSSI() { return -60; }
+  bool setAutoReconnect(bool) { return true; }
+  int hostByName(const char* host, IPAddress& address);
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include <memory>
+
+namespace mock {
+struct Socket;
+}
+
+class Client : public Stream {
+ public:
+  virtual int connect(const char* host, uint16_t port) = 0;
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int read(uint8_t* buffer, size_t size) = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual void flush() {}
+  using Stream::read;
+  using Print::write;
+};
+
+// A connection to the simulated network (mock_board.h): what the server
+// side queued is read here, writes are collected for it
+class WiFiClient : public Client {
+ public:
+  WiFiClient() {}
+  explicit WiFiClient(std::shared_ptr<mock::Socket> socket) : socket_(std::move(socket)) {}
+
+  int connect(const char* host, uint16_t port) override;
+  int connect(IPAddress ip, uint16_t port) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  size_t readBytes(uint8_t* buffer, size_t length) override;
+  using Stream::readBytes;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() { return connected(); }
+  void setNoDelay(bool) {}
+  IPAddress remoteIP();
+
+  const std::shared_ptr<mock::Socket>& socket() const { return socket_; }
+
+ protected:
+  virtual bool secure() const { return false; }
+  std::shared_ptr<mock::Socket> socket_;
+};
+
+class WiFiServer {
+ public:
+  WiFiServer(uint16_t) {}
+  void begin() {}
+  void stop() {}
+  WiFiClient accept() { return WiFiClient(); }
+  WiFiClient available() { return WiFiClient(); }
+};
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// Control side of the simulated Pico W: virtual clock, WiFi, a scripted
+// network (HTTP handler per request), RAM flash and LittleFS, picoOTA,
+// mDNS peers and the web server's clients. Tests and benchmarks set these
+// up, run the library against them and inspect what it did.
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mock {
+
+// rp2040.reboot(): the library's state ends here (see support/device.h)
+struct Reboot {};
+
+// ━━━ Clock ━━━
+// Virtual by default: micros() moves by microsTick per call, delay() by
+// its argument. Benchmarks switch to the real clock, where delay() still
+// only moves the time forward instead of sleeping.
+struct ClockState {
+  bool real = false;
+  uint32_t microsTick = 1;
+};
+ClockState& clock();
+uint64_t nowUs();
+void advanceUs(uint64_t us);
+
+// ━━━ Serial ━━━
+const std::string& serialLog();
+void clearSerialLog();
+bool logged(const std::string& text);  // Some Serial output contains text
+
+// ━━━ WiFi ━━━
+struct WifiState {
+  bool connected = true;
+  bool connectOnBegin = true;    // begin() / beginNoBlock() succeed at once
+  uint8_t mac[6] = {0x28, 0xCD, 0xC1, 0x00, 0x00, 0x01};
+  IPAddress ip = IPAddress(192, 168, 1, 50);
+  std::vector<std::string> unresolvable;  // hostByName() fails for these
+  unsigned beginCalls = 0;
+};
+WifiState& wifi();
+
+// ━━━ Network ━━━
+// One TCP connection. The server side fills rx; the client reads at most
+// rxLimit bytes of it, then the connection stalls (open) or closes.
+struct Socket {
+  std::string host;
+  uint16_t port = 0;
+  bool secure = false;
+  bool open = true;
+  std::string rx;
+  size_t rxPos = 0;
+  size_t rxLimit = std::string::npos;
+  bool closeWhenDrained = false;
+  std::string tx;                // Bytes the client wrote
+};
+
+struct HttpRequest {
+  std::string method = "GET";
+  std::string url;
+  std::string host;              // Without the port
+  uint16_t port = 0;
+  std::string path;              // With the query
+  bool secure = false;
+  bool http10 = false;
+  std::map<std::string, std::string> headers;  // Lower-case names
+  std::string header(const std::string& name) const;
+};
+
+struct HttpResponse {
+  int code = 200;                // <= 0: HTTPClient error code, nothing sent
+  std::map<std::string, std::string> headers;
+  std::string body;
+  bool chunked = false;          // No Content-Length (HTTP/1.0: ends with the connection)
+  bool close = false;            // Connection: close
+  size_t dropAfter = std::string::npos;   // Connection lost after this many body bytes
+  size_t stallAfter = std::string::npos;  // Server stops sending after this many
+};
+
+using HttpHandler = std::function<HttpResponse(const HttpRequest&)>;
+
+struct NetState {
+  HttpHandler handler;           // 404 for everything when unset
+  std::vector<HttpRequest> requests;
+  std::vector<std::shared_ptr<Socket>> sockets;  // Every client connection opened
+  std::vector<std::string> refused;       // "host" or "host:port" that refuse connections
+  bool failBegin = false;        // HTTPClient::begin() returns false
+  size_t packetSize = 1460;      // Most available() reports at once
+  uint32_t usPerKiB = 0;         // Virtual time per KiB read (link rate)
+  unsigned connects = 0;
+  unsigned tlsHandshakes = 0;
+  unsigned tlsResumed = 0;
+};
+NetState& net();
+void onHttp(HttpHandler handler);
+
+// ━━━ Flash and LittleFS ━━━
+static const size_t kFlashSize = 4 * 1024 * 1024;
+void setSketchArea(size_t bytes);                // Where LittleFS starts (_FS_start)
+size_t sketchArea();
+void setRunningImage(const std::string& image);  // At flash offset 0, sets __flash_binary_end
+std::string runningImage();
+
+struct FsNode {
+  std::string data;
+};
+
+struct FsState {
+  std::map<std::string, std::shared_ptr<FsNode>> files;
+  size_t capacity = 1024 * 1024;
+  size_t blockSize = 4096;
+  bool mounted = false;
+  bool mountFails = false;       // begin() fails until format()
+  uint32_t usPerKiB = 0;         // Virtual time per KiB written
+  uint32_t usPerWrite = 0;       // And per write() call (LittleFS metadata, program setup)
+  size_t bytesWritten = 0;
+  size_t writes = 0;             // write() calls
+};
+FsState& fs();
+size_t fsUsed();
+bool fsExists(const std::string& path);
+std::string fsRead(const std::string& path);
+void fsWrite(const std::string& path, const std::string& data);
+
+// ━━━ picoOTA ━━━
+struct PicoOtaState {
+  std::vector<std::string> queued;
+  unsigned commits = 0;
+  bool failCommit = false;
+};
+PicoOtaState& picoOta();
+
+// ━━━ mDNS ━━━
+struct MdnsPeer {
+  IPAddress ip;
+  uint16_t port;
+};
+struct MdnsState {
+  std::vector<MdnsPeer> peers;
+  std::vector<std::string> services;  // "service.proto:port" announced
+};
+MdnsState& mdns();
+
+// ━━━ Web server ━━━
+struct WebRequest {
+  HTTPMethod method = HTTP_GET;
+  std::string uri;               // Path only
+  std::map<std::string, std::string> args;
+  std::map<std::string, std::string> headers;  // Lower-case names
+  std::string user;              // Basic credentials the client sends
+  std::string password;
+  std::string filename;          // Upload: file part, sent in upload chunks
+  std::vector<std::string> upload;
+  bool abortUpload = false;
+
+  // Response
+  bool handled = false;
+  int code = 0;
+  std::string contentType;
+  std::map<std::string, std::string> responseHeaders;
+  std::shared_ptr<Socket> socket = std::make_shared<Socket>();
+  const std::string& body() const { return socket->tx; }
+  bool closed() const { return !socket->open; }
+};
+// Queue a request for the next WebServer::handleClient()
+std::shared_ptr<WebRequest> webRequest(const WebRequest& request);
+WebServer* webServer();
+
+// ━━━ Lifecycle ━━━
+void reset();        // Power-on: everything back to defaults
+void rebootReset();  // Reboot: RAM state dropped, flash and LittleFS kept
+
+}  // namespace mock
@@ -0,0 +1,951 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// The simulated board behind the stand-in headers. Built as a shared
+// library so its state (flash, file system, network) outlives the reboots
+// of the library under test (support/device.cpp).
+
+#include "mock_board.h"
+
+#include <ArduinoOTA.h>
+#include <FS.h>
+#include <HTTPClient.h>
+#include <LEAmDNS.h>
+#include <LittleFS.h>
+#include <PicoOTA.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <deque>
+#include <mutex>
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+RP2040 rp2040;
+FS LittleFS;
+PicoOTA picoOTA;
+MDNSResponder MDNS;
+ArduinoOTAClass ArduinoOTA;
+
+uint8_t g_mockFlash[mock::kFlashSize];
+uint8_t* g_mockFsStart = g_mockFlash + 1024 * 1024;
+uint8_t* g_mockFlashBinaryEnd = g_mockFlash;
+
+namespace {
+
+const uint64_t kBootUs = 1000000;  // millis() starts at 1000, as after a real boot
+
+std::atomic<uint64_t> g_us{kBootUs};
+std::chrono::steady_clock::time_point g_realStart = std::chrono::steady_clock::now();
+mock::ClockState g_clock;
+
+std::mutex g_serialMutex;
+std::string g_serialLog;
+
+mock::WifiState g_wifi;
+mock::NetState g_net;
+mock::FsState g_fs;
+mock::PicoOtaState g_picoOta;
+mock::MdnsState g_mdns;
+
+WebServer* g_server = nullptr;
+std::deque<std::shared_ptr<mock::WebRequest>> g_webQueue;
+
+uint32_t g_random = 0x2545F491;
+
+std::string lower(std::string s) {
+  for (char& c : s) c = (char)tolower((unsigned char)c);
+  return s;
+}
+
+bool listed(const std::vector<std::string>& list, const std::string& item) {
+  return std::find(list.begin(), list.end(), item) != list.end();
+}
+
+// Virtual time for moving bytes at a given rate
+void spend(size_t bytes, uint32_t usPerKiB) {
+  if (usPerKiB) mock::advanceUs((uint64_t)bytes * usPerKiB / 1024);
+}
+
+IPAddress addressOf(const std::string& host) {
+  uint32_t hash = 2166136261u;
+  for (char c : host) hash = (hash ^ (uint8_t)c) * 16777619u;
+  return IPAddress(10, (uint8_t)(hash >> 16), (uint8_t)(hash >> 8), (uint8_t)(hash | 1));
+}
+
+struct Url {
+  bool valid = false;
+  bool secure = false;
+  std::string host;
+  uint16_t port = 0;
+  std::string path;
+};
+
+Url parseUrl(const std::string& url) {
+  Url parsed;
+  size_t rest;
+  if (url.rfind("http://", 0) == 0) {
+    rest = 7;
+  } else if (url.rfind("https://", 0) == 0) {
+    rest = 8;
+    parsed.secure = true;
+  } else {
+    return parsed;
+  }
+  size_t slash = url.find('/', rest);
+  std::string hostPort = url.substr(rest, slash == std::string::npos ? std::string::npos : slash - rest);
+  parsed.path = slash == std::string::npos ? "/" : url.substr(slash);
+  size_t colon = hostPort.rfind(':');
+  parsed.port = parsed.secure ? 443 : 80;
+  if (colon != std::string::npos) {
+    parsed.port = (uint16_t)atoi(hostPort.c_str() + colon + 1);
+    hostPort.resize(colon);
+  }
+  parsed.host = hostPort;
+  parsed.valid = !hostPort.empty();
+  return parsed;
+}
+
+std::string base64(const std::string& in) {
+  static const char* kDigits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < in.size(); i += 3) {
+    uint32_t v = (uint8_t)in[i] << 16;
+    if (i + 1 < in.size()) v |= (uint8_t)in[i + 1] << 8;
+    if (i + 2 < in.size()) v |= (uint8_t)in[i + 2];
+    out += kDigits[(v >> 18) & 63];
+    out += kDigits[(v >> 12) & 63];
+    out += i + 1 < in.size() ? kDigits[(v >> 6) & 63] : '=';
+    out += i + 2 < in.size() ? kDigits[v & 63] : '=';
+  }
+  return out;
+}
+
+// Bytes the client may still read from the socket
+size_t readable(const mock::Socket& s) {
+  size_t limit = std::min(s.rx.size(), s.rxLimit);
+  return s.rxPos < limit ? limit - s.rxPos : 0;
+}
+
+// The server closes once the client has read everything it will send
+void settle(mock::Socket& s) {
+  if (s.open && s.closeWhenDrained && readable(s) == 0) s.open = false;
+}
+
+size_t fileBlocks(size_t size) {
+  size_t blocks = (size + g_fs.blockSize - 1) / g_fs.blockSize;
+  return blocks ? blocks : 1;
+}
+
+}  // namespace
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Arduino core
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+unsigned long micros() {
+  if (g_clock.real) {
+    auto elapsed = std::chrono::steady_clock::now() - g_realStart;
+    return (unsigned long)(g_us + std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  }
+  return (unsigned long)(g_us += g_clock.microsTick);
+}
+
+unsigned long millis() {
+  if (g_clock.real) return micros() / 1000;
+  return (unsigned long)(g_us.load() / 1000);
+}
+
+void delay(unsigned long ms) {
+  g_us += (uint64_t)ms * 1000;
+}
+
+void yield() {
+  if (!g_clock.real) g_us += 1;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char small[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(small, sizeof(small), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(small)) return write(reinterpret_cast<const uint8_t*>(small), (size_t)len);
+  std::string big((size_t)len + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&big[0], big.size(), format, args);
+  va_end(args);
+  return write(reinterpret_cast<const uint8_t*>(big.data()), (size_t)len);
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+  size_t got = 0;
+  unsigned long startMs = millis();
+  while (got < length) {
+    int c = read();
+    if (c < 0) {
+      if (millis() - startMs >= timeoutMs_) break;
+      delay(1);
+      continue;
+    }
+    buffer[got++] = (uint8_t)c;
+  }
+  return got;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(g_serialMutex);
+  g_serialLog.append(reinterpret_cast<const char*>(buffer), size);
+  if (getenv("OTA_TEST_VERBOSE")) fwrite(buffer, 1, size, stderr);
+  return size;
+}
+
+uint32_t RP2040::hwrand32() {
+  g_random ^= g_random << 13;
+  g_random ^= g_random >> 17;
+  g_random ^= g_random << 5;
+  return g_random;
+}
+
+void RP2040::reboot() {
+  throw mock::Reboot();
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// WiFi and sockets
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+int WiFiClass::begin(const char*, const char*) {
+  g_wifi.beginCalls++;
+  if (g_wifi.connectOnBegin) g_wifi.connected = true;
+  return status();
+}
+
+int WiFiClass::beginNoBlock(const char* ssid, const char* password) {
+  return begin(ssid, password);
+}
+
+bool WiFiClass::disconnect(bool) {
+  g_wifi.connected = false;
+  return true;
+}
+
+wl_status_t WiFiClass::status() {
+  return g_wifi.connected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP() {
+  return g_wifi.connected ? g_wifi.ip : IPAddress();
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+  memcpy(mac, g_wifi.mac, sizeof(g_wifi.mac));
+  return mac;
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& address) {
+  if (!g_wifi.connected || listed(g_wifi.unresolvable, host)) return 0;
+  address = addressOf(host);
+  return 1;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  std::string hostPort = std::string(host) + ":" + std::to_string(port);
+  if (!g_wifi.connected || listed(g_net.refused, host) || listed(g_net.refused, hostPort)) return 0;
+  g_net.connects++;
+  socket_ = std::make_shared<mock::Socket>();
+  socket_->host = host;
+  socket_->port = port;
+  socket_->secure = secure();
+  g_net.sockets.push_back(socket_);
+  return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip.toString().c_str(), port);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+  if (!socket_ || !socket_->open) return 0;
+  socket_->tx.append(reinterpret_cast<const char*>(buffer), size);
+  return size;
+}
+
+int WiFiClient::available() {
+  if (!socket_) return 0;
+  settle(*socket_);
+  return (int)std::min(readable(*socket_), g_net.packetSize);
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  if (!socket_) return -1;
+  size_t n = std::min(size, readable(*socket_));
+  if (n == 0) return -1;
+  memcpy(buffer, socket_->rx.data() + socket_->rxPos, n);
+  socket_->rxPos += n;
+  spend(n, g_net.usPerKiB);
+  settle(*socket_);
+  return (int)n;
+}
+
+int WiFiClient::peek() {
+  if (!socket_ || readable(*socket_) == 0) return -1;
+  return (uint8_t)socket_->rx[socket_->rxPos];
+}
+
+size_t WiFiClient::readBytes(uint8_t* buffer, size_t length) {
+  size_t got = 0;
+  unsigned long startMs = millis();
+  while (got < length) {
+    int n = read(buffer + got, length - got);
+    if (n > 0) {
+      got += (size_t)n;
+      continue;
+    }
+    if (!connected() || millis() - startMs >= timeoutMs_) break;
+    delay(1);
+  }
+  return got;
+}
+
+void WiFiClient::stop() {
+  if (socket_) {
+    socket_->open = false;
+    socket_.reset();
+  }
+}
+
+uint8_t WiFiClient::connected() {
+  if (!socket_) return 0;
+  settle(*socket_);
+  return socket_->open || readable(*socket_) > 0;
+}
+
+IPAddress WiFiClient::remoteIP() {
+  return socket_ ? addressOf(socket_->host) : IPAddress();
+}
+
+int WiFiClientSecure::connect(const char* host, uint16_t port) {
+  if (!WiFiClient::connect(host, port)) return 0;
+  g_net.tlsHandshakes++;
+  if (session_) {
+    if (session_->valid) g_net.tlsResumed++;
+    session_->valid = true;
+  }
+  return 1;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// HTTPClient
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+bool HTTPClient::begin(WiFiClient& client, const String& url) {
+  if (g_net.failBegin || !parseUrl(url.str()).valid) return false;
+  client_ = &client;
+  url_ = url.str();
+  requestHeaders_.clear();
+  responseHeaders_.clear();
+  size_ = -1;
+  return true;
+}
+
+void HTTPClient::end() {
+  if (client_ && !(reuse_ && canReuse_)) client_->stop();
+  client_ = nullptr;
+  requestHeaders_.clear();
+}
+
+void HTTPClient::setAuthorization(const char* user, const char* password) {
+  addHeader("Authorization", ("Basic " + base64(std::string(user) + ":" + password)).c_str());
+}
+
+void HTTPClient::addHeader(const String& name, const String& value, bool first, bool replace) {
+  for (auto& header : requestHeaders_) {
+    if (lower(header.first) == lower(name.str())) {
+      if (replace) header.second = value.str();
+      return;
+    }
+  }
+  if (first) {
+    requestHeaders_.insert(requestHeaders_.begin(), {name.str(), value.str()});
+  } else {
+    requestHeaders_.push_back({name.str(), value.str()});
+  }
+}
+
+void HTTPClient::collectHeaders(const char* headerKeys[], const size_t count) {
+  collect_.clear();
+  for (size_t i = 0; i < count; i++) collect_.push_back(lower(headerKeys[i]));
+}
+
+String HTTPClient::header(const char* name) {
+  auto it = responseHeaders_.find(lower(name));
+  return it == responseHeaders_.end() ? String() : String(it->second);
+}
+
+bool HTTPClient::hasHeader(const char* name) {
+  return responseHeaders_.count(lower(name)) != 0;
+}
+
+int HTTPClient::GET() {
+  if (!client_) return HTTPC_ERROR_NOT_CONNECTED;
+  Url url = parseUrl(url_);
+  if (!(reuse_ && canReuse_ && client_->connected())) {
+    if (!client_->connect(url.host.c_str(), url.port)) return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  client_->setTimeout(timeoutMs_);
+
+  mock::HttpRequest request;
+  request.url = url_;
+  request.host = url.host;
+  request.port = url.port;
+  request.path = url.path;
+  request.secure = url.secure;
+  request.http10 = http10_;
+  request.headers["host"] = url.host;
+  for (const auto& header : requestHeaders_) request.headers[lower(header.first)] = header.second;
+  g_net.requests.push_back(request);
+  std::string head = "GET " + url.path + (http10_ ? " HTTP/1.0\r\n" : " HTTP/1.1\r\n");
+  client_->write(reinterpret_cast<const uint8_t*>(head.data()), head.size());
+
+  mock::HttpResponse response;
+  if (g_net.handler) {
+    response = g_net.handler(request);
+  } else {
+    response.code = 404;
+  }
+
+  responseHeaders_.clear();
+  if (response.code <= 0) {
+    client_->stop();
+    return response.code;
+  }
+  for (const auto& header : response.headers) {
+    std::string name = lower(header.first);
+    if (listed(collect_, name)) responseHeaders_[name] = header.second;
+  }
+  size_ = response.chunked ? -1 : (int)response.body.size();
+  canReuse_ = !http10_ && !response.close;
+
+  mock::Socket& socket = *client_->socket();
+  socket.rx = response.body;
+  socket.rxPos = 0;
+  socket.rxLimit = std::min(response.dropAfter, response.stallAfter);
+  socket.closeWhenDrained = response.dropAfter != std::string::npos ||
+                            (response.stallAfter == std::string::npos && !canReuse_);
+  return response.code;
+}
+
+String HTTPClient::errorToString(int error) {
+  switch (error) {
+    case HTTPC_ERROR_CONNECTION_FAILED: return "connection failed";
+    case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+    case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+    case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+    case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+    case HTTPC_ERROR_NO_STREAM: return "no stream";
+    case HTTPC_ERROR_NO_HTTP_SERVER: return "no HTTP server";
+    case HTTPC_ERROR_TOO_LESS_RAM: return "too less ram";
+    case HTTPC_ERROR_ENCODING: return "Transfer-Encoding not supported";
+    case HTTPC_ERROR_STREAM_WRITE: return "Stream write error";
+    case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+    default: return String();
+  }
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// LittleFS
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+struct File::State {
+  std::shared_ptr<mock::FsNode> node;
+  size_t pos = 0;
+  bool read = false;
+  bool write = false;
+};
+
+File::File(std::shared_ptr<mock::FsNode> node, bool read, bool write, bool append)
+    : state_(std::make_shared<State>()) {
+  state_->node = std::move(node);
+  state_->read = read;
+  state_->write = write;
+  state_->pos = append ? state_->node->data.size() : 0;
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!state_ || !state_->write) return 0;
+  std::string& data = state_->node->data;
+  size_t end = state_->pos + size;
+  if (end > data.size()) {
+    size_t grow = fileBlocks(end) - fileBlocks(data.size());
+    if (mock::fsUsed() + grow * g_fs.blockSize > g_fs.capacity) return 0;  // No space left
+    data.resize(end);
+  }
+  memcpy(&data[state_->pos], buffer, size);
+  state_->pos = end;
+  g_fs.bytesWritten += size;
+  g_fs.writes++;
+  spend(size, g_fs.usPerKiB);
+  if (g_fs.usPerWrite) mock::advanceUs(g_fs.usPerWrite);
+  return size;
+}
+
+int File::available() {
+  if (!state_ || !state_->read) return 0;
+  size_t size = state_->node->data.size();
+  return state_->pos < size ? (int)(size - state_->pos) : 0;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::read(uint8_t* buffer, size_t size) {
+  size_t n = std::min(size, (size_t)available());
+  if (n == 0) return -1;
+  memcpy(buffer, state_->node->data.data() + state_->pos, n);
+  state_->pos += n;
+  return (int)n;
+}
+
+int File::peek() {
+  if (available() == 0) return -1;
+  return (uint8_t)state_->node->data[state_->pos];
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!state_) return false;
+  size_t size = state_->node->data.size();
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? state_->pos : size;
+  if (base + pos > size) return false;
+  state_->pos = base + pos;
+  return true;
+}
+
+size_t File::position() const {
+  return state_ ? state_->pos : 0;
+}
+
+size_t File::size() const {
+  return state_ ? state_->node->data.size() : 0;
+}
+
+bool File::truncate(uint32_t size) {
+  if (!state_ || !state_->write) return false;
+  state_->node->data.resize(size);
+  if (state_->pos > size) state_->pos = size;
+  return true;
+}
+
+void File::close() {
+  state_.reset();
+}
+
+bool FS::begin() {
+  if (g_fs.mountFails) return false;
+  g_fs.mounted = true;
+  return true;
+}
+
+void FS::end() {
+  g_fs.mounted = false;
+}
+
+bool FS::format() {
+  g_fs.files.clear();
+  g_fs.mountFails = false;
+  return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+  if (!g_fs.mounted) return File();
+  auto it = g_fs.files.find(path);
+  bool plus = strchr(mode, '+') != nullptr;
+  switch (mode[0]) {
+    case 'r':
+      if (it == g_fs.files.end()) return File();
+      return File(it->second, true, plus, false);
+    case 'w': {
+      if (mock::fsUsed() + (it == g_fs.files.end() ? g_fs.blockSize : 0) > g_fs.capacity) return File();
+      auto node = std::make_shared<mock::FsNode>();
+      g_fs.files[path] = node;
+      return File(node, plus, true, false);
+    }
+    case 'a':
+      if (it == g_fs.files.end()) {
+        if (mock::fsUsed() + g_fs.blockSize > g_fs.capacity) return File();
+        it = g_fs.files.emplace(path, std::make_shared<mock::FsNode>()).first;
+      }
+      return File(it->second, plus, true, true);
+    default:
+      return File();
+  }
+}
+
+bool FS::exists(const char* path) {
+  return g_fs.mounted && g_fs.files.count(path) != 0;
+}
+
+bool FS::remove(const char* path) {
+  return g_fs.mounted && g_fs.files.erase(path) != 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  if (!g_fs.mounted) return false;
+  auto it = g_fs.files.find(from);
+  if (it == g_fs.files.end()) return false;
+  auto node = it->second;
+  g_fs.files.erase(it);
+  g_fs.files[to] = node;
+  return true;
+}
+
+bool FS::info(FSInfo& info) {
+  if (!g_fs.mounted) return false;
+  info.totalBytes = g_fs.capacity;
+  info.usedBytes = mock::fsUsed();
+  info.blockSize = g_fs.blockSize;
+  info.pageSize = 256;
+  info.maxOpenFiles = 5;
+  info.maxPathLength = 32;
+  return true;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// picoOTA and mDNS
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+void PicoOTA::begin() {
+  g_picoOta.queued.clear();
+}
+
+bool PicoOTA::addFile(const char* path, uint32_t, uint32_t, uint32_t) {
+  g_picoOta.queued.push_back(path);
+  return true;
+}
+
+// The bootloader's copy happens here rather than on the next boot; the
+// library reboots right after committing either way
+bool PicoOTA::commit() {
+  if (g_picoOta.failCommit || g_picoOta.queued.empty()) return false;
+  auto it = g_fs.files.find(g_picoOta.queued.back());
+  if (it == g_fs.files.end()) return false;
+  g_picoOta.commits++;
+  mock::setRunningImage(it->second->data);
+  return true;
+}
+
+void* MDNSResponder::addService(const char* service, const char* proto, uint16_t port) {
+  g_mdns.services.push_back(std::string(service) + "." + proto + ":" + std::to_string(port));
+  return this;
+}
+
+uint32_t MDNSResponder::queryService(const char*, const char*, uint16_t) {
+  return (uint32_t)g_mdns.peers.size();
+}
+
+IPAddress MDNSResponder::IP(uint32_t index) {
+  return index < g_mdns.peers.size() ? g_mdns.peers[index].ip : IPAddress();
+}
+
+uint16_t MDNSResponder::port(uint32_t index) {
+  return index < g_mdns.peers.size() ? g_mdns.peers[index].port : 0;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// WebServer
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+WebServer::WebServer(int port) : port_(port) {
+  g_server = this;
+}
+
+WebServer::~WebServer() {
+  if (g_server == this) g_server = nullptr;
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction upload) {
+  routes_.push_back({uri.str(), method, std::move(fn), std::move(upload)});
+}
+
+void WebServer::handleClient() {
+  if (g_webQueue.empty()) return;
+  std::shared_ptr<mock::WebRequest> request = g_webQueue.front();
+  g_webQueue.pop_front();
+  request_ = request;
+  client_ = WiFiClient(request->socket);
+  responseHeaders_.clear();
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+
+  const Route* match = nullptr;
+  for (const Route& route : routes_) {
+    if (route.uri == request->uri && (route.method == HTTP_ANY || route.method == request->method)) {
+      match = &route;
+      break;
+    }
+  }
+  if (match) {
+    if (match->upload && request->method == HTTP_POST) runUpload(*match);
+    match->fn();
+  } else if (notFound_) {
+    notFound_();
+  } else {
+    send(404, "text/plain", "Not found");
+  }
+
+  request->handled = true;
+  client_ = WiFiClient();
+  request_.reset();
+  // The server closes the connection unless the handler kept it
+  if (request->socket.use_count() == 1) request->socket->open = false;
+}
+
+void WebServer::runUpload(const Route& route) {
+  mock::WebRequest& request = *request_;
+  upload_.filename = request.filename.c_str();
+  upload_.name = "update";
+  upload_.type = "application/octet-stream";
+  upload_.totalSize = 0;
+  upload_.currentSize = 0;
+  upload_.status = UPLOAD_FILE_START;
+  route.upload();
+  for (const std::string& chunk : request.upload) {
+    for (size_t pos = 0; pos < chunk.size(); pos += HTTP_UPLOAD_BUFLEN) {
+      size_t len = std::min(chunk.size() - pos, (size_t)HTTP_UPLOAD_BUFLEN);
+      memcpy(upload_.buf, chunk.data() + pos, len);
+      upload_.currentSize = len;
+      upload_.status = UPLOAD_FILE_WRITE;
+      route.upload();
+      upload_.totalSize += len;
+    }
+  }
+  upload_.currentSize = 0;
+  upload_.status = request.abortUpload ? UPLOAD_FILE_ABORTED : UPLOAD_FILE_END;
+  route.upload();
+}
+
+bool WebServer::authenticate(const char* user, const char* password) {
+  return request_ && !request_->user.empty() && request_->user == user && request_->password == password;
+}
+
+void WebServer::requestAuthentication() {
+  sendHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
+  send(401);
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+  if (!request_) return;
+  request_->code = code;
+  request_->contentType = contentType ? contentType : "";
+  for (const auto& header : responseHeaders_) request_->responseHeaders[header.first] = header.second;
+  if (contentLength_ != CONTENT_LENGTH_NOT_SET && contentLength_ != CONTENT_LENGTH_UNKNOWN) {
+    request_->responseHeaders["Content-Length"] = std::to_string(contentLength_);
+  }
+  responseHeaders_.clear();
+  sendContent(content.c_str(), content.length());
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+  send(code, contentType, String(std::string(content, length)));
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool) {
+  responseHeaders_[name.str()] = value.str();
+}
+
+void WebServer::sendContent(const char* content, size_t length) {
+  if (length) client_.write(reinterpret_cast<const uint8_t*>(content), length);
+}
+
+void WebServer::collectHeaders(const char* headerKeys[], const size_t count) {
+  collect_.clear();
+  for (size_t i = 0; i < count; i++) collect_.push_back(lower(headerKeys[i]));
+}
+
+String WebServer::header(const char* name) {
+  std::string key = lower(name);
+  if (!request_ || !listed(collect_, key)) return String();
+  auto it = request_->headers.find(key);
+  return it == request_->headers.end() ? String() : String(it->second);
+}
+
+bool WebServer::hasHeader(const char* name) {
+  std::string key = lower(name);
+  return request_ && listed(collect_, key) && request_->headers.count(key) != 0;
+}
+
+String WebServer::arg(const char* name) {
+  if (!request_) return String();
+  auto it = request_->args.find(name);
+  return it == request_->args.end() ? String() : String(it->second);
+}
+
+bool WebServer::hasArg(const char* name) {
+  return request_ && request_->args.count(name) != 0;
+}
+
+size_t WebServer::clientContentLength() {
+  if (!request_) return 0;
+  size_t length = 0;
+  for (const std::string& chunk : request_->upload) length += chunk.size();
+  return length ? length + 192 : 0;  // Plus the multipart framing around the file
+}
+
+HTTPMethod WebServer::method() {
+  return request_ ? request_->method : HTTP_GET;
+}
+
+String WebServer::uri() {
+  return request_ ? String(request_->uri) : String();
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Control API
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+namespace mock {
+
+ClockState& clock() {
+  return g_clock;
+}
+
+uint64_t nowUs() {
+  return g_clock.real ? micros() : g_us.load();
+}
+
+void advanceUs(uint64_t us) {
+  g_us += us;
+}
+
+const std::string& serialLog() {
+  return g_serialLog;
+}
+
+void clearSerialLog() {
+  std::lock_guard<std::mutex> lock(g_serialMutex);
+  g_serialLog.clear();
+}
+
+bool logged(const std::string& text) {
+  std::lock_guard<std::mutex> lock(g_serialMutex);
+  return g_serialLog.find(text) != std::string::npos;
+}
+
+WifiState& wifi() {
+  return g_wifi;
+}
+
+std::string HttpRequest::header(const std::string& name) const {
+  auto it = headers.find(lower(name));
+  return it == headers.end() ? std::string() : it->second;
+}
+
+NetState& net() {
+  return g_net;
+}
+
+void onHttp(HttpHandler handler) {
+  g_net.handler = std::move(handler);
+}
+
+void setSketchArea(size_t bytes) {
+  g_mockFsStart = g_mockFlash + bytes;
+}
+
+size_t sketchArea() {
+  return (size_t)(g_mockFsStart - g_mockFlash);
+}
+
+void setRunningImage(const std::string& image) {
+  memcpy(g_mockFlash, image.data(), std::min(image.size(), kFlashSize));
+  g_mockFlashBinaryEnd = g_mockFlash + std::min(image.size(), kFlashSize);
+}
+
+std::string runningImage() {
+  return std::string(reinterpret_cast<const char*>(g_mockFlash), (size_t)(g_mockFlashBinaryEnd - g_mockFlash));
+}
+
+FsState& fs() {
+  return g_fs;
+}
+
+size_t fsUsed() {
+  size_t blocks = 2;  // Superblocks
+  for (const auto& file : g_fs.files) blocks += fileBlocks(file.second->data.size());
+  return blocks * g_fs.blockSize;
+}
+
+bool fsExists(const std::string& path) {
+  return g_fs.files.count(path) != 0;
+}
+
+std::string fsRead(const std::string& path) {
+  auto it = g_fs.files.find(path);
+  return it == g_fs.files.end() ? std::string() : it->second->data;
+}
+
+void fsWrite(const std::string& path, const std::string& data) {
+  auto node = std::make_shared<FsNode>();
+  node->data = data;
+  g_fs.files[path] = node;
+}
+
+PicoOtaState& picoOta() {
+  return g_picoOta;
+}
+
+MdnsState& mdns() {
+  return g_mdns;
+}
+
+std::shared_ptr<WebRequest> webRequest(const WebRequest& request) {
+  auto queued = std::make_shared<WebRequest>(request);
+  queued->socket = std::make_shared<Socket>();
+  queued->socket->host = "192.168.1.99";
+  g_webQueue.push_back(queued);
+  return queued;
+}
+
+WebServer* webServer() {
+  return g_server;
+}
+
+void rebootReset() {
+  ArduinoOTA = ArduinoOTAClass();
+  g_server = nullptr;
+  g_webQueue.clear();
+  g_wifi.connected = false;
+  g_mdns.services.clear();
+  g_fs.mounted = false;
+  g_picoOta.queued.clear();
+}
+
+void reset() {
+  rebootReset();
+  g_us = kBootUs;
+  g_clock = ClockState();
+  g_realStart = std::chrono::steady_clock::now();
+  clearSerialLog();
+  g_wifi = WifiState();
+  g_net = NetState();
+  g_fs = FsState();
+  g_picoOta = PicoOtaState();
+  g_mdns = MdnsState();
+  g_random = 0x2545F491;
+  memset(g_mockFlash, 0xFF, kFlashSize);
+  setSketchArea(1024 * 1024);
+  std::string image(16 * 1024, '\0');
+  for (size_t i = 0; i < image.size(); i++) image[i] = (char)(i * 131 + (i >> 8));
+  setRunningImage(image);
+}
+
+}  // namespace mock
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "device.h"
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "device_api.h"
+
+namespace device {
+
+static std::string g_modulePath = OTA_DEVICE_MODULE;
+static void* g_module = nullptr;
+static const OtaDeviceApi* g_api = nullptr;
+static void (*g_heap)(long*, long*, bool) = nullptr;
+static long g_earlierPeak = 0;  // Of firmware booted since resetHeapPeak()
+static unsigned g_boots = 0;
+static bool g_rebooted = false;
+
+// The dynamic loader keeps one instance per path, so every boot loads its
+// own copy of the module: nothing survives from the previous firmware.
+static void boot() {
+  if (g_module) {
+    long peak = 0;
+    g_heap(nullptr, &peak, false);
+    if (peak > g_earlierPeak) g_earlierPeak = peak;
+    g_api = nullptr;
+    dlclose(g_module);
+    g_module = nullptr;
+  }
+  char path[] = "/tmp/pico_ota_device_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) throw std::runtime_error("mkstemp failed");
+  close(fd);
+  {
+    std::ifstream in(g_modulePath, std::ios::binary);
+    if (!in) throw std::runtime_error("device module missing: " + g_modulePath);
+    std::ofstream out(path, std::ios::binary);
+    out << in.rdbuf();
+  }
+  g_module = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  unlink(path);
+  if (!g_module) throw std::runtime_error(std::string("dlopen failed: ") + dlerror());
+  auto entry = reinterpret_cast<const OtaDeviceApi* (*)()>(dlsym(g_module, "otaDeviceApi"));
+  if (!entry) throw std::runtime_error("otaDeviceApi missing from the device module");
+  g_api = entry();
+  g_heap = reinterpret_cast<void (*)(long*, long*, bool)>(dlsym(g_module, "otaDeviceHeap"));
+  g_boots++;
+}
+
+static const OtaDeviceApi* api() {
+  if (!g_api) throw std::runtime_error("no firmware booted");
+  return g_api;
+}
+
+void powerOn() {
+  powerOn(OTA_DEVICE_MODULE);
+}
+
+void powerOn(const char* module) {
+  g_modulePath = module;
+  mock::reset();
+  g_rebooted = false;
+  boot();
+  g_boots = 1;
+  g_earlierPeak = 0;
+}
+
+void reboot() {
+  mock::rebootReset();
+  g_rebooted = true;
+  boot();
+}
+
+unsigned boots() {
+  return g_boots;
+}
+
+bool rebooted() {
+  return g_rebooted;
+}
+
+void setup() {
+  otaSetup("test-ssid", "test-password", "pico-test", nullptr);
+}
+
+long heapInUse() {
+  long inUse = 0;
+  g_heap(&inUse, nullptr, false);
+  return inUse;
+}
+
+long heapPeak() {
+  long peak = 0;
+  g_heap(nullptr, &peak, false);
+  return peak > g_earlierPeak ? peak : g_earlierPeak;
+}
+
+void resetHeapPeak() {
+  g_earlierPeak = 0;
+  g_heap(nullptr, nullptr, true);
+}
+
+bool loopUntil(const std::function<bool()>& done, unsigned long ms) {
+  g_rebooted = false;
+  unsigned long startMs = millis();
+  bool finished = false;
+  run([&]() {
+    while (!(finished = done())) {
+      if (millis() - startMs >= ms) return;
+      otaLoop();
+      delay(1);
+    }
+  });
+  return finished;
+}
+
+}  // namespace device
+
+// The library's functions, forwarded to the firmware booted last
+#define OTA_DEVICE_ENTRY(ret, entry, name, params, args) \
+  ret name params {                                      \
+    return device::api()->entry args;                    \
+  }
+OTA_DEVICE_API(OTA_DEVICE_ENTRY)
+#undef OTA_DEVICE_ENTRY
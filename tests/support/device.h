@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// The simulated Pico W running a sketch built with the library. The
+// library is loaded as a module (dlopen) so a reboot can drop all of its
+// state, as on the board, while the flash and LittleFS (mock_board.h) keep
+// theirs. The library's functions (pico_ota.h) can be called directly and
+// go to the firmware booted last.
+
+#include <pico_ota.h>
+
+#include <functional>
+
+#include "../mocks/mock_board.h"
+
+namespace device {
+
+void powerOn();  // Fresh board (mock::reset()), then boot
+// The same, running another build of the library (a module path) until the
+// next powerOn(): pico_ota_config.h settings the benchmarks compare
+void powerOn(const char* module);
+void reboot();   // What rp2040.reboot() does on the board
+unsigned boots();
+
+// Runs fn; if the library reboots the board inside it, boots the next
+// firmware and returns true
+template <class Fn>
+bool run(Fn&& fn) {
+  try {
+    fn();
+    return false;
+  } catch (const mock::Reboot&) {
+    reboot();
+    return true;
+  }
+}
+
+// setup() of the test sketch: WiFi, ArduinoOTA and LittleFS
+void setup();
+
+// otaLoop() until done() holds (true) or ms of virtual time have passed.
+// A reboot inside ends the loop early (false, and rebooted() is set).
+bool loopUntil(const std::function<bool()>& done, unsigned long ms = 60000);
+bool rebooted();  // The board rebooted during the last loopUntil()
+
+// Heap the library holds (its operator new), now and at the most since
+// resetHeapPeak(), including firmware that ran before a reboot
+long heapInUse();
+long heapPeak();
+void resetHeapPeak();
+
+}  // namespace device
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// Built into the firmware module next to the library: hands the test
+// executable the library's functions (the module is loaded with dlopen)
+
+#include "device_api.h"
+
+#include <stdlib.h>
+
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+extern "C" const OtaDeviceApi* otaDeviceApi() {
+  static const OtaDeviceApi api = {
+#define OTA_DEVICE_ENTRY(ret, entry, name, params, args) static_cast<ret(*) params>(&name),
+      OTA_DEVICE_API(OTA_DEVICE_ENTRY)
+#undef OTA_DEVICE_ENTRY
+  };
+  return &api;
+}
+
+// Heap the library holds: what its own operator new handed out (the module
+// binds to the definitions below, see CMakeLists.txt) and it has not freed.
+// Blocks the board support allocated, e.g. a String returned by
+// HTTPClient::header(), are not counted.
+template <class T>
+struct MallocAllocator {
+  typedef T value_type;
+  MallocAllocator() {}
+  template <class U>
+  MallocAllocator(const MallocAllocator<U>&) {}
+  T* allocate(size_t n) { return static_cast<T*>(malloc(n * sizeof(T))); }
+  void deallocate(T* p, size_t) { free(p); }
+  bool operator==(const MallocAllocator&) const { return true; }
+  bool operator!=(const MallocAllocator&) const { return false; }
+};
+
+typedef std::unordered_map<void*, size_t, std::hash<void*>, std::equal_to<void*>,
+                           MallocAllocator<std::pair<void* const, size_t>>>
+    BlockMap;
+
+static std::mutex g_heapMutex;
+static BlockMap* g_blocks = nullptr;
+static long g_heapInUse = 0;
+static long g_heapPeak = 0;
+
+extern "C" void otaDeviceHeap(long* inUse, long* peak, bool resetPeak) {
+  std::lock_guard<std::mutex> lock(g_heapMutex);
+  if (resetPeak) g_heapPeak = g_heapInUse;
+  if (inUse) *inUse = g_heapInUse;
+  if (peak) *peak = g_heapPeak;
+}
+
+void* operator new(size_t size) {
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  std::lock_guard<std::mutex> lock(g_heapMutex);
+  if (!g_blocks) g_blocks = new (malloc(sizeof(BlockMap))) BlockMap();
+  (*g_blocks)[p] = size;
+  g_heapInUse += (long)size;
+  if (g_heapInUse > g_heapPeak) g_heapPeak = g_heapInUse;
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  if (!p) return;
+  {
+    std::lock_guard<std::mutex> lock(g_heapMutex);
+    auto it = g_blocks ? g_blocks->find(p) : BlockMap::iterator();
+    if (g_blocks && it != g_blocks->end()) {
+      g_heapInUse -= (long)it->second;
+      g_blocks->erase(it);
+    }
+  }
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  operator delete(p);
+}
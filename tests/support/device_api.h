@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// The public API of a loaded firmware (support/device.h). Each entry is
+// X(return type, table entry, function, parameters, arguments); overloads
+// get their own entry.
+
+#include <pico_ota.h>
+
+#define OTA_DEVICE_API(X)                                                                                     \
+  X(void, otaSetWifiTimeout, otaSetWifiTimeout, (unsigned long a), (a))                                       \
+  X(void, otaSetFsAutoFormat, otaSetFsAutoFormat, (bool a), (a))                                              \
+  X(void, otaSetAutoReconnect, otaSetAutoReconnect, (bool a), (a))                                            \
+  X(void, otaSetReconnectInterval, otaSetReconnectInterval, (unsigned long a), (a))                           \
+  X(void, otaSetReconnectMaxInterval, otaSetReconnectMaxInterval, (unsigned long a), (a))                     \
+  X(void, otaSetMaxReconnectAttempts, otaSetMaxReconnectAttempts, (int a), (a))                               \
+  X(void, otaOnWifiDisconnect, otaOnWifiDisconnect, (void (*a)()), (a))                                       \
+  X(void, otaOnWifiReconnect, otaOnWifiReconnect, (void (*a)()), (a))                                         \
+  X(void, otaOnStart, otaOnStart, (void (*a)()), (a))                                                         \
+  X(void, otaOnProgress, otaOnProgress, (void (*a)(unsigned int, unsigned int)), (a))                         \
+  X(void, otaOnEnd, otaOnEnd, (void (*a)()), (a))                                                             \
+  X(void, otaOnError, otaOnError, (void (*a)(int)), (a))                                                      \
+  X(void, otaSetup, otaSetup, (const char* a, const char* b, const char* c, const char* d), (a, b, c, d))     \
+  X(bool, otaSetupWithTimeout, otaSetupWithTimeout,                                                           \
+    (const char* a, const char* b, unsigned long c, const char* d, const char* e, bool f), (a, b, c, d, e, f)) \
+  X(bool, otaSetupAsync, otaSetupAsync, (const char* a, const char* b, const char* c, const char* d),         \
+    (a, b, c, d))                                                                                             \
+  X(void, otaLoop, otaLoop, (), ())                                                                           \
+  X(bool, otaIsConnected, otaIsConnected, (), ())                                                             \
+  X(bool, otaIsReady, otaIsReady, (), ())                                                                     \
+  X(OtaWifiState, otaGetWifiState, otaGetWifiState, (), ())                                                   \
+  X(void, otaGetHeapStats, otaGetHeapStats, (OtaHeapStats * a), (a))                                          \
+  X(void, otaResetHeapStats, otaResetHeapStats, (), ())                                                       \
+  X(void, otaGetTransferStatus, otaGetTransferStatus, (OtaTransferStatus * a), (a))                           \
+  X(void, otaOnProgressReport, otaOnProgressReport, (void (*a)(const OtaProgress*)), (a))                     \
+  X(void, otaSetProgressThrottle, otaSetProgressThrottle, (uint32_t a, uint32_t b), (a, b))                   \
+  X(void, otaGetStats, otaGetStats, (OtaStats * a), (a))                                                      \
+  X(void, otaResetStats, otaResetStats, (), ())                                                               \
+  X(int, otaUpdateFromUrl1, otaUpdateFromUrl, (const char* a), (a))                                           \
+  X(int, otaUpdateFromUrl2, otaUpdateFromUrl, (const char* a, const char* b), (a, b))                         \
+  X(int, otaUpdateFromUrl3, otaUpdateFromUrl, (const char* a, const char* b, const char* c), (a, b, c))       \
+  X(int, otaUpdateFromHost3, otaUpdateFromHost, (const char* a, uint16_t b, const char* c), (a, b, c))        \
+  X(int, otaUpdateFromHost4, otaUpdateFromHost, (const char* a, uint16_t b, const char* c, const char* d),    \
+    (a, b, c, d))                                                                                             \
+  X(void, otaSetDownloadChunkSize, otaSetDownloadChunkSize, (size_t a), (a))                                  \
+  X(void, otaSetDownloadRetries, otaSetDownloadRetries, (int a), (a))                                         \
+  X(void, otaClearPendingDownload, otaClearPendingDownload, (), ())                                           \
+  X(bool, otaBeginUpdate, otaBeginUpdate, (const char* a, const char* b, const char* c), (a, b, c))           \
+  X(int, otaUpdateStep, otaUpdateStep, (uint32_t a), (a))                                                     \
+  X(int, otaGetUpdateResult, otaGetUpdateResult, (), ())                                                      \
+  X(void, otaCancelUpdate, otaCancelUpdate, (), ())                                                           \
+  X(void, otaSetUpdateStepBudget, otaSetUpdateStepBudget, (uint32_t a), (a))                                  \
+  X(void, otaSetVersionPolicy, otaSetVersionPolicy, (OtaVersionPolicy a), (a))                                \
+  X(void, otaSetAllowPrerelease, otaSetAllowPrerelease, (bool a), (a))                                        \
+  X(void, otaSetMinimumVersion, otaSetMinimumVersion, (const char* a), (a))                                   \
+  X(void, otaSetDeltaUpdates, otaSetDeltaUpdates, (bool a), (a))                                              \
+  X(void, otaSetSigningKey, otaSetSigningKey, (const uint8_t* a), (a))                                        \
+  X(void, otaSetPeerSharing, otaSetPeerSharing, (bool a), (a))                                                \
+  X(void, otaSetPeerToken, otaSetPeerToken, (const char* a), (a))                                                \
+  X(void, otaGetTlsStats, otaGetTlsStats, (OtaTlsStats * a), (a))                                             \
+  X(void, otaResetTlsStats, otaResetTlsStats, (), ())                                                         \
+  X(void, otaStartWebServer, otaStartWebServer, (uint16_t a), (a))                                            \
+  X(void, otaStopWebServer, otaStopWebServer, (), ())                                                         \
+  X(void, otaSetWebCredentials, otaSetWebCredentials, (const char* a, const char* b), (a, b))                 \
+  X(bool, otaIsWebServerRunning, otaIsWebServerRunning, (), ())                                               \
+  X(void, otaSetCurrentVersion, otaSetCurrentVersion, (const char* a), (a))                                   \
+  X(void, otaSetGitHubRepo, otaSetGitHubRepo, (const char* a, const char* b), (a, b))                         \
+  X(void, otaSetGitHubAssetName, otaSetGitHubAssetName, (const char* a), (a))                                 \
+  X(void, otaSetGitHubDeltaAssetName, otaSetGitHubDeltaAssetName, (const char* a), (a))                       \
+  X(int, otaCheckGitHubUpdate, otaCheckGitHubUpdate, (char* a, size_t b), (a, b))                             \
+  X(int, otaUpdateFromGitHub, otaUpdateFromGitHub, (), ())                                                    \
+  X(const char*, otaGetLatestGitHubVersion, otaGetLatestGitHubVersion, (), ())                                \
+  X(unsigned long, otaGetGitHubRetryDelay, otaGetGitHubRetryDelay, (), ())                                    \
+  X(void, otaSetGitHubApiUrl, otaSetGitHubApiUrl, (const char* a), (a))                                       \
+  X(bool, otaAddUpdateSource, otaAddUpdateSource, (const char* a), (a))                                       \
+  X(bool, otaAddGitHubSource, otaAddGitHubSource, (), ())                                                     \
+  X(void, otaClearUpdateSources, otaClearUpdateSources, (), ())                                               \
+  X(int, otaUpdateFromSources, otaUpdateFromSources, (), ())                                                  \
+  X(bool, otaGetSourceProbe, otaGetSourceProbe, (size_t a, OtaSourceProbe * b), (a, b))                       \
+  X(void, otaSetBootGuard, otaSetBootGuard, (uint8_t a, unsigned long b), (a, b))                             \
+  X(void, otaMarkAppValid, otaMarkAppValid, (), ())                                                           \
+  X(OtaBootStatus, otaGetBootStatus, otaGetBootStatus, (), ())                                                \
+  X(void, otaSetUpdatePolicy, otaSetUpdatePolicy, (const OtaUpdatePolicy& a), (a))                            \
+  X(unsigned long, otaGetNextCheckDelay, otaGetNextCheckDelay, (), ())                                        \
+  X(bool, otaWorkerBegin, otaWorkerBegin, (), ())                                                             \
+  X(void, otaWorkerLoop, otaWorkerLoop, (), ())                                                               \
+  X(bool, otaRequestGitHubCheck, otaRequestGitHubCheck, (), ())                                               \
+  X(bool, otaRequestGitHubUpdate, otaRequestGitHubUpdate, (), ())                                             \
+  X(bool, otaRequestUpdateFromUrl, otaRequestUpdateFromUrl, (const char* a, const char* b), (a, b))           \
+  X(bool, otaPollEvent, otaPollEvent, (OtaEvent * a), (a))
+
+struct OtaDeviceApi {
+#define OTA_DEVICE_ENTRY(ret, entry, name, params, args) ret(*entry) params;
+  OTA_DEVICE_API(OTA_DEVICE_ENTRY)
+#undef OTA_DEVICE_ENTRY
+};
+
+extern "C" const OtaDeviceApi* otaDeviceApi();
+
+// Bytes the library holds on the heap now and at most since the last reset
+extern "C" void otaDeviceHeap(long* inUse, long* peak, bool resetPeak);
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "device.h"
+
+// Each test starts on a freshly powered board
+class DeviceTest : public ::testing::Test {
+ protected:
+  void SetUp() override { device::powerOn(); }
+};
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// The host tools in extras/, for tests that check the device code against
+// what they produce. Skipped when CMake found no Python 3.
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace extras {
+
+inline bool available() { return OTA_PYTHON[0] != '\0'; }
+
+// A directory for the files a tool reads and writes, removed afterwards
+class ScratchDir {
+ public:
+  ScratchDir() {
+    std::string pattern = (std::filesystem::temp_directory_path() / "ota-extras-XXXXXX").string();
+    if (!mkdtemp(pattern.data())) throw std::runtime_error("mkdtemp failed");
+    path_ = pattern;
+  }
+  ~ScratchDir() {
+    std::error_code ignored;
+    std::filesystem::remove_all(path_, ignored);
+  }
+  ScratchDir(const ScratchDir&) = delete;
+  ScratchDir& operator=(const ScratchDir&) = delete;
+
+  std::string path(const std::string& name) const { return (path_ / name).string(); }
+
+  std::string write(const std::string& name, const std::string& data) const {
+    std::ofstream out(path(name), std::ios::binary);
+    out << data;
+    return path(name);
+  }
+
+  std::string read(const std::string& name) const {
+    std::ifstream in(path(name), std::ios::binary);
+    if (!in) throw std::runtime_error("tool wrote no " + name);
+    std::ostringstream data;
+    data << in.rdbuf();
+    return data.str();
+  }
+
+ private:
+  std::filesystem::path path_;
+};
+
+// Run extras/<script> with args (quiet); returns its exit status
+inline int run(const std::string& script, const std::vector<std::string>& args) {
+  std::string command = std::string("'") + OTA_PYTHON + "' '" + OTA_EXTRAS + "/" + script + "'";
+  for (const std::string& arg : args) command += " '" + arg + "'";
+  command += " >/dev/null";
+  return std::system(command.c_str());
+}
+
+}  // namespace extras
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fixtures {
+
+// Contents of tests/fixtures/<name>
+inline std::string read(const std::string& name) {
+  std::ifstream in(std::string(OTA_TEST_FIXTURES) + "/" + name, std::ios::binary);
+  if (!in) throw std::runtime_error("missing fixture " + name);
+  std::ostringstream data;
+  data << in.rdbuf();
+  return data.str();
+}
+
+// Piece lengths that split size bytes at random points: runs of single
+// bytes, short pieces and long ones, as a slow or bursty connection
+// delivers them
+inline std::vector<size_t> randomSplit(size_t size, std::mt19937& rng) {
+  std::vector<size_t> pieces;
+  while (size > 0) {
+    size_t len;
+    switch (rng() % 4) {
+      case 0: len = 1; break;
+      case 1: len = 1 + rng() % 8; break;
+      case 2: len = 1 + rng() % 64; break;
+      default: len = 1 + rng() % 1500; break;
+    }
+    if (len > size) len = size;
+    pieces.push_back(len);
+    size -= len;
+  }
+  return pieces;
+}
+
+}  // namespace fixtures
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#include "images.h"
+
+#include <ota_sha256.h>
+
+#include <random>
+#include <vector>
+
+namespace images {
+
+static uint32_t crc32Mpeg2(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint32_t)data[i] << 24;
+    for (int bit = 0; bit < 8; bit++) crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+  }
+  return crc;
+}
+
+static void putLe32(std::string& s, size_t pos, uint32_t v) {
+  for (int i = 0; i < 4; i++) s[pos + i] = (char)(v >> (8 * i));
+}
+
+std::string rp2040(size_t size, uint32_t seed) {
+  std::string image(size < 512 ? 512 : size, '\0');
+  uint32_t x = seed * 2654435761u + 1;
+  for (char& c : image) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    c = (char)x;
+  }
+  putLe32(image, 252, crc32Mpeg2(reinterpret_cast<const uint8_t*>(image.data()), 252));
+  putLe32(image, 256, 0x20042000);  // Initial stack pointer: top of SRAM
+  putLe32(image, 260, 0x100001F7);  // Reset handler (Thumb) after the vector table
+  return image;
+}
+
+std::string codeLike(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  auto randomBytes = [&](size_t len) {
+    std::string bytes(len, '\0');
+    for (char& c : bytes) c = (char)rng();
+    return bytes;
+  };
+  std::vector<std::string> snippets;
+  for (int i = 0; i < 64; i++) snippets.push_back(randomBytes(4 + rng() % 29));
+
+  std::string image;
+  while (image.size() < size) {
+    switch (rng() % 8) {
+      case 0: image.append(8 + rng() % 56, '\0'); break;
+      case 1: image += randomBytes(4 + rng() % 13); break;
+      default: {
+        std::string snippet = snippets[rng() % snippets.size()];
+        if (rng() % 2) snippet[rng() % snippet.size()] = (char)rng();
+        image += snippet;
+      }
+    }
+  }
+  image.resize(size);
+  return image;
+}
+
+std::string sha256Hex(const std::string& data) {
+  OtaSha256 sha;
+  sha.update(data.data(), data.size());
+  uint8_t digest[OtaSha256::kDigestSize];
+  sha.finish(digest);
+  std::string hex;
+  char byte[3];
+  for (uint8_t b : digest) {
+    snprintf(byte, sizeof(byte), "%02x", b);
+    hex += byte;
+  }
+  return hex;
+}
+
+void FileServer::add(const std::string& path, const std::string& data, const std::string& version) {
+  Entry& entry = files[path];
+  entry.data = data;
+  entry.etag = "\"" + sha256Hex(data).substr(0, 16) + "\"";
+  entry.version = version;
+}
+
+mock::HttpResponse FileServer::operator()(const mock::HttpRequest& request) const {
+  mock::HttpResponse response;
+  response.close = close;
+  std::string path = request.path.substr(0, request.path.find('?'));
+  auto it = files.find(path);
+  if (it == files.end()) {
+    response.code = 404;
+    response.body = "Not found";
+    return response;
+  }
+  const Entry& entry = it->second;
+  if (!entry.version.empty() && request.header("x-ota-version") == entry.version) {
+    response.code = 304;
+    return response;
+  }
+  response.headers["ETag"] = entry.etag;
+  response.headers["Accept-Ranges"] = "bytes";
+  if (!entry.sha256.empty()) response.headers["X-Firmware-SHA256"] = entry.sha256;
+
+  std::string range = request.header("range");
+  std::string ifRange = request.header("if-range");
+  size_t first = 0;
+  size_t last = entry.data.size() - 1;
+  bool partial = ranges && range.rfind("bytes=", 0) == 0 && (ifRange.empty() || ifRange == entry.etag);
+  if (partial) {
+    first = strtoul(range.c_str() + 6, nullptr, 10);
+    size_t dash = range.find('-');
+    if (dash != std::string::npos && dash + 1 < range.size()) last = strtoul(range.c_str() + dash + 1, nullptr, 10);
+    if (last >= entry.data.size()) last = entry.data.size() - 1;
+    if (first > last) {
+      response.code = 416;
+      response.headers["Content-Range"] = "bytes */" + std::to_string(entry.data.size());
+      return response;
+    }
+    response.code = 206;
+    response.headers["Content-Range"] =
+        "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(entry.data.size());
+  }
+  response.body = entry.data.substr(first, last - first + 1);
+  return response;
+}
+
+}  // namespace images
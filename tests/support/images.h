@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+#pragma once
+
+// Firmware images and an HTTP server for them, for the simulated network
+
+#include <map>
+#include <string>
+
+#include "../mocks/mock_board.h"
+
+namespace images {
+
+// An RP2040 image the pre-flight check accepts (boot2 with its CRC, then a
+// vector table into the sketch area), size bytes of content from seed
+std::string rp2040(size_t size, uint32_t seed = 1);
+
+// Compresses about like a real sketch: short instruction sequences that
+// recur with small changes, constants and zero padding
+std::string codeLike(size_t size, uint32_t seed = 1);
+
+std::string sha256Hex(const std::string& data);
+
+// Serves files like a static web server or CDN: Range (206 with
+// Content-Range), ETag and If-Range, and 304 for x-ota-version when the
+// file is marked as that version.
+struct FileServer {
+  struct Entry {
+    std::string data;
+    std::string etag;
+    std::string version;   // 304 when the request's x-ota-version matches
+    std::string sha256;    // X-Firmware-SHA256, if set
+  };
+
+  std::map<std::string, Entry> files;  // By path
+  bool ranges = true;                   // false: ignore Range, always 200
+  bool close = false;                   // Connection: close on every response
+
+  void add(const std::string& path, const std::string& data, const std::string& version = "");
+  mock::HttpResponse operator()(const mock::HttpRequest& request) const;
+};
+
+}  // namespace images
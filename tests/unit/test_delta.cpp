@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// OtaDeltaPatcher: patches made by extras/ota_delta.py rebuild the target
+// however the network splits them, and damaged patches fail with the
+// right error before writing past the target
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "extras.h"
+#include "fixtures.h"
+#include "ota_crc32.h"
+#include "ota_delta.h"
+
+namespace {
+
+// Running image on one side, rebuilt image on the other
+struct Device {
+  explicit Device(std::string running) : source(std::move(running)) {}
+
+  std::string source;
+  std::string target;
+  bool failRead = false;
+  bool failWrite = false;
+
+  static bool read(uint32_t offset, uint8_t* buf, size_t len, void* context) {
+    Device* device = static_cast<Device*>(context);
+    if (device->failRead || offset > device->source.size() || len > device->source.size() - offset) {
+      return false;
+    }
+    memcpy(buf, device->source.data() + offset, len);
+    return true;
+  }
+
+  static bool write(const uint8_t* data, size_t len, void* context) {
+    Device* device = static_cast<Device*>(context);
+    if (device->failWrite) return false;
+    device->target.append(reinterpret_cast<const char*>(data), len);
+    return true;
+  }
+};
+
+bool apply(OtaDeltaPatcher& patcher, Device& device, const std::string& patch,
+           const std::vector<size_t>& pieces) {
+  patcher.begin(Device::read, Device::write, &device);
+  size_t pos = 0;
+  for (size_t len : pieces) {
+    if (!patcher.feed(reinterpret_cast<const uint8_t*>(patch.data()) + pos, len)) return false;
+    pos += len;
+  }
+  return true;
+}
+
+bool apply(OtaDeltaPatcher& patcher, Device& device, const std::string& patch) {
+  return apply(patcher, device, patch, {patch.size()});
+}
+
+uint32_t crc(const std::string& data) {
+  return otaCrc32(0, data.data(), data.size());
+}
+
+// ━━━ Round trip with extras/ota_delta.py ━━━
+
+std::string randomBytes(size_t size, std::mt19937& rng) {
+  std::string data(size, '\0');
+  for (char& c : data) c = static_cast<char>(rng());
+  return data;
+}
+
+// What a rebuild with a small code change looks like: code inserted near
+// the start, everything after it moved, and the pointers into the moved
+// part fixed up in scattered words
+std::string relocated(const std::string& old, std::mt19937& rng) {
+  std::string image = old;
+  image.insert(old.size() / 3, randomBytes(300, rng));
+  for (size_t pos = old.size() / 3 + 300; pos + 4 <= image.size(); pos += 64 + rng() % 64) {
+    image[pos] = static_cast<char>(image[pos] + 0x2C);
+    image[pos + 1] = static_cast<char>(image[pos + 1] + 1);
+  }
+  image.erase(image.size() * 3 / 4, 200);
+  return image + randomBytes(100, rng);
+}
+
+struct Pair {
+  const char* name;
+  std::string source;
+  std::string target;
+};
+
+std::vector<Pair> pairs() {
+  std::mt19937 rng(7);
+  std::string old = randomBytes(48 * 1024, rng);
+  return {
+      {"identical", old, old},
+      {"relocated", old, relocated(old, rng)},
+      {"unrelated", old, randomBytes(20 * 1024, rng)},
+      {"shrunk", old, old.substr(0, old.size() / 2)},
+      {"empty target", old, ""},
+  };
+}
+
+TEST(DeltaRoundTrip, PatchesFromTheHostToolRebuildTheTarget) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  for (const Pair& pair : pairs()) {
+    SCOPED_TRACE(pair.name);
+    extras::ScratchDir dir;
+    ASSERT_EQ(extras::run("ota_delta.py", {"diff", dir.write("old.bin", pair.source),
+                                           dir.write("new.bin", pair.target), dir.path("patch.otad")}),
+              0);
+    std::string patch = dir.read("patch.otad");
+
+    OtaDeltaPatcher patcher;
+    Device whole{pair.source};
+    ASSERT_TRUE(apply(patcher, whole, patch)) << patcher.error();
+    EXPECT_TRUE(patcher.done());
+    EXPECT_EQ(whole.target, pair.target);
+
+    for (uint32_t seed = 0; seed < 50; seed++) {
+      std::mt19937 rng(seed);
+      Device device{pair.source};
+      ASSERT_TRUE(apply(patcher, device, patch, fixtures::randomSplit(patch.size(), rng)))
+          << "seed " << seed << ": error " << patcher.error();
+      ASSERT_TRUE(patcher.done()) << "seed " << seed;
+      ASSERT_EQ(device.target, pair.target) << "seed " << seed;
+    }
+  }
+}
+
+TEST(DeltaRoundTrip, SmallChangeMakesASmallPatch) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  std::vector<Pair> all = pairs();
+  const Pair& pair = all[1];
+  extras::ScratchDir dir;
+  ASSERT_EQ(extras::run("ota_delta.py", {"diff", dir.write("old.bin", pair.source),
+                                         dir.write("new.bin", pair.target), dir.path("patch.otad")}),
+            0);
+  EXPECT_LT(dir.read("patch.otad").size(), pair.target.size() / 4);
+}
+
+// ━━━ Damaged patches ━━━
+
+// Hand-made patches, so each case breaks exactly one thing
+struct Patch {
+  std::string bytes;
+
+  Patch(const std::string& source, uint32_t targetSize, uint32_t targetCrc, uint8_t version = 1) {
+    bytes = std::string("OTAD") + static_cast<char>(version) + std::string(3, '\0');
+    le32(source.size());
+    le32(crc(source));
+    le32(targetSize);
+    le32(targetCrc);
+  }
+  Patch(const std::string& source, const std::string& target) : Patch(source, target.size(), crc(target)) {}
+
+  void le32(uint32_t value) {
+    for (int i = 0; i < 4; i++) bytes += static_cast<char>(value >> (8 * i));
+  }
+  Patch& varint(uint32_t value) {
+    do {
+      uint8_t byte = value & 0x7F;
+      value >>= 7;
+      bytes += static_cast<char>(value ? (byte | 0x80) : byte);
+    } while (value);
+    return *this;
+  }
+  Patch& seek(int32_t offset) {
+    return varint(offset >= 0 ? (uint32_t)offset << 1 : ((uint32_t)-offset << 1) - 1);
+  }
+  Patch& raw(const std::string& data) {
+    bytes += data;
+    return *this;
+  }
+};
+
+const std::string kSource = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// "2345" copied, "6789" with each byte + 1, then "!!" and a seek back to the start
+Patch validPatch() {
+  Patch patch(kSource, "2345789:!!01");
+  patch.varint(0).varint(0).seek(2);               // Record 1: skip to '2'
+  patch.varint(8).varint(2).seek(-10);             // Record 2: 8 diff bytes, 2 extra, back to '0'
+  patch.varint(4).varint(4).raw(std::string(4, '\x01')).raw("!!");
+  patch.varint(2).varint(0).seek(0).varint(2).varint(0);  // Record 3: "01"
+  return patch;
+}
+
+OtaDeltaError applyError(const Patch& patch, Device& device) {
+  OtaDeltaPatcher patcher;
+  EXPECT_FALSE(apply(patcher, device, patch.bytes));
+  return patcher.error();
+}
+
+OtaDeltaError applyError(const Patch& patch) {
+  Device device{kSource};
+  return applyError(patch, device);
+}
+
+TEST(DeltaPatch, HandMadePatchApplies) {
+  Device device{kSource};
+  OtaDeltaPatcher patcher;
+  ASSERT_TRUE(apply(patcher, device, validPatch().bytes)) << patcher.error();
+  EXPECT_TRUE(patcher.done());
+  EXPECT_EQ(device.target, "2345789:!!01");
+  EXPECT_EQ(patcher.produced(), 12u);
+}
+
+TEST(DeltaPatch, HeaderIsChecked) {
+  Patch badVersion(kSource, 0, 0, 2);
+  EXPECT_EQ(applyError(badVersion), OTA_DELTA_ERR_HEADER);
+
+  Patch badMagic = validPatch();
+  badMagic.bytes[3] = 'Z';
+  EXPECT_EQ(applyError(badMagic), OTA_DELTA_ERR_HEADER);
+  EXPECT_FALSE(OtaDeltaPatcher::isPatch(reinterpret_cast<const uint8_t*>(badMagic.bytes.data()), 4));
+}
+
+TEST(DeltaPatch, OtherSourceIsRefusedBeforeAnyOutput) {
+  Device device{kSource};
+  device.source[20] ^= 1;
+  EXPECT_EQ(applyError(validPatch(), device), OTA_DELTA_ERR_SOURCE_MISMATCH);
+  EXPECT_TRUE(device.target.empty());
+
+  Device shorter{kSource.substr(0, 30)};
+  EXPECT_EQ(applyError(validPatch(), shorter), OTA_DELTA_ERR_READ);
+}
+
+TEST(DeltaPatch, OverlongVarintIsCorrupt) {
+  Patch patch(kSource, "x");
+  patch.raw(std::string(5, '\x80')).raw("\x01");
+  EXPECT_EQ(applyError(patch), OTA_DELTA_ERR_CORRUPT);
+
+  // The same bytes one at a time
+  Device device{kSource};
+  OtaDeltaPatcher patcher;
+  EXPECT_FALSE(apply(patcher, device, patch.bytes, std::vector<size_t>(patch.bytes.size(), 1)));
+  EXPECT_EQ(patcher.error(), OTA_DELTA_ERR_CORRUPT);
+}
+
+TEST(DeltaPatch, SeekOutsideTheSourceIsCorrupt) {
+  Patch before(kSource, "x");
+  before.varint(0).varint(1).seek(-1);
+  EXPECT_EQ(applyError(before), OTA_DELTA_ERR_CORRUPT);
+
+  Patch past(kSource, "x");
+  past.varint(0).varint(1).seek((int32_t)kSource.size() + 1);
+  EXPECT_EQ(applyError(past), OTA_DELTA_ERR_CORRUPT);
+
+  // Diff run plus seek lands past the end
+  Patch runPast(kSource, "x");
+  runPast.varint(30).varint(0).seek(10);
+  EXPECT_EQ(applyError(runPast), OTA_DELTA_ERR_CORRUPT);
+}
+
+TEST(DeltaPatch, RunsLongerThanTheirBoundsAreCorrupt) {
+  Patch diffPastSource(kSource, "x");
+  diffPastSource.varint((uint32_t)kSource.size() + 1);
+  EXPECT_EQ(applyError(diffPastSource), OTA_DELTA_ERR_CORRUPT);
+
+  Patch copyPastDiff(kSource, "0123");
+  copyPastDiff.varint(2).varint(0).seek(0).varint(3);
+  EXPECT_EQ(applyError(copyPastDiff), OTA_DELTA_ERR_CORRUPT);
+
+  Patch addPastDiff(kSource, "0123");
+  addPastDiff.varint(2).varint(0).seek(0).varint(0).varint(3);
+  EXPECT_EQ(applyError(addPastDiff), OTA_DELTA_ERR_CORRUPT);
+
+  Patch pastTarget(kSource, "xy");
+  pastTarget.varint(0).varint(3).seek(0).raw("xyz");
+  EXPECT_EQ(applyError(pastTarget), OTA_DELTA_ERR_CORRUPT);
+}
+
+TEST(DeltaPatch, TrailingBytesAreCorrupt) {
+  Patch patch = validPatch();
+  patch.raw(std::string(1, '\0'));
+  EXPECT_EQ(applyError(patch), OTA_DELTA_ERR_CORRUPT);
+}
+
+TEST(DeltaPatch, WrongTargetCrcFailsAtTheEnd) {
+  Patch patch(kSource, "2345789:!!01");
+  std::string body = validPatch().bytes.substr(OtaDeltaPatcher::kHeaderSize);
+  patch.bytes.replace(20, 4, std::string(4, '\0'));
+  patch.raw(body);
+
+  Device device{kSource};
+  EXPECT_EQ(applyError(patch, device), OTA_DELTA_ERR_TARGET_CRC);
+  EXPECT_EQ(device.target, "2345789:!!01");
+}
+
+TEST(DeltaPatch, CallbackFailuresAreReported) {
+  Device readFails{kSource};
+  readFails.failRead = true;
+  EXPECT_EQ(applyError(validPatch(), readFails), OTA_DELTA_ERR_READ);
+
+  Device writeFails{kSource};
+  writeFails.failWrite = true;
+  EXPECT_EQ(applyError(validPatch(), writeFails), OTA_DELTA_ERR_WRITE);
+}
+
+TEST(DeltaPatch, TruncatedPatchIsIncompleteNotFailed) {
+  std::string bytes = validPatch().bytes;
+  for (size_t len = 0; len < bytes.size(); len++) {
+    Device device{kSource};
+    OtaDeltaPatcher patcher;
+    EXPECT_TRUE(apply(patcher, device, bytes.substr(0, len))) << len;
+    EXPECT_FALSE(patcher.done()) << len;
+    EXPECT_EQ(patcher.error(), OTA_DELTA_ERR_NONE) << len;
+  }
+}
+
+}  // namespace
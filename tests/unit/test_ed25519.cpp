@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// otaEd25519Verify against RFC 8032 section 7.1 and a long message signed
+// by extras/ota_sign.py; every altered signature, key or message fails
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ota_ed25519.h"
+
+namespace {
+
+std::vector<uint8_t> unhex(const std::string& hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) bytes.push_back((uint8_t)std::stoul(hex.substr(i, 2), nullptr, 16));
+  return bytes;
+}
+
+struct Vector {
+  std::vector<uint8_t> publicKey;
+  std::vector<uint8_t> message;
+  std::vector<uint8_t> signature;
+};
+
+bool verify(const Vector& v) {
+  return otaEd25519Verify(v.signature.data(), v.message.data(), v.message.size(), v.publicKey.data());
+}
+
+// RFC 8032 section 7.1, tests 1-3 (same as extras/ota_sign.py selftest)
+std::vector<Vector> rfc8032() {
+  return {
+      {unhex("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a"), {},
+       unhex("e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555"
+             "fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b")},
+      {unhex("3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c"), unhex("72"),
+       unhex("92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+             "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00")},
+      {unhex("fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025"), unhex("af82"),
+       unhex("6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+             "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a")},
+  };
+}
+
+// 1023 bytes (i * 7 mod 251) signed by ota_sign.py with the key of RFC
+// 8032 "TEST 1024": several SHA-512 blocks of message
+Vector longMessage() {
+  Vector v;
+  v.publicKey = unhex("278117fc144c72340f67d0f2316e8386ceffbf2b2428c9c51fef7c597f1d426e");
+  for (int i = 0; i < 1023; i++) v.message.push_back((uint8_t)(i * 7 % 251));
+  v.signature = unhex("628a31092ae2840d0790567ca48a00525a33d1f320a4b8a95fee83c233c2928f"
+                      "48e385be57e4ccaed3f87f957801ed7bcc622cc1d927d24f742c3aa6d2a34e07");
+  return v;
+}
+
+TEST(Ed25519, Rfc8032Vectors) {
+  for (const Vector& v : rfc8032()) {
+    EXPECT_TRUE(verify(v)) << v.message.size() << "-byte message";
+  }
+}
+
+TEST(Ed25519, LongMessageFromTheSigningTool) {
+  EXPECT_TRUE(verify(longMessage()));
+}
+
+TEST(Ed25519, AnyFlippedSignatureBitFails) {
+  std::vector<Vector> vectors = rfc8032();
+  vectors.push_back(longMessage());
+  for (const Vector& v : vectors) {
+    for (size_t bit = 0; bit < v.signature.size() * 8; bit++) {
+      Vector altered = v;
+      altered.signature[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+      ASSERT_FALSE(verify(altered)) << "bit " << bit;
+    }
+  }
+}
+
+TEST(Ed25519, AlteredMessageFails) {
+  for (Vector v : rfc8032()) {
+    v.message.push_back('x');
+    EXPECT_FALSE(verify(v));
+  }
+  Vector v = longMessage();
+  v.message[500] ^= 1;
+  EXPECT_FALSE(verify(v));
+}
+
+TEST(Ed25519, OtherKeyFails) {
+  std::vector<Vector> vectors = rfc8032();
+  Vector v = vectors[1];
+  v.publicKey = vectors[2].publicKey;
+  EXPECT_FALSE(verify(v));
+}
+
+// RFC 8032 5.1.7: S must be below the group order L, or one signature
+// would have a second valid encoding S + L
+TEST(Ed25519, NonCanonicalScalarFails) {
+  static const uint8_t kOrder[32] = {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+                                     0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+  Vector v = rfc8032()[0];
+  unsigned carry = 0;
+  for (int i = 0; i < 32; i++) {
+    unsigned sum = v.signature[32 + i] + kOrder[i] + carry;
+    v.signature[32 + i] = (uint8_t)sum;
+    carry = sum >> 8;
+  }
+  ASSERT_EQ(carry, 0u);
+  EXPECT_FALSE(verify(v));
+}
+
+TEST(Ed25519, KeysOffTheCurveFail) {
+  Vector v = rfc8032()[0];
+  v.publicKey.assign(32, 0);
+  v.publicKey[0] = 2;  // y = 2 has no x on the curve
+  EXPECT_FALSE(verify(v));
+
+  // y = p, a non-canonical encoding of y = 0
+  v.publicKey.assign(32, 0xff);
+  v.publicKey[0] = 0xed;
+  v.publicKey[31] = 0x7f;
+  EXPECT_FALSE(verify(v));
+}
+
+}  // namespace
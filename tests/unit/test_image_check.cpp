@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// otaImageCheck against the header corpus of extras/ota_image_check.py:
+// every header on every board gives the result the corpus expects, the
+// same one the Python selftest checks its own implementation against
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "extras.h"
+#include "ota_image_check.h"
+
+namespace {
+
+const size_t kWindow = 512;  // OTA_IMAGE_CHECK_BYTES, WINDOW in the tool
+const uint32_t kMB = 1024 * 1024;
+
+// BOARDS in the tool: default partition schemes
+const std::map<std::string, OtaImageTarget> kBoards = {
+    {"picow", {OTA_IMAGE_KIND_RP2040, 0, 0, 0, 1 * kMB}},
+    {"pico2w", {OTA_IMAGE_KIND_RP2350, 0, 0, 0, 2 * kMB}},
+    {"esp32", {OTA_IMAGE_KIND_ESP, 0x0000, 301, 4 * kMB, 0x140000}},
+    {"esp32s3", {OTA_IMAGE_KIND_ESP, 0x0009, 2, 8 * kMB, 0x300000}},
+    {"esp32c3", {OTA_IMAGE_KIND_ESP, 0x0005, 4, 4 * kMB, 0x140000}},
+};
+
+const char* resultName(OtaImageCheckError error) {
+  switch (error) {
+    case OTA_IMAGE_CHECK_OK: return "ok";
+    case OTA_IMAGE_CHECK_ERR_FORMAT: return "format";
+    case OTA_IMAGE_CHECK_ERR_CHIP: return "chip";
+    case OTA_IMAGE_CHECK_ERR_REVISION: return "revision";
+    case OTA_IMAGE_CHECK_ERR_FLASH: return "flash";
+    case OTA_IMAGE_CHECK_ERR_SIZE: return "size";
+  }
+  return "?";
+}
+
+TEST(ImageCheck, CorpusGivesTheExpectedResultOnEveryBoard) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+  extras::ScratchDir dir;
+  ASSERT_EQ(extras::run("ota_image_check.py", {"corpus", dir.path("corpus")}), 0);
+
+  // "# name image_size <board>...", then a line per header
+  std::istringstream expected(dir.read("corpus/expected.txt"));
+  std::string line;
+  ASSERT_TRUE(std::getline(expected, line));
+  std::istringstream columns(line.substr(1));
+  std::string column;
+  columns >> column >> column;
+  std::vector<std::string> boards;
+  while (columns >> column) {
+    ASSERT_EQ(kBoards.count(column), 1u) << "board " << column << " missing here";
+    boards.push_back(column);
+  }
+  ASSERT_EQ(boards.size(), kBoards.size());
+
+  size_t headers = 0;
+  while (std::getline(expected, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    uint32_t imageSize = 0;
+    fields >> name >> imageSize;
+    std::string data = dir.read("corpus/" + name + ".bin").substr(0, kWindow);
+    for (const std::string& board : boards) {
+      std::string want;
+      fields >> want;
+      OtaImageInfo info;
+      OtaImageCheckError got = otaImageCheck(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                                             imageSize, kBoards.at(board), &info);
+      EXPECT_EQ(resultName(got), want) << name << " on " << board;
+      if (got == OTA_IMAGE_CHECK_OK) {
+        EXPECT_EQ(info.kind, kBoards.at(board).kind) << name;
+      }
+    }
+    headers++;
+  }
+  EXPECT_GE(headers, 30u);
+}
+
+}  // namespace
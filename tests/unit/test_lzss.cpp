@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// OtaLzssDecoder: files made by extras/ota_compress.py decode to the input
+// for every window / lookahead the device accepts, however the network
+// splits them, and damaged streams fail instead of producing output
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "extras.h"
+#include "fixtures.h"
+#include "images.h"
+#include "ota_lzss.h"
+
+namespace {
+
+struct Sink {
+  std::string out;
+  bool fail = false;
+
+  static bool write(const uint8_t* data, size_t len, void* context) {
+    Sink* sink = static_cast<Sink*>(context);
+    if (sink->fail) return false;
+    sink->out.append(reinterpret_cast<const char*>(data), len);
+    return true;
+  }
+};
+
+bool decode(OtaLzssDecoder& decoder, const std::string& input, const std::vector<size_t>& pieces) {
+  size_t pos = 0;
+  for (size_t len : pieces) {
+    if (!decoder.feed(reinterpret_cast<const uint8_t*>(input.data()) + pos, len)) return false;
+    pos += len;
+  }
+  return decoder.finish();
+}
+
+bool decode(OtaLzssDecoder& decoder, const std::string& input) {
+  return decode(decoder, input, {input.size()});
+}
+
+// Compressed with ota_compress.py -w windowBits -l lookaheadBits
+std::string compress(const std::string& data, int windowBits, int lookaheadBits) {
+  extras::ScratchDir dir;
+  int status = extras::run("ota_compress.py", {"compress", dir.write("in.bin", data), dir.path("out.otaz"),
+                                               "-w", std::to_string(windowBits), "-l",
+                                               std::to_string(lookaheadBits)});
+  if (status != 0) return "";
+  return dir.read("out.otaz");
+}
+
+// ━━━ Round trip with extras/ota_compress.py ━━━
+
+struct Input {
+  const char* name;
+  std::string data;
+};
+
+std::vector<Input> inputs() {
+  std::mt19937 rng(3);
+  std::string random(8 * 1024, '\0');
+  for (char& c : random) c = static_cast<char>(rng());
+  std::string text;
+  while (text.size() < 8 * 1024) text += "[OTA] Downloading chunk " + std::to_string(text.size() % 977) + "\n";
+  return {
+      {"empty", ""},
+      {"one byte", "x"},
+      {"code", images::codeLike(24 * 1024)},
+      {"text", text},
+      {"zeros", std::string(8 * 1024, '\0')},
+      {"random", random},
+  };
+}
+
+void expectRoundTrip(const std::string& data, int windowBits, int lookaheadBits) {
+  std::string blob = compress(data, windowBits, lookaheadBits);
+  ASSERT_FALSE(blob.empty());
+
+  OtaLzssDecoder decoder;
+  Sink whole;
+  decoder.begin(Sink::write, &whole);
+  ASSERT_TRUE(decode(decoder, blob)) << decoder.error();
+  EXPECT_TRUE(decoder.done());
+  EXPECT_EQ(decoder.outputSize(), data.size());
+  ASSERT_EQ(whole.out, data);
+
+  for (uint32_t seed = 0; seed < 20; seed++) {
+    std::mt19937 rng(seed);
+    Sink sink;
+    decoder.begin(Sink::write, &sink);
+    ASSERT_TRUE(decode(decoder, blob, fixtures::randomSplit(blob.size(), rng)))
+        << "seed " << seed << ": error " << decoder.error();
+    ASSERT_EQ(sink.out, data) << "seed " << seed;
+  }
+}
+
+TEST(LzssRoundTrip, InputsDecodeWithTheDefaultParameters) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  for (const Input& input : inputs()) {
+    SCOPED_TRACE(input.name);
+    expectRoundTrip(input.data, 12, 4);
+  }
+}
+
+TEST(LzssRoundTrip, EveryWindowTheDeviceAccepts) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  std::string code = images::codeLike(16 * 1024, 9);
+  const int params[][2] = {{4, 3}, {8, 4}, {10, 6}, {11, 4}, {OTA_LZSS_MAX_WINDOW_BITS, 8}};
+  for (const auto& p : params) {
+    SCOPED_TRACE("w " + std::to_string(p[0]) + " l " + std::to_string(p[1]));
+    expectRoundTrip(code, p[0], p[1]);
+  }
+}
+
+TEST(LzssRoundTrip, CodeShrinksByAtLeastAThird) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  std::string code = images::codeLike(24 * 1024);
+  EXPECT_LT(compress(code, 12, 4).size(), code.size() * 2 / 3);
+}
+
+// The same bit stream without the header, as sent with
+// "Content-Encoding: heatshrink"
+TEST(LzssRoundTrip, BareStreamDecodesToTheEndOfInput) {
+  if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+
+  std::string code = images::codeLike(16 * 1024, 5);
+  std::string blob = compress(code, OtaLzssDecoder::kDefaultWindowBits, OtaLzssDecoder::kDefaultLookaheadBits);
+  ASSERT_FALSE(blob.empty());
+  std::string bare = blob.substr(OtaLzssDecoder::kHeaderSize);
+
+  for (uint32_t seed = 0; seed < 20; seed++) {
+    std::mt19937 rng(seed);
+    OtaLzssDecoder decoder;
+    Sink sink;
+    ASSERT_TRUE(decoder.beginRaw(OtaLzssDecoder::kDefaultWindowBits, OtaLzssDecoder::kDefaultLookaheadBits,
+                                 Sink::write, &sink));
+    ASSERT_TRUE(decode(decoder, bare, fixtures::randomSplit(bare.size(), rng))) << decoder.error();
+    EXPECT_FALSE(decoder.sizeKnown());
+    ASSERT_EQ(sink.out, code) << "seed " << seed;
+  }
+}
+
+// ━━━ Damaged streams ━━━
+
+class LzssDamage : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!extras::available()) GTEST_SKIP() << "Python 3 not found";
+    data = images::codeLike(4 * 1024, 2);
+    blob = compress(data, 10, 4);
+    ASSERT_FALSE(blob.empty());
+  }
+
+  OtaLzssError error(const std::string& input) {
+    OtaLzssDecoder decoder;
+    decoder.begin(Sink::write, &sink);
+    EXPECT_FALSE(decode(decoder, input));
+    return decoder.error();
+  }
+
+  std::string data;
+  std::string blob;
+  Sink sink;
+};
+
+TEST_F(LzssDamage, HeaderIsChecked) {
+  std::string badMagic = blob;
+  badMagic[0] = 'X';
+  EXPECT_EQ(error(badMagic), OTA_LZSS_ERR_HEADER);
+
+  std::string badVersion = blob;
+  badVersion[4] = 2;
+  EXPECT_EQ(error(badVersion), OTA_LZSS_ERR_HEADER);
+  EXPECT_TRUE(sink.out.empty());
+}
+
+TEST_F(LzssDamage, WindowLargerThanTheDeviceAllowsIsRefused) {
+  std::string wide = compress(data, OTA_LZSS_MAX_WINDOW_BITS + 1, 4);
+  ASSERT_FALSE(wide.empty());
+  EXPECT_EQ(error(wide), OTA_LZSS_ERR_PARAMS);
+
+  std::string lookaheadTooLong = blob;
+  lookaheadTooLong[6] = lookaheadTooLong[5];
+  EXPECT_EQ(error(lookaheadTooLong), OTA_LZSS_ERR_PARAMS);
+  EXPECT_TRUE(sink.out.empty());
+}
+
+TEST_F(LzssDamage, TruncatedStreamFailsAtFinish) {
+  for (size_t len : {(size_t)5, OtaLzssDecoder::kHeaderSize, blob.size() / 2, blob.size() - 1}) {
+    SCOPED_TRACE(len);
+    sink.out.clear();
+    EXPECT_EQ(error(blob.substr(0, len)), OTA_LZSS_ERR_CORRUPT);
+  }
+}
+
+TEST_F(LzssDamage, MoreOutputThanAnnouncedIsCorrupt) {
+  std::string shortSize = blob;
+  uint32_t announced = (uint32_t)data.size() - 1;
+  for (int i = 0; i < 4; i++) shortSize[8 + i] = static_cast<char>(announced >> (8 * i));
+  EXPECT_EQ(error(shortSize), OTA_LZSS_ERR_CORRUPT);
+  EXPECT_LE(sink.out.size(), announced);
+}
+
+TEST_F(LzssDamage, InputAfterTheEndIsCorrupt) {
+  EXPECT_EQ(error(blob + "x"), OTA_LZSS_ERR_CORRUPT);
+}
+
+TEST_F(LzssDamage, WriteFailureIsReported) {
+  sink.fail = true;
+  EXPECT_EQ(error(blob), OTA_LZSS_ERR_WRITE);
+}
+
+}  // namespace
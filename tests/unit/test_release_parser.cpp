@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// OtaReleaseParser on release documents (tests/fixtures/releases/) fed in
+// pieces split at random points: the result must not depend on where the
+// network cut the body
+
+#include <gtest/gtest.h>
+#include <ota_release_parser.h>
+
+#include "fixtures.h"
+
+namespace {
+
+struct Parsed {
+  bool done;
+  bool failed;
+  std::string tag;
+  std::string asset;
+  std::string delta;
+
+  bool operator==(const Parsed& o) const {
+    return done == o.done && failed == o.failed && tag == o.tag && asset == o.asset && delta == o.delta;
+  }
+};
+
+std::ostream& operator<<(std::ostream& out, const Parsed& p) {
+  return out << "{done=" << p.done << " failed=" << p.failed << " tag=" << p.tag << " asset=" << p.asset
+             << " delta=" << p.delta << "}";
+}
+
+Parsed result(const OtaReleaseParser& parser) {
+  return {parser.done(), parser.failed(), parser.hasTagName() ? parser.tagName() : "", parser.assetUrl(),
+          parser.deltaAssetUrl()};
+}
+
+Parsed parse(const std::string& doc, const std::vector<size_t>& pieces, const char* pattern,
+             const char* deltaPattern) {
+  OtaReleaseParser parser(pattern, deltaPattern);
+  size_t pos = 0;
+  for (size_t len : pieces) {
+    if (!parser.feed(doc.data() + pos, len)) break;
+    pos += len;
+  }
+  return result(parser);
+}
+
+Parsed parseWhole(const std::string& doc, const char* pattern = nullptr, const char* deltaPattern = nullptr) {
+  return parse(doc, {doc.size()}, pattern, deltaPattern);
+}
+
+// Same result for every two-piece split and for many random splits
+void expectSplitInvariant(const std::string& doc, const Parsed& expected, const char* pattern,
+                          const char* deltaPattern) {
+  ASSERT_EQ(parseWhole(doc, pattern, deltaPattern), expected);
+  for (size_t cut = 0; cut <= doc.size(); cut++) {
+    std::vector<size_t> pieces;
+    if (cut) pieces.push_back(cut);
+    if (cut < doc.size()) pieces.push_back(doc.size() - cut);
+    ASSERT_EQ(parse(doc, pieces, pattern, deltaPattern), expected) << "split at byte " << cut;
+  }
+  for (uint32_t seed = 1; seed <= 300; seed++) {
+    std::mt19937 rng(seed);
+    ASSERT_EQ(parse(doc, fixtures::randomSplit(doc.size(), rng), pattern, deltaPattern), expected)
+        << "seed " << seed;
+  }
+}
+
+const char* kBase = "https://github.com/wedsamuel1230/PICO_OTA/releases/download/v1.4.0/";
+
+TEST(ReleaseParser, TypicalReleasePicksAssetAndDelta) {
+  std::string doc = fixtures::read("releases/typical.json");
+  Parsed expected{true, false, "v1.4.0", std::string(kBase) + "firmware-picow.bin",
+                  std::string(kBase) + "firmware-picow-from-1.3.0.otad"};
+  expectSplitInvariant(doc, expected, "firmware-picow.bin", "firmware-picow-from-*.otad");
+}
+
+TEST(ReleaseParser, DefaultPatternTakesFirstBin) {
+  std::string doc = fixtures::read("releases/typical.json");
+  Parsed expected{true, false, "v1.4.0", std::string(kBase) + "firmware-pico2w.bin", ""};
+  expectSplitInvariant(doc, expected, nullptr, nullptr);
+}
+
+TEST(ReleaseParser, NestedNameIsNotAnAssetName) {
+  // The first asset's uploader has "name": "firmware-picow.bin"
+  std::string doc = fixtures::read("releases/typical.json");
+  Parsed parsed = parseWhole(doc, "firmware-picow.bin");
+  EXPECT_EQ(parsed.asset, std::string(kBase) + "firmware-picow.bin");
+}
+
+TEST(ReleaseParser, EscapesInUrlAreDecoded) {
+  std::string doc = fixtures::read("releases/escaped.json");
+  Parsed expected{true, false, "v2.0.0-rc.1",
+                  "https://objects.example.com/releases/fw-picow.bin?X-Amz-Date=20260502T092045Z&X-Amz-Expires=300", ""};
+  expectSplitInvariant(doc, expected, "fw-*.bin", nullptr);
+}
+
+TEST(ReleaseParser, ReleaseWithoutAssets) {
+  std::string doc = fixtures::read("releases/no_assets.json");
+  expectSplitInvariant(doc, Parsed{true, false, "v0.9.1", "", ""}, nullptr, nullptr);
+}
+
+TEST(ReleaseParser, TruncatedDocumentIsNotDone) {
+  std::string doc = fixtures::read("releases/truncated.json");
+  expectSplitInvariant(doc, Parsed{false, false, "v1.4.0", "", ""}, nullptr, nullptr);
+}
+
+TEST(ReleaseParser, MalformedDocumentFails) {
+  std::string doc = fixtures::read("releases/malformed.json");
+  Parsed parsed = parseWhole(doc);
+  EXPECT_TRUE(parsed.failed);
+  expectSplitInvariant(doc, parsed, nullptr, nullptr);
+}
+
+TEST(ReleaseParser, OverlongFieldsAreDroppedNotTruncated) {
+  std::string longTag(OTA_MAX_VERSION_LEN + 4, '1');
+  std::string longUrl = "https://example.com/" + std::string(OTA_MAX_URL_LEN, 'a') + ".bin";
+  std::string doc = "{\"tag_name\":\"" + longTag + "\",\"assets\":[{\"name\":\"a.bin\",\"browser_download_url\":\"" +
+                    longUrl + "\"},{\"name\":\"b.bin\",\"browser_download_url\":\"https://example.com/b.bin\"}]}";
+  expectSplitInvariant(doc, Parsed{true, false, "", "https://example.com/b.bin", ""}, nullptr, nullptr);
+}
+
+TEST(ReleaseParser, NestingLimitFails) {
+  std::string doc = "{\"a\":" + std::string(40, '[') + std::string(40, ']') + "}";
+  Parsed parsed = parseWhole(doc);
+  EXPECT_TRUE(parsed.failed);
+}
+
+TEST(AssetPattern, Matching) {
+  EXPECT_TRUE(otaMatchAssetPattern("firmware.bin", nullptr));
+  EXPECT_TRUE(otaMatchAssetPattern("firmware.bin", ""));
+  EXPECT_FALSE(otaMatchAssetPattern("firmware.otad", nullptr));
+  EXPECT_TRUE(otaMatchAssetPattern("fw-picow.bin", "fw-*.bin"));
+  EXPECT_FALSE(otaMatchAssetPattern("fw-picow.bin.sig", "fw-*.bin"));
+  EXPECT_TRUE(otaMatchAssetPattern("exact.bin", "exact.bin"));
+  EXPECT_FALSE(otaMatchAssetPattern("exact.bin2", "exact.bin"));
+  EXPECT_FALSE(otaMatchAssetPattern("ab", "a*b*c"));
+}
+
+}  // namespace
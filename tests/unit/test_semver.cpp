@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// otaSemverParse / otaSemverCompare: the SemVer 2.0.0 examples, the cases
+// release tags bring, and random versions and mutated strings checked
+// against a grammar (std::regex) and a plain reference comparison
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "ota_semver.h"
+
+namespace {
+
+int compare(const char* a, const char* b) {
+  OtaSemver va;
+  OtaSemver vb;
+  EXPECT_TRUE(otaSemverParse(a, &va)) << a;
+  EXPECT_TRUE(otaSemverParse(b, &vb)) << b;
+  return otaSemverCompare(va, vb);
+}
+
+TEST(Semver, ParsesReleaseTags) {
+  OtaSemver v;
+  ASSERT_TRUE(otaSemverParse("1.2.3", &v));
+  EXPECT_EQ(v.major, 1u);
+  EXPECT_EQ(v.minor, 2u);
+  EXPECT_EQ(v.patch, 3u);
+  EXPECT_FALSE(otaSemverIsPrerelease(v));
+
+  ASSERT_TRUE(otaSemverParse("v1.4", &v));
+  EXPECT_EQ(v.minor, 4u);
+  EXPECT_EQ(v.patch, 0u);
+
+  ASSERT_TRUE(otaSemverParse("V2", &v));
+  EXPECT_EQ(v.major, 2u);
+
+  const char* text = "1.0.0-rc.1+build.5";
+  ASSERT_TRUE(otaSemverParse(text, &v));
+  ASSERT_TRUE(otaSemverIsPrerelease(v));
+  EXPECT_EQ(std::string(v.pre, v.preLen), "rc.1");
+  EXPECT_EQ(v.pre, text + 6);
+
+  ASSERT_TRUE(otaSemverParse("4294967295.0.0", &v));
+  EXPECT_EQ(v.major, 4294967295u);
+  EXPECT_TRUE(otaSemverParse("1.0.0-0", &v));
+  EXPECT_TRUE(otaSemverParse("1.0.0-0a.--", &v));
+  EXPECT_TRUE(otaSemverParse("1.0.0+001", &v));  // Leading zeros are fine in build metadata
+}
+
+TEST(Semver, RejectsWhatIsNotAVersion) {
+  const char* invalid[] = {
+      "",        "v",          "x1.2.3",   " 1.2.3",    "1.2.3 ",     "01.2.3",     "1.02.3",
+      "1.2.03",  "1.",         "1..3",     "1.2.",      "1.2.3.4",    "1.2.3-",     "1.2.3-01",
+      "1.2.3-a..b", "1.2.3-a.", "1.2.3+",  "1.2.3+a+b", "1.2.3-a_b",  "1.2.3-\xc3\xa9",
+      "4294967296", "1.99999999999999999999", "-1.2.3", "vv1.2.3",
+  };
+  OtaSemver v;
+  for (const char* text : invalid) {
+    EXPECT_FALSE(otaSemverParse(text, &v)) << '"' << text << '"';
+  }
+  EXPECT_FALSE(otaSemverParse(nullptr, &v));
+  EXPECT_FALSE(otaSemverParse("1.2.3", nullptr));
+}
+
+// SemVer 2.0.0 section 11, in ascending order
+TEST(Semver, SpecPrecedenceExamples) {
+  const char* ordered[] = {"1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta",
+                           "1.0.0-beta.2", "1.0.0-beta.11", "1.0.0-rc.1",     "1.0.0",
+                           "2.0.0",        "2.1.0",         "2.1.1"};
+  const size_t count = sizeof(ordered) / sizeof(ordered[0]);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(compare(ordered[i], ordered[i]), 0) << ordered[i];
+    for (size_t j = i + 1; j < count; j++) {
+      EXPECT_LT(compare(ordered[i], ordered[j]), 0) << ordered[i] << " < " << ordered[j];
+      EXPECT_GT(compare(ordered[j], ordered[i]), 0) << ordered[j] << " > " << ordered[i];
+    }
+  }
+}
+
+TEST(Semver, BuildMetadataAndShortFormsCompareEqual) {
+  EXPECT_EQ(compare("1.0.0+a", "1.0.0+b"), 0);
+  EXPECT_EQ(compare("v1.4", "1.4.0"), 0);
+  EXPECT_EQ(compare("1", "1.0.0+x"), 0);
+  EXPECT_EQ(compare("1.0.0-rc.1+a", "1.0.0-rc.1+b"), 0);
+  EXPECT_LT(compare("1.9.0", "1.10.0"), 0);
+  EXPECT_LT(compare("1.0.0-rc.9", "1.0.0-rc.10"), 0);
+  EXPECT_LT(compare("1.0.0-9", "1.0.0-a"), 0);
+  EXPECT_LT(compare("1.0.0-Z", "1.0.0-a"), 0);  // ASCII order
+}
+
+// ━━━ Random versions ━━━
+
+// Grammar oracle: SemVer 2.0.0's regex with the optional "v" and the
+// optional MINOR / PATCH this parser allows
+const std::regex& grammar() {
+  static const std::regex re(
+      "[vV]?(0|[1-9][0-9]*)(\\.(0|[1-9][0-9]*)(\\.(0|[1-9][0-9]*))?)?"
+      "(-((0|[1-9][0-9]*|[0-9]*[a-zA-Z-][0-9a-zA-Z-]*)(\\.(0|[1-9][0-9]*|[0-9]*[a-zA-Z-][0-9a-zA-Z-]*))*))?"
+      "(\\+[0-9a-zA-Z-]+(\\.[0-9a-zA-Z-]+)*)?");
+  return re;
+}
+
+bool fits32(const std::string& digits) {
+  return digits.empty() || digits.size() < 10 || (digits.size() == 10 && digits <= "4294967295");
+}
+
+bool grammarAccepts(const std::string& text) {
+  std::smatch m;
+  if (!std::regex_match(text, m, grammar())) return false;
+  return fits32(m[1].str()) && fits32(m[3].str()) && fits32(m[5].str());
+}
+
+// Reference precedence on the parts a generated version was built from
+struct Parts {
+  uint32_t core[3];
+  std::vector<std::string> pre;
+  std::string text;
+};
+
+bool numeric(const std::string& id) {
+  return std::all_of(id.begin(), id.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+int referenceCompare(const Parts& a, const Parts& b) {
+  for (int i = 0; i < 3; i++) {
+    if (a.core[i] != b.core[i]) return a.core[i] < b.core[i] ? -1 : 1;
+  }
+  // A release is above its pre-releases
+  if (a.pre.empty() || b.pre.empty()) return (int)a.pre.empty() - (int)b.pre.empty();
+  for (size_t i = 0; i < a.pre.size() && i < b.pre.size(); i++) {
+    const std::string& x = a.pre[i];
+    const std::string& y = b.pre[i];
+    if (x == y) continue;
+    if (numeric(x) && numeric(y)) return std::stoull(x) < std::stoull(y) ? -1 : 1;
+    if (numeric(x) != numeric(y)) return numeric(x) ? -1 : 1;
+    return x < y ? -1 : 1;
+  }
+  if (a.pre.size() == b.pre.size()) return 0;
+  return a.pre.size() < b.pre.size() ? -1 : 1;
+}
+
+Parts randomVersion(std::mt19937& rng) {
+  static const char* kIdentifiers[] = {"alpha", "beta", "rc", "0", "1", "2", "10", "11", "a-b", "-", "x9", "9x"};
+  Parts v;
+  for (uint32_t& n : v.core) n = rng() % 4 == 0 ? rng() : rng() % 3;
+  v.text = (rng() % 4 == 0 ? "v" : "") + std::to_string(v.core[0]) + "." + std::to_string(v.core[1]) + "." +
+           std::to_string(v.core[2]);
+  if (rng() % 2) {
+    size_t count = 1 + rng() % 3;
+    for (size_t i = 0; i < count; i++) v.pre.push_back(kIdentifiers[rng() % 12]);
+    v.text += "-" + v.pre[0];
+    for (size_t i = 1; i < count; i++) v.text += "." + v.pre[i];
+  }
+  if (rng() % 3 == 0) v.text += "+build." + std::to_string(rng() % 100);
+  return v;
+}
+
+TEST(SemverFuzz, RandomVersionsParseAndOrderLikeTheReference) {
+  std::mt19937 rng(2026);
+  std::vector<Parts> versions;
+  for (int i = 0; i < 400; i++) versions.push_back(randomVersion(rng));
+
+  std::vector<OtaSemver> parsed(versions.size());
+  for (size_t i = 0; i < versions.size(); i++) {
+    ASSERT_TRUE(otaSemverParse(versions[i].text.c_str(), &parsed[i])) << versions[i].text;
+    EXPECT_EQ(parsed[i].major, versions[i].core[0]);
+    EXPECT_EQ(otaSemverIsPrerelease(parsed[i]), !versions[i].pre.empty());
+  }
+  for (size_t i = 0; i < versions.size(); i++) {
+    for (size_t j = 0; j < versions.size(); j++) {
+      int expected = referenceCompare(versions[i], versions[j]);
+      ASSERT_EQ(otaSemverCompare(parsed[i], parsed[j]), expected)
+          << versions[i].text << " vs " << versions[j].text;
+    }
+  }
+}
+
+// Valid versions with characters inserted, dropped or replaced: the parser
+// accepts exactly what the grammar does, and never reads past the text
+TEST(SemverFuzz, MutatedStringsMatchTheGrammar) {
+  static const char kAlphabet[] = "0123456789.-+vVaz_ \xff";
+  std::mt19937 rng(7);
+  for (int i = 0; i < 20000; i++) {
+    std::string text = randomVersion(rng).text;
+    int edits = 1 + rng() % 3;
+    for (int e = 0; e < edits; e++) {
+      size_t pos = text.empty() ? 0 : rng() % (text.size() + 1);
+      char c = kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+      switch (rng() % 3) {
+        case 0: text.insert(text.begin() + pos, c); break;
+        case 1: if (pos < text.size()) text.erase(pos, 1); break;
+        default: if (pos < text.size()) text[pos] = c; break;
+      }
+    }
+    // Exactly the text, in its own allocation, so a read past the end is visible to sanitizers
+    std::vector<char> owned(text.begin(), text.end());
+    owned.push_back('\0');
+    OtaSemver v;
+    ASSERT_EQ(otaSemverParse(owned.data(), &v), grammarAccepts(text)) << '"' << text << '"';
+  }
+}
+
+}  // namespace
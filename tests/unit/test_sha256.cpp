@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// OtaSha256 against the NIST example vectors and the padding boundaries,
+// fed whole and in the pieces a download delivers; otaParseSha256Hex
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fixtures.h"
+#include "images.h"
+#include "ota_sha256.h"
+
+namespace {
+
+std::string hex(const uint8_t* data, size_t len) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string out;
+  for (size_t i = 0; i < len; i++) {
+    out += kDigits[data[i] >> 4];
+    out += kDigits[data[i] & 15];
+  }
+  return out;
+}
+
+std::string sha256(const std::string& message, const std::vector<size_t>& pieces) {
+  OtaSha256 sha;
+  size_t pos = 0;
+  for (size_t len : pieces) {
+    sha.update(message.data() + pos, len);
+    pos += len;
+  }
+  uint8_t digest[OtaSha256::kDigestSize];
+  sha.finish(digest);
+  return hex(digest, sizeof(digest));
+}
+
+std::string sha256(const std::string& message) {
+  return sha256(message, {message.size()});
+}
+
+struct Vector {
+  std::string message;
+  const char* digest;
+};
+
+// FIPS 180-4 examples (NIST CSRC "SHA256.pdf", "SHA256_2.pdf") and the
+// one-million-"a" message from FIPS 180-2 appendix B.3
+TEST(Sha256, NistVectors) {
+  const Vector vectors[] = {
+      {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+      {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+      {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+       "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+      {"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+       "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"},
+      {std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+  };
+  for (const Vector& v : vectors) {
+    EXPECT_EQ(sha256(v.message), v.digest) << v.message.size() << " bytes";
+  }
+}
+
+// Lengths around the 55/56-byte padding split and the 64-byte block (same
+// digests as sha256sum)
+TEST(Sha256, PaddingBoundaries) {
+  const Vector vectors[] = {
+      {std::string(55, 'a'), "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318"},
+      {std::string(56, 'a'), "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a"},
+      {std::string(63, 'a'), "7d3e74a05d7db15bce4ad9ec0658ea98e3f06eeecf16b4c6fff2da457ddc2f34"},
+      {std::string(64, 'a'), "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb"},
+      {std::string(65, 'a'), "635361c48bb9eab14198e76ea8ab7f1a41685d6ad62aa9146d301d4f17eb0ae0"},
+      {std::string(119, 'a'), "31eba51c313a5c08226adf18d4a359cfdfd8d2e816b13f4af952f7ea6584dcfb"},
+      {std::string(120, 'a'), "2f3d335432c70b580af0e8e1b3674a7c020d683aa5f73aaaedfdc55af904c21c"},
+      {std::string(128, 'a'), "6836cf13bac400e9105071cd6af47084dfacad4e5e302c94bfed24e013afb73e"},
+  };
+  for (const Vector& v : vectors) {
+    EXPECT_EQ(sha256(v.message), v.digest) << v.message.size() << " bytes";
+  }
+}
+
+TEST(Sha256, PiecesDoNotChangeTheDigest) {
+  std::string image = images::codeLike(64 * 1024);
+  std::string whole = sha256(image);
+  for (uint32_t seed = 0; seed < 100; seed++) {
+    std::mt19937 rng(seed);
+    ASSERT_EQ(sha256(image, fixtures::randomSplit(image.size(), rng)), whole) << "seed " << seed;
+  }
+  EXPECT_EQ(sha256(image, std::vector<size_t>(image.size(), 1)), whole);
+}
+
+TEST(Sha256, BeginStartsOver) {
+  OtaSha256 sha;
+  sha.update("something else", 14);
+  sha.begin();
+  sha.update("abc", 3);
+  uint8_t digest[OtaSha256::kDigestSize];
+  sha.finish(digest);
+  EXPECT_EQ(hex(digest, sizeof(digest)), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(Sha256, ParseHex) {
+  const char* abc = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+  uint8_t digest[OtaSha256::kDigestSize];
+
+  ASSERT_TRUE(otaParseSha256Hex(abc, digest));
+  EXPECT_EQ(hex(digest, sizeof(digest)), abc);
+
+  std::string upper = abc;
+  for (char& c : upper) c = (char)toupper(c);
+  ASSERT_TRUE(otaParseSha256Hex(upper.c_str(), digest));
+  EXPECT_EQ(hex(digest, sizeof(digest)), abc);
+
+  std::string sha256sumLine = std::string("  ") + abc + "  firmware.bin\n";
+  ASSERT_TRUE(otaParseSha256Hex(sha256sumLine.c_str(), digest));
+  EXPECT_EQ(hex(digest, sizeof(digest)), abc);
+
+  EXPECT_FALSE(otaParseSha256Hex(std::string(abc, 63).c_str(), digest));
+  EXPECT_FALSE(otaParseSha256Hex((std::string(abc) + "0").c_str(), digest));
+  std::string badDigit = abc;
+  badDigit[10] = 'g';
+  EXPECT_FALSE(otaParseSha256Hex(badDigit.c_str(), digest));
+  EXPECT_FALSE(otaParseSha256Hex("", digest));
+}
+
+}  // namespace
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Samuel F.
+
+// OtaSpscQueue and OtaSeqlock between real threads. Build with
+// -DOTA_TEST_TSAN=ON to have ThreadSanitizer check them as well.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "ota_spsc.h"
+
+namespace {
+
+struct Item {
+  uint32_t sequence;
+  uint32_t check;  // ~sequence, so a torn copy is visible
+};
+
+TEST(SpscQueue, FifoUpToCapacity) {
+  OtaSpscQueue<Item, 4> queue;
+  EXPECT_EQ(queue.space(), 4u);
+  for (uint32_t i = 0; i < 4; i++) EXPECT_TRUE(queue.push({i, ~i}));
+  EXPECT_FALSE(queue.push({4, ~4u}));
+  EXPECT_EQ(queue.space(), 0u);
+
+  Item item;
+  for (uint32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.pop(&item));
+    EXPECT_EQ(item.sequence, i);
+  }
+  EXPECT_FALSE(queue.pop(&item));
+}
+
+// Indices wrap through uint32_t many times over a long run; every item
+// arrives once, in order and whole
+TEST(SpscQueue, ThreadsPassEveryItemInOrder) {
+  const uint32_t kItems = 1000000;
+  OtaSpscQueue<Item, 16> queue;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < kItems;) {
+      if (queue.push({i, ~i})) {
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < kItems) {
+    Item item;
+    if (!queue.pop(&item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ordered = ordered && item.sequence == expected && item.check == ~expected;
+    expected++;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  Item item;
+  EXPECT_FALSE(queue.pop(&item));
+}
+
+// A value whose words all hold the same count
+struct Snapshot {
+  uint32_t words[8];
+};
+
+Snapshot snapshot(uint32_t count) {
+  Snapshot value;
+  for (uint32_t& word : value.words) word = count;
+  return value;
+}
+
+TEST(Seqlock, ReadsTheLastWrite) {
+  OtaSeqlock<Snapshot> lock;
+  Snapshot value;
+  lock.read(&value);
+  EXPECT_EQ(value.words[0], 0u);
+
+  lock.write(snapshot(7));
+  ASSERT_TRUE(lock.tryRead(&value));
+  for (uint32_t word : value.words) EXPECT_EQ(word, 7u);
+}
+
+// One writer, several readers: every read is one whole write, and a
+// reader never goes back to an older one
+TEST(Seqlock, ReadersNeverSeeHalfAWrite) {
+  const uint32_t kWrites = 200000;
+  const int kReaders = 3;
+  OtaSeqlock<Snapshot> lock;
+  std::atomic<bool> done{false};
+  std::atomic<unsigned> torn{0};
+  std::atomic<unsigned> backwards{0};
+  std::atomic<unsigned> reads{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < kReaders; r++) {
+    readers.emplace_back([&] {
+      uint32_t last = 0;
+      while (!done.load()) {
+        Snapshot value;
+        lock.read(&value);
+        for (uint32_t word : value.words) {
+          if (word != value.words[0]) torn++;
+        }
+        if (value.words[0] < last) backwards++;
+        last = value.words[0];
+        reads++;
+      }
+    });
+  }
+  // At least kWrites, and on until the readers have overlapped many of them
+  uint32_t written = 0;
+  while (written < kWrites || reads.load() < 10000) lock.write(snapshot(++written));
+  done.store(true);
+  for (std::thread& reader : readers) reader.join();
+
+  EXPECT_EQ(torn.load(), 0u);
+  EXPECT_EQ(backwards.load(), 0u);
+  EXPECT_GT(reads.load(), 0u);
+  Snapshot value;
+  lock.read(&value);
+  EXPECT_EQ(value.words[0], written);
+}
+
+}  // namespace